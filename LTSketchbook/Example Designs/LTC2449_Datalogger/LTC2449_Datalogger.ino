@@ -62,6 +62,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <Wire.h>
 #include "LT_I2C.h"
 #include "LTC24XX_general.h"
+#include "LTC24XX_scan_ISR.h"
 
 #define CS QUIKEVAL_CS                              //!< The chip select 
 
@@ -89,7 +90,7 @@ const uint8_t OSR_CONFIG_ARRAY[10] = {LTC24XX_MULTI_CH_OSR_32768, LTC24XX_MULTI_
                                      };            //!< Build the command for different OSR modes
 
 // Prototypes
-void read_LTC2449(float vref, uint16_t eoc_timeout, uint16_t channel_delay);
+void read_LTC2449(float vref, uint16_t eoc_timeout);
 void print_all(float *results);
 void print_prompt();
 void print_all(float *results);
@@ -123,7 +124,6 @@ void loop()
   static float LTC2499_vref = 5.0;                  // Reference voltage
   static uint16_t EOC_timout = 250;                 // End of conversion timeout
   static uint16_t loop_delay = 500;                 // the delay between loops
-  static uint16_t channel_read_delay = 20;          // The delay between channel readings
   static char user_command;                         // The user input command
 
   print_prompt();                                   // Prints the prompt
@@ -136,14 +136,14 @@ void loop()
     case 'S':
     case 's':
       // Single loop
-      read_LTC2449(LTC2499_vref, EOC_timout, channel_read_delay);   // Read all the channels
+      read_LTC2449(LTC2499_vref, EOC_timout);                       // Read all the channels
       break;
     case 'C':
     case 'c':
       // Continous loop
       do
       {
-        read_LTC2449(LTC2499_vref, EOC_timout, channel_read_delay); // Read all the channels
+        read_LTC2449(LTC2499_vref, EOC_timout);                     // Read all the channels
         delay(loop_delay);                                          // Delay before repeating the loop
       }
       while (Serial.available() == false);                          // Check to see is anything was entered
@@ -166,23 +166,47 @@ void print_prompt()
   Serial.print(F("Enter a command: "));
 }
 
-//! Reads the LTC2449 and displays the results
-void read_LTC2449(float vref, uint16_t eoc_timeout, uint16_t channel_delay)
+//! Reads the LTC2449 and displays the results. The channels are swept by the
+//! LTC24XX_general scan, which reads each channel the moment its conversion ends
+//! and starts the next channel's conversion in the same transfer.
+void read_LTC2449(float vref, uint16_t eoc_timeout)
 {
   float results[16];
-  int32_t adc_code = 0;
+  LTC24XX_scan_channel channels[16];
+  LTC24XX_scan_result ring[17];
+  LTC24XX_scan_result result;
+  uint8_t done = 0;
+  uint32_t start;
   uint8_t i;
 
-  LTC24XX_EOC_timeout(CS, eoc_timeout);             // Wait for end of conversion
-  LTC24XX_SPI_16bit_command_32bit_data(CS, SINGLE_ENDED_CONFIG_ARRAY[0], OSR_CONFIG_ARRAY[7], &adc_code);           // Prime with CH0
-
   for (i=0; i<=15; i++)
   {
-    delay(channel_delay);
-    LTC24XX_EOC_timeout(CS, eoc_timeout);           // Wait for end of conversion
-    LTC24XX_SPI_16bit_command_32bit_data(CS, SINGLE_ENDED_CONFIG_ARRAY[(i+1)%16], OSR_CONFIG_ARRAY[7], &adc_code);  // Read the ADC
-    results[i%16] = LTC24XX_diff_code_to_voltage(adc_code, vref);   // Convert ADC code to voltage
+    channels[i].command_high = SINGLE_ENDED_CONFIG_ARRAY[i];
+    channels[i].command_low = OSR_CONFIG_ARRAY[7];
+    results[i] = 0;
+  }
+
+  if (LTC24XX_scan_begin(CS, channels, 16, 4, ring, 17, LTC24XX_SCAN_INTERRUPT, eoc_timeout))
+  {
+    Serial.println(F("EOC timeout"));
+    return;
+  }
+  start = millis();
+  while (done < 16)
+  {
+    if (LTC24XX_scan_read(&result) == 0)
+    {
+      results[result.channel] = LTC24XX_diff_code_to_voltage(result.code, vref);    // Convert ADC code to voltage
+      done++;
+      start = millis();
+    }
+    else if (millis() - start > eoc_timeout)
+    {
+      Serial.println(F("EOC timeout"));
+      break;
+    }
   }
+  LTC24XX_scan_end();
 
   print_all(results);                               // Display results
 }
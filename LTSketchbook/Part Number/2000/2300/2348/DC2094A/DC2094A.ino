@@ -135,20 +135,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Global variable
 static uint8_t demo_board_connected;   //!< Set to 1 if the board is connected
 union LT_union_int32_4bytes configuration_bits;
-union LT_union_int32_4bytes data;
 
 // LTC2348 specific values
 uint8_t num_of_channels = 8;  // Number of channels
 uint8_t num_of_bits = 18;
 
+#define RECORD_FRAMES 16    //!< Frames read back to back before they are printed
+
 // Function declarations
 void sneaker_port_init();
 uint8_t discover_DC2094(char *demo_name);
 void print_title();
 void print_prompt();
-void decode_values(uint32_t channel_data);
+void print_channel(LTC23XX_channel *channel);
 void menu1_display_adc_output();
 void menu2_change_softspan_range();
+void menu3_record_frames();
 
 //! Initialize Linduino
 void setup()
@@ -188,6 +190,9 @@ void loop()
       case 2:
         menu2_change_softspan_range();
         break;
+      case 3:
+        menu3_record_frames();
+        break;
       default:
         Serial.println(F("Incorrect Option"));
     }
@@ -280,30 +285,23 @@ void print_prompt()
   Serial.print(F("\n\n\n\t\t\t\tOPTIONS\n"));
   Serial.print(F("\n1 - Display ADC output\n"));
   Serial.print(F("2 - Change configuration setting\n"));
+  Serial.print(F("3 - Record frames\n"));
 
   Serial.print(F("\nENTER A COMMAND: "));
 }
 
-void decode_values(uint32_t channel_data)
+//! Prints one decoded channel word
+void print_channel(LTC23XX_channel *channel)
 {
-  uint8_t channel, config_number;
-  float voltage;
-  uint32_t code;
-
-  channel = (channel_data & CHANNEL_NUMBER) >> 3;
-  config_number = channel_data & SOFTSPAN;
-  code = (channel_data & 0xFFFFC0) >> 6;
-  voltage = LTC23XX_voltage_calculator(code, config_number);
-
   Serial.print(F("\nChannel  : "));
-  Serial.print(channel);
+  Serial.print(channel->channel);
   Serial.print(F("\t\tData       : 0x"));
-  Serial.println(code, HEX);
+  Serial.println((uint32_t)channel->code & 0x3FFFF, HEX);
   Serial.print(F("Voltage  : "));
-  Serial.print(voltage, 6);
+  Serial.print(channel->microvolts / 1000000.0, 6);
   Serial.print(F(" V"));
   Serial.print(F("\tConfig Number: "));
-  Serial.println(config_number);
+  Serial.println(channel->softspan);
 }
 
 //! Displays the ADC output and calculated voltage for all channels
@@ -311,8 +309,7 @@ void menu1_display_adc_output()
 {
   uint8_t display_channels;
   uint8_t Result[24];
-  uint8_t pos;
-  data.LT_uint32 = 0;
+  LTC23XX_channel channels[LTC23XX_FRAME_CHANNELS];
 
   Serial.print("\nEnter the number of channels to be displayed: ");
   display_channels = read_int();
@@ -324,17 +321,44 @@ void menu1_display_adc_output()
   while (!Serial.available())
   {
     LTC23XX_read(QUIKEVAL_CS, configuration_bits.LT_uint32, Result);
+    LTC23XX_decode_frame(Result, channels);
     Serial.println(F("\n********************************************"));
 
-    pos = 23;
     for (int i = 0; i < display_channels; ++i)
-    {
-      data.LT_byte[2] = Result[pos--];
-      data.LT_byte[1] = Result[pos--];
-      data.LT_byte[0] = Result[pos--];
+      print_channel(&channels[i]);
+  }
+}
 
-      decode_values(data.LT_uint32);
+//! Reads frames as fast as the loop allows and prints each as 48 hex digits,
+//! first byte clocked out first. Saved from the serial monitor, the lines are
+//! the recorded frames LTC2348/host/ltc23xx_decode_bench.cpp replays.
+void menu3_record_frames()
+{
+  uint8_t frames[RECORD_FRAMES][LTC23XX_FRAME_BYTES];
+  uint16_t count;
+  uint16_t i;
+  int8_t j;
+
+  Serial.print(F("\nEnter the number of frames to record: "));
+  count = read_int();
+  Serial.println(count);
+  while (count > 0)
+  {
+    uint16_t batch = (count > RECORD_FRAMES) ? RECORD_FRAMES : count;
+    for (i = 0; i < batch; ++i)
+      LTC23XX_read(QUIKEVAL_CS, configuration_bits.LT_uint32, frames[i]);
+    for (i = 0; i < batch; ++i)
+    {
+      Serial.print(F("FRAME,"));
+      for (j = LTC23XX_FRAME_BYTES - 1; j >= 0; --j)
+      {
+        if (frames[i][j] < 0x10)
+          Serial.print('0');
+        Serial.print(frames[i][j], HEX);
+      }
+      Serial.println();
     }
+    count -= batch;
   }
 }
 
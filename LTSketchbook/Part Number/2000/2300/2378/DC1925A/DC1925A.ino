@@ -20,6 +20,8 @@ NOTES
    to tie the voltage source negative terminal to COM.) Ensure the voltage
    source is set within the range of 0V to +5V (differential voltage range).
    (Swapping input voltages results in a reversed polarity reading.)
+   Option 3 filters many conversions into each reading. With a low-noise
+   source, the noise it reports falls as the conversions per reading rise.
 
 USER INPUT DATA FORMAT:
  decimal : 1024
@@ -84,6 +86,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LT_I2C.h"
 #include "QuikEval_EEPROM.h"
 #include "LTC2378.h"
+#include "LT_Decimate.h"
 #include <SPI.h>
 #include <Wire.h>
 
@@ -94,12 +97,15 @@ void print_user_command(uint8_t menu);                      // Display selected
 
 void menu_1_read_input();
 void menu_2_select_gain_compression();
+void menu_3_read_oversampled();
 
 // Global variables
 static uint8_t LTC2378_dgc = 0;         //!< Default set for no gain compression
 static uint8_t LTC2378_bits = 20;                   //!< Default set for 20 bits
 float LTC2378_vref = 5;
 
+#define OVERSAMPLED_RESULTS 8           //!< Results printed by menu 3
+
 
 //! Initialize Linduino
 void setup()
@@ -132,6 +138,9 @@ void loop()
         case 2:
           menu_2_select_gain_compression();
           break;
+        case 3:
+          menu_3_read_oversampled();
+          break;
         default:
           Serial.println("  Invalid Option");
           break;
@@ -204,6 +213,50 @@ void menu_2_select_gain_compression()
 }
 
 
+//! Read the input oversampled: the codes of many back to back conversions are
+//! filtered into each result, trading sample rate for resolution.
+//! @return void
+void menu_3_read_oversampled()
+{
+  LT_decimator filter;
+  LT_decimate_output result;
+  LT_scale scale;
+  int32_t adc_code;
+  uint8_t order;
+  uint16_t ratio;
+  uint8_t i;
+
+  Serial.print(F("  Filter order, 1 for a boxcar average, 2 to 4 for CIC: "));
+  order = read_int();
+  Serial.println(order);
+  Serial.print(F("  Conversions per result, a power of two: "));
+  ratio = read_int();
+  Serial.println(ratio);
+  if (LT_decimate_begin(&filter, order, ratio, LTC2378_bits, LT_DECIMATE_STATISTICS))
+  {
+    Serial.println(F("  Out of range: 20 + order * log2(conversions) must be 32 or less"));
+    return;
+  }
+  scale = LTC2378_scale_microvolts(LTC2378_vref, LTC2378_dgc);
+
+  LTC2378_read(LTC2378_CS, &adc_code);  //discard first reading
+  for (i = 0; i < OVERSAMPLED_RESULTS; i++)
+  {
+    LT_decimate_read(&filter, LTC2378_read, LTC2378_CS, &result);
+
+    Serial.print(F("  Voltage: "));
+    Serial.print(LT_convert(result.value, &scale));
+    Serial.print(F("uV  min: "));
+    Serial.print(LT_convert(result.min, &scale));
+    Serial.print(F("uV  max: "));
+    Serial.print(LT_convert(result.max, &scale));
+    Serial.print(F("uV  noise: "));
+    Serial.print(LT_convert((int32_t)result.ac_rms, &scale) - LT_convert(0, &scale));  // a spread, so without the output offset
+    Serial.println(F("uV RMS"));
+  }
+}
+
+
 //! Prints the title block when program first starts.
 void print_title()
 {
@@ -229,6 +282,7 @@ void print_prompt()
   Serial.println(F("*************************"));
   Serial.println(F("1-Read ADC Input"));
   Serial.println(F("2-Select No Gain Compression / Gain Compression (default is no compression)"));
+  Serial.println(F("3-Read ADC Input Oversampled"));
   Serial.print(F("Enter a command:"));
 }
 
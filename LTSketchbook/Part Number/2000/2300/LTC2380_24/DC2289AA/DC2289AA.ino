@@ -3,6 +3,13 @@ LTC2380-24: Low Noise, High Speed, 24-Bit SAR ADC With Digital Filter
 
 @verbatim
 
+  Option 3 streams the input: CNV is driven by Timer1 on QUIKEVAL_CS at the
+  rate entered, and a sample averaged over the number of conversions entered
+  is read on every Timer2 interrupt into the LT_Stream ring, for
+  STREAM_MS milliseconds. The sample rate achieved, the samples dropped
+  because the sketch fell behind (overruns), samples whose averaging count
+  was not the one asked for, and the mean, minimum and maximum voltage are
+  then printed.
 
 @endverbatim
 http://www.linear.com/product/LTC2380-24
@@ -52,17 +59,21 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UserInterface.h"
 #include "LT_I2C.h"
 #include <SPI.h>
+#include "LT_Stream.h"
 #include "LTC2380_24.h"
 
 #ifndef LTC2380_CNV
 #define LTC2380_CNV QUIKEVAL_CS
 #endif
 
+#define STREAM_MS 1000            //!< Length of a stream, in milliseconds
+
 // Function Declaration
 void print_title();                                         // Print the title block
 void print_prompt();
 void menu_1_read_input();
 void menu_2_select_gain_compression();
+void menu_3_stream_input();
 void configureCNV();
 
 // Global variables
@@ -100,6 +111,9 @@ void loop()
       case 2:
         menu_2_select_gain_compression();
         break;
+      case 3:
+        menu_3_stream_input();
+        break;
       default:
         Serial.println("  Invalid Option");
         break;
@@ -160,12 +174,90 @@ void menu_2_select_gain_compression()
   }
 }
 
+//! Stream the input for STREAM_MS milliseconds and print the rates and the voltage range
+//! @return void
+void menu_3_stream_input()
+{
+  int32_t cnv_hz;
+  int32_t averages;
+  int32_t adc_code;
+  int16_t cycles;
+  int32_t min_code = 0x7FFFFFFF;
+  int32_t max_code = -0x7FFFFFFF;
+  int64_t sum = 0;
+  uint32_t taken = 0;
+  uint32_t count_errors = 0;
+  uint32_t start;
+
+  Serial.print(F("\nEnter the CNV rate in Hz: "));
+  cnv_hz = read_int();
+  Serial.println(cnv_hz);
+  Serial.print(F("Enter the number of conversions averaged per sample: "));
+  averages = read_int();
+  Serial.println(averages);
+  if (cnv_hz < 1 || averages < 1 || averages > 65535)
+  {
+    Serial.println(F("  Invalid Option"));
+    return;
+  }
+
+  spi_enable(SPI_CLOCK_DIV2);    // Read each sample in as little of the sample period as possible
+  if (LTC2380_stream_begin(cnv_hz, averages))
+  {
+    Serial.println(F("  The timers cannot make these rates"));
+    quikeval_SPI_init();
+    return;
+  }
+  start = millis();
+  while (millis() - start < STREAM_MS)
+  {
+    if (LTC2380_stream_read(&adc_code, &cycles))
+      continue;
+    if (taken++ == 0)
+      continue;                  // The first sample also averages the conversion started with the timers
+    if (cycles + 1 != averages)
+      count_errors++;
+    sum += adc_code;
+    if (adc_code < min_code)
+      min_code = adc_code;
+    if (adc_code > max_code)
+      max_code = adc_code;
+  }
+  lt_stream_end();
+  quikeval_SPI_init();
+
+  Serial.print(F("\nSamples read: "));
+  Serial.print(lt_stream_samples());
+  Serial.print(F(", taken by the sketch: "));
+  Serial.println(taken);
+  Serial.print(F("Sample rate: "));
+  Serial.print(lt_stream_rate());
+  Serial.print(F(" Hz, set up for "));
+  Serial.print(lt_stream_nominal_rate());
+  Serial.println(F(" Hz"));
+  Serial.print(F("Overruns: "));
+  Serial.println(lt_stream_overruns());
+  Serial.print(F("Samples with another averaging count: "));
+  Serial.println(count_errors);
+  if (taken > 1)
+  {
+    Serial.print(F("Mean voltage: "));
+    Serial.print(LTC2380_code_to_voltage((int32_t)(sum / (taken - 1)), LTC2380_dgc, LTC2380_vref), 6);
+    Serial.print(F(" V, min "));
+    Serial.print(LTC2380_code_to_voltage(min_code, LTC2380_dgc, LTC2380_vref), 6);
+    Serial.print(F(" V, max "));
+    Serial.print(LTC2380_code_to_voltage(max_code, LTC2380_dgc, LTC2380_vref), 6);
+    Serial.println(F(" V"));
+  }
+}
+
 //! Prints main menu.
 void print_prompt()
 {
   Serial.println(F("*************************"));
   Serial.println(F("1-Read ADC Input"));
   Serial.println(F("2-Select No Gain Compression / Gain Compression (default is no compression)"));
+  Serial.println(F("3-Stream ADC Input"));
   Serial.print(F("Enter a command:"));
 }
 
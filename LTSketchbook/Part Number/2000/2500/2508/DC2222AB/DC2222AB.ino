@@ -24,6 +24,12 @@ NOTES
    Option 1: Read 40 bits of data and calculate input analog voltage.
    Option 2: Set the DF value for filter.
    Option 3: Set the reference voltage.
+   Option 4: Stream the input. MCLK is driven by Timer1 on QUIKEVAL_CS at the
+             rate entered, and a sample is read every DF MCLK pulses on a
+             Timer2 interrupt into the LT_Stream ring, for STREAM_MS
+             milliseconds. The sample rate achieved, the samples dropped
+             because the sketch fell behind (overruns), samples with the wrong
+             DF, and the mean, minimum and maximum voltage are then printed.
 
 USER INPUT DATA FORMAT:
  decimal : 1024
@@ -87,8 +93,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <Wire.h>
 #include <stdint.h>
 #include <SPI.h>
+#include "LT_Stream.h"
 #include "LTC2508.h"
 
+#define STREAM_MS 1000            //!< Length of a stream, in milliseconds
+
 float VREF = 5.0;
 uint16_t global_config_data = CONFIG_DF_1024;
 uint16_t num_of_mclk_pulses = 1024;
@@ -132,6 +141,9 @@ void loop()
       case 3:
         menu_3_set_VREF();           // Sequencing menu
         break;
+      case 4:
+        menu_4_stream_voltage();
+        break;
       default:
         Serial.println("Incorrect Option");
         break;
@@ -205,6 +217,77 @@ void menu_3_set_VREF()
 }
 
 
+//! Stream the input for STREAM_MS milliseconds and print the rates and the voltage range
+void menu_4_stream_voltage()
+{
+  int32_t mclk_hz;
+  int32_t code;
+  uint16_t DF;
+  int32_t min_code = 0x7FFFFFFF;
+  int32_t max_code = -0x7FFFFFFF;
+  float sum = 0;
+  uint32_t taken = 0;
+  uint32_t DF_errors = 0;
+  uint32_t start;
+
+  Serial.print(F("\n  Enter the MCLK rate in Hz : "));
+  mclk_hz = read_int();
+  Serial.println(mclk_hz);
+  if (mclk_hz < 1)
+  {
+    Serial.println("Incorrect Option");
+    return;
+  }
+
+  spi_enable(SPI_CLOCK_DIV2);    // Read each sample in as little of the sample period as possible
+  if (LTC2508_stream_begin(mclk_hz, num_of_mclk_pulses))
+  {
+    Serial.println(F("  The timers cannot make these rates"));
+    quikeval_SPI_init();
+    return;
+  }
+  start = millis();
+  while (millis() - start < STREAM_MS)
+  {
+    if (LTC2508_stream_read(&code, &DF))
+      continue;
+    taken++;
+    if (DF != num_of_mclk_pulses)
+      DF_errors++;
+    sum += LTC2508_code_to_voltage(code, VREF);
+    if (code < min_code)
+      min_code = code;
+    if (code > max_code)
+      max_code = code;
+  }
+  lt_stream_end();
+  quikeval_SPI_init();
+
+  Serial.print(F("\n  Samples read  : "));
+  Serial.print(lt_stream_samples());
+  Serial.print(F(", taken by the sketch: "));
+  Serial.println(taken);
+  Serial.print(F("  Sample rate   : "));
+  Serial.print(lt_stream_rate());
+  Serial.print(F(" Hz, set up for "));
+  Serial.print(lt_stream_nominal_rate());
+  Serial.println(F(" Hz"));
+  Serial.print(F("  Overruns      : "));
+  Serial.println(lt_stream_overruns());
+  Serial.print(F("  Wrong DF      : "));
+  Serial.println(DF_errors);
+  if (taken)
+  {
+    Serial.print(F("  Mean voltage  : "));
+    Serial.print(sum / taken, 9);
+    Serial.print(F(" V, min "));
+    Serial.print(LTC2508_code_to_voltage(min_code, VREF), 9);
+    Serial.print(F(" V, max "));
+    Serial.print(LTC2508_code_to_voltage(max_code, VREF), 9);
+    Serial.println(F(" V"));
+  }
+}
+
 //! Send configuration data through sneaker port
 // Send I2C data to sneaker port to bit bang WRIN_I2C(CS) at P2,
 // SCK at P5 and SDI at P6.
@@ -300,5 +383,6 @@ void print_prompt()
   Serial.print(F("  1-Read Voltage input\n"));
   Serial.print(F("  2-Change DF\n"));
   Serial.print(F("  3-Set VREF\n"));
+  Serial.print(F("  4-Stream Voltage input\n"));
   Serial.print(F("\nEnter a command:"));
 }
\ No newline at end of file
@@ -77,10 +77,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define CHIP_SELECT QUIKEVAL_CS  // Chip select pin
 
+// The configuration RAM from the channel assignments up to the end of the
+// channel 6 table: 652 + 10 * 6 - CH_ADDRESS_BASE bytes
+#define IMAGE_BYTES 200
+
 // Function prototypes
-void configure_memory_table();
-void configure_channels();
-void configure_global_parameters();
+void configure_memory_table(struct config_image *image);
+void configure_channels(struct config_image *image);
+void configure_global_parameters(struct config_image *image);
 
 
 // -------------- Configure the LTC2983 -------------------------------
@@ -96,13 +100,30 @@ void setup()
   print_title();
   discover_demo_board(demo_name);
 
-  configure_channels();
-  configure_memory_table();
-  configure_global_parameters();
+  // Build the whole configuration, then write it in one block unless the
+  // LTC2983 already holds it
+  static uint8_t image_buffer[IMAGE_BYTES];
+  struct config_image image;
+  image_begin(&image, image_buffer, IMAGE_BYTES);
+  configure_channels(&image);
+  configure_memory_table(&image);
+  configure_global_parameters(&image);
+  switch (configure_from_image(CHIP_SELECT, &image))
+  {
+    case IMAGE_WRITTEN:
+      Serial.println(F("Configuration written"));
+      break;
+    case IMAGE_ALREADY_CONFIGURED:
+      Serial.println(F("Already configured"));
+      break;
+    default:
+      Serial.println(F("Configuration did not read back correctly"));
+      break;
+  }
 }
 
 
-void configure_channels()
+void configure_channels(struct config_image *image)
 {
   uint8_t channel_number;
   uint32_t channel_assignment_data;
@@ -111,7 +132,7 @@ void configure_channels()
   channel_assignment_data =
     SENSOR_TYPE__SENSE_RESISTOR |
     (uint32_t) 0x4E20CC << SENSE_RESISTOR_VALUE_LSB;    // sense resistor - value: 5000.19921875
-  assign_channel(CHIP_SELECT, 4, channel_assignment_data);
+  image_assign_channel(image, 4, channel_assignment_data);
   // ----- Channel 6: Assign RTD Custom -----
   channel_assignment_data =
     SENSOR_TYPE__RTD_CUSTOM |
@@ -121,17 +142,17 @@ void configure_channels()
     RTD_EXCITATION_CURRENT__5UA |
     (uint32_t) 0xA << RTD_CUSTOM_ADDRESS_LSB |    // rtd - custom address: 10.
     (uint32_t) 0x9 << RTD_CUSTOM_LENGTH_1_LSB;    // rtd - custom length-1: 9.
-  assign_channel(CHIP_SELECT, 6, channel_assignment_data);
+  image_assign_channel(image, 6, channel_assignment_data);
   // ----- Channel 11: Assign Sense Resistor -----
   channel_assignment_data =
     SENSOR_TYPE__SENSE_RESISTOR |
     (uint32_t) 0x4E20CC << SENSE_RESISTOR_VALUE_LSB;    // sense resistor - value: 5000.19921875
-  assign_channel(CHIP_SELECT, 11, channel_assignment_data);
+  image_assign_channel(image, 11, channel_assignment_data);
 
 }
 
 
-void configure_memory_table()
+void configure_memory_table(struct config_image *image)
 {
   uint16_t start_address;
   uint16_t table_length;
@@ -153,20 +174,18 @@ void configure_memory_table()
   };
   start_address = (uint16_t) 652; // Real address = 6*10 + 0x250 = 652
   table_length = (uint8_t) 10;  // Real table length = 9 + 1 = 10
-  write_custom_table(CHIP_SELECT, ch_6_coefficients, start_address, table_length);
+  image_custom_table(image, ch_6_coefficients, start_address, table_length);
 
 
 }
 
 
 
-void configure_global_parameters()
+void configure_global_parameters(struct config_image *image)
 {
-  // -- Set global parameters
-  transfer_byte(CHIP_SELECT, WRITE_TO_RAM, 0xF0, TEMP_UNIT__C |
-                REJECTION__50_60_HZ);
-  // -- Set any extra delay between conversions (in this case, 0*100us)
-  transfer_byte(CHIP_SELECT, WRITE_TO_RAM, 0xFF, 0);
+  // -- Set global parameters, and any extra delay between conversions (in this case, 0*100us)
+  image_global_parameters(image, TEMP_UNIT__C |
+                          REJECTION__50_60_HZ, 0);
 }
 
 // -------------- Run the LTC2983 -------------------------------------
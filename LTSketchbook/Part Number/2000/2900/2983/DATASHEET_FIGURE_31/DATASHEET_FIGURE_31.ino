@@ -234,16 +234,27 @@ void configure_global_parameters()
 
 void loop()
 {
-  measure_channel(CHIP_SELECT, 1, TEMPERATURE);      // Ch 1: Type J Thermocouple
-  measure_channel(CHIP_SELECT, 2, TEMPERATURE);      // Ch 2: Off-Chip Diode
-  measure_channel(CHIP_SELECT, 3, TEMPERATURE);      // Ch 3: Type N Thermocouple
-  measure_channel(CHIP_SELECT, 4, TEMPERATURE);      // Ch 4: Off-Chip Diode
-  measure_channel(CHIP_SELECT, 5, TEMPERATURE);      // Ch 5: Type K Thermocouple
-  measure_channel(CHIP_SELECT, 6, TEMPERATURE);      // Ch 6: Type S Thermocouple
-  measure_channel(CHIP_SELECT, 7, TEMPERATURE);      // Ch 7: Off-Chip Diode
-  measure_channel(CHIP_SELECT, 9, TEMPERATURE);      // Ch 9: Type T Thermocouple
-  measure_channel(CHIP_SELECT, 10, TEMPERATURE);     // Ch 10: Type E Thermocouple
-  measure_channel(CHIP_SELECT, 14, TEMPERATURE);     // Ch 14: RTD PT-100
-  measure_channel(CHIP_SELECT, 16, TEMPERATURE);     // Ch 16: Type J Thermocouple
-  measure_channel(CHIP_SELECT, 20, TEMPERATURE);     // Ch 20: Thermistor 44006 10K@25C
-}
\ No newline at end of file
+  // Ch 1: Type J Thermocouple, Ch 2: Off-Chip Diode, Ch 3: Type N Thermocouple,
+  // Ch 4: Off-Chip Diode, Ch 5: Type K Thermocouple, Ch 6: Type S Thermocouple,
+  // Ch 7: Off-Chip Diode, Ch 9: Type T Thermocouple, Ch 10: Type E Thermocouple,
+  // Ch 14: RTD PT-100, Ch 16: Type J Thermocouple, Ch 20: Thermistor 44006 10K@25C
+  const uint8_t channels[] = {1, 2, 3, 4, 5, 6, 7, 9, 10, 14, 16, 20};
+  struct conversion_result results[NUMBER_OF_CHANNELS];
+  uint32_t channel_mask = 0;
+  uint8_t i;
+
+  for (i = 0; i < sizeof(channels); i++)
+    channel_mask |= (uint32_t)1 << (channels[i] - 1);
+
+  // One multiple conversion and one read of all the results
+  measure_channels(CHIP_SELECT, channel_mask, 0, results);
+
+  for (i = 0; i < sizeof(channels); i++)
+  {
+    Serial.print(F("\nChannel "));
+    Serial.println(channels[i]);
+    Serial.print(F("  Temperature = "));
+    Serial.println(results[channels[i] - 1].value);
+    print_fault_data(results[channels[i] - 1].fault);
+  }
+}
@@ -35,6 +35,10 @@ NOTES
     The command will continuously measure the LTC6804 cell voltages and print the results to the serial port.
     The loop can be exited by sending the MCU a 'm' character over the serial link.
 
+ Menu Entry 8: Start cell voltage measurement loop with binary datalog output
+    The same loop as entry 7, but each scan is sent as one binary datalog frame.
+    Decode the frames with LTC68xx/host/ltc68xx_datalog.py.
+
 USER INPUT DATA FORMAT:
  decimal : 1024
  hex     : 0x400
@@ -145,6 +149,8 @@ uint8_t rx_cfg[TOTAL_IC][8];
 |IC1 CFGR0      |IC1 CFGR1      |IC1 CFGR2      |IC1 CFGR3      |IC1 CFGR4      |IC1 CFGR5      |IC1 PEC High     |IC1 PEC Low     |IC2 CFGR0      |IC2 CFGR1      |  .....    |
 */
 
+LTC68xx_datalog datalog; //!< Binary datalog frame encoder, see LTC68xx.h
+
 /*!**********************************************************************
  \brief  Inititializes hardware and variables
  ***********************************************************************/
@@ -153,6 +159,7 @@ void setup()
   Serial.begin(115200);
   LTC6804_initialize();  //Initialize LTC6804 hardware
   init_cfg();        //initialize the 6804 configuration array to be written
+  LTC68xx_datalog_init(&datalog, datalog_write);
   print_menu();
 }
 
@@ -200,6 +207,10 @@ void loop()
     The command will continuously measure the LTC6804 cell voltages and print the results to the serial port.
     The loop can be exited by sending the MCU a 'm' character over the serial link.
 
+ Menu Entry 8: Start cell voltage measurement loop with binary datalog output
+    The same loop as entry 7, but each scan is sent as one binary datalog frame.
+    Decode the frames with LTC68xx/host/ltc68xx_datalog.py.
+
 *******************************************/
 void run_command(uint32_t cmd)
 {
@@ -286,6 +297,28 @@ void run_command(uint32_t cmd)
       print_menu();
       break;
 
+    case 8:
+      Serial.println("transmit 'm' to quit");
+      wakeup_sleep();
+      LTC6804_wrcfg(TOTAL_IC,tx_cfg);
+      while (input != 'm')
+      {
+        if (Serial.available() > 0)
+        {
+          input = read_char();
+        }
+        uint32_t timestamp = millis();
+        wakeup_idle();
+        LTC6804_adcv();
+        delay(10);
+        wakeup_idle();
+        error = LTC6804_rdcv(0, TOTAL_IC,cell_codes);
+        send_cells_datalog(error, timestamp);
+        delay(500);
+      }
+      print_menu();
+      break;
+
     default:
       Serial.println("Incorrect Option");
       break;
@@ -322,12 +355,37 @@ void print_menu()
   Serial.println("Start Aux Voltage Conversion: 5");
   Serial.println("Read Aux Voltages: 6");
   Serial.println("loop cell voltages: 7");
+  Serial.println("loop cell voltages with binary datalog output: 8");
   Serial.println("Please enter command: ");
   Serial.println();
 }
 
 
 
+/*!************************************************************
+  \brief Sends the cell codes as one binary datalog frame
+
+  The library reports a PEC error for the whole read, so every cell
+  register group is flagged when there was one.
+ *************************************************************/
+void send_cells_datalog(int8_t error, uint32_t timestamp)
+{
+  LTC68xx_datalog_begin(&datalog, TOTAL_IC, 12, 0, 0, timestamp);
+  for (int current_ic = 0 ; current_ic < TOTAL_IC; current_ic++)
+  {
+    LTC68xx_datalog_ic(&datalog, (error == -1) ? 0x000F : 0, cell_codes[current_ic], 0, 0);
+  }
+  LTC68xx_datalog_end(&datalog);
+}
+
+/*!************************************************************
+  \brief Sends binary datalog frame bytes to the serial port
+ *************************************************************/
+void datalog_write(const uint8_t *data, uint8_t len)
+{
+  Serial.write(data, len);
+}
+
 /*!************************************************************
   \brief Prints cell coltage codes to the serial port
  *************************************************************/
@@ -78,6 +78,7 @@ Copyright 2017 Linear Technology Corp. (LTC)
 
 #define DATALOG_ENABLED 1
 #define DATALOG_DISABLED 0
+#define DATALOG_BINARY 2
 
 char get_char();
 void print_menu();
@@ -89,6 +90,8 @@ void print_rxconfig();
 void print_aux(uint8_t datalog_en);
 void print_stat();
 void check_error(int error);
+void measurement_wait(uint16_t wait_ms);
+void datalog_write(const uint8_t *data, uint8_t len);
 /**********************************************************
   Setup Variables
   The following variables can be modified to
@@ -117,6 +120,7 @@ const uint8_t READ_CONFIG = DISABLED; // This is ENABLED or DISABLED
 const uint8_t MEASURE_CELL = ENABLED; // This is ENABLED or DISABLED
 const uint8_t MEASURE_AUX = DISABLED; // This is ENABLED or DISABLED
 const uint8_t MEASURE_STAT = DISABLED; //This is ENABLED or DISABLED
+const uint8_t MEASURE_OPENWIRE = DISABLED; //This is ENABLED or DISABLED, runs the open wire test between measurements
 const uint8_t PRINT_PEC = DISABLED; //This is ENABLED or DISABLED
 /************************************
   END SETUP
@@ -131,6 +135,11 @@ const uint8_t PRINT_PEC = DISABLED; //This is ENABLED or DISABLED
 
 cell_asic bms_ic[TOTAL_IC];
 
+ow_test open_wire; //!< State of the open wire test run between loop measurements
+uint16_t open_wire_codes[TOTAL_IC*12]; //!< Pull up cell codes kept by the open wire test
+
+LTC68xx_datalog datalog; //!< Binary datalog frame encoder
+
 
 /*!**********************************************************************
  \brief  Inititializes hardware and variables
@@ -143,6 +152,7 @@ void setup()
   LTC681x_init_cfg(TOTAL_IC, bms_ic);
   LTC6811_reset_crc_count(TOTAL_IC,bms_ic);
   LTC6811_init_reg_limits(TOTAL_IC,bms_ic);
+  LTC68xx_datalog_init(&datalog, datalog_write);
   print_menu();
 }
 
@@ -248,7 +258,7 @@ void run_command(uint32_t cmd)
 
         measurement_loop(DATALOG_DISABLED);
 
-        delay(MEASUREMENT_LOOP_TIME);
+        measurement_wait(MEASUREMENT_LOOP_TIME);
       }
       //print_menu();
       break;
@@ -357,7 +367,25 @@ void run_command(uint32_t cmd)
 
         measurement_loop(DATALOG_ENABLED);
 
-        delay(MEASUREMENT_LOOP_TIME);
+        measurement_wait(MEASUREMENT_LOOP_TIME);
+      }
+      print_menu();
+      break;
+
+    case 21: //Binary datalog Loop Measurements, decode with LTC68xx/host/ltc68xx_datalog.py
+      Serial.println(F("transmit 'm' to quit"));
+      wakeup_sleep(TOTAL_IC);
+      LTC6811_wrcfg(TOTAL_IC,bms_ic);
+      while (input != 'm')
+      {
+        if (Serial.available() > 0)
+        {
+          input = read_char();
+        }
+
+        measurement_loop(DATALOG_BINARY);
+
+        measurement_wait(MEASUREMENT_LOOP_TIME);
       }
       print_menu();
       break;
@@ -375,6 +403,7 @@ void run_command(uint32_t cmd)
 void measurement_loop(uint8_t datalog_en)
 {
   int8_t error = 0;
+  uint32_t timestamp = millis();
   if (WRITE_CONFIG == ENABLED)
   {
     wakeup_sleep(TOTAL_IC);
@@ -397,8 +426,11 @@ void measurement_loop(uint8_t datalog_en)
     LTC6811_pollAdc();
     wakeup_idle(TOTAL_IC);
     error = LTC6811_rdcv(0, TOTAL_IC,bms_ic);
-    check_error(error);
-    print_cells(datalog_en);
+    if (datalog_en != DATALOG_BINARY)
+    {
+      check_error(error);
+      print_cells(datalog_en);
+    }
 
   }
 
@@ -409,8 +441,11 @@ void measurement_loop(uint8_t datalog_en)
     LTC6811_pollAdc();
     wakeup_idle(TOTAL_IC);
     error = LTC6811_rdaux(0,TOTAL_IC,bms_ic); // Set to read back all aux registers
-    check_error(error);
-    print_aux(datalog_en);
+    if (datalog_en != DATALOG_BINARY)
+    {
+      check_error(error);
+      print_aux(datalog_en);
+    }
   }
 
   if (MEASURE_STAT == ENABLED)
@@ -420,11 +455,19 @@ void measurement_loop(uint8_t datalog_en)
     LTC6811_pollAdc();
     wakeup_idle(TOTAL_IC);
     error = LTC6811_rdstat(0,TOTAL_IC,bms_ic); // Set to read back all aux registers
-    check_error(error);
-    print_stat();
+    if (datalog_en != DATALOG_BINARY)
+    {
+      check_error(error);
+      print_stat();
+    }
   }
 
-  if (PRINT_PEC == ENABLED)
+  if (datalog_en == DATALOG_BINARY)
+  {
+    // PEC errors are flagged per register group in the frame
+    LTC681x_datalog(&datalog, TOTAL_IC, bms_ic, MEASURE_CELL == ENABLED, MEASURE_AUX == ENABLED, MEASURE_STAT == ENABLED, timestamp);
+  }
+  else if (PRINT_PEC == ENABLED)
   {
     print_pec();
   }
@@ -448,6 +491,7 @@ void print_menu()
   Serial.println(F("Read Stat Voltages: 8             | Run Digital Redundancy Test: 18"));
   Serial.println(F("loop Measurements: 9              | Run Open Wire Test: 19"));
   Serial.println(F("Read PEC Errors: 10               |  Loop measurements with datalog output: 20"));
+  Serial.println(F("                                  |  Loop measurements with binary datalog output: 21"));
   Serial.println();
   Serial.println(F("Please enter command: "));
   Serial.println();
@@ -492,6 +536,40 @@ void print_cells(uint8_t datalog_en)
   Serial.println();
 }
 
+/*!****************************************************************************
+  \brief Waits for the next loop measurement, running the open wire test meanwhile
+
+  The test is stepped until it is done and has read back its conversions,
+  so the next measurement never starts an ADC conversion in the middle of it.
+ *****************************************************************************/
+void measurement_wait(uint16_t wait_ms)
+{
+  uint32_t start = millis();
+
+  if (MEASURE_OPENWIRE == ENABLED)
+  {
+    LTC6811_ow_start(&open_wire, TOTAL_IC, bms_ic, open_wire_codes);
+  }
+  while ((millis() - start) < wait_ms || LTC681x_ow_busy(&open_wire))
+  {
+    if (MEASURE_OPENWIRE == ENABLED && open_wire.state != OW_DONE)
+    {
+      if (LTC6811_ow_step(&open_wire, TOTAL_IC, bms_ic) == OW_DONE)
+      {
+        print_open();
+      }
+    }
+  }
+}
+
+/*!****************************************************************************
+  \brief Sends binary datalog frame bytes to the serial port
+ *****************************************************************************/
+void datalog_write(const uint8_t *data, uint8_t len)
+{
+  Serial.write(data, len);
+}
+
 /*!****************************************************************************
   \brief Prints Open wire test results to the serial port
  *****************************************************************************/
@@ -10,6 +10,9 @@
 #include <SPI.h>
 #include <Wire.h>
 #include "LTC24XX_general.h"
+#include "QuikEval_Bus.h"
+#include "LTC2378.h"
+#include "LT_FFT.h"
 
 int8_t restore_calibration();                   // Read the DAC calibration from EEPROM, Return 1 if successful, 0 if not
 void store_calibration();                       // Store the ADC calibration to the EEPROM
@@ -19,6 +22,21 @@ uint8_t calibrate_voltage();
 static float start, stop, step;
 const uint16_t MISO_TIMEOUT = 1000;       //!< The MISO timeout (ms)
 
+//! The LTC2484 on the QuikEval connector, 1MHz SCK
+static quikeval_spi_device LTC2484_device = {LTC2484_CS, SPISettings(1000000, MSBFIRST, SPI_MODE0)};
+
+// Spectrum mode: an LTC2378 board on the QuikEval connector in place of the LTC2484
+#define FFT_LOG2_POINTS 7                     //!< 128 samples per spectrum
+#define FFT_POINTS (1 << FFT_LOG2_POINTS)
+#define FFT_MIN_PERIOD_US 20                  //!< Shortest sample period that leaves time for the read
+#define LTC2378_VREF 5.0                      //!< Reference of the LTC2378 board
+
+static int16_t fft_re[FFT_POINTS];            //!< Samples, then the real part of the spectrum
+static int16_t fft_im[FFT_POINTS];            //!< Imaginary part of the spectrum, then the magnitudes
+
+//! The LTC2378 on the QuikEval connector, 8MHz SCK
+static quikeval_spi_device LTC2378_device = {LTC2378_CS, SPISettings(8000000, MSBFIRST, SPI_MODE0)};
+
 // Calibration variables
 static float LTC2484_lsb = 9.3132258E-9;  //!< Ideal LSB size, 5V/(2^29) for a 5V reference
 static int32_t LTC2484_offset_code = 0;   //!< Ideal offset
@@ -26,8 +44,7 @@ static int32_t LTC2484_offset_code = 0;   //!< Ideal offset
 void setup()
 {
   Serial.begin(115200);
-  quikeval_SPI_init();      // Configures the SPI port for 4MHz SCK
-  quikeval_I2C_init();      // Configure the EEPROM I2C port for 100kHz SCK
+  quikeval_bus_init();      // Configures the SPI port and the 100kHz I2C port, and tracks the QuikEval mux
   restore_calibration();
 }
 
@@ -53,6 +70,10 @@ void loop()
       break;
     case 4:
       calibrate_voltage();
+      break;
+    case 5:
+      spectrum();
+      break;
     default:
       Serial.println(F("incorrect option"));
       Serial.println();
@@ -68,6 +89,7 @@ void display_menu()
   Serial.println(F("2-Analyze"));
   Serial.println(F("3-Test Clock"));
   Serial.println(F("4-Calibrate ADC"));
+  Serial.println(F("5-FFT Spectrum"));
   Serial.println();
   Serial.print(F("Enter a command: "));
 }
@@ -109,17 +131,15 @@ void analyze()
     float adc_voltage = 0;
     int32_t adc_code = 0;
 
-    quikeval_I2C_connect();                 // Connects I2C port to the QuikEval connector
+    quikeval_bus_select(QUIKEVAL_BUS_I2C);  // Connects I2C port to the QuikEval connector
 
     clock_code = LTC6904_frequency_to_code(clock, (uint8_t)LTC6904_CLK_ON_CLK_INV_ON);
     clock += (step)/10;
     LTC6904_write(LTC6904_ADDRESS, (uint32_t)clock_code);
 
-    delay(500);
-
-    quikeval_SPI_connect();                 // Connects SPI to QuikEval port
-
-    delay (500);
+    // The mux only needs the LTC4315 settling time, which quikeval_bus_select() waits
+    // for. The filter settles during the conversion that is thrown away below.
+    quikeval_spi_select(&LTC2484_device);   // Connects SPI to QuikEval port
 
     // Build ADC command to read the ADC voltage
     adc_command = LTC2484_ENABLE;
@@ -185,6 +205,90 @@ void analyze()
 
 }
 
+//! Captures FFT_POINTS samples from the LTC2378 at a fixed rate and prints the
+//! whole spectrum from 0 to half the sample rate, from the one capture.
+void spectrum()
+{
+  float rate;
+  uint16_t period_us;
+  uint32_t next_us, first_us = 0, last_us = 0;
+  int32_t adc_code;
+  int32_t sum = 0;
+  int32_t sample;
+  int16_t mean;
+  uint16_t *magnitude = (uint16_t *)fft_im;
+  float vrms_per_lsb;
+  uint16_t i;
+
+  Serial.println(F("Enter the sample rate (KHz)"));
+  rate = read_float();
+  Serial.println(rate, 4);
+  if (rate <= 0 || 1000 / rate < FFT_MIN_PERIOD_US)
+  {
+    Serial.println(F("Sample rate out of range"));
+    return;
+  }
+  period_us = (uint16_t)(1000 / rate + 0.5);
+
+  quikeval_spi_select(&LTC2378_device);   // Connects SPI to QuikEval port
+  LTC2378_read(LTC2378_CS, &adc_code);    // Throw away last reading
+
+  // Each read returns the conversion started by the one before, so the samples
+  // are as evenly spaced as the reads.
+  next_us = micros();
+  for (i = 0; i < FFT_POINTS; i++)
+  {
+    while ((int32_t)(micros() - next_us) < 0);
+    next_us += period_us;
+    if (i == 0)
+      first_us = micros();
+    else if (i == FFT_POINTS - 1)
+      last_us = micros();
+    LTC2378_read(LTC2378_CS, &adc_code);
+    fft_re[i] = (int16_t)(adc_code >> 16);
+    sum += fft_re[i];
+  }
+  rate = (FFT_POINTS - 1) * 1000.0 / (last_us - first_us);  // kHz, as measured
+
+  // Remove DC, so that it does not leak into the low bins through the window
+  mean = sum / FFT_POINTS;
+  for (i = 0; i < FFT_POINTS; i++)
+  {
+    sample = (int32_t)fft_re[i] - mean;
+    fft_re[i] = (int16_t)constrain(sample, -32767, 32767);
+    fft_im[i] = 0;
+  }
+  LT_fft_window(fft_re, FFT_LOG2_POINTS);
+  LT_fft(fft_re, fft_im, FFT_LOG2_POINTS);
+  LT_fft_magnitude(fft_re, fft_im, magnitude, FFT_POINTS / 2 + 1);
+
+  // A sine of amplitude A at the center of a bin reads A / 4 LSBs: half from the
+  // transform and half from the window's coherent gain.
+  vrms_per_lsb = 4 * LTC2378_VREF / 32768 / sqrt(2);
+
+  Serial.println();
+  Serial.print(F("Spectrum at "));
+  Serial.print(rate, 3);
+  Serial.print(F("KHz, "));
+  Serial.print(rate / FFT_POINTS, 4);
+  Serial.println(F("KHz per bin"));
+  Serial.println();
+  Serial.println(F("         --------------------------------0 dBV-|"));
+  Serial.println(F("                                               V"));
+  for (i = 1; i <= FFT_POINTS / 2; i++)
+  {
+    float frequency = i * rate / FFT_POINTS;
+
+    if (frequency <= 9)
+      Serial.print(F("  "));
+    else if (frequency <= 99)
+      Serial.print(F(" "));
+    Serial.print(frequency);
+    Serial.print(F("KHz"));
+    display_graph(magnitude[i] * vrms_per_lsb);
+  }
+}
+
 void display_graph(float data)
 {
   int16_t i, j;
@@ -224,8 +328,10 @@ void test()
     Serial.println("No Sloution");
     return;
   }
+  quikeval_bus_select(QUIKEVAL_BUS_I2C);
   LTC6904_write(LTC6904_ADDRESS, (uint32_t)clock_code);
   delay(3000);
+  quikeval_spi_select(&LTC2484_device);
 
   // Build ADC command to read the ADC voltage
   adc_command = LTC2484_ENABLE;
@@ -255,6 +361,7 @@ int8_t restore_calibration()
 // Read the DAC calibration from EEPROM
 {
   int16_t cal_key;
+  quikeval_bus_select(QUIKEVAL_BUS_I2C);
   // Read the cal key from the EEPROM
   eeprom_read_int16(EEPROM_I2C_ADDRESS, &cal_key, EEPROM_CAL_STATUS_ADDRESS);
   if (cal_key == EEPROM_CAL_KEY)
@@ -290,6 +397,7 @@ uint8_t calibrate_voltage()
   Serial.print(F("Enter the measured input voltage:"));
   zero_voltage = read_float();
   Serial.println(zero_voltage, 6);
+  quikeval_spi_select(&LTC2484_device);
 
   // Build ADC command to read the ADC voltage
   adc_command = LTC2484_ENABLE;
@@ -330,6 +438,7 @@ uint8_t calibrate_voltage()
 void store_calibration()
 // Store the ADC calibration to the EEPROM
 {
+  quikeval_bus_select(QUIKEVAL_BUS_I2C);
   eeprom_write_int16(EEPROM_I2C_ADDRESS, EEPROM_CAL_KEY, EEPROM_CAL_STATUS_ADDRESS);           // Cal key
   eeprom_write_int32(EEPROM_I2C_ADDRESS, LTC2484_offset_code, EEPROM_CAL_STATUS_ADDRESS + 2);  // Offset
   eeprom_write_float(EEPROM_I2C_ADDRESS, LTC2484_lsb, EEPROM_CAL_STATUS_ADDRESS + 6);          // LSB
@@ -0,0 +1,187 @@
+/*
+Bus Trace
+
+Records the SPI and I2C transactions of a PMBus telemetry poll with LT_Trace
+and sends them to the PC as one binary dump frame, which
+libraries/LT_Trace/host/lt_trace.py decodes and saves. The saved capture can
+be replayed on the PC by lt_trace_replay_bench.cpp, which runs the same
+poll_rail() through the unmodified LT_PMBus and LT_SMBus libraries, checks
+every transaction against the trace and times the library code without the
+bus.
+
+ 1 - Capture: traces TRACE_POLLS polls of the device at PSM_I2C_ADDRESS and
+     dumps the trace. Close the Serial Monitor and capture with:
+       python3 lt_trace.py --port /dev/ttyACM0 --frames 1 -o poll.bin
+     then send 1 from the script's port, or send 1 in the monitor and save
+     the output of a terminal program that logs binary.
+ 2 - Overhead: times TRACE_POLLS polls with the trace stopped and running.
+
+Set the baud rate to 115200 and select the newline terminator.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "Linduino.h"
+#include "UserInterface.h"
+#include "LT_I2CBus.h"
+#include "LT_SMBusNoPec.h"
+#include "LT_PMBus.h"
+#include "LT_Trace.h"
+
+#define PSM_I2C_ADDRESS 0x30      //!< 7-bit address of the PMBus device to poll
+#define TRACE_POLLS     5         //!< Polls per capture
+#define TRACE_RING_SIZE 512       //!< Trace ring size, a power of two
+
+static uint8_t trace_ring[TRACE_RING_SIZE];
+static LT_SMBus *smbus = new LT_SMBusNoPec();
+static LT_PMBus *pmbus = new LT_PMBus(smbus);
+
+//! One telemetry poll, six transactions. lt_trace_replay_bench.cpp makes the same calls.
+//! @return the sum of the readings, so none of them can be left out
+static float poll_rail(LT_PMBus *pmbus, uint8_t address)
+{
+  float sum;
+
+  pmbus->setPage(address, 0);
+  pmbus->readStatusWord(address);
+  sum = pmbus->readVout(address, false);
+  sum += pmbus->readIout(address, false);
+  sum += pmbus->readInternalTemperature(address, false);
+  return sum;
+}
+
+//! Trace TRACE_POLLS polls and send the dump frame
+static void capture()
+{
+  uint8_t i;
+
+  lt_trace_start(trace_ring, TRACE_RING_SIZE);
+  for (i = 0; i < TRACE_POLLS; i++)
+    poll_rail(pmbus, PSM_I2C_ADDRESS);
+  lt_trace_stop();
+  lt_trace_dump();
+  Serial.println();
+  Serial.print(F("Dropped records: "));
+  Serial.println(lt_trace_dropped());
+}
+
+//! Time TRACE_POLLS polls
+//! @return microseconds
+static uint32_t time_polls()
+{
+  uint32_t start;
+  uint8_t i;
+
+  start = micros();
+  for (i = 0; i < TRACE_POLLS; i++)
+    poll_rail(pmbus, PSM_I2C_ADDRESS);
+  return micros() - start;
+}
+
+//! Compare the poll time with the trace stopped and running
+static void overhead()
+{
+  uint32_t plain_us;
+  uint32_t traced_us;
+
+  plain_us = time_polls();
+  lt_trace_start(trace_ring, TRACE_RING_SIZE);
+  traced_us = time_polls();
+  lt_trace_stop();
+
+  Serial.print(F("Without trace: "));
+  Serial.print(plain_us / TRACE_POLLS);
+  Serial.println(F(" us per poll"));
+  Serial.print(F("With trace:    "));
+  Serial.print(traced_us / TRACE_POLLS);
+  Serial.println(F(" us per poll"));
+}
+
+void print_title()
+// Print the title block
+{
+  Serial.println(F(""));
+  Serial.println(F("*****************************************************************"));
+  Serial.println(F("* Bus Trace                                                     *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Records the bus transactions of a PMBus telemetry poll for    *"));
+  Serial.println(F("* lt_trace.py and the host replayer.                            *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Set the baud rate to 115200 select the newline terminator.    *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("*****************************************************************"));
+}
+
+void print_prompt()
+// Print the main menu
+{
+  Serial.println(F("\n  1-Capture and dump a trace"));
+  Serial.println(F("  2-Measure the trace overhead"));
+  Serial.print(F("\nEnter a command: "));
+}
+
+void setup()
+// Setup the program
+{
+  Serial.begin(115200);         // Initialize the serial port to the PC
+  quikeval_I2C_connect();       // Connects to main I2C port
+  print_title();
+  print_prompt();
+}
+
+void loop()
+{
+  uint8_t user_command;
+
+  if (Serial.available())
+  {
+    user_command = read_int();
+    Serial.println(user_command);
+    switch (user_command)
+    {
+      case 1:
+        capture();
+        break;
+      case 2:
+        overhead();
+        break;
+      default:
+        Serial.println(F("Incorrect Option"));
+        break;
+    }
+    print_prompt();
+  }
+}
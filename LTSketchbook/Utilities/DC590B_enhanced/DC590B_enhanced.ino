@@ -4,6 +4,11 @@ DC590B USB to Serial Controller
 
 This file contains the routines to emulate the DC590B USB to Serial Converter. All commands
 are supported except Uxxy the Write Port D bus. Added the 'D' delay ms command.
+Added the 'B' command, which switches to the binary framing mode of DC590_binary.h
+for hosts that move large SPI or I2C buffers. QuikEval keeps the ASCII protocol.
+Recording loops are compiled as they are recorded, see DC590_recording.h, and the
+added 'Wxxxx' command plays one xxxx times in a row, or until a character arrives
+when xxxx is 0000.
 With this program, the Linduino can be used by the QuikEval program running on a PC
 to communicate with QuikEval compatible demo boards.
 
@@ -57,6 +62,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LT_SPI.h"
 #include "UserInterface.h"
 #include "LT_I2C.h"
+#include "DC590_binary.h"
+#include "DC590_recording.h"
 #include <Wire.h>
 #include <SPI.h>
 
@@ -107,7 +114,7 @@ char byte_to_hex_buffer[3]=
 {
   '\0','\0','\0'
 };                     // buffer for byte to ASCII hex conversion
-char recording_buffer[RECORDING_SIZE]=
+char recording_buffer[RECORDING_SIZE + 1]=
 {
   '\0'
 }; // buffer for saving recording loop
@@ -156,6 +163,8 @@ char get_char()
       if (command == 't') command='\1';
       if (command == 'v') command='\1';
       if (command == 'u') command='\1';
+      if (command == 'W') command='\1';
+      if (command == 'B') command='\1';
     }
     else
       command = '\0';
@@ -210,9 +219,15 @@ void loop()
   char command;
   int byte_count;
   long delay_count;
+  unsigned int pass_count;
+  unsigned int pass;
   command = get_char();
   switch (command)
   {
+    case 'B':
+      // binary framing mode, until the host sends EXIT or QuikEval a reset
+      serial_mode = dc590_binary_mode(serial_mode);
+      break;
     case 'D':
       // delay milliseconds
       delay_value = read_hex();
@@ -476,6 +491,7 @@ void loop()
       break;
     case 't':   // recording loop
       recording_index = 0;
+      dc590_rec_begin();
       do
       {
         command = get_char();
@@ -483,11 +499,13 @@ void loop()
         {
           recording_buffer[recording_index]='\0';
           recording_index = 0;
+          dc590_rec_end();    // the text is only played if this fails
           break;
         }
         else            // add character to recording buffer
         {
           if (recording_index < RECORDING_SIZE) recording_buffer[recording_index++]=command;
+          dc590_rec_add(command);
         }
       }
       while (1);
@@ -502,10 +520,27 @@ void loop()
       }
       break;
     case 'v':    // echo recording loop
-      Serial.print(recording_buffer);
+      if (dc590_rec_ready()) dc590_rec_print();
+      else Serial.print(recording_buffer);
       break;
     case 'w':
-      recording_mode = playback;
+      if (dc590_rec_ready()) dc590_rec_play(serial_mode, 0);
+      else recording_mode = playback;
+      break;
+    case 'W':   // play the recording loop many times
+      pass_count = read_hex();
+      pass_count <<= 8;
+      pass_count |= read_hex();
+      if (!dc590_rec_ready())
+      {
+        recording_mode = playback;  // a recording played from its text runs once
+        break;
+      }
+      for (pass = 0; pass_count == 0 || pass < pass_count; pass++)
+      {
+        if (Serial.available() > 0) break;  // left for the next command
+        dc590_rec_play(serial_mode, 0);
+      }
       break;
     case 'x':
       output_low(QUIKEVAL_CS);
@@ -0,0 +1,225 @@
+/*
+I2C Block Read Benchmark
+
+Times a 255 byte read with PEC two ways on the QuikEval EEPROM of the demo
+board, which every board has and which sends its bytes back to back like an
+SMBus block read:
+
+ - chunked:   the Wire library way. Wire buffers 32 bytes, so the read is
+              split into 8 transactions that each resend the EEPROM address
+              pointer, the bytes are copied out of the Wire buffer, and the
+              PEC is worked out afterwards as LT_SMBus used to do.
+ - zero copy: one LT_I2C engine transaction that stores the bytes straight
+              into the buffer and works out the PEC while the next byte is
+              clocked. The 256th byte is read in place of the PEC.
+
+Both PECs cover the bytes of a single 255 byte transaction, so they must match.
+If an LTC2977 answers at LTC2977_I2C_ADDRESS its 255 byte fault log is also
+read with LT_SMBusPec::readBlock(), which only the zero copy path can do.
+
+Set the baud rate to 115200 and send any character to run the benchmark.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <Wire.h>
+#include "Linduino.h"
+#include "LT_I2C.h"
+#include "LT_SMBusPec.h"
+#include "LT_PMBus.h"
+#include "QuikEval_EEPROM.h"
+#include "UserInterface.h"
+
+#define BENCH_I2C_HZ        100000    //!< Bus speed for both paths, 100kHz or 400kHz
+#define BENCH_DATA_BYTES    255       //!< Data bytes, a full SMBus block
+#define BENCH_RUNS          10        //!< Reads averaged for each path
+#define WIRE_BUFFER_BYTES   32        //!< Wire's BUFFER_LENGTH on AVR
+#define LTC2977_I2C_ADDRESS 0x33      //!< Optional PMBus device with a 255 byte fault log
+
+static uint8_t chunked_data[BENCH_DATA_BYTES + 1];
+static uint8_t zero_copy_data[BENCH_DATA_BYTES + 1];
+static LT_SMBus *smbus = new LT_SMBusPec();
+
+//! Adds one byte to the SMBus PEC, the same CRC-8 as LT_SMBus::pecAdd()
+static uint8_t pec_add(uint8_t pec, uint8_t data)
+{
+  uint8_t i;
+
+  pec ^= data;
+  for (i = 0; i < 8; i++)
+    pec = (pec & 0x80) ? (uint8_t)((pec << 1) ^ 0x07) : (uint8_t)(pec << 1);
+  return pec;
+}
+
+//! Read BENCH_DATA_BYTES + 1 bytes from EEPROM address 0 through the 32 byte Wire buffer
+//! @return 0 on success, 1 on failure
+static int8_t read_chunked(uint8_t *data, uint8_t *pec)
+{
+  uint8_t address = EEPROM_I2C_ADDRESS >> 1;
+  uint16_t pos;
+  uint8_t length;
+  uint8_t i;
+
+  for (pos = 0; pos < BENCH_DATA_BYTES + 1; pos += length)
+  {
+    length = min(WIRE_BUFFER_BYTES, BENCH_DATA_BYTES + 1 - pos);
+    Wire.beginTransmission(address);
+    Wire.write((uint8_t)pos);                         // EEPROM address pointer
+    if (Wire.endTransmission(false))
+      return 1;
+    if (Wire.requestFrom(address, length, (uint8_t)true) != length)
+      return 1;
+    for (i = 0; i < length; i++)
+      data[pos + i] = Wire.read();
+  }
+
+  // PEC of the bytes one transaction would have sent
+  *pec = pec_add(0, address << 1);
+  *pec = pec_add(*pec, 0);
+  *pec = pec_add(*pec, (address << 1) | 0x01);
+  for (pos = 0; pos < BENCH_DATA_BYTES + 1; pos++)
+    *pec = pec_add(*pec, data[pos]);
+  return 0;
+}
+
+//! Read BENCH_DATA_BYTES bytes and a PEC byte from EEPROM address 0 in one engine transaction
+//! @return 0 on success, 1 on failure
+static int8_t read_zero_copy(uint8_t *data, uint8_t *pec)
+{
+  i2c_transfer x;
+
+  x.address = EEPROM_I2C_ADDRESS >> 1;
+  x.command[0] = 0;                                   // EEPROM address pointer
+  x.command_len = 1;
+  x.tx = 0;
+  x.tx_len = 0;
+  x.rx = data;
+  x.rx_len = BENCH_DATA_BYTES;
+  x.flags = I2C_XFER_PEC;
+  x.callback = 0;
+  x.arg = 0;
+  if (i2c_submit(&x))
+    return 1;
+  i2c_wait(&x);                                       // Fails the PEC check, the EEPROM knows no PEC
+  *pec = x.pec;
+  return 0;
+}
+
+void print_title()
+// Print the title block
+{
+  Serial.println(F(""));
+  Serial.println(F("*****************************************************************"));
+  Serial.println(F("* I2C Block Read Benchmark                                      *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Times a 255 byte read with PEC from the QuikEval EEPROM,      *"));
+  Serial.println(F("* through the Wire buffer in chunks and with the zero copy path.*"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Set the baud rate to 115200 select the newline terminator.    *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("*****************************************************************"));
+}
+
+void setup()
+// Setup the program
+{
+  Serial.begin(115200);         // Initialize the serial port to the PC
+  quikeval_I2C_connect();       // Connects to main I2C port
+  Wire.begin();
+  Wire.setClock(BENCH_I2C_HZ);  // The engine shares the TWI bit rate with Wire
+  print_title();
+}
+
+void loop()
+{
+  uint8_t chunked_pec = 0;
+  uint8_t zero_copy_pec = 0;
+  uint32_t start;
+  uint32_t chunked_us = 0;
+  uint32_t zero_copy_us = 0;
+  uint8_t run;
+  uint16_t actual_size;
+
+  Serial.println(F("\nSend any character to start the benchmark. (Press enter in Arduino Serial Monitor.)"));
+  read_int();
+  if (i2c_poll(EEPROM_I2C_ADDRESS >> 1))
+  {
+    Serial.println(F("No acknowledge from the QuikEval EEPROM, is a demo board connected?"));
+    return;
+  }
+
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    start = micros();
+    if (read_chunked(chunked_data, &chunked_pec))
+    {
+      Serial.println(F("Chunked read failed"));
+      return;
+    }
+    chunked_us += micros() - start;
+
+    start = micros();
+    if (read_zero_copy(zero_copy_data, &zero_copy_pec))
+    {
+      Serial.println(F("Zero copy read failed"));
+      return;
+    }
+    zero_copy_us += micros() - start;
+  }
+
+  Serial.print(F("Chunked:   "));
+  Serial.print(chunked_us / BENCH_RUNS);
+  Serial.print(F(" us, PEC 0x"));
+  Serial.println(chunked_pec, HEX);
+  Serial.print(F("Zero copy: "));
+  Serial.print(zero_copy_us / BENCH_RUNS);
+  Serial.print(F(" us, PEC 0x"));
+  Serial.println(zero_copy_pec, HEX);
+  if (chunked_pec != zero_copy_pec || memcmp(chunked_data, zero_copy_data, BENCH_DATA_BYTES) != 0)
+    Serial.println(F("MISMATCH between the two reads"));
+
+  // A real SMBus block read, which Wire alone cannot do in one transaction
+  if (i2c_poll(LTC2977_I2C_ADDRESS) == 0)
+  {
+    start = micros();
+    actual_size = smbus->readBlock(LTC2977_I2C_ADDRESS, MFR_FAULT_LOG, zero_copy_data, BENCH_DATA_BYTES);
+    Serial.print(F("LTC2977 fault log: "));
+    Serial.print(actual_size);
+    Serial.print(F(" bytes in "));
+    Serial.print(micros() - start);
+    Serial.println(F(" us"));
+  }
+}
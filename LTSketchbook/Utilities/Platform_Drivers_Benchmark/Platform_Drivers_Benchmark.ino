@@ -0,0 +1,305 @@
+/*
+Platform Drivers Benchmark
+
+Times the hot read path of the no-OS drivers on top of platform_drivers two
+ways. "Before" is the platform code the drivers used to run on, reproduced
+in this sketch. "After" is the platform_drivers library as it is now.
+
+ - AD7124 data register: ad7124_read_data() makes one spi_write_and_read() of
+   the command byte and 3 data bytes. Before: the bytes were copied to a
+   stack buffer and sent one SPI.transfer() at a time, between two
+   digitalWrite() calls for CS. After: the buffer is transferred in place in
+   one burst, and CS is set through its port register.
+ - AD5933 real/imag data: 4 bytes from registers 0x94 to 0x97. Before: the
+   driver's pattern, one pointer write and one 1 byte Wire read per register.
+   After: one pointer write, then the block read command and the 4 byte read
+   as one LT_I2C engine transaction straight into the caller's buffer. Only
+   run if an AD5933 answers at AD5933_I2C_ADDRESS.
+ - Long read: 64 bytes from the QuikEval EEPROM, which every demo board has.
+   Before: two 32 byte Wire reads, each with its own pointer write. After:
+   one pointer write held by i2c_write() and one i2c_read() of 64 bytes.
+
+The SPI reads need no board; without one the AD7124 bytes read are 0xFF.
+
+Set the baud rate to 115200 and send any character to run the benchmark.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <SPI.h>
+#include <Wire.h>
+#include "Linduino.h"
+#include "UserInterface.h"
+#include <platform_drivers.h>
+
+#define BENCH_RUNS          1000      //!< Reads timed for each path
+#define AD7124_DATA_READ    0x42      //!< Communications register: read, data register
+#define AD7124_DATA_BYTES   3
+#define AD5933_I2C_ADDRESS  0x0D
+#define AD5933_ADDR_POINTER 0xB0      //!< Command: set the address pointer
+#define AD5933_BLOCK_READ   0xA1      //!< Command: read a block from the address pointer
+#define AD5933_REAL_DATA    0x94      //!< Real data MSB, imaginary data follows
+#define AD5933_DATA_BYTES   4
+#define EEPROM_I2C_ADDRESS  0x50      //!< 7-bit address of the QuikEval EEPROM
+#define LONG_READ_BYTES     64
+#define WIRE_BUFFER_BYTES   32        //!< Wire's BUFFER_LENGTH on AVR
+
+spi_init_param spi_params =
+{
+  GENERIC_SPI, // Type
+  QUIKEVAL_CS, // ID
+  1000000, // Max speed, Hz, as EVAL-AD7124-8
+  3, // Mode
+  QUIKEVAL_CS, // CS ID
+};
+
+i2c_init_param i2c_params =
+{
+  GENERIC_I2C,    // i2c type
+  0,              // i2c id
+  100000,         // i2c max speed (hz), as EVAL-AD5933
+  AD5933_I2C_ADDRESS,  // i2c slave address
+};
+
+static spi_desc *spi;
+static i2c_desc *ad5933;
+static i2c_desc *eeprom;
+static uint8_t before_long[LONG_READ_BYTES];
+static uint8_t after_long[LONG_READ_BYTES];
+
+//! spi_write_and_read() as it was: a copy to a stack buffer, a function call per
+//! byte and digitalWrite() for CS
+static void before_spi_write_and_read(uint8_t cs, uint8_t *data, uint8_t bytes_number)
+{
+  uint8_t tx[bytes_number];
+  uint8_t i;
+
+  for (i = 0; i < bytes_number; i++)
+    tx[i] = data[i];
+  output_low(cs);
+  for (i = 0; i < bytes_number; i++)
+    data[i] = SPI.transfer(tx[i]);
+  output_high(cs);
+}
+
+//! AD5933 real and imaginary data the way the driver reads registers, one byte at a time
+//! @return 0 on success, 1 on failure
+static int8_t before_ad5933_read(uint8_t *data)
+{
+  uint8_t pointer[2];
+  uint8_t i;
+
+  for (i = 0; i < AD5933_DATA_BYTES; i++)
+  {
+    pointer[0] = AD5933_ADDR_POINTER;
+    pointer[1] = AD5933_REAL_DATA + i;
+    if (Wire_Write(AD5933_I2C_ADDRESS, pointer, 2, 1))
+      return 1;
+    if (Wire_Read(AD5933_I2C_ADDRESS, &data[i], 1, 1) != 1)
+      return 1;
+  }
+  return 0;
+}
+
+//! AD5933 real and imaginary data with a block read
+//! @return 0 on success, 1 on failure
+static int8_t after_ad5933_read(uint8_t *data)
+{
+  uint8_t pointer[2] = {AD5933_ADDR_POINTER, AD5933_REAL_DATA};
+  uint8_t block[2] = {AD5933_BLOCK_READ, AD5933_DATA_BYTES};
+
+  if (i2c_write(ad5933, pointer, 2, 1) != SUCCESS)
+    return 1;
+  if (i2c_write(ad5933, block, 2, 0) != SUCCESS)
+    return 1;
+  return (i2c_read(ad5933, data, AD5933_DATA_BYTES, 1) != SUCCESS);
+}
+
+//! LONG_READ_BYTES from EEPROM address 0 through the 32 byte Wire buffer
+//! @return 0 on success, 1 on failure
+static int8_t before_long_read(uint8_t *data)
+{
+  uint8_t pos;
+
+  for (pos = 0; pos < LONG_READ_BYTES; pos += WIRE_BUFFER_BYTES)
+  {
+    if (Wire_Write(EEPROM_I2C_ADDRESS, &pos, 1, 0))
+      return 1;
+    if (Wire_Read(EEPROM_I2C_ADDRESS, data + pos, WIRE_BUFFER_BYTES, 1) != WIRE_BUFFER_BYTES)
+      return 1;
+  }
+  return 0;
+}
+
+//! LONG_READ_BYTES from EEPROM address 0 in one transaction
+//! @return 0 on success, 1 on failure
+static int8_t after_long_read(uint8_t *data)
+{
+  uint8_t pointer = 0;
+
+  if (i2c_write(eeprom, &pointer, 1, 0) != SUCCESS)
+    return 1;
+  return (i2c_read(eeprom, data, LONG_READ_BYTES, 1) != SUCCESS);
+}
+
+//! Prints one result line
+static void print_result(const __FlashStringHelper *name, uint32_t us, uint16_t runs, uint16_t bytes)
+{
+  Serial.print(name);
+  Serial.print(us / runs);
+  Serial.print(F(" us per read, "));
+  Serial.print((uint32_t)((float)bytes * runs * 1000000.0 / us));
+  Serial.println(F(" data bytes/s"));
+}
+
+//! Time the AD7124 data register read both ways
+static void bench_ad7124()
+{
+  uint8_t data[1 + AD7124_DATA_BYTES];
+  uint32_t start;
+  uint32_t before_us;
+  uint32_t after_us;
+  uint16_t run;
+
+  quikeval_set_mux(MUX_SPI);
+  SPI.beginTransaction(SPISettings(spi_params.max_speed_hz, MSBFIRST, SPI_MODE3));
+  start = micros();
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    data[0] = AD7124_DATA_READ;
+    before_spi_write_and_read(QUIKEVAL_CS, data, sizeof(data));
+  }
+  before_us = micros() - start;
+  SPI.endTransaction();
+
+  start = micros();
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    data[0] = AD7124_DATA_READ;
+    spi_write_and_read(spi, data, sizeof(data));
+  }
+  after_us = micros() - start;
+  quikeval_set_mux(MUX_I2C);
+
+  Serial.println(F("AD7124 data register, 1MHz SCK:"));
+  print_result(F("  Before: "), before_us, BENCH_RUNS, AD7124_DATA_BYTES);
+  print_result(F("  After:  "), after_us, BENCH_RUNS, AD7124_DATA_BYTES);
+}
+
+//! Time an I2C read both ways
+static void bench_i2c(const __FlashStringHelper *title, int8_t (*before)(uint8_t *), int8_t (*after)(uint8_t *),
+                      uint8_t *before_data, uint8_t *after_data, uint16_t bytes)
+{
+  uint32_t start;
+  uint32_t before_us;
+  uint32_t after_us;
+  uint16_t run;
+
+  start = micros();
+  for (run = 0; run < BENCH_RUNS / 10; run++)
+    if (before(before_data))
+    {
+      Serial.println(F("Before read failed"));
+      return;
+    }
+  before_us = micros() - start;
+
+  start = micros();
+  for (run = 0; run < BENCH_RUNS / 10; run++)
+    if (after(after_data))
+    {
+      Serial.println(F("After read failed"));
+      return;
+    }
+  after_us = micros() - start;
+
+  Serial.println(title);
+  print_result(F("  Before: "), before_us, BENCH_RUNS / 10, bytes);
+  print_result(F("  After:  "), after_us, BENCH_RUNS / 10, bytes);
+  if (memcmp(before_data, after_data, bytes) != 0)
+    Serial.println(F("  MISMATCH between the two reads"));
+}
+
+void print_title()
+// Print the title block
+{
+  Serial.println(F(""));
+  Serial.println(F("*****************************************************************"));
+  Serial.println(F("* Platform Drivers Benchmark                                    *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Times the no-OS drivers' hot read paths on the platform code  *"));
+  Serial.println(F("* they used to run on and on platform_drivers as it is now.     *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Set the baud rate to 115200 select the newline terminator.    *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("*****************************************************************"));
+}
+
+void setup()
+// Setup the program
+{
+  i2c_init_param eeprom_params = i2c_params;
+
+  Serial.begin(115200);         // Initialize the serial port to the PC
+  spi_init(&spi, spi_params);
+  i2c_init(&ad5933, i2c_params);  // Leaves the QuikEval mux on I2C
+  eeprom_params.slave_address = EEPROM_I2C_ADDRESS;
+  i2c_init(&eeprom, eeprom_params);
+  print_title();
+}
+
+void loop()
+{
+  uint8_t before_data[AD5933_DATA_BYTES];
+  uint8_t after_data[AD5933_DATA_BYTES];
+
+  Serial.println(F("\nSend any character to start the benchmark. (Press enter in Arduino Serial Monitor.)"));
+  read_int();
+
+  bench_ad7124();
+
+  if (Wire_Write(AD5933_I2C_ADDRESS, 0, 0, 1) == 0)
+    bench_i2c(F("AD5933 real/imag data, 100kHz SCL:"), before_ad5933_read, after_ad5933_read,
+              before_data, after_data, AD5933_DATA_BYTES);
+  else
+    Serial.println(F("No AD5933, real/imag data read skipped"));
+
+  if (Wire_Write(EEPROM_I2C_ADDRESS, 0, 0, 1) == 0)
+    bench_i2c(F("64 byte read from the QuikEval EEPROM, 100kHz SCL:"), before_long_read, after_long_read,
+              before_long, after_long, LONG_READ_BYTES);
+  else
+    Serial.println(F("No acknowledge from the QuikEval EEPROM, is a demo board connected?"));
+}
@@ -1,68 +1,545 @@
+/*
+Speed Test
 
-//#define SerialUSB Serial
+Times the Linduino transfer paths and prints one machine-readable line per
+result, so that a driver change can be compared with the one before it, and
+one board with another:
+
+ - spi:    LT_SPI byte, word and 64 byte block transfers and a 256 byte
+           spi_stream(), at every SPI clock divider.
+ - i2c:    LT_I2C byte, byte data, word data and 32 byte block reads.
+ - i2cbus: LT_I2CBus, the Wire based bus under LT_SMBus, byte, byte data,
+           word data and 32 and 255 byte block reads.
+ - smbus:  the cost of PEC. A word read without PEC, with the PEC worked out
+           by LT_SMBus as LT_SMBusPec::readWord() does, and with the PEC
+           checked by the LT_I2C engine as the bytes arrive; the same for a
+           32 byte block, and pecAdd() on its own.
+ - convert: an LTC2378 code to volts with the float formula, to microvolts
+           with LT_convert(), and a block of codes with LT_convert_array().
+ - serial: 64 words printed in decimal and in hex and written as binary,
+           once into a Print that only counts bytes (param 0, the CPU cost)
+           and once to the serial port (param is the baud rate, wire time).
+
+The I2C tests read the QuikEval EEPROM of the demo board, so any demo board
+will do. The EEPROM knows no PEC, so the PEC reads report fail, but take the
+same time as on a PMBus part. The SPI tests select BENCH_SPI_CS, a pin that
+is not on the QuikEval connector, so no part on the demo board is written.
+
+Each result is a line of comma separated fields:
+
+  RESULT,group,test,param,bytes,ops,total_us,cycles,status
+
+param is the SCK or SCL frequency in Hz, the baud rate, or 0. bytes is the
+data moved by one operation, ops the number of operations timed together
+with micros() in total_us. cycles is the best of BENCH_CYCLE_RUNS single
+operations counted by Timer1 at the CPU clock on AVR, and is empty where
+there is no cycle counter or the operation takes longer than Timer1 can
+count. status is ok or fail. A BOARD line comes first and a DONE line with
+the number of results last; every other line is for people and can be
+ignored. speed_test.py in this folder collects a run into a CSV or JSON file
+and compares two of them.
+
+Set the baud rate to 115200 and send any character to run the tests.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <Wire.h>
+#include <SPI.h>
+#include "Linduino.h"
+#include "LT_SPI.h"
+#include "LT_I2C.h"
+#include "LT_I2CBus.h"
+#include "LT_SMBusNoPec.h"
+#include "QuikEval_EEPROM.h"
+#include "LT_Convert.h"
+#include "LTC2378.h"
+#include "UserInterface.h"
+
+#ifndef BENCH_BOARD
+#define BENCH_BOARD         "Linduino"  //!< Board name for the BOARD line, define it when building for another board
+#endif
+#define BENCH_BAUD          115200    //!< Serial baud rate, also the param of the serial results
+#define BENCH_SPI_CS        2         //!< Chip select for the SPI tests, a pin not on the QuikEval connector
+#define BENCH_OPS           100       //!< Operations timed together for the short tests
+#define BENCH_BLOCK_OPS     20        //!< Operations timed together for the block tests
+#define BENCH_SERIAL_OPS    4         //!< Operations timed together for the serial tests
+#define BENCH_CYCLE_RUNS    3         //!< Single operations counted by Timer1, the best is reported
+#define BENCH_SPI_BLOCK     64        //!< Bytes in an SPI block transfer
+#define BENCH_SPI_STREAM    256       //!< Bytes in an spi_stream() call
+#define BENCH_I2C_BLOCK     32        //!< Bytes in an I2C block read, the size of the Wire buffer
+#define BENCH_I2C_LONG      255       //!< Bytes in a long I2C block read, a full SMBus block
+#define BENCH_SERIAL_WORDS  64        //!< Words printed or written by the serial tests
+#define BENCH_CONVERT_CODES 32        //!< Codes in an LT_convert_array() block
+
+//! Timer1 counts up to 65535 CPU cycles, so longer operations only get a micros() time
+#define BENCH_CYCLE_MAX_US  (65536UL / (F_CPU / 1000000UL) - 50)
+
+//! One operation under test
+//! @return 0 on success, 1 on failure
+typedef int8_t (*bench_fn)(void);
+
+//! A Print that counts the bytes it is given and drops them, to time the formatting alone
+class CountPrint : public Print
+{
+  public:
+    uint16_t count;
+
+    size_t write(uint8_t c)
+    {
+      count++;
+      return 1;
+    }
+};
+
+static uint8_t bench_buf[BENCH_SPI_STREAM];
+static uint16_t serial_words[BENCH_SERIAL_WORDS];
+static int32_t convert_codes[BENCH_CONVERT_CODES];
+static int32_t convert_values[BENCH_CONVERT_CODES];
+static volatile int32_t convert_code = 0x5A5A5A5A;   // volatile, so the conversions are not worked out at compile time
+static volatile int32_t convert_value;
+static volatile float convert_volts;
+static const LT_scale convert_scale = LTC2378_scale_microvolts(5.0, 0);
+static uint8_t eeprom_address = EEPROM_I2C_ADDRESS >> 1;
+static uint16_t cycle_overhead;
+static uint16_t results;
+static Print *serial_out;
+static CountPrint count_print;
+static LT_SMBus *smbus;
+static LT_I2CBus *i2cbus;
+
+//! Print one RESULT line
+static void bench_report(const __FlashStringHelper *group, const __FlashStringHelper *test, uint32_t param,
+                         uint16_t bytes, uint16_t ops, uint32_t total_us, uint16_t cycles, int8_t fail)
+{
+  Serial.print(F("RESULT,"));
+  Serial.print(group);
+  Serial.print(',');
+  Serial.print(test);
+  Serial.print(',');
+  Serial.print(param);
+  Serial.print(',');
+  Serial.print(bytes);
+  Serial.print(',');
+  Serial.print(ops);
+  Serial.print(',');
+  Serial.print(total_us);
+  Serial.print(',');
+  if (cycles)
+    Serial.print(cycles);
+  Serial.print(',');
+  Serial.println(fail ? F("fail") : F("ok"));
+  results++;
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+//! Count the CPU cycles of single calls of fn with Timer1, the best of a few to drop
+//! the ones hit by the millis() interrupt
+//! @return the cycles, or 0 if a call takes longer than Timer1 can count
+static uint16_t bench_cycles(bench_fn fn)
+{
+  uint32_t start;
+  uint16_t count;
+  uint16_t best = 0xFFFF;
+  uint8_t i;
+
+  for (i = 0; i < BENCH_CYCLE_RUNS; i++)
+  {
+    start = micros();
+    TCNT1 = 0;
+    fn();
+    count = TCNT1;
+    if (micros() - start >= BENCH_CYCLE_MAX_US)
+      return 0;                         // Timer1 wrapped
+    if (count < best)
+      best = count;
+  }
+  return best;
+}
+#endif
+
+//! Time ops calls of fn with micros(), count the cycles of single calls, and report them
+static void bench(const __FlashStringHelper *group, const __FlashStringHelper *test, uint32_t param,
+                  uint16_t bytes, uint16_t ops, bench_fn fn)
+{
+  uint32_t start;
+  uint32_t total_us;
+  uint16_t cycles = 0;
+  int8_t fail = 0;
+  uint16_t i;
+
+  Serial.flush();                       // No transmit interrupts while timing
+  start = micros();
+  for (i = 0; i < ops; i++)
+    fail |= fn();
+  total_us = micros() - start;
+
+#if defined(ARDUINO_ARCH_AVR)
+  cycles = bench_cycles(fn);
+  if (cycles)
+    cycles -= cycle_overhead;
+#endif
+
+  bench_report(group, test, param, bytes, ops, total_us, cycles, fail);
+}
+
+static int8_t bench_nothing()
+{
+  return 0;
+}
+
+static int8_t bench_spi_byte()
+{
+  spi_transfer_byte(BENCH_SPI_CS, 0xFF, bench_buf);
+  return 0;
+}
+
+static int8_t bench_spi_word()
+{
+  uint16_t rx;
+
+  spi_transfer_word(BENCH_SPI_CS, 0xFFFF, &rx);
+  return 0;
+}
+
+static int8_t bench_spi_block()
+{
+  spi_transfer_block(BENCH_SPI_CS, bench_buf, bench_buf, BENCH_SPI_BLOCK);
+  return 0;
+}
+
+static int8_t bench_spi_stream()
+{
+  spi_stream(0, bench_buf, BENCH_SPI_STREAM, LT_SPI_FILL_ONES);
+  return 0;
+}
+
+static int8_t bench_i2c_byte()
+{
+  return i2c_read_byte(eeprom_address, bench_buf);
+}
+
+static int8_t bench_i2c_byte_data()
+{
+  return i2c_read_byte_data(eeprom_address, 0, bench_buf);
+}
+
+static int8_t bench_i2c_word_data()
+{
+  uint16_t value;
+
+  return i2c_read_word_data(eeprom_address, 0, &value);
+}
+
+static int8_t bench_i2c_block()
+{
+  return i2c_read_block_data(eeprom_address, 0, BENCH_I2C_BLOCK, bench_buf);
+}
+
+static int8_t bench_i2cbus_byte()
+{
+  return i2cbus->readByte(eeprom_address, bench_buf);
+}
+
+static int8_t bench_i2cbus_byte_data()
+{
+  return i2cbus->readByteData(eeprom_address, 0, bench_buf);
+}
+
+static int8_t bench_i2cbus_word_data()
+{
+  uint16_t value;
+
+  return i2cbus->readWordData(eeprom_address, 0, &value);
+}
+
+static int8_t bench_i2cbus_block()
+{
+  return i2cbus->readBlockData(eeprom_address, 0, BENCH_I2C_BLOCK, bench_buf);
+}
+
+static int8_t bench_i2cbus_long()
+{
+  return i2cbus->readBlockData(eeprom_address, 0, BENCH_I2C_LONG, bench_buf);
+}
+
+//! LT_SMBusBase::readWord() with PEC, without its failure messages
+static int8_t bench_smbus_word_pec_software()
+{
+  smbus->pecClear();
+  smbus->pecAdd(eeprom_address << 1);
+  smbus->pecAdd(0);
+  smbus->pecAdd((eeprom_address << 1) | 0x01);
+  if (i2cbus->readBlockData(eeprom_address, 0, 3, bench_buf))
+    return 1;
+  smbus->pecAdd(bench_buf[0]);
+  smbus->pecAdd(bench_buf[1]);
+  return smbus->pecGet() != bench_buf[2];
+}
+
+static int8_t bench_smbus_word_pec_engine()
+{
+  return i2cbus->readBlockDataPec(eeprom_address, 0, 2, bench_buf);
+}
+
+static int8_t bench_smbus_block_pec_software()
+{
+  uint8_t i;
+
+  smbus->pecClear();
+  smbus->pecAdd(eeprom_address << 1);
+  smbus->pecAdd(0);
+  smbus->pecAdd((eeprom_address << 1) | 0x01);
+  if (i2cbus->readBlockData(eeprom_address, 0, BENCH_I2C_BLOCK + 1, bench_buf))
+    return 1;
+  for (i = 0; i < BENCH_I2C_BLOCK; i++)
+    smbus->pecAdd(bench_buf[i]);
+  return smbus->pecGet() != bench_buf[BENCH_I2C_BLOCK];
+}
+
+static int8_t bench_smbus_block_pec_engine()
+{
+  return i2cbus->readBlockDataPec(eeprom_address, 0, BENCH_I2C_BLOCK, bench_buf);
+}
+
+static int8_t bench_smbus_pec_add()
+{
+  uint8_t i;
+
+  smbus->pecClear();
+  for (i = 0; i < BENCH_I2C_BLOCK; i++)
+    smbus->pecAdd(bench_buf[i]);
+  return 0;
+}
+
+static int8_t bench_convert_float()
+{
+  convert_volts = LTC2378_code_to_voltage(convert_code, 0, 5.0);
+  return 0;
+}
+
+static int8_t bench_convert_int()
+{
+  convert_value = LT_convert(convert_code, &convert_scale);
+  return 0;
+}
+
+static int8_t bench_convert_array()
+{
+  LT_convert_array(convert_codes, convert_values, BENCH_CONVERT_CODES, &convert_scale);
+  return 0;
+}
+
+static int8_t bench_serial_print_dec()
+{
+  uint8_t i;
+
+  serial_out->print('#');
+  for (i = 0; i < BENCH_SERIAL_WORDS; i++)
+  {
+    serial_out->print(serial_words[i]);
+    serial_out->print(',');
+  }
+  serial_out->println();
+  serial_out->flush();
+  return 0;
+}
+
+static int8_t bench_serial_print_hex()
+{
+  uint8_t i;
+
+  serial_out->print('#');
+  for (i = 0; i < BENCH_SERIAL_WORDS; i++)
+  {
+    serial_out->print(serial_words[i], HEX);
+    serial_out->print(',');
+  }
+  serial_out->println();
+  serial_out->flush();
+  return 0;
+}
+
+//! The words are chosen so that none of their bytes is a line end
+static int8_t bench_serial_write()
+{
+  serial_out->write('#');
+  serial_out->write((const uint8_t *)serial_words, sizeof(serial_words));
+  serial_out->println();
+  serial_out->flush();
+  return 0;
+}
+
+//! Run a serial test into the counting Print and then to the serial port
+static void bench_serial(const __FlashStringHelper *test, bench_fn fn)
+{
+  uint16_t bytes;
+
+  serial_out = &count_print;
+  count_print.count = 0;
+  fn();
+  bytes = count_print.count;
+  bench(F("serial"), test, 0, bytes, BENCH_OPS, fn);
+  serial_out = &Serial;
+  bench(F("serial"), test, BENCH_BAUD, bytes, BENCH_SERIAL_OPS, fn);
+  Serial.println();
+}
+
+static void bench_spi()
+{
+  static const uint8_t dividers[] = {SPI_CLOCK_DIV2, SPI_CLOCK_DIV4, SPI_CLOCK_DIV8, SPI_CLOCK_DIV16,
+                                     SPI_CLOCK_DIV32, SPI_CLOCK_DIV64, SPI_CLOCK_DIV128
+                                    };
+  uint8_t i;
+  uint32_t sck = F_CPU / 2;
+
+  quikeval_SPI_connect();
+  for (i = 0; i < sizeof(dividers); i++, sck /= 2)
+  {
+    spi_enable(dividers[i]);
+    bench(F("spi"), F("transfer_byte"), sck, 1, BENCH_OPS, bench_spi_byte);
+    bench(F("spi"), F("transfer_word"), sck, 2, BENCH_OPS, bench_spi_word);
+    bench(F("spi"), F("transfer_block"), sck, BENCH_SPI_BLOCK, BENCH_BLOCK_OPS, bench_spi_block);
+    bench(F("spi"), F("stream"), sck, BENCH_SPI_STREAM, BENCH_BLOCK_OPS, bench_spi_stream);
+  }
+  spi_disable();
+}
+
+static void bench_i2c()
+{
+  static const uint32_t speeds[] = {100000, 400000};
+  uint8_t i;
+
+  quikeval_I2C_connect();
+  if (i2c_poll(eeprom_address))
+  {
+    Serial.println(F("No acknowledge from the QuikEval EEPROM, is a demo board connected? I2C tests skipped."));
+    return;
+  }
+  for (i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+  {
+    LT_Wire.setClock(speeds[i]);          // LT_I2C and the engine share the TWI bit rate with Wire
+
+    bench(F("i2c"), F("read_byte"), speeds[i], 1, BENCH_OPS, bench_i2c_byte);
+    bench(F("i2c"), F("read_byte_data"), speeds[i], 1, BENCH_OPS, bench_i2c_byte_data);
+    bench(F("i2c"), F("read_word_data"), speeds[i], 2, BENCH_OPS, bench_i2c_word_data);
+    bench(F("i2c"), F("read_block_data"), speeds[i], BENCH_I2C_BLOCK, BENCH_BLOCK_OPS, bench_i2c_block);
+
+    bench(F("i2cbus"), F("read_byte"), speeds[i], 1, BENCH_OPS, bench_i2cbus_byte);
+    bench(F("i2cbus"), F("read_byte_data"), speeds[i], 1, BENCH_OPS, bench_i2cbus_byte_data);
+    bench(F("i2cbus"), F("read_word_data"), speeds[i], 2, BENCH_OPS, bench_i2cbus_word_data);
+    bench(F("i2cbus"), F("read_block_data"), speeds[i], BENCH_I2C_BLOCK, BENCH_BLOCK_OPS, bench_i2cbus_block);
+    bench(F("i2cbus"), F("read_block_data"), speeds[i], BENCH_I2C_LONG, BENCH_BLOCK_OPS, bench_i2cbus_long);
+
+    bench(F("smbus"), F("read_word"), speeds[i], 2, BENCH_OPS, bench_i2cbus_word_data);
+    bench(F("smbus"), F("read_word_pec_software"), speeds[i], 2, BENCH_OPS, bench_smbus_word_pec_software);
+    bench(F("smbus"), F("read_word_pec_engine"), speeds[i], 2, BENCH_OPS, bench_smbus_word_pec_engine);
+    bench(F("smbus"), F("read_block"), speeds[i], BENCH_I2C_BLOCK, BENCH_BLOCK_OPS, bench_i2cbus_block);
+    bench(F("smbus"), F("read_block_pec_software"), speeds[i], BENCH_I2C_BLOCK, BENCH_BLOCK_OPS,
+          bench_smbus_block_pec_software);
+    bench(F("smbus"), F("read_block_pec_engine"), speeds[i], BENCH_I2C_BLOCK, BENCH_BLOCK_OPS,
+          bench_smbus_block_pec_engine);
+  }
+  bench(F("smbus"), F("pec_add"), 0, BENCH_I2C_BLOCK, BENCH_OPS, bench_smbus_pec_add);
+}
+
+static void bench_convert()
+{
+  bench(F("convert"), F("code_to_voltage"), 0, 4, BENCH_OPS, bench_convert_float);
+  bench(F("convert"), F("convert"), 0, 4, BENCH_OPS, bench_convert_int);
+  bench(F("convert"), F("convert_array"), 0, BENCH_CONVERT_CODES * 4, BENCH_BLOCK_OPS, bench_convert_array);
+}
+
+void print_title()
+// Print the title block
+{
+  Serial.println(F(""));
+  Serial.println(F("*****************************************************************"));
+  Serial.println(F("* Speed Test                                                    *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Times LT_SPI, LT_I2C, LT_I2CBus, SMBus PEC, LT_Convert and    *"));
+  Serial.println(F("* serial output, one RESULT line per test for speed_test.py.    *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("* Set the baud rate to 115200 select the newline terminator.    *"));
+  Serial.println(F("*                                                               *"));
+  Serial.println(F("*****************************************************************"));
+}
 
 void setup()
+// Setup the program
 {
-	delay(1000);
-	SerialUSB.begin(115200);
-	while (!Serial); // wait for serial port to connect. Needed for native USB
+  uint8_t i;
+
+  Serial.begin(BENCH_BAUD);         // Initialize the serial port to the PC
+  pinMode(BENCH_SPI_CS, OUTPUT);
+  output_high(BENCH_SPI_CS);
+  quikeval_I2C_init();
+  smbus = new LT_SMBusNoPec();
+  i2cbus = smbus->i2cbus();
+  for (i = 0; i < BENCH_SERIAL_WORDS; i++)
+    serial_words[i] = 0x3030 + i * 0x0101;
+  for (i = 0; i < BENCH_CONVERT_CODES; i++)
+    convert_codes[i] = (int32_t)(0x9E3779B9UL * (i + 1));
+
+#if defined(ARDUINO_ARCH_AVR)
+  // Timer1 counts CPU cycles, free running and without interrupts
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TIMSK1 = 0;
+  cycle_overhead = bench_cycles(bench_nothing);
+#endif
+  print_title();
 }
 
 void loop()
 {
-	delay(1000);
-	SerialUSB.write("Hello!\n");
-	unsigned long StartTime;
-	unsigned long CurrentTime;
-	unsigned long ElapsedTime;
-	
-	const uint16_t baseStrRepetion = 48;
-	const uint32_t baseStrSize = 64;
-	const uint32_t newStrSize = ((baseStrSize - 1)*baseStrRepetion) + 1;
-	uint32_t numIterations = 4096;
-	
-	char baseStr[baseStrSize] = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ\n";
-	char newStr[newStrSize];
-	int j = 0, k = 0;
-	
-	// Populate newStr using baseStr
-	for(j = 0; j < (newStrSize - 1); ++j)
-	{
-		newStr[j] = baseStr[k];
-		k++;
-		if(k == (baseStrSize - 1))
-		{	
-			k = 0;
-			continue;
-		}
-	}
-	newStr[newStrSize - 1] = '\0';
-	
-	SerialUSB.write("Measuring time for new string:\n");	
-	delay(1000);
-	
-	StartTime = micros();
-	for(uint32_t i = 0; i< numIterations; ++i){
-		SerialUSB.write(newStr); 
-	}
-	CurrentTime = micros();
-	ElapsedTime = CurrentTime - StartTime;
-	SerialUSB.print(newStrSize * numIterations);
-	SerialUSB.print(" characters in microSeconds = ");
-	SerialUSB.println(ElapsedTime);
-	delay(1000);
-	
-	/* while(true)
-	{
-	}; */
-}
-
-void createRandomString(uint32_t size, char* newStr)
-{
-	
-}
-
-void createDefiniteString(char* newStr)
-{
-	
-}
\ No newline at end of file
+  Serial.println(F("\nSend any character to run the tests. (Press enter in Arduino Serial Monitor.)"));
+  read_int();
+
+  results = 0;
+  Serial.print(F("BOARD,"));
+  Serial.print(F(BENCH_BOARD));
+  Serial.print(',');
+  Serial.println(F_CPU);
+  bench_spi();
+  bench_i2c();
+  bench_convert();
+  bench_serial(F("print_dec"), bench_serial_print_dec);
+  bench_serial(F("print_hex"), bench_serial_print_hex);
+  bench_serial(F("write_binary"), bench_serial_write);
+  Serial.print(F("DONE,"));
+  Serial.println(results);
+}
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""
+Speed Test collector
+
+Runs the Speed_Test sketch, or reads a saved copy of what it printed, and
+writes the RESULT lines to a CSV or JSON file with the time per operation and
+the throughput worked out. Two such files, from before and after a driver
+change or from two boards, can then be compared. The line format is described
+at the top of Speed_Test.ino; any other line is skipped.
+
+Usage:
+  python3 speed_test.py --port /dev/ttyACM0 -o before.csv    (needs pyserial)
+  python3 speed_test.py capture.txt --label uno -o after.json
+  python3 speed_test.py --compare before.csv after.csv [--fail-above 10]
+
+Options:
+  -o FILE           write the results to FILE, CSV or JSON by its extension,
+                    instead of printing a table
+  --label NAME      name for the run, stored with every result (default: the
+                    board name from the BOARD line)
+  --port DEV        start the tests on a serial port instead of reading a file
+  --baud N          serial baud rate, default 115200
+  --timeout S       give up on the serial port after S seconds, default 120
+  --compare A B     compare two result files, B against A
+  --fail-above PCT  with --compare, exit with status 1 if any test is more
+                    than PCT percent slower in B
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+"""
+
+import argparse
+import csv
+import json
+import sys
+import time
+
+FIELDS = ['label', 'board', 'f_cpu', 'group', 'test', 'param', 'bytes', 'ops', 'total_us', 'cycles', 'status',
+          'us_per_op', 'kbytes_per_s']
+
+
+class Collector(object):
+    """Turns the lines printed by Speed_Test into result dictionaries"""
+
+    def __init__(self, label=None):
+        self.label = label
+        self.board = ''
+        self.f_cpu = 0
+        self.results = []
+        self.done = False
+
+    def line(self, text):
+        fields = text.strip().split(',')
+        if fields[0] == 'BOARD' and len(fields) == 3:
+            self.board = fields[1]
+            self.f_cpu = int(fields[2])
+            self.results = []
+            self.done = False
+        elif fields[0] == 'RESULT' and len(fields) == 9:
+            self.result(fields[1:])
+        elif fields[0] == 'DONE' and len(fields) == 2:
+            if int(fields[1]) != len(self.results):
+                sys.stderr.write('expected %s results, got %d\n' % (fields[1], len(self.results)))
+            self.done = True
+
+    def result(self, fields):
+        group, test, param, nbytes, ops, total_us, cycles, status = fields
+        try:
+            r = {'label': self.label or self.board, 'board': self.board, 'f_cpu': self.f_cpu,
+                 'group': group, 'test': test, 'param': int(param), 'bytes': int(nbytes), 'ops': int(ops),
+                 'total_us': int(total_us), 'cycles': int(cycles) if cycles else None, 'status': status}
+        except ValueError:
+            return                      # A line cut short by a reset
+        r['us_per_op'] = round(float(r['total_us']) / r['ops'], 3) if r['ops'] else 0.0
+        r['kbytes_per_s'] = round(1000.0 * r['bytes'] * r['ops'] / r['total_us'], 3) if r['total_us'] else 0.0
+        self.results.append(r)
+
+
+def key(r):
+    return (r['group'], r['test'], r['param'], r['bytes'])
+
+
+def collect_file(path, collector):
+    with open(path, 'rb') as f:
+        for raw in f:
+            collector.line(raw.decode('ascii', 'replace'))
+
+
+def collect_port(args, collector):
+    import serial
+    port = serial.Serial(args.port, args.baud, timeout=1)
+    deadline = time.time() + args.timeout
+    started = False
+    while not collector.done:
+        if time.time() > deadline:
+            sys.stderr.write('timed out waiting for the tests\n')
+            break
+        raw = port.readline()
+        if not raw:
+            if not started:
+                port.write(b'\n')       # The prompt may have gone by before the port was opened
+                started = True
+            continue
+        text = raw.decode('ascii', 'replace')
+        if 'Send any character' in text:
+            port.write(b'\n')
+            started = True
+        collector.line(text)
+    port.close()
+
+
+def write_results(path, results):
+    if path.endswith('.json'):
+        with open(path, 'w') as f:
+            json.dump(results, f, indent=1)
+    else:
+        with open(path, 'w', newline='') as f:
+            w = csv.DictWriter(f, FIELDS)
+            w.writeheader()
+            for r in results:
+                w.writerow(dict(r, cycles='' if r['cycles'] is None else r['cycles']))
+
+
+def read_results(path):
+    if path.endswith('.json'):
+        with open(path) as f:
+            return json.load(f)
+    results = []
+    with open(path, newline='') as f:
+        for row in csv.DictReader(f):
+            for name in ('f_cpu', 'param', 'bytes', 'ops', 'total_us'):
+                row[name] = int(row[name])
+            row['cycles'] = int(row['cycles']) if row['cycles'] else None
+            row['us_per_op'] = float(row['us_per_op'])
+            row['kbytes_per_s'] = float(row['kbytes_per_s'])
+            results.append(row)
+    return results
+
+
+def print_table(results):
+    print('%-7s %-24s %9s %5s %12s %9s %11s %s' %
+          ('group', 'test', 'param', 'bytes', 'us/op', 'cycles', 'kbytes/s', 'status'))
+    for r in results:
+        print('%-7s %-24s %9d %5d %12.2f %9s %11.2f %s' %
+              (r['group'], r['test'], r['param'], r['bytes'], r['us_per_op'],
+               '' if r['cycles'] is None else r['cycles'], r['kbytes_per_s'], r['status']))
+
+
+def compare(path_a, path_b, fail_above):
+    a = read_results(path_a)
+    b = dict((key(r), r) for r in read_results(path_b))
+    slower = 0
+    print('%s: %s, %s: %s' % (path_a, a[0]['label'] if a else '', path_b,
+                              list(b.values())[0]['label'] if b else ''))
+    print('%-7s %-24s %9s %5s %12s %12s %8s' % ('group', 'test', 'param', 'bytes', 'A us/op', 'B us/op', 'change'))
+    for ra in a:
+        rb = b.pop(key(ra), None)
+        if rb is None:
+            print('%-7s %-24s %9d %5d %12.2f %12s' % (ra['group'], ra['test'], ra['param'], ra['bytes'],
+                                                     ra['us_per_op'], 'missing'))
+            continue
+        change = 100.0 * (rb['us_per_op'] - ra['us_per_op']) / ra['us_per_op'] if ra['us_per_op'] else 0.0
+        mark = ''
+        if fail_above is not None and change > fail_above:
+            mark = ' SLOWER'
+            slower += 1
+        print('%-7s %-24s %9d %5d %12.2f %12.2f %+7.1f%%%s' % (ra['group'], ra['test'], ra['param'], ra['bytes'],
+                                                               ra['us_per_op'], rb['us_per_op'], change, mark))
+    for rb in b.values():
+        print('%-7s %-24s %9d %5d %12s %12.2f' % (rb['group'], rb['test'], rb['param'], rb['bytes'],
+                                                 'missing', rb['us_per_op']))
+    return 1 if slower else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Collect and compare Speed_Test results')
+    parser.add_argument('capture', nargs='?', help='text saved from the serial port')
+    parser.add_argument('-o', '--output', help='write the results to a .csv or .json file')
+    parser.add_argument('--label', help='name for the run, default the board name')
+    parser.add_argument('--port', help='serial port to run the tests on instead of a file')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--timeout', type=float, default=120)
+    parser.add_argument('--compare', nargs=2, metavar=('A', 'B'), help='compare two result files')
+    parser.add_argument('--fail-above', type=float, help='with --compare, percent slower that fails')
+    args = parser.parse_args()
+
+    if args.compare:
+        sys.exit(compare(args.compare[0], args.compare[1], args.fail_above))
+    if not args.capture and not args.port:
+        parser.error('give a capture file, --port or --compare')
+
+    collector = Collector(args.label)
+    if args.port:
+        collect_port(args, collector)
+    else:
+        collect_file(args.capture, collector)
+    if not collector.results:
+        sys.stderr.write('no results found\n')
+        sys.exit(1)
+    if args.output:
+        write_results(args.output, collector.results)
+        sys.stderr.write('%d results written to %s\n' % (len(collector.results), args.output))
+    else:
+        print_table(collector.results)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,453 @@
+/*!
+DC590_binary: Binary framing mode for the DC590B command interpreter.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! @ingroup Linduino
+//! @{
+//! @defgroup DC590 DC590: DC590B command interpreter extensions.
+//! @}
+
+/*! @file
+    @ingroup DC590
+    Library for DC590_binary: Binary framing mode for the DC590B command interpreter.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <SPI.h>
+#include "Linduino.h"
+#include "LT_SPI.h"
+#include "LT_I2C.h"
+#include "DC590_binary.h"
+#include "DC590_recording.h"
+
+#define BIN_NO_BYTE     -1        // bin_read_byte() timed out
+#define BIN_RESET       0x80      // QuikEval's reset byte
+#define BIN_ASCII_BAUD  115200    // Rate of the ASCII protocol
+#define BIN_CHUNK       32        // SPI_READ bytes clocked per Serial.write(), half the AVR transmit buffer
+
+// Request payload, also the I2C receive buffer and the SPI_READ chunk buffer
+static uint8_t bin_payload[DC590_BIN_MAX_PAYLOAD];
+static uint16_t bin_crc;
+
+// Adds one byte to a CRC-16/CCITT
+static uint16_t bin_crc_add(uint16_t crc, uint8_t data)
+{
+  uint8_t i;
+
+  crc ^= (uint16_t)data << 8;
+  for (i = 0; i < 8; i++)
+    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  return crc;
+}
+
+// Waits up to DC590_BIN_BYTE_TIMEOUT ms for the next byte of a frame
+static int16_t bin_read_byte()
+{
+  uint32_t start = millis();
+
+  while (Serial.available() <= 0)
+    if (millis() - start > DC590_BIN_BYTE_TIMEOUT)
+      return BIN_NO_BYTE;
+  return Serial.read();
+}
+
+static void bin_send(uint8_t data)
+{
+  Serial.write(data);
+  bin_crc = bin_crc_add(bin_crc, data);
+}
+
+// Starts a reply. length counts the status byte and the data sent after it.
+static void bin_reply_begin(uint8_t command, uint16_t length, uint8_t status)
+{
+  Serial.write(DC590_BIN_SYNC);
+  bin_crc = 0xFFFF;
+  bin_send(command);
+  bin_send((uint8_t)length);
+  bin_send((uint8_t)(length >> 8));
+  bin_send(status);
+}
+
+static void bin_reply_data(const uint8_t *data, uint16_t length)
+{
+  while (length--)
+    bin_send(*data++);
+}
+
+static void bin_reply_end()
+{
+  uint16_t crc = bin_crc;
+
+  Serial.write((uint8_t)crc);
+  Serial.write((uint8_t)(crc >> 8));
+}
+
+// A reply with no data
+static void bin_reply(uint8_t command, uint8_t status)
+{
+  bin_reply_begin(command, 1, status);
+  bin_reply_end();
+}
+
+static uint16_t bin_get16(const uint8_t *p)
+{
+  return p[0] | ((uint16_t)p[1] << 8);
+}
+
+static void bin_set_pin(uint8_t pin, uint8_t level)
+{
+  if (level == 0)
+    output_low(pin);
+  else if (level == 1)
+    output_high(pin);
+}
+
+// CONFIG request
+static uint8_t bin_config(const uint8_t *p, uint8_t *serial_mode)
+{
+  const uint8_t modes[4] = {SPI_MODE0, SPI_MODE1, SPI_MODE2, SPI_MODE3};
+  const uint8_t dividers[7] = {SPI_CLOCK_DIV2, SPI_CLOCK_DIV4, SPI_CLOCK_DIV8, SPI_CLOCK_DIV16,
+                               SPI_CLOCK_DIV32, SPI_CLOCK_DIV64, SPI_CLOCK_DIV128
+                              };
+  uint8_t divider = 0;
+
+  if (p[0] > DC590_BIN_BUS_I2C_AUXILIARY && p[0] != 0xFF)
+    return DC590_BIN_STATUS_ARGUMENT;
+  if (p[1] > 3 && p[1] != 0xFF)
+    return DC590_BIN_STATUS_ARGUMENT;
+  if (p[2] != 0)
+  {
+    while (divider < 7 && (2 << divider) != p[2])
+      divider++;
+    if (divider == 7)
+      return DC590_BIN_STATUS_ARGUMENT;
+  }
+
+  if (p[0] == DC590_BIN_BUS_I2C)
+    quikeval_I2C_connect();
+  else if (p[0] != 0xFF)
+    quikeval_SPI_connect();       // The auxiliary I2C port needs no switching, as for 'MX'
+  if (p[0] != 0xFF)
+    *serial_mode = p[0];
+  if (p[1] != 0xFF)
+    SPI.setDataMode(modes[p[1]]);
+  if (p[2] != 0)
+    SPI.setClockDivider(dividers[divider]);
+  return DC590_BIN_STATUS_OK;
+}
+
+// WAIT_MISO request
+static uint8_t bin_wait_miso(uint8_t level, uint16_t timeout)
+{
+  uint32_t start = millis();
+
+  while (input(MISO) != level)
+    if (millis() - start >= timeout)
+      return DC590_BIN_STATUS_TIMEOUT;
+  return DC590_BIN_STATUS_OK;
+}
+
+// SPI request. The received bytes replace the sent ones in the payload.
+static void bin_spi(uint8_t *p, uint16_t length)
+{
+  uint8_t flags = p[0];
+
+  if (!(flags & DC590_BIN_SPI_NO_CS))
+    output_low(QUIKEVAL_CS);
+  spi_stream(p + 1, p + 1, length - 1, 0);
+  if (!(flags & (DC590_BIN_SPI_NO_CS | DC590_BIN_SPI_HOLD_CS)))
+    output_high(QUIKEVAL_CS);
+  bin_reply_begin(DC590_BIN_SPI, length, DC590_BIN_STATUS_OK);
+  bin_reply_data(p + 1, length - 1);
+  bin_reply_end();
+}
+
+// SPI_READ request. Each chunk is clocked while the previous one drains from the
+// serial transmit buffer.
+static void bin_spi_read(uint8_t flags, uint16_t count)
+{
+  uint8_t chunk;
+  uint8_t i;
+
+  bin_reply_begin(DC590_BIN_SPI_READ, count + 1, DC590_BIN_STATUS_OK);
+  if (!(flags & DC590_BIN_SPI_NO_CS))
+    output_low(QUIKEVAL_CS);
+  while (count)
+  {
+    chunk = (count > BIN_CHUNK) ? BIN_CHUNK : count;
+    spi_stream(0, bin_payload, chunk, (flags & DC590_BIN_SPI_FILL_ONES) ? LT_SPI_FILL_ONES : 0);
+    for (i = 0; i < chunk; i++)
+      bin_crc = bin_crc_add(bin_crc, bin_payload[i]);
+    Serial.write(bin_payload, chunk);
+    count -= chunk;
+  }
+  if (!(flags & (DC590_BIN_SPI_NO_CS | DC590_BIN_SPI_HOLD_CS)))
+    output_high(QUIKEVAL_CS);
+  bin_reply_end();
+}
+
+// I2C request. The engine sends all of tx before it stores the first rx byte,
+// so the bytes read can go to the start of the payload.
+static void bin_i2c(const uint8_t *p, uint16_t length)
+{
+  i2c_transfer x;
+
+  x.address = p[0];
+  x.command_len = 0;
+  x.tx = p + 4;
+  x.tx_len = length - 4;
+  x.rx = bin_payload;
+  x.rx_len = bin_get16(p + 2);
+  x.flags = p[1];
+  x.callback = 0;
+  x.arg = 0;
+  if (i2c_submit(&x) || i2c_wait(&x))
+  {
+    bin_reply(DC590_BIN_I2C, DC590_BIN_STATUS_NACK);
+    return;
+  }
+  bin_reply_begin(DC590_BIN_I2C, x.rx_len + 1, DC590_BIN_STATUS_OK);
+  bin_reply_data(bin_payload, x.rx_len);
+  bin_reply_end();
+}
+
+// RECORD request
+static void bin_record(const uint8_t *p, uint16_t length, uint8_t serial_mode)
+{
+  uint16_t size;
+  uint16_t results;
+
+  if (dc590_rec_compile(p, length))
+  {
+    bin_reply(DC590_BIN_RECORD, DC590_BIN_STATUS_ARGUMENT);
+    return;
+  }
+  size = dc590_rec_size();
+  results = dc590_rec_results(serial_mode);
+  bin_reply_begin(DC590_BIN_RECORD, 5, DC590_BIN_STATUS_OK);
+  bin_send((uint8_t)size);
+  bin_send((uint8_t)(size >> 8));
+  bin_send((uint8_t)results);
+  bin_send((uint8_t)(results >> 8));
+  bin_reply_end();
+}
+
+// PLAY request. The passes run back to back, each byte read is sent as it comes.
+static void bin_play(uint16_t passes, uint8_t serial_mode)
+{
+  uint32_t total = (uint32_t)passes * dc590_rec_results(serial_mode);
+
+  if (!dc590_rec_ready() || total > 0xFFFE)
+  {
+    bin_reply(DC590_BIN_PLAY, DC590_BIN_STATUS_ARGUMENT);
+    return;
+  }
+  bin_reply_begin(DC590_BIN_PLAY, total + 1, DC590_BIN_STATUS_OK);
+  while (passes--)
+    dc590_rec_play(serial_mode, bin_send);
+  bin_reply_end();
+}
+
+// Reads the rest of a frame after the sync byte into bin_payload
+// @return DC590_BIN_STATUS_OK, or the status of the reply that drops it
+static uint8_t bin_read_frame(uint8_t *command, uint16_t *length)
+{
+  uint8_t header[3];
+  uint16_t crc = 0xFFFF;
+  uint16_t i;
+  int16_t c;
+
+  for (i = 0; i < 3; i++)
+  {
+    if ((c = bin_read_byte()) == BIN_NO_BYTE)
+      return DC590_BIN_STATUS_TIMEOUT;
+    header[i] = c;
+    crc = bin_crc_add(crc, c);
+    if (i == 0)
+      *command = c;
+  }
+  *length = bin_get16(header + 1);
+  for (i = 0; i < *length + 2; i++)
+  {
+    if ((c = bin_read_byte()) == BIN_NO_BYTE)
+      return DC590_BIN_STATUS_TIMEOUT;
+    if (i < *length)
+    {
+      crc = bin_crc_add(crc, c);
+      if (i < DC590_BIN_MAX_PAYLOAD)
+        bin_payload[i] = c;
+    }
+    else
+      crc ^= (uint16_t)c << ((i - *length) * 8);   // 0 once both CRC bytes match
+  }
+  if (*length > DC590_BIN_MAX_PAYLOAD)
+    return DC590_BIN_STATUS_LENGTH;               // Read to the end, so the next frame is found
+  if (crc != 0)
+    return DC590_BIN_STATUS_CRC;
+  return DC590_BIN_STATUS_OK;
+}
+
+uint8_t dc590_binary_mode(uint8_t serial_mode)
+{
+  const uint8_t info[3] = {DC590_BIN_VERSION, (uint8_t)DC590_BIN_MAX_PAYLOAD, (uint8_t)(DC590_BIN_MAX_PAYLOAD >> 8)};
+  uint8_t baud_changed = 0;
+  uint8_t command;
+  uint16_t length;
+  uint8_t status;
+  uint32_t baud;
+
+  bin_reply_begin(DC590_BIN_INFO, sizeof(info) + 1, DC590_BIN_STATUS_OK);
+  bin_reply_data(info, sizeof(info));
+  bin_reply_end();
+
+  while (1)
+  {
+    while (Serial.available() <= 0);
+    if (Serial.peek() == BIN_RESET)
+      break;                      // Left in the serial buffer for the sketch's reset command
+    if (Serial.read() != DC590_BIN_SYNC)
+      continue;
+
+    command = 0xFF;
+    status = bin_read_frame(&command, &length);
+    if (status != DC590_BIN_STATUS_OK)
+    {
+      bin_reply(command, status);
+      continue;
+    }
+
+    switch (command)
+    {
+      case DC590_BIN_INFO:
+        if (length != 0)
+          break;
+        bin_reply_begin(command, sizeof(info) + 1, DC590_BIN_STATUS_OK);
+        bin_reply_data(info, sizeof(info));
+        bin_reply_end();
+        continue;
+      case DC590_BIN_EXIT:
+        if (length != 0)
+          break;
+        bin_reply(command, DC590_BIN_STATUS_OK);
+        Serial.flush();
+        if (baud_changed)
+          Serial.begin(BIN_ASCII_BAUD);
+        return serial_mode;
+      case DC590_BIN_BAUD:
+        if (length != 4)
+          break;
+        baud = bin_get16(bin_payload) | ((uint32_t)bin_get16(bin_payload + 2) << 16);
+        if (baud == 0)
+        {
+          bin_reply(command, DC590_BIN_STATUS_ARGUMENT);
+          continue;
+        }
+        bin_reply(command, DC590_BIN_STATUS_OK);
+        Serial.flush();
+        Serial.begin(baud);
+        baud_changed = 1;
+        continue;
+      case DC590_BIN_CONFIG:
+        if (length != 3)
+          break;
+        bin_reply(command, bin_config(bin_payload, &serial_mode));
+        continue;
+      case DC590_BIN_PINS:
+        if (length != 2)
+          break;
+        bin_set_pin(QUIKEVAL_CS, bin_payload[0]);
+        bin_set_pin(QUIKEVAL_GPIO, bin_payload[1]);
+        bin_reply(command, DC590_BIN_STATUS_OK);
+        continue;
+      case DC590_BIN_DELAY:
+        if (length != 2)
+          break;
+        delay(bin_get16(bin_payload));
+        bin_reply(command, DC590_BIN_STATUS_OK);
+        continue;
+      case DC590_BIN_WAIT_MISO:
+        if (length != 3)
+          break;
+        bin_reply(command, bin_wait_miso(bin_payload[0], bin_get16(bin_payload + 1)));
+        continue;
+      case DC590_BIN_SPI:
+        if (length < 1)
+          break;
+        bin_spi(bin_payload, length);
+        continue;
+      case DC590_BIN_SPI_READ:
+        if (length != 3)
+          break;
+        if (bin_get16(bin_payload + 1) == 0xFFFF)
+        {
+          bin_reply(command, DC590_BIN_STATUS_ARGUMENT);   // The reply length would not fit
+          continue;
+        }
+        bin_spi_read(bin_payload[0], bin_get16(bin_payload + 1));
+        continue;
+      case DC590_BIN_I2C:
+        if (length < 4)
+          break;
+        if (bin_get16(bin_payload + 2) > DC590_BIN_MAX_PAYLOAD || (bin_payload[1] & ~(I2C_XFER_PEC | I2C_XFER_BLOCK)))
+        {
+          bin_reply(command, DC590_BIN_STATUS_ARGUMENT);
+          continue;
+        }
+        bin_i2c(bin_payload, length);
+        continue;
+      case DC590_BIN_RECORD:
+        bin_record(bin_payload, length, serial_mode);
+        continue;
+      case DC590_BIN_PLAY:
+        if (length != 2)
+          break;
+        bin_play(bin_get16(bin_payload), serial_mode);
+        continue;
+      default:
+        bin_reply(command, DC590_BIN_STATUS_COMMAND);
+        continue;
+    }
+    bin_reply(command, DC590_BIN_STATUS_LENGTH);   // Only a bad length gets here
+  }
+
+  if (baud_changed)
+  {
+    Serial.flush();
+    Serial.begin(BIN_ASCII_BAUD);
+  }
+  return serial_mode;
+}
@@ -0,0 +1,177 @@
+/*!
+DC590_binary: Binary framing mode for the DC590B command interpreter.
+
+@verbatim
+  The DC590B sketches speak QuikEval's ASCII protocol, where every SPI or I2C
+  byte is a command letter and two hex digits each way. The ASCII command 'B'
+  switches them to this binary mode. Each bulk SPI or I2C transfer is then one
+  length-prefixed frame with a CRC. The Linduino answers 'B' with an INFO
+  reply, so a host can tell whether the firmware has binary mode. Firmware
+  without it ignores the 'B'. QuikEval never sends 'B', so it keeps the ASCII
+  protocol.
+
+  Frame, both directions, lengths little endian:
+
+    0xA5                  sync
+    command               DC590_BIN_* command. A reply repeats the request's command.
+    length                uint16, bytes of payload
+    payload
+    crc                   uint16, CRC-16/CCITT (polynomial 0x1021, start 0xFFFF) of
+                          command, length and payload, as LT_Trace's dump frame
+
+  Every request gets exactly one reply. The first reply payload byte is a
+  DC590_BIN_STATUS_* value and any data follows it. A request with a bad CRC or
+  a bad length or argument is not run. Its reply has only the status byte.
+
+  Requests (payload -> reply data):
+
+    INFO      0x00  -                                 -> version, max payload (uint16)
+    EXIT      0x01  -                                 -> -, then back to ASCII commands
+    BAUD      0x02  baud (uint32)                     -> -, sent at the old rate, then
+                                                         the new rate is used. EXIT goes
+                                                         back to 115200.
+    CONFIG    0x03  bus, spi mode, spi divider        -> -
+                    bus: 0 SPI, 1 I2C, 2 auxiliary I2C, as the ASCII 'M' command.
+                    spi mode 0 to 3, spi divider 2 to 128. 0xFF and 0 keep the setting.
+    PINS      0x04  cs, gpio                          -> -
+                    0 low, 1 high, 0xFF unchanged
+    DELAY     0x05  ms (uint16)                       -> -
+    WAIT_MISO 0x06  level, timeout ms (uint16)        -> -, or DC590_BIN_STATUS_TIMEOUT
+    SPI       0x10  flags, tx bytes                   -> rx bytes, as many as tx
+    SPI_READ  0x11  flags, count (uint16)             -> count bytes, streamed while
+                                                         they are clocked, so count
+                                                         may exceed the max payload
+    I2C       0x20  address, flags, rx count (uint16), tx bytes
+                                                      -> rx bytes. With I2C_XFER_BLOCK,
+                                                         the bytes counted by the device.
+    RECORD    0x30  recording text                    -> code size (uint16), bytes read
+                                                         per pass (uint16). Compiles the
+                                                         text as 't' ... 'u' would, see
+                                                         DC590_recording.h.
+                                                         DC590_BIN_STATUS_ARGUMENT if it
+                                                         cannot be compiled.
+    PLAY      0x31  passes (uint16)                   -> the bytes read by every pass,
+                                                         streamed as they are read
+                                                         Sends that the I2C device NACKs
+                                                         are not reported, and Z sends
+                                                         nothing.
+
+  SPI flags: DC590_BIN_SPI_HOLD_CS leaves QUIKEVAL_CS low at the end, so the
+  next SPI request continues the same transaction. DC590_BIN_SPI_NO_CS does
+  not touch QUIKEVAL_CS. DC590_BIN_SPI_FILL_ONES makes SPI_READ send 0xFF.
+
+  I2C flags are those of the LT_I2C transaction engine (I2C_XFER_PEC,
+  I2C_XFER_BLOCK). The write phase, repeated START and read phase are one
+  engine transaction.
+
+  If a frame stops for longer than DC590_BIN_BYTE_TIMEOUT ms, it is dropped
+  with DC590_BIN_STATUS_TIMEOUT. Bytes outside a frame are skipped. The
+  QuikEval reset byte 0x80 outside a frame leaves binary mode and is left for
+  the sketch's reset command, so QuikEval finds the ASCII protocol even if a
+  host left the Linduino in binary mode.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup DC590
+    Library Header File for DC590_binary: Binary framing mode for the DC590B command interpreter.
+*/
+
+#ifndef DC590_BINARY_H
+#define DC590_BINARY_H
+
+#include <stdint.h>
+
+#define DC590_BIN_SYNC          0xA5  //!< First byte of every frame
+#define DC590_BIN_VERSION       1     //!< Protocol version reported by INFO
+
+//! Largest request payload, and largest reply payload apart from SPI_READ
+#ifndef DC590_BIN_MAX_PAYLOAD
+#define DC590_BIN_MAX_PAYLOAD   256
+#endif
+
+//! ms allowed between two bytes of a frame
+#define DC590_BIN_BYTE_TIMEOUT  50
+
+//! @name COMMANDS
+//! @{
+#define DC590_BIN_INFO          0x00
+#define DC590_BIN_EXIT          0x01
+#define DC590_BIN_BAUD          0x02
+#define DC590_BIN_CONFIG        0x03
+#define DC590_BIN_PINS          0x04
+#define DC590_BIN_DELAY         0x05
+#define DC590_BIN_WAIT_MISO     0x06
+#define DC590_BIN_SPI           0x10
+#define DC590_BIN_SPI_READ      0x11
+#define DC590_BIN_I2C           0x20
+#define DC590_BIN_RECORD        0x30
+#define DC590_BIN_PLAY          0x31
+//! @}
+
+//! @name REPLY STATUS
+//! @{
+#define DC590_BIN_STATUS_OK          0x00
+#define DC590_BIN_STATUS_NACK        0x01  //!< The I2C transaction failed
+#define DC590_BIN_STATUS_TIMEOUT     0x02  //!< MISO did not reach the level, or the frame stopped
+#define DC590_BIN_STATUS_CRC         0x80  //!< Request CRC was bad
+#define DC590_BIN_STATUS_COMMAND     0x81  //!< Unknown command
+#define DC590_BIN_STATUS_LENGTH      0x82  //!< Payload too long or too short for the command
+#define DC590_BIN_STATUS_ARGUMENT    0x83  //!< An argument is out of range
+//! @}
+
+//! @name SPI FLAGS
+//! @{
+#define DC590_BIN_SPI_HOLD_CS        0x01  //!< Leave QUIKEVAL_CS low after the transfer
+#define DC590_BIN_SPI_NO_CS          0x02  //!< Do not touch QUIKEVAL_CS
+#define DC590_BIN_SPI_FILL_ONES      0x04  //!< SPI_READ sends 0xFF instead of 0x00
+//! @}
+
+//! @name SERIAL MODES
+//! The DC590B sketches' serial_mode values
+//! @{
+#define DC590_BIN_BUS_SPI            0
+#define DC590_BIN_BUS_I2C            1
+#define DC590_BIN_BUS_I2C_AUXILIARY  2
+//! @}
+
+//! Runs binary mode until an EXIT request or a reset byte. Replies to the 'B'
+//! command with an INFO reply first.
+//! @return the serial mode when binary mode ended, for the sketch's serial_mode
+uint8_t dc590_binary_mode(uint8_t serial_mode   //!< The sketch's serial_mode on entry
+                         );
+
+#endif  // DC590_BINARY_H
@@ -0,0 +1,349 @@
+/*!
+DC590_recording: Compiled recording loops for the DC590B command interpreter.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup DC590
+    Library for DC590_recording: Compiled recording loops for the DC590B command interpreter.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "Linduino.h"
+#include "LT_SPI.h"
+#include "LT_I2C.h"
+#include "DC590_binary.h"
+#include "DC590_recording.h"
+
+// Each opcode is the command letter, followed by its operand in binary:
+// one byte for S and T, two bytes MSB first for D. The code ends with REC_END.
+#define REC_END           0x00
+#define REC_MISO_TIMEOUT  1000      // ms, as the sketch's MISO_TIMEOUT
+
+#define REC_EMPTY         0
+#define REC_COMPILING     1
+#define REC_READY         2
+#define REC_FAILED        3
+
+static uint8_t rec_code[DC590_REC_SIZE];
+static uint16_t rec_length = 0;     // Bytes of code
+static uint8_t rec_state = REC_EMPTY;
+static uint8_t rec_digits = 0;      // Hex digits of the last operand still to come
+
+static const char rec_hex[16] =
+{
+  '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+// Appends an opcode and room for its operand, keeping a byte for REC_END
+static void rec_op(char op, uint8_t operand_bytes)
+{
+  uint8_t i;
+
+  if (rec_length + 1 + operand_bytes + 1 > DC590_REC_SIZE)
+  {
+    rec_state = REC_FAILED;
+    return;
+  }
+  rec_code[rec_length++] = op;
+  for (i = 0; i < operand_bytes; i++)
+    rec_code[rec_length++] = 0;
+  rec_digits = operand_bytes * 2;
+}
+
+// Shifts a hex digit into the operand of the last opcode
+static void rec_digit(char c)
+{
+  uint8_t nibble;
+  uint8_t *operand;
+
+  if (c >= '0' && c <= '9')
+    nibble = c - '0';
+  else if (c >= 'A' && c <= 'F')
+    nibble = c - 'A' + 10;
+  else if (c >= 'a' && c <= 'f')
+    nibble = c - 'a' + 10;
+  else
+  {
+    rec_state = REC_FAILED;       // strtol() in read_hex() would stop here, leave it to the text
+    return;
+  }
+  operand = &rec_code[rec_length - (rec_digits + 1) / 2];
+  *operand = (*operand << 4) | nibble;
+  rec_digits--;
+}
+
+static void rec_emit(uint8_t data, dc590_rec_output output)
+{
+  if (output)
+  {
+    output(data);
+    return;
+  }
+  Serial.print(rec_hex[data >> 4]);
+  Serial.print(rec_hex[data & 0x0F]);
+}
+
+static void rec_wait_miso(uint8_t level)
+{
+  uint32_t start = millis();
+
+  while (input(MISO) != level && millis() - start <= REC_MISO_TIMEOUT);
+}
+
+void dc590_rec_begin()
+{
+  rec_length = 0;
+  rec_digits = 0;
+  rec_state = REC_COMPILING;
+}
+
+void dc590_rec_add(char c)
+{
+  if (rec_state != REC_COMPILING)
+    return;
+  if (rec_digits)
+  {
+    rec_digit(c);
+    return;
+  }
+  switch (c)
+  {
+    case 'x':
+    case 'X':
+    case 'g':
+    case 'G':
+    case 'R':
+    case 'r':
+    case 'Q':
+    case 's':
+    case 'p':
+    case 'H':
+    case 'L':
+    case 'Z':
+      rec_op(c, 0);
+      break;
+    case 'S':
+    case 'T':
+      rec_op(c, 1);
+      break;
+    case 'D':
+      rec_op(c, 2);
+      break;
+    case 't':
+    case 'u':
+    case 'v':
+    case 'w':
+    case 'W':
+      break;                      // Loop commands are not played back
+    case 'B':
+    case 'i':
+    case 'I':
+    case 'j':
+    case 'k':
+    case 'K':
+    case 'M':
+    case 'P':
+    case (char)0x80:
+      rec_state = REC_FAILED;     // Played from the text by the sketch
+      break;
+    default:
+      break;                      // Not a command, the sketch ignores it too
+  }
+}
+
+int8_t dc590_rec_end()
+{
+  if (rec_state != REC_COMPILING || rec_digits)
+  {
+    rec_state = REC_FAILED;
+    return 1;
+  }
+  rec_code[rec_length++] = REC_END;
+  rec_state = REC_READY;
+  return 0;
+}
+
+int8_t dc590_rec_compile(const uint8_t *text, uint16_t length)
+{
+  dc590_rec_begin();
+  while (length--)
+    dc590_rec_add(*text++);
+  return dc590_rec_end();
+}
+
+uint8_t dc590_rec_ready()
+{
+  return rec_state == REC_READY;
+}
+
+uint16_t dc590_rec_size()
+{
+  return (rec_state == REC_READY) ? rec_length : 0;
+}
+
+uint16_t dc590_rec_results(uint8_t serial_mode)
+{
+  uint8_t spi = (serial_mode == DC590_BIN_BUS_SPI);
+  uint16_t results = 0;
+  uint16_t pc;
+
+  if (rec_state != REC_READY)
+    return 0;
+  for (pc = 0; rec_code[pc] != REC_END; pc++)
+  {
+    switch (rec_code[pc])
+    {
+      case 'T':
+        results += spi;
+        pc++;
+        break;
+      case 'R':
+      case 'r':
+        results++;
+        break;
+      case 'Q':
+        results += !spi;
+        break;
+      case 'S':
+        pc++;
+        break;
+      case 'D':
+        pc += 2;
+        break;
+    }
+  }
+  return results;
+}
+
+void dc590_rec_print()
+{
+  uint16_t pc;
+
+  if (rec_state != REC_READY)
+    return;
+  for (pc = 0; rec_code[pc] != REC_END; pc++)
+  {
+    Serial.print((char)rec_code[pc]);
+    switch (rec_code[pc])
+    {
+      case 'D':
+        rec_emit(rec_code[++pc], 0);
+        rec_emit(rec_code[++pc], 0);
+        break;
+      case 'S':
+      case 'T':
+        rec_emit(rec_code[++pc], 0);
+        break;
+    }
+  }
+}
+
+void dc590_rec_play(uint8_t serial_mode, dc590_rec_output output)
+{
+  const uint8_t *pc = rec_code;
+  uint8_t spi = (serial_mode == DC590_BIN_BUS_SPI);
+
+  if (rec_state != REC_READY)
+    return;
+  while (1)
+  {
+    switch (*pc++)
+    {
+      case REC_END:
+        return;
+      case 'x':
+        output_low(QUIKEVAL_CS);
+        break;
+      case 'X':
+        output_high(QUIKEVAL_CS);
+        break;
+      case 'g':
+        output_low(QUIKEVAL_GPIO);
+        break;
+      case 'G':
+        output_high(QUIKEVAL_GPIO);
+        break;
+      case 'S':
+        if (spi)
+          spi_write(*pc);
+        else if (i2c_write(*pc) == 1 && !output)
+          Serial.print('N');
+        pc++;
+        break;
+      case 'T':
+        if (spi)
+          rec_emit(spi_read(*pc), output);
+        pc++;
+        break;
+      case 'R':
+        rec_emit(spi ? spi_read(0) : i2c_read(WITH_NACK), output);
+        break;
+      case 'r':
+        rec_emit(spi_read(0), output);
+        break;
+      case 'Q':
+        if (!spi)
+          rec_emit(i2c_read(WITH_ACK), output);
+        break;
+      case 's':
+        if (!spi)
+          i2c_start();
+        break;
+      case 'p':
+        if (!spi)
+          i2c_stop();
+        break;
+      case 'H':
+        rec_wait_miso(1);
+        break;
+      case 'L':
+        rec_wait_miso(0);
+        break;
+      case 'D':
+        delay(((uint16_t)pc[0] << 8) | pc[1]);
+        pc += 2;
+        break;
+      case 'Z':
+        if (!output)
+        {
+          Serial.print('\n');
+          Serial.flush();
+        }
+        break;
+    }
+  }
+}
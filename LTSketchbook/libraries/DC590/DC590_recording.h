@@ -0,0 +1,123 @@
+/*!
+DC590_recording: Compiled recording loops for the DC590B command interpreter.
+
+@verbatim
+  The DC590B 't' command records the commands that follow it, up to 'u', and
+  'w' plays them back. The sketch used to keep the recording as text and parse
+  it again on every pass. Here each recorded command is compiled as it
+  arrives, into an opcode and a binary operand. The code is kept in a buffer
+  of DC590_REC_SIZE bytes, and a pass runs through a switch with no parsing.
+
+  Commands that are compiled:
+
+    x X       QUIKEVAL_CS low, high
+    g G       QUIKEVAL_GPIO low, high
+    Sxx       send a byte: SPI write, or I2C write that prints 'N' on a NACK
+    Txx       SPI transceive, prints the byte read
+    R         SPI read, or I2C read with NACK, prints the byte read
+    r         SPI read, prints the byte read
+    Q         I2C read with ACK, prints the byte read
+    s p       I2C start, stop
+    H L       wait up to 1s for MISO high, low
+    Dxxxx     delay ms
+    Z         line feed
+
+  SPI or I2C is chosen by the serial mode when the recording is played, as it
+  was when the text was parsed. The loop commands t, u, v, w and W are left
+  out, and so are characters that are not commands. A recording with any
+  other command (M, K, I, ...) is not compiled, and the sketch plays it from
+  its text as before.
+
+  The sketch's 'W' command plays the recording many times in a row, and the
+  binary mode's PLAY request does the same with the results in binary.
+  A GUI can then ask for N back-to-back ADC reads in one request.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup DC590
+    Library Header File for DC590_recording: Compiled recording loops for the DC590B command interpreter.
+*/
+
+#ifndef DC590_RECORDING_H
+#define DC590_RECORDING_H
+
+#include <stdint.h>
+
+//! Bytes of compiled code, including the end opcode
+#ifndef DC590_REC_SIZE
+#define DC590_REC_SIZE 256
+#endif
+
+//! Receives each byte a pass reads, in place of printing it in hex
+typedef void (*dc590_rec_output)(uint8_t data);
+
+//! Clears the recording and starts compiling a new one
+void dc590_rec_begin();
+
+//! Compiles one recorded character
+void dc590_rec_add(char c   //!< Character received after 't'
+                  );
+
+//! Ends the recording started by dc590_rec_begin()
+//! @return 0 if it was compiled, 1 if it must be played from its text
+int8_t dc590_rec_end();
+
+//! Compiles a whole recording, for the binary mode
+//! @return 0 if it was compiled, 1 if not
+int8_t dc590_rec_compile(const uint8_t *text, //!< Recorded commands, without 't' and 'u'
+                         uint16_t length      //!< Number of characters
+                        );
+
+//! @return 1 if a compiled recording is ready to play, else 0
+uint8_t dc590_rec_ready();
+
+//! @return bytes of compiled code, including the end opcode
+uint16_t dc590_rec_size();
+
+//! @return bytes one pass reads in the given serial mode
+uint16_t dc590_rec_results(uint8_t serial_mode  //!< DC590_BIN_BUS_SPI, DC590_BIN_BUS_I2C or DC590_BIN_BUS_I2C_AUXILIARY
+                          );
+
+//! Prints the compiled recording back as command text, for the 'v' command
+void dc590_rec_print();
+
+//! Runs one pass of the compiled recording
+void dc590_rec_play(uint8_t serial_mode,      //!< DC590_BIN_BUS_SPI, DC590_BIN_BUS_I2C or DC590_BIN_BUS_I2C_AUXILIARY
+                    dc590_rec_output output   //!< Gets the bytes read, or 0 to print them in hex as the ASCII commands do
+                   );
+
+#endif  // DC590_RECORDING_H
@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+"""
+DC590B binary mode client
+
+Switches a Linduino running DC590B or DC590B_enhanced to the binary framing
+mode of DC590_binary.h and moves SPI and I2C buffers in single frames. The
+frame layout and the requests are described in DC590_binary.h.
+
+Usage (needs pyserial):
+  python3 dc590_binary.py --port /dev/ttyACM0 --id
+  python3 dc590_binary.py --port /dev/ttyACM0 --baud 1000000 --spi-read 16384
+
+Options:
+  --port DEV       serial port of the Linduino
+  --baud N         switch to this rate after entering binary mode
+  --id             read the demo board ID string from the QuikEval EEPROM
+  --spi-read N     clock N bytes from the QuikEval SPI port and report the rate
+  --record TEXT    compile a recording loop, e.g. xT00T00T00X for a 24-bit read
+  --play N         play the recording N times and print the bytes of each pass
+
+As a module:
+  link = Dc590Binary(serial.Serial(port, 115200, timeout=1))
+  link.enter()
+  rx = link.spi(b'\\x00\\x00\\x00')
+  link.exit()
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+import time
+
+SYNC = 0xA5
+VERSION = 1
+
+INFO = 0x00
+EXIT = 0x01
+BAUD = 0x02
+CONFIG = 0x03
+PINS = 0x04
+DELAY = 0x05
+WAIT_MISO = 0x06
+SPI = 0x10
+SPI_READ = 0x11
+I2C = 0x20
+RECORD = 0x30
+PLAY = 0x31
+
+STATUS_OK = 0x00
+STATUS_NACK = 0x01
+STATUS_TIMEOUT = 0x02
+STATUS_NAMES = {0x01: 'NACK', 0x02: 'timeout', 0x80: 'bad CRC', 0x81: 'unknown command',
+                0x82: 'bad length', 0x83: 'bad argument'}
+
+SPI_HOLD_CS = 0x01
+SPI_NO_CS = 0x02
+SPI_FILL_ONES = 0x04
+
+BUS_SPI = 0
+BUS_I2C = 1
+BUS_I2C_AUXILIARY = 2
+
+I2C_XFER_PEC = 0x02
+I2C_XFER_BLOCK = 0x04
+
+EEPROM_I2C_ADDRESS = 0x50
+
+
+class Dc590Error(Exception):
+    pass
+
+
+class Dc590Status(Dc590Error):
+    """The Linduino ran the request, or refused it, with a status other than OK."""
+
+    def __init__(self, command, status):
+        Dc590Error.__init__(self, 'command 0x%02x: %s' % (command, STATUS_NAMES.get(status, '0x%02x' % status)))
+        self.command = command
+        self.status = status
+
+
+def crc16(data):
+    """CRC-16/CCITT, polynomial 0x1021 MSB first, start 0xFFFF."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def frame(command, payload=b''):
+    body = struct.pack('<BH', command, len(payload)) + bytes(payload)
+    return bytes([SYNC]) + body + struct.pack('<H', crc16(body))
+
+
+class Dc590Binary(object):
+    """One Linduino. port is anything with read(n), write(data) and, for
+    baud(), a baudrate attribute, such as serial.Serial."""
+
+    def __init__(self, port):
+        self.port = port
+        self.max_payload = 0
+
+    def _read(self, n):
+        data = b''
+        while len(data) < n:
+            piece = self.port.read(n - len(data))
+            if not piece:
+                raise Dc590Error('no reply from the Linduino')
+            data += piece
+        return data
+
+    def _reply(self, command):
+        """Reads one reply, skipping any text before it. Returns the data after the status byte."""
+        while self._read(1)[0] != SYNC:
+            pass
+        header = self._read(3)
+        reply_command, length = struct.unpack('<BH', header)
+        payload = self._read(length)
+        crc, = struct.unpack('<H', self._read(2))
+        if crc16(header + payload) != crc:
+            raise Dc590Error('reply CRC error')
+        if length < 1:
+            raise Dc590Error('reply without a status byte')
+        if payload[0] != STATUS_OK:
+            raise Dc590Status(reply_command, payload[0])
+        if reply_command != command:
+            raise Dc590Error('reply to command 0x%02x, expected 0x%02x' % (reply_command, command))
+        return payload[1:]
+
+    def request(self, command, payload=b''):
+        """Sends one request and returns the reply data. Raises Dc590Status if it failed."""
+        if len(payload) > self.max_payload:
+            raise Dc590Error('payload of %d bytes, the Linduino takes %d' % (len(payload), self.max_payload))
+        self.port.write(frame(command, payload))
+        return self._reply(command)
+
+    def _info(self, data):
+        version, self.max_payload = struct.unpack('<BH', data[:3])
+        if version != VERSION:
+            raise Dc590Error('binary mode version %d, expected %d' % (version, VERSION))
+        return version, self.max_payload
+
+    def enter(self):
+        """Switches from the ASCII protocol. Raises Dc590Error if the firmware has no binary mode."""
+        self.port.write(b'B')
+        return self._info(self._reply(INFO))
+
+    def info(self):
+        return self._info(self.request(INFO))
+
+    def exit(self):
+        """Goes back to the ASCII protocol at 115200 baud."""
+        self.request(EXIT)
+        if hasattr(self.port, 'baudrate'):
+            self.port.baudrate = 115200
+
+    def baud(self, rate):
+        self.request(BAUD, struct.pack('<I', rate))
+        self.port.baudrate = rate
+        time.sleep(0.01)
+
+    def config(self, bus=None, spi_mode=None, spi_divider=None):
+        self.request(CONFIG, bytes([0xFF if bus is None else bus, 0xFF if spi_mode is None else spi_mode,
+                                    spi_divider or 0]))
+
+    def pins(self, cs=None, gpio=None):
+        self.request(PINS, bytes([0xFF if cs is None else int(cs), 0xFF if gpio is None else int(gpio)]))
+
+    def delay(self, ms):
+        self.request(DELAY, struct.pack('<H', ms))
+
+    def wait_miso(self, level, timeout_ms):
+        """Returns False if MISO did not reach level in time."""
+        try:
+            self.request(WAIT_MISO, struct.pack('<BH', level, timeout_ms))
+        except Dc590Status as e:
+            if e.status != STATUS_TIMEOUT:
+                raise
+            return False
+        return True
+
+    def spi(self, tx, flags=0):
+        """Sends tx and returns as many bytes received."""
+        return self.request(SPI, bytes([flags]) + bytes(tx))
+
+    def spi_read(self, count, flags=0):
+        """Clocks count fill bytes, count may be larger than the max payload."""
+        return self.request(SPI_READ, struct.pack('<BH', flags, count))
+
+    def i2c(self, address, tx=b'', rx_count=0, flags=0):
+        """One I2C transaction: writes tx, then repeated START and reads rx_count
+        bytes. Raises Dc590Status with STATUS_NACK if the device did not answer."""
+        return self.request(I2C, struct.pack('<BBH', address, flags, rx_count) + bytes(tx))
+
+    def record(self, text):
+        """Compiles a recording loop, the commands 't' and 'u' would enclose.
+        Returns (code size, bytes read per pass)."""
+        if isinstance(text, str):
+            text = text.encode('ascii')
+        return struct.unpack('<HH', self.request(RECORD, text))
+
+    def play(self, passes):
+        """Plays the recording passes times back to back and returns every byte read."""
+        return self.request(PLAY, struct.pack('<H', passes))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='DC590B binary mode client')
+    parser.add_argument('--port', required=True, help='serial port of the Linduino')
+    parser.add_argument('--baud', type=int, default=0, help='switch to this rate in binary mode')
+    parser.add_argument('--id', action='store_true', help='read the demo board ID string')
+    parser.add_argument('--spi-read', type=int, default=0, metavar='N', help='clock N bytes and report the rate')
+    parser.add_argument('--record', help='recording loop to compile')
+    parser.add_argument('--play', type=int, default=0, metavar='N', help='play the recording N times')
+    args = parser.parse_args()
+
+    import serial
+    port = serial.Serial(args.port, 115200, timeout=2)
+    time.sleep(2)                 # the Linduino resets when the port opens
+    port.reset_input_buffer()
+    link = Dc590Binary(port)
+    version, max_payload = link.enter()
+    print('binary mode version %d, max payload %d' % (version, max_payload))
+    try:
+        if args.baud:
+            link.baud(args.baud)
+        if args.id:
+            link.config(bus=BUS_I2C_AUXILIARY)
+            ident = link.i2c(EEPROM_I2C_ADDRESS, b'\x00', 50)
+            print(ident.split(b'\n')[0].decode('ascii', 'replace'))
+        if args.spi_read:
+            link.config(bus=BUS_SPI)
+            start = time.time()
+            data = link.spi_read(args.spi_read)
+            seconds = time.time() - start
+            print('%d bytes in %.3f s, %.0f bytes/s' % (len(data), seconds, len(data) / seconds))
+        if args.record:
+            size, per_pass = link.record(args.record)
+            print('recording: %d bytes of code, %d bytes read per pass' % (size, per_pass))
+            if args.play and per_pass:
+                start = time.time()
+                data = link.play(args.play)
+                seconds = time.time() - start
+                for i in range(0, len(data), per_pass):
+                    print(data[i:i + per_pass].hex())
+                print('%d passes in %.3f s' % (args.play, seconds))
+    finally:
+        link.exit()
+
+
+if __name__ == '__main__':
+    main()
@@ -122,11 +122,5 @@ void LTC2338_read(uint8_t cs, int32_t *ptr_adc_code)
 // Calculates the voltage corresponding to an adc code in 2's complement, given the reference voltage (in volts)
 float LTC2338_code_to_voltage(int32_t adc_code, float vref)
 {
-  float voltage;
-
-  voltage = (float)adc_code;
-  voltage = voltage / (pow(2,31)-1);    //! 2) This calculates the input as a fraction of the reference voltage (dimensionless)
-  voltage = voltage * vref;           //! 3) Multiply fraction by Vref to get the actual voltage at the input (in volts)
-
-  return(voltage);
+  return(LT_code_to_float(adc_code, 0, vref / 2147483647.0));
 }
@@ -98,6 +98,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LTC2338_H
 
 #include <SPI.h>
+#include "LT_Convert.h"
 
 //! Define the SPI CS pin
 #ifndef LTC2338_CS
@@ -124,6 +125,14 @@ float LTC2338_code_to_voltage(int32_t adc_code,                   //!< Raw ADC c
                               float vref              //!< Reference voltage
                              );
 
+//! Makes the scale from LTC2338_read() codes to microvolts, for LT_convert() and LT_convert_array().
+//! @return the scale, worked out by the compiler for a constant vref
+constexpr LT_scale LTC2338_scale_microvolts(double vref     //!< Reference voltage
+                                           )
+{
+  return LT_make_scale(vref * 1e6 / 2147483647.0);
+}
+
 #endif  //  LTC2338_H
 
 
@@ -177,3 +177,104 @@ float LTC23XX_voltage_calculator(uint32_t data, uint8_t channel_configuration)
   return voltage;
 }
 
+
+//! Scale of one SoftSpan for the integer decoder. The full scale in
+//! microvolts is split in two 12 bit halves so that an 18 bit result times
+//! either half fits 32 bits.
+struct LTC23XX_scale
+{
+  int32_t offset;       //!< 0x20000 in the two's complement SoftSpans, else 0
+  int16_t high;         //!< Full scale in microvolts >> 12
+  int16_t low;          //!< Full scale in microvolts & 0xFFF
+  uint8_t shift;        //!< LSBs in the full scale, less 12, as a power of 2
+  int16_t half;         //!< 2^(shift - 1), rounds to the nearest microvolt
+};
+
+// Full scale of each SoftSpan as a multiple of VREF. SoftSpans with bit 1 set
+// are two's complement and have 2^17 LSBs in it, the others 2^18.
+static const float LTC23XX_span_range[8] = {0, 1.25, 1.25 / 1.024, 1.25, 2.50 / 1.024, 2.50, 2.50 / 1.024, 2.50};
+
+static struct LTC23XX_scale LTC23XX_scales[8];
+static uint8_t LTC23XX_scales_ready = 0;
+
+// Works out the scale of each SoftSpan from VREF once
+static const struct LTC23XX_scale *LTC23XX_scale_table()
+{
+  uint8_t span;
+  uint32_t full_scale;
+  struct LTC23XX_scale *s;
+
+  if (LTC23XX_scales_ready)
+    return LTC23XX_scales;
+  for (span = 0; span < 8; span++)
+  {
+    s = &LTC23XX_scales[span];
+    full_scale = (uint32_t)(VREF * 1000000.0 * LTC23XX_span_range[span] + 0.5);
+    s->offset = (span & 0x02) ? 0x20000 : 0;
+    s->high = full_scale >> 12;
+    s->low = full_scale & 0xFFF;
+    s->shift = ((span & 0x02) ? 17 : 18) - 12;
+    s->half = 1 << (s->shift - 1);
+  }
+  LTC23XX_scales_ready = 1;
+  return LTC23XX_scales;
+}
+
+// code * full scale / 2^bits, rounded half up. Rounding the low product down
+// first does not change the result, so this is exact for any VREF.
+static inline int32_t LTC23XX_scale_microvolts(const struct LTC23XX_scale *s, int32_t code)
+{
+  return (code * s->high + ((code * s->low) >> 12) + s->half) >> s->shift;
+}
+
+// Calculates the voltage in microvolts from ADC output data depending on the channel configuration
+int32_t LTC23XX_microvolt_calculator(uint32_t data, uint8_t channel_configuration)
+{
+  const struct LTC23XX_scale *s = &LTC23XX_scale_table()[channel_configuration & SOFTSPAN];
+  int32_t code = (int32_t)((data & 0x3FFFF) ^ s->offset) - s->offset;
+  return LTC23XX_scale_microvolts(s, code);
+}
+
+// Decodes one frame with the scale table already built. The first word
+// clocked out is at data_array[23], as spi_transfer_block() stores it.
+static void LTC23XX_decode(const struct LTC23XX_scale *table, const uint8_t *data_array, LTC23XX_channel *channels)
+{
+  const uint8_t *p = data_array + LTC23XX_FRAME_BYTES;
+  const struct LTC23XX_scale *s;
+  uint8_t i;
+  uint8_t b0, b1, b2;
+  int32_t code;
+
+  for (i = 0; i < LTC23XX_FRAME_CHANNELS; i++)
+  {
+    b0 = *--p;
+    b1 = *--p;
+    b2 = *--p;
+    s = &table[b2 & SOFTSPAN];
+    code = ((uint32_t)b0 << 10) | ((uint16_t)b1 << 2) | (b2 >> 6);
+    code = (code ^ s->offset) - s->offset;
+    channels[i].code = code;
+    channels[i].microvolts = LTC23XX_scale_microvolts(s, code);
+    channels[i].channel = (b2 & CHANNEL_NUMBER) >> 3;
+    channels[i].softspan = b2 & SOFTSPAN;
+  }
+}
+
+// Decodes all 8 channel words of a frame in one pass
+void LTC23XX_decode_frame(const uint8_t data_array[24], LTC23XX_channel channels[8])
+{
+  LTC23XX_decode(LTC23XX_scale_table(), data_array, channels);
+}
+
+// Decodes frames stored back to back
+void LTC23XX_decode_frames(const uint8_t *frames, uint16_t count, LTC23XX_channel *channels)
+{
+  const struct LTC23XX_scale *table = LTC23XX_scale_table();
+
+  while (count--)
+  {
+    LTC23XX_decode(table, frames, channels);
+    frames += LTC23XX_FRAME_BYTES;
+    channels += LTC23XX_FRAME_CHANNELS;
+  }
+}
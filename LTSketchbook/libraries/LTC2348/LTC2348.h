@@ -134,4 +134,39 @@ float LTC23XX_voltage_calculator(uint32_t data,             //!< 24 bits of ADC
                                  uint8_t channel_configuration      //!< 3 bits of channel configuration data
                                 );
 
+//! Number of channel words in a frame read by LTC23XX_read()
+#define LTC23XX_FRAME_CHANNELS 8
+//! Bytes in a frame read by LTC23XX_read()
+#define LTC23XX_FRAME_BYTES 24
+
+//! One channel word of a frame, decoded
+typedef struct
+{
+  int32_t code;           //!< 18 bit result, sign extended in the two's complement SoftSpans
+  int32_t microvolts;     //!< Input voltage in microvolts, 0 for a disabled channel
+  uint8_t channel;        //!< Channel ID sent with the result
+  uint8_t softspan;       //!< SoftSpan configuration sent with the result
+} LTC23XX_channel;
+
+//! Calculates the voltage in microvolts from ADC output data depending on the channel configuration.
+//! Integer counterpart of LTC23XX_voltage_calculator(), rounded to the nearest microvolt.
+//! @return the voltage in microvolts
+int32_t LTC23XX_microvolt_calculator(uint32_t data,             //!< 18 bit result of a single channel
+                                     uint8_t channel_configuration      //!< 3 bits of channel configuration data
+                                    );
+
+//! Decodes all 8 channel words of a frame read by LTC23XX_read() in one pass.
+//! The words are decoded in the order they were clocked out, each with the
+//! channel ID and SoftSpan it was sent with, so disabled or reordered channels
+//! need no bookkeeping by the caller.
+void LTC23XX_decode_frame(const uint8_t data_array[24],           //!< Frame as read by LTC23XX_read()
+                          LTC23XX_channel channels[8]             //!< Decoded channel words
+                         );
+
+//! Decodes frames stored back to back, as LTC23XX_decode_frame() does for one.
+void LTC23XX_decode_frames(const uint8_t *frames,             //!< count frames of 24 bytes as read by LTC23XX_read()
+                           uint16_t count,                    //!< Number of frames
+                           LTC23XX_channel *channels          //!< count * 8 decoded channel words
+                          );
+
 #endif
\ No newline at end of file
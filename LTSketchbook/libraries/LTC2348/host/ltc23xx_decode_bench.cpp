@@ -0,0 +1,326 @@
+/*!
+LTC23XX frame decoder benchmark
+@verbatim
+  Replays recorded LTC2348 family frames through LTC23XX_read() on a PC and
+  times three ways of turning them into voltages: the per channel path of the
+  demo sketches (unpack each 24 bit word, then LTC23XX_voltage_calculator()),
+  LTC23XX_decode_frame() frame by frame, and LTC23XX_decode_frames() over all
+  frames at once. Every decoded word is checked against the code, channel ID
+  and SoftSpan unpacked the old way, and the microvolts against the exact
+  value worked out in double precision; the largest error of the float path
+  is reported next to it.
+
+  Frames are recorded with option 3 of the DC2094A sketch: save the serial
+  monitor output to a file. Lines other than FRAME lines are ignored. With no
+  file, frames are made up with each channel in a different SoftSpan and a
+  random result, which covers every SoftSpan and both signs.
+
+  Build, from LTC2348:
+    g++ -O2 -I../LT_SMBUS/linux -I../LT_Trace/host -I. -I../Linduino -I../LT_SPI \
+        -I../UserInterface -I../QuikEval_EEPROM \
+        host/ltc23xx_decode_bench.cpp LTC2348.cpp -o ltc23xx_decode_bench
+
+  Run:
+    ./ltc23xx_decode_bench [capture.txt] [-n passes] [-f frames]
+
+    -n passes   times the frames are decoded, default 200
+    -f frames   frames made up when there is no capture, default 4096
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "Linduino.h"
+#include "LTC2348.h"
+
+static std::vector<uint8_t> recorded;     // Frames in the order they were clocked out
+static size_t replay_position = 0;
+
+// Stands in for LT_SPI: returns the next recorded frame, stored the way the
+// real spi_transfer_block() stores it, last byte clocked out first.
+void spi_transfer_block(uint8_t cs_pin, uint8_t *tx, uint8_t *rx, uint8_t length)
+{
+  uint8_t i;
+
+  for (i = 0; i < length; i++)
+  {
+    rx[length - 1 - i] = recorded[replay_position++];
+    if (replay_position == recorded.size())
+      replay_position = 0;
+  }
+}
+
+static double now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int hex_digit(char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+// Reads the FRAME lines printed by the DC2094A sketch
+static size_t load_capture(const char *path)
+{
+  char line[256];
+  size_t frames = 0;
+  FILE *f = fopen(path, "r");
+  int i;
+
+  if (!f)
+  {
+    perror(path);
+    exit(2);
+  }
+  while (fgets(line, sizeof(line), f))
+  {
+    const char *p = strstr(line, "FRAME,");
+    uint8_t frame[LTC23XX_FRAME_BYTES];
+
+    if (!p)
+      continue;
+    p += 6;
+    for (i = 0; i < LTC23XX_FRAME_BYTES; i++)
+    {
+      int hi = hex_digit(p[2 * i]);
+      int lo = hi < 0 ? -1 : hex_digit(p[2 * i + 1]);
+      if (lo < 0)
+        break;
+      frame[i] = (hi << 4) | lo;
+    }
+    if (i < LTC23XX_FRAME_BYTES)
+      continue;                 // A line cut short
+    recorded.insert(recorded.end(), frame, frame + LTC23XX_FRAME_BYTES);
+    frames++;
+  }
+  fclose(f);
+  return frames;
+}
+
+// Channel i in SoftSpan (i + frame) % 8 with a random result; a disabled
+// channel sends all zeros, as the part does.
+static size_t make_frames(size_t frames)
+{
+  size_t n;
+  uint8_t i;
+
+  srand(2348);
+  for (n = 0; n < frames; n++)
+  {
+    for (i = 0; i < LTC23XX_FRAME_CHANNELS; i++)
+    {
+      uint8_t span = (i + n) % 8;
+      uint32_t code = span ? ((uint32_t)rand() & 0x3FFFF) : 0;
+      uint32_t word = (code << 6) | ((uint32_t)i << 3) | span;
+      if (!span)
+        word = (uint32_t)i << 3;
+      recorded.push_back(word >> 16);
+      recorded.push_back(word >> 8);
+      recorded.push_back(word);
+    }
+  }
+  return frames;
+}
+
+// The exact voltage in microvolts, rounded half up as the decoder does
+static int32_t reference_microvolts(uint32_t code, uint8_t span)
+{
+  static const double range[8] = {0, 1.25, 1.25 / 1.024, 1.25, 2.50 / 1.024, 2.50, 2.50 / 1.024, 2.50};
+  double full_scale = floor(VREF * 1e6 * range[span] + 0.5);
+  int32_t value = code;
+
+  if (span & 0x02)
+  {
+    if (code & 0x20000)
+      value -= 0x40000;
+    return (int32_t)floor(value * full_scale / POW2_17 + 0.5);
+  }
+  return (int32_t)floor(value * full_scale / POW2_18 + 0.5);
+}
+
+// The per channel decode of the demo sketches
+static float decode_old(const uint8_t *frame, uint32_t *codes, uint8_t *ids, uint8_t *spans)
+{
+  union LT_union_int32_4bytes data;
+  float sum = 0;
+  uint8_t pos = 23;
+  uint8_t i;
+
+  data.LT_uint32 = 0;
+  for (i = 0; i < LTC23XX_FRAME_CHANNELS; i++)
+  {
+    data.LT_byte[2] = frame[pos--];
+    data.LT_byte[1] = frame[pos--];
+    data.LT_byte[0] = frame[pos--];
+    ids[i] = (data.LT_uint32 & CHANNEL_NUMBER) >> 3;
+    spans[i] = data.LT_uint32 & SOFTSPAN;
+    codes[i] = (data.LT_uint32 & 0xFFFFC0) >> 6;
+    sum += LTC23XX_voltage_calculator(codes[i], spans[i]);
+  }
+  return sum;
+}
+
+int main(int argc, char *argv[])
+{
+  int passes = 200;
+  size_t made = 4096;
+  size_t frames;
+  size_t n;
+  int opt;
+  int p;
+  uint8_t i;
+  uint32_t mismatches = 0;
+  double old_error = 0;
+  int32_t new_error = 0;
+  double start, old_ns, frame_ns, batch_ns;
+  volatile float old_sum = 0;
+  volatile int32_t new_sum = 0;
+
+  while ((opt = getopt(argc, argv, "n:f:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n':
+        passes = atoi(optarg);
+        break;
+      case 'f':
+        made = strtoul(optarg, 0, 0);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [capture.txt] [-n passes] [-f frames]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (optind < argc)
+    frames = load_capture(argv[optind]);
+  else
+    frames = make_frames(made);
+  if (frames == 0)
+  {
+    fprintf(stderr, "no frames\n");
+    return 2;
+  }
+
+  // Read every frame back through the library, as the sketch would
+  std::vector<uint8_t> data(frames * LTC23XX_FRAME_BYTES);
+  std::vector<LTC23XX_channel> channels(frames * LTC23XX_FRAME_CHANNELS);
+  for (n = 0; n < frames; n++)
+    LTC23XX_read(QUIKEVAL_CS, 0, &data[n * LTC23XX_FRAME_BYTES]);
+
+  // Check the decoder against the old path and the exact value
+  LTC23XX_decode_frames(&data[0], frames, &channels[0]);
+  for (n = 0; n < frames; n++)
+  {
+    uint32_t codes[LTC23XX_FRAME_CHANNELS];
+    uint8_t ids[LTC23XX_FRAME_CHANNELS];
+    uint8_t spans[LTC23XX_FRAME_CHANNELS];
+    LTC23XX_channel single[LTC23XX_FRAME_CHANNELS];
+
+    decode_old(&data[n * LTC23XX_FRAME_BYTES], codes, ids, spans);
+    LTC23XX_decode_frame(&data[n * LTC23XX_FRAME_BYTES], single);
+    for (i = 0; i < LTC23XX_FRAME_CHANNELS; i++)
+    {
+      LTC23XX_channel *c = &channels[n * LTC23XX_FRAME_CHANNELS + i];
+      int32_t exact = reference_microvolts(codes[i], spans[i]);
+      double old_uv = LTC23XX_voltage_calculator(codes[i], spans[i]) * 1e6;
+
+      if (((uint32_t)c->code & 0x3FFFF) != codes[i] || c->channel != ids[i] || c->softspan != spans[i]
+          || c->code != single[i].code || c->microvolts != single[i].microvolts
+          || c->channel != single[i].channel || c->softspan != single[i].softspan
+          || c->microvolts != LTC23XX_microvolt_calculator(codes[i], spans[i]))
+      {
+        if (mismatches++ < 10)
+          printf("frame %zu word %u: decoded code 0x%05x ch %u span %u, expected 0x%05x ch %u span %u\n",
+                 n, i, (uint32_t)c->code & 0x3FFFF, c->channel, c->softspan, codes[i], ids[i], spans[i]);
+      }
+      if (abs(c->microvolts - exact) > new_error)
+        new_error = abs(c->microvolts - exact);
+      if (fabs(old_uv - exact) > old_error)
+        old_error = fabs(old_uv - exact);
+    }
+  }
+
+  start = now_ns();
+  for (p = 0; p < passes; p++)
+    for (n = 0; n < frames; n++)
+    {
+      uint32_t codes[LTC23XX_FRAME_CHANNELS];
+      uint8_t ids[LTC23XX_FRAME_CHANNELS];
+      uint8_t spans[LTC23XX_FRAME_CHANNELS];
+      old_sum += decode_old(&data[n * LTC23XX_FRAME_BYTES], codes, ids, spans);
+    }
+  old_ns = (now_ns() - start) / ((double)passes * frames);
+
+  start = now_ns();
+  for (p = 0; p < passes; p++)
+    for (n = 0; n < frames; n++)
+    {
+      LTC23XX_decode_frame(&data[n * LTC23XX_FRAME_BYTES], &channels[n * LTC23XX_FRAME_CHANNELS]);
+      new_sum += channels[n * LTC23XX_FRAME_CHANNELS].microvolts;
+    }
+  frame_ns = (now_ns() - start) / ((double)passes * frames);
+
+  start = now_ns();
+  for (p = 0; p < passes; p++)
+  {
+    LTC23XX_decode_frames(&data[0], frames, &channels[0]);
+    new_sum += channels[0].microvolts;
+  }
+  batch_ns = (now_ns() - start) / ((double)passes * frames);
+
+  printf("%zu frames (%s), %d passes\n", frames, optind < argc ? argv[optind] : "made up", passes);
+  printf("%-30s %10s %12s\n", "path", "ns/frame", "max error uV");
+  printf("%-30s %10.1f %12.3f\n", "LTC23XX_voltage_calculator", old_ns, old_error);
+  printf("%-30s %10.1f %12d\n", "LTC23XX_decode_frame", frame_ns, new_error);
+  printf("%-30s %10.1f %12d\n", "LTC23XX_decode_frames", batch_ns, new_error);
+  printf("%u mismatches\n", mismatches);
+  return (mismatches || new_error > 0) ? 1 : 0;
+}
@@ -114,6 +114,15 @@ void LTC2370_read(uint8_t cs, uint32_t *ptr_adc_code)
   return;
 }
 
+// Reads the same offset binary code as LTC2370_read(), for the read functions that take an int32_t
+void LTC2370_read_code(uint8_t cs, int32_t *ptr_adc_code)
+{
+  uint32_t adc_code;
+
+  LTC2370_read(cs, &adc_code);
+  *ptr_adc_code = (int32_t)adc_code;
+}
+
 
 // Calculates the voltage corresponding to an adc code in offset binary, given the reference voltage (in volts)
 float LTC2370_code_to_voltage(uint32_t adc_code, float vref)
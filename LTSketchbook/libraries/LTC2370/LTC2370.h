@@ -113,6 +113,13 @@ void LTC2370_read(uint8_t cs,           //!< Chip Select Pin
                   uint32_t *ptr_adc_code    //!< Returns code read from ADC (from previous conversion)
                  );
 
+//! Reads the LTC2370 as LTC2370_read() does, into an int32_t, so that it can be given to
+//! LT_decimate_read() with LT_DECIMATE_OFFSET_BINARY. The code is still offset binary.
+//! @return void
+void LTC2370_read_code(uint8_t cs,           //!< Chip Select Pin
+                       int32_t *ptr_adc_code    //!< Returns code read from ADC (from previous conversion)
+                      );
+
 
 //! Calculates the LTC2370 input voltage given the binary data and lsb weight.
 //! @return Floating point voltage
@@ -103,14 +103,8 @@ void LTC2378_read(uint8_t cs, int32_t *ptr_adc_code)
 // Calculates the voltage corresponding to an adc code in 2's complement, given the reference voltage (in volts)
 float LTC2378_code_to_voltage(int32_t adc_code, uint8_t gain_compression, float vref)
 {
-  float voltage;
-
   if (gain_compression == 1)
     vref = 0.8*vref;
 
-  voltage = (float)adc_code;
-  voltage = voltage / (pow(2,31)-1);    //! 2) This calculates the input as a fraction of the reference voltage (dimensionless)
-  voltage = voltage * vref + 0.1;           //! 3) Multiply fraction by Vref to get the actual voltage at the input (in volts)
-
-  return(voltage);
+  return(LT_code_to_float(adc_code, 0, vref / 2147483647.0) + LTC2378_OUTPUT_OFFSET);
 }
@@ -79,6 +79,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LTC2378_H
 
 #include <SPI.h>
+#include "LT_Convert.h"
 
 //! Define the SPI CS pin
 #ifndef LTC2378_CS
@@ -91,6 +92,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LTC2378_ADDRESS             0x00
 //!@}
 
+//! Volts added to every conversion by LTC2378_code_to_voltage() and LTC2378_scale_microvolts()
+#define LTC2378_OUTPUT_OFFSET       0.1
+
 
 //! Reads the LTC2378 and returns 32-bit data in 2's complement format
 //! @return void
@@ -106,6 +110,16 @@ float LTC2378_code_to_voltage(int32_t adc_code,                   //!< Raw ADC c
                               float vref              //!< Reference voltage
                              );
 
+//! Makes the scale from LTC2378_read() codes to microvolts, for LT_convert() and LT_convert_array().
+//! @return the scale, worked out by the compiler for a constant vref
+constexpr LT_scale LTC2378_scale_microvolts(double vref,                //!< Reference voltage
+                                            uint8_t gain_compression    //!< 1 with digital gain compression
+                                           )
+{
+  return LT_make_scale((gain_compression == 1 ? 0.8 : 1.0) * vref * 1e6 / 2147483647.0, 0,
+                       (int32_t)(LTC2378_OUTPUT_OFFSET * 1e6));
+}
+
 #endif  //  LTC2378_H
 
 
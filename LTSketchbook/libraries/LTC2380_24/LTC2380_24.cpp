@@ -57,15 +57,33 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdint.h>
 #include "Linduino.h"
 #include "LT_SPI.h"
+#include "LT_Stream.h"
 #include "LTC2380_24.h"
 #include <SPI.h>
 #include "UserInterface.h"
 
+// Splits the 24 bit code and the 16 bit averaging count clocked out of the LTC2380-24
+static void LTC2380_decode(const uint8_t *frame, int32_t *ptr_adc_code, int16_t *ptr_cycles)
+{
+  LT_union_int16_2bytes cycles;    // LTC2380 data and command
+  LT_union_int32_4bytes data; //instantiate the union
+
+  data.LT_byte[3] = (frame[0] & 0x80) ? 0xFF : 0;   // Sign extend the 24 bit code
+  data.LT_byte[2] = frame[0];
+  data.LT_byte[1] = frame[1];
+  data.LT_byte[0] = frame[2];
+  cycles.LT_byte[1] = frame[3];
+  cycles.LT_byte[0] = frame[4];
+
+  *ptr_adc_code = data.LT_int32;
+  *ptr_cycles = cycles.LT_int16;
+}
+
 // Reads from a SPI LTC2380-XX device that has no configuration word and a 32 bit output word in 2's complement format.
 void LTC2380_read(int32_t *ptr_adc_code, int16_t *ptr_cycles)
 {
   int N;
-  int negative;
+  uint8_t frame[5];
 
   Serial.print("\nEnter the number of CNV pulses: ");
   while (Serial.available());
@@ -78,31 +96,25 @@ void LTC2380_read(int32_t *ptr_adc_code, int16_t *ptr_cycles)
     __asm__("nop\n\t");
   }
 
-  LT_union_int16_2bytes cycles;    // LTC2380 data and command
-  cycles.LT_uint16 = 0;            // Set to zero, not necessary but avoids random data in scope shots.
+  spi_stream(0, frame, 5, 0);     // Code, then averaging count
+  LTC2380_decode(frame, ptr_adc_code, ptr_cycles);
+}
 
-  // Form a four byte object to hold four bytes of data
-  LT_union_int32_4bytes data; //instantiate the union
-  data.LT_byte[3] = 0;
-  data.LT_byte[2] = 0;
-  data.LT_byte[1] = 0;
-  data.LT_byte[0] = 0;
-
-  data.LT_byte[2] = spi_read(0);
-  data.LT_byte[1] = spi_read(0);
-  data.LT_byte[0] = spi_read(0);
-  cycles.LT_byte[1] = spi_read(0);
-  cycles.LT_byte[0] = spi_read(0);
-
-  negative = (data.LT_byte[2] & 0x80) != 0;
-  if (negative)
-  {
-    data.LT_byte[3] = 0xFF;
-  }
-  *ptr_adc_code = data.LT_int32;
-  *ptr_cycles = cycles.LT_int16;
+// Starts converting continuously and reading every "averages" conversions
+int8_t LTC2380_stream_begin(uint32_t cnv_hz, uint16_t averages)
+{
+  return lt_stream_begin(cnv_hz, averages, 5);
+}
+
+// Takes the oldest sample out of the ring
+int8_t LTC2380_stream_read(int32_t *ptr_adc_code, int16_t *ptr_cycles)
+{
+  uint8_t frame[5];
 
-  return;
+  if (lt_stream_read(frame))
+    return 1;
+  LTC2380_decode(frame, ptr_adc_code, ptr_cycles);
+  return 0;
 }
 
 // Calculates the voltage corresponding to an adc code in 2's complement, given the reference voltage (in volts)
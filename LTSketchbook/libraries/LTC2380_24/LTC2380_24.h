@@ -72,6 +72,20 @@ void LTC2380_read(int32_t *ptr_adc_code,    //!< Returns code read from ADC (fro
                   int16_t *ptr_cycles
                  );
 
+//! Starts converting continuously, with CNV pulses from Timer1 on QUIKEVAL_CS, and reading
+//! one averaged sample every "averages" conversions into the LT_Stream ring. SPI must be
+//! enabled. Use LT_Stream for the rates, overruns and lt_stream_end().
+//! @return 0 on success, 1 if the rates cannot be made by the timers
+int8_t LTC2380_stream_begin(uint32_t cnv_hz,     //!< Conversion rate, up to 2MHz
+                            uint16_t averages    //!< Conversions averaged per sample
+                           );
+
+//! Takes the oldest sample out of the LT_Stream ring, in the format of LTC2380_read().
+//! @return 0 on success, 1 if there is no sample yet
+int8_t LTC2380_stream_read(int32_t *ptr_adc_code,  //!< Returns code read from ADC
+                           int16_t *ptr_cycles     //!< Returns the number of conversions averaged, less one
+                          );
+
 
 //! Calculates the LTC2380 input voltage given the binary data and lsb weight.
 //! @return Floating point voltage
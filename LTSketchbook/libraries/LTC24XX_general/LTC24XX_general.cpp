@@ -82,18 +82,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 int8_t LTC24XX_EOC_timeout(uint8_t cs, uint16_t miso_timeout)
 // Checks for EOC with a specified timeout (ms)
 {
-  uint16_t timer_count = 0;             // Timer count for MISO
+  uint32_t start = millis();            // Start of the timeout
   output_low(cs);                       //! 1) Pull CS low
-  while (1)                             //! 2) Wait for SDO (MISO) to go low
+  while (1)                             //! 2) Wait for SDO (MISO) to go low, checking it continuously
   {
     if (input(MISO) == 0) break;        //! 3) If SDO is low, break loop
-    if (timer_count++>miso_timeout)     // If timeout, return 1 (failure)
+    if (millis() - start > miso_timeout)  // If timeout, return 1 (failure)
     {
       output_high(cs);                  // Pull CS high
       return(1);
     }
-    else
-      delay(1);
   }
   output_high(cs);                  // Pull CS high
   return(0);
@@ -374,12 +372,7 @@ int8_t LTC24XX_I2C_16bit_command_32bit_data(uint8_t i2c_address,uint8_t adc_comm
 // Calculates the voltage corresponding to an adc code, given the reference voltage (in volts)
 float LTC24XX_SE_code_to_voltage(int32_t adc_code, float vref)
 {
-  float voltage;
-  adc_code -= 0x20000000;             //! 1) Subtract offset
-  voltage=(float) adc_code;
-  voltage = voltage / 268435456.0;    //! 2) This calculates the input as a fraction of the reference voltage (dimensionless)
-  voltage = voltage * vref;           //! 3) Multiply fraction by Vref to get the actual voltage at the input (in volts)
-  return(voltage);
+  return(LT_code_to_float(adc_code, 0x20000000, vref / 268435456.0));
 }
 
 // Calculates the voltage corresponding to an adc code, given the reference voltage (in volts)
@@ -388,8 +381,6 @@ float LTC24XX_SE_code_to_voltage(int32_t adc_code, float vref)
 // is in bit 28 (the same as the SPI parts.)
 float LTC24XX_diff_code_to_voltage(int32_t adc_code, float vref)
 {
-  float voltage;
-
 #ifndef SKIP_EZDRIVE_2X_ZERO_CHECK
   if (adc_code == 0x00000000)
   {
@@ -397,19 +388,13 @@ float LTC24XX_diff_code_to_voltage(int32_t adc_code, float vref)
   }
 #endif
 
-  adc_code -= 0x20000000;             //! 1) Converts offset binary to binary
-  voltage=(float) adc_code;
-  voltage = voltage / 536870912.0;    //! 2) This calculates the input as a fraction of the reference voltage (dimensionless)
-  voltage = voltage * vref;           //! 3) Multiply fraction by Vref to get the actual voltage at the input (in volts)
-  return(voltage);
+  return(LT_code_to_float(adc_code, 0x20000000, vref / 536870912.0));
 }
 
 // Calculates the voltage corresponding to an adc code, given lsb weight (in volts) and the calibrated
 // adc offset code (zero code that is subtracted from adc_code). For use with the LTC24XX_cal_voltage() function.
 float LTC24XX_diff_code_to_calibrated_voltage(int32_t adc_code, float LTC2449_lsb, int32_t LTC2449_offset_code)
 {
-  float adc_voltage;
-
 #ifndef SKIP_EZDRIVE_2X_ZERO_CHECK
   if (adc_code == 0x00000000)
   {
@@ -417,9 +402,7 @@ float LTC24XX_diff_code_to_calibrated_voltage(int32_t adc_code, float LTC2449_ls
   }
 #endif
 
-  adc_code -= 536870912;                                            //! 1) Converts offset binary to binary
-  adc_voltage=(float)(adc_code+LTC2449_offset_code)*LTC2449_lsb;    //! 2) Calculate voltage from ADC code, lsb, offset.
-  return(adc_voltage);
+  return(LT_code_to_float(adc_code, 536870912 - LTC2449_offset_code, LTC2449_lsb));
 }
 
 
@@ -436,3 +419,174 @@ void LTC24XX_calibrate_voltage(int32_t zero_code, int32_t fs_code, float zero_vo
   temp_offset = (temp_offset > (floor(temp_offset) + 0.5)) ? ceil(temp_offset) : floor(temp_offset);    //! 5) Round
   *LTC24XX_offset_code = (int32_t)temp_offset;                                                          //! 6) Cast as int32_t
 }
+
+// The scan in progress. Only one can run, as there is one EOC interrupt.
+static struct
+{
+  const LTC24XX_scan_channel *channels;   // Channel list
+  LTC24XX_scan_result *ring;              // Ring buffer for the results
+  uint8_t cs;                             // Chip select
+  uint8_t count;                          // Channels in the list
+  uint8_t current;                        // Channel whose conversion is running
+  uint8_t data_bytes;                     // Bytes in the output word
+  uint8_t ring_size;                      // Entries in the ring buffer
+  volatile uint8_t mode;                  // LTC24XX_SCAN_OFF, _POLL or _INTERRUPT
+  volatile uint8_t head;                  // Next entry written
+  volatile uint8_t tail;                  // Next entry read
+  volatile uint16_t overruns;             // Results dropped with the ring buffer full
+} LTC24XX_scan;
+
+// Reads out the conversion that has just ended while sending the command of the
+// next channel, so that its conversion starts as the readout ends, then goes
+// back to watching EOC.
+static void LTC24XX_scan_service()
+{
+  LT_union_int32_4bytes data, command;
+  uint32_t timestamp = micros();
+  uint8_t next = LTC24XX_scan.current + 1;
+  uint8_t head;
+
+  if (next == LTC24XX_scan.count)
+    next = 0;
+  command.LT_uint32 = 0;
+  data.LT_uint32 = 0;
+  command.LT_byte[LTC24XX_scan.data_bytes - 1] = LTC24XX_scan.channels[next].command_high;
+  command.LT_byte[LTC24XX_scan.data_bytes - 2] = LTC24XX_scan.channels[next].command_low;
+  spi_transfer_block(LTC24XX_scan.cs, command.LT_byte, data.LT_byte, LTC24XX_scan.data_bytes);
+  output_low(LTC24XX_scan.cs);          // Watch SDO for the end of the next conversion
+  if (LTC24XX_scan.data_bytes == 3)
+    data.LT_uint32 <<= 8;               // Left-justify, as LTC24XX_SPI_24bit_data() does
+
+  head = LTC24XX_scan.head + 1;
+  if (head == LTC24XX_scan.ring_size)
+    head = 0;
+  if (head == LTC24XX_scan.tail)
+    LTC24XX_scan.overruns++;
+  else
+  {
+    LTC24XX_scan_result *result = &LTC24XX_scan.ring[LTC24XX_scan.head];
+    result->code = data.LT_int32;
+    result->timestamp = timestamp;
+    result->channel = LTC24XX_scan.current;
+    LTC24XX_scan.head = head;
+  }
+  LTC24XX_scan.current = next;
+}
+
+// Replaced by LTC24XX_scan_ISR.h when the sketch installs the pin change interrupt handler
+uint8_t __attribute__((weak)) LTC24XX_scan_isr_installed()
+{
+  return 0;
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+// Called by the PCINT0 handler in LTC24XX_scan_ISR.h
+void LTC24XX_scan_isr()
+{
+  if (LTC24XX_scan.mode == LTC24XX_SCAN_INTERRUPT && input(MISO) == 0)
+  {
+    LTC24XX_scan_service();
+    PCIFR = _BV(PCIF0);                 // Forget the edges of the readout itself
+  }
+}
+#endif
+
+// Waits for the conversion in progress, sends the command of the first channel and starts watching EOC
+int8_t LTC24XX_scan_begin(uint8_t cs, const LTC24XX_scan_channel *channels, uint8_t count, uint8_t data_bytes,
+                          LTC24XX_scan_result *ring, uint8_t ring_size, uint8_t mode, uint16_t eoc_timeout)
+{
+  LTC24XX_scan_end();
+  if (count == 0 || ring_size < 2 || (data_bytes != 3 && data_bytes != 4))
+    return(1);
+#if !defined(ARDUINO_ARCH_AVR)
+  if (mode == LTC24XX_SCAN_INTERRUPT)
+    return(1);
+#endif
+  if (mode == LTC24XX_SCAN_INTERRUPT && !LTC24XX_scan_isr_installed())
+    return(1);
+  if (mode != LTC24XX_SCAN_POLL && mode != LTC24XX_SCAN_INTERRUPT)
+    return(1);
+
+  LTC24XX_scan.channels = channels;
+  LTC24XX_scan.ring = ring;
+  LTC24XX_scan.cs = cs;
+  LTC24XX_scan.count = count;
+  LTC24XX_scan.data_bytes = data_bytes;
+  LTC24XX_scan.ring_size = ring_size;
+  LTC24XX_scan.head = 0;
+  LTC24XX_scan.tail = 0;
+  LTC24XX_scan.overruns = 0;
+
+  if (LTC24XX_EOC_timeout(cs, eoc_timeout))       //! 1) Wait for the conversion in progress
+    return(1);
+  LTC24XX_scan.current = count - 1;               //! 2) Read it out, sending the command of channel 0,
+  LTC24XX_scan_service();                         //!    and throw the result away
+  LTC24XX_scan.head = 0;
+  LTC24XX_scan.overruns = 0;
+
+#if defined(ARDUINO_ARCH_AVR)
+  if (mode == LTC24XX_SCAN_INTERRUPT)             //! 3) Interrupt on any change of MISO
+  {
+    *digitalPinToPCMSK(MISO) |= _BV(digitalPinToPCMSKbit(MISO));
+    PCIFR = _BV(PCIF0);
+    *digitalPinToPCICR(MISO) |= _BV(digitalPinToPCICRbit(MISO));
+  }
+#endif
+  LTC24XX_scan.mode = mode;
+  return(0);
+}
+
+// Stops watching EOC and releases CS
+void LTC24XX_scan_end()
+{
+  if (LTC24XX_scan.mode == LTC24XX_SCAN_OFF)
+    return;
+#if defined(ARDUINO_ARCH_AVR)
+  if (LTC24XX_scan.mode == LTC24XX_SCAN_INTERRUPT)
+    *digitalPinToPCMSK(MISO) &= ~_BV(digitalPinToPCMSKbit(MISO));
+#endif
+  LTC24XX_scan.mode = LTC24XX_SCAN_OFF;
+  output_high(LTC24XX_scan.cs);
+}
+
+// Reads out the channel whose conversion has ended, if any, and starts the next
+uint8_t LTC24XX_scan_poll()
+{
+  if (LTC24XX_scan.mode != LTC24XX_SCAN_POLL || input(MISO) != 0)
+    return(0);
+  LTC24XX_scan_service();
+  return(1);
+}
+
+// Number of results waiting in the ring buffer
+uint8_t LTC24XX_scan_available()
+{
+  uint8_t head = LTC24XX_scan.head;
+  uint8_t tail = LTC24XX_scan.tail;
+  return (head >= tail) ? head - tail : LTC24XX_scan.ring_size - tail + head;
+}
+
+// Takes the oldest result from the ring buffer
+int8_t LTC24XX_scan_read(LTC24XX_scan_result *result)
+{
+  uint8_t tail = LTC24XX_scan.tail;
+
+  if (tail == LTC24XX_scan.head)
+    return(1);
+  *result = LTC24XX_scan.ring[tail];
+  if (++tail == LTC24XX_scan.ring_size)
+    tail = 0;
+  LTC24XX_scan.tail = tail;
+  return(0);
+}
+
+// Number of results dropped because the ring buffer was full
+uint16_t LTC24XX_scan_overruns()
+{
+  uint16_t overruns;
+
+  noInterrupts();
+  overruns = LTC24XX_scan.overruns;
+  interrupts();
+  return(overruns);
+}
@@ -120,6 +120,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef LTC24XX_general_H
 #define LTC24XX_general_H
 
+#include "LT_Convert.h"
+
 //! Define the SPI CS pin
 #ifndef LTC24XX_CS
 #define LTC24XX_CS QUIKEVAL_CS
@@ -429,6 +431,46 @@ float LTC24XX_diff_code_to_calibrated_voltage(int32_t adc_code,               //
     int32_t LTC24XX_offset_code     //!< The calibrated offset code (This is the ADC code zero code that will be subtracted from adc_code)
                                              );
 
+//! Makes the scale from codes of Single-Ended input parts to microvolts, for LT_convert() and LT_convert_array().
+//! @return the scale, worked out by the compiler for a constant vref
+constexpr LT_scale LTC24XX_SE_scale_microvolts(double vref   //!< Reference voltage
+                                              )
+{
+  return LT_make_scale(vref * 1e6 / 268435456.0, 0x20000000);
+}
+
+//! Makes the scale from codes of differential input parts to microvolts, for LTC24XX_diff_code_to_microvolts().
+//! @return the scale, worked out by the compiler for a constant vref
+constexpr LT_scale LTC24XX_diff_scale_microvolts(double vref     //!< Reference voltage
+                                                )
+{
+  return LT_make_scale(vref * 1e6 / 536870912.0, 0x20000000);
+}
+
+//! Makes the scale from codes of differential input parts to microvolts with the lsb weight and offset code
+//! of LTC24XX_calibrate_voltage(), for LTC24XX_diff_code_to_microvolts(). Make it once after calibrating.
+//! @return the scale
+constexpr LT_scale LTC24XX_calibrated_scale_microvolts(double LTC24XX_lsb,          //!< LSB weight (in volts)
+    int32_t LTC24XX_offset_code  //!< The calibrated offset code
+                                                      )
+{
+  return LT_make_scale(LTC24XX_lsb * 1e6, 0x20000000 - LTC24XX_offset_code);
+}
+
+//! Converts a code of a differential input part to microvolts, with the same 2X mode zero
+//! correction as LTC24XX_diff_code_to_voltage(). LT_convert_array() does not apply the correction.
+//! @return the input in microvolts
+inline int32_t LTC24XX_diff_code_to_microvolts(int32_t adc_code,        //!< Code read from ADC
+    const LT_scale *scale    //!< Scale from LTC24XX_diff_scale_microvolts() or LTC24XX_calibrated_scale_microvolts()
+                                              )
+{
+#ifndef SKIP_EZDRIVE_2X_ZERO_CHECK
+  if (adc_code == 0x00000000)
+    adc_code = 0x20000000;
+#endif
+  return LT_convert(adc_code, scale);
+}
+
 //! Calculate the lsb weight and offset code given a full-scale code and a measured zero-code.
 //! @return Void
 void LTC24XX_calibrate_voltage(int32_t zero_code,             //!< Measured code with the inputs shorted to ground
@@ -439,6 +481,93 @@ void LTC24XX_calibrate_voltage(int32_t zero_code,             //!< Measured code
                                int32_t *LTC24XX_offset_code   //!< Overwritten with offset code (zero code)
                               );
 
+/*! @name Channel Scan
+@verbatim
+Sweeps a list of channels of a multi-channel SPI part (LTC2418, LTC2449,
+LTC2498 and the like) back to back. Each channel has its own command, so
+OSR, speed and gain can differ from channel to channel. The command for the
+next channel is sent while the result of the current one is read out, so a
+new conversion starts the moment the last one is read, and the end of each
+conversion is seen within microseconds, either by a pin change interrupt on
+MISO or by LTC24XX_scan_poll(). Results go into a ring buffer given by the
+caller, each with the channel's index in the list and the micros() time its
+conversion ended.
+
+The pin change interrupt handler is not part of the library, so sketches that
+use PCINT0 for something else still link. Including LTC24XX_scan_ISR.h in one
+file of the sketch installs it; without it LTC24XX_SCAN_INTERRUPT is refused.
+
+CS is held low between readouts to watch EOC on SDO, so nothing else may use
+the SPI or I2C port of the QuikEval connector while a scan runs. 2X speed
+modes, which add a cycle of latency, are not supported.
+
+Example, three channels of an LTC2449 at different OSRs:
+  LTC24XX_scan_channel channels[3] = {{LTC24XX_MULTI_CH_CH0, LTC24XX_MULTI_CH_OSR_32768},
+                                      {LTC24XX_MULTI_CH_CH1, LTC24XX_MULTI_CH_OSR_256},
+                                      {LTC24XX_MULTI_CH_P2_N3, LTC24XX_MULTI_CH_OSR_2048}};
+  LTC24XX_scan_result ring[16];
+  LTC24XX_scan_begin(LTC24XX_CS, channels, 3, 4, ring, 16, LTC24XX_SCAN_INTERRUPT, 250);
+@endverbatim
+@{ */
+#define LTC24XX_SCAN_OFF        0   //!< No scan running
+#define LTC24XX_SCAN_POLL       1   //!< EOC seen by LTC24XX_scan_poll()
+#define LTC24XX_SCAN_INTERRUPT  2   //!< EOC seen by a pin change interrupt on MISO (AVR only, needs LTC24XX_scan_ISR.h)
+
+//! One channel of a scan
+typedef struct
+{
+  uint8_t command_high;     //!< First command byte: the channel
+  uint8_t command_low;      //!< Second command byte: OSR and speed, or rejection, gain and speed; 0 for parts with an 8 bit command
+} LTC24XX_scan_channel;
+
+//! One conversion of a scan
+typedef struct
+{
+  int32_t code;             //!< Code as the LTC24XX_SPI_16bit_command_32bit_data() family returns it
+  uint32_t timestamp;       //!< micros() when the end of the conversion was seen
+  uint8_t channel;          //!< Index of the channel in the list given to LTC24XX_scan_begin()
+} LTC24XX_scan_result;
+
+//! Waits for the conversion in progress, sends the command of the first channel
+//! and starts watching EOC. A scan already running is ended first.
+//! @return 0=successful, 1=unsuccessful (exceeded timeout or bad arguments)
+int8_t LTC24XX_scan_begin(uint8_t cs,                             //!< Chip Select pin
+                          const LTC24XX_scan_channel *channels,   //!< Channel list, kept by the caller while the scan runs
+                          uint8_t count,                          //!< Number of channels in the list
+                          uint8_t data_bytes,                     //!< 4 for parts with a 32 bit output word, 3 for 24 bit
+                          LTC24XX_scan_result *ring,              //!< Ring buffer for the results, kept by the caller while the scan runs
+                          uint8_t ring_size,                      //!< Entries in the ring buffer, one is always left free
+                          uint8_t mode,                           //!< LTC24XX_SCAN_POLL or LTC24XX_SCAN_INTERRUPT
+                          uint16_t eoc_timeout                    //!< Timeout for the first conversion (in milliseconds)
+                         );
+
+//! Stops watching EOC and releases CS. Results not yet read stay in the ring buffer.
+void LTC24XX_scan_end();
+
+//! Reads out the channel whose conversion has ended, if any, and starts the next.
+//! Call it as often as possible in LTC24XX_SCAN_POLL mode; it does nothing in interrupt mode.
+//! @return 1 if a result was added to the ring buffer, 0 if not
+uint8_t LTC24XX_scan_poll();
+
+//! @return the number of results waiting in the ring buffer
+uint8_t LTC24XX_scan_available();
+
+//! Takes the oldest result from the ring buffer
+//! @return 0=successful, 1=unsuccessful (ring buffer empty)
+int8_t LTC24XX_scan_read(LTC24XX_scan_result *result     //!< Overwritten with the result
+                        );
+
+//! @return the number of results dropped because the ring buffer was full
+uint16_t LTC24XX_scan_overruns();
+
+//! @return 1 if LTC24XX_scan_ISR.h installed the pin change interrupt handler, 0 if not
+uint8_t LTC24XX_scan_isr_installed();
+
+//! Reads out the channel whose conversion has ended in LTC24XX_SCAN_INTERRUPT mode.
+//! Called by the pin change interrupt handler in LTC24XX_scan_ISR.h.
+void LTC24XX_scan_isr();
+/*! @} */
+
 
 
 // I2C Addresses for 8/16 channel parts (LTC2495/7/9)
@@ -0,0 +1,73 @@
+/*!
+LTC24XX_scan_ISR: Installs the pin change interrupt handler for LTC24XX_SCAN_INTERRUPT scans.
+
+@verbatim
+
+Include this file in exactly one file of a sketch (normally the .ino) to let
+LTC24XX_scan_begin() run a scan in LTC24XX_SCAN_INTERRUPT mode. Without it,
+interrupt mode is refused and only LTC24XX_SCAN_POLL is available.
+
+Do not include it in a sketch that uses pin change interrupt 0 for something
+else, such as SoftwareSerial or a pin change library, which install their own
+PCINT0 handler.
+
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LTC24XX_general
+    Installs the pin change interrupt handler for LTC24XX_general scans.
+*/
+
+#ifndef LTC24XX_SCAN_ISR_H
+#define LTC24XX_SCAN_ISR_H
+
+#include <avr/interrupt.h>
+#include "LTC24XX_general.h"
+
+//! Tells LTC24XX_scan_begin() that interrupt mode can be used
+uint8_t LTC24XX_scan_isr_installed()
+{
+  return 1;
+}
+
+//! Pin change interrupt 0: MISO is on port B on all Linduino compatible boards
+ISR(PCINT0_vect)
+{
+  LTC24XX_scan_isr();
+}
+
+#endif  // LTC24XX_SCAN_ISR_H
@@ -71,6 +71,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <Wire.h>
 #include <stdint.h>
 #include <SPI.h>
+#include "LT_Stream.h"
+#include "LTC2508.h"
 
 // Calculates the output voltage from the given digital code and reference voltage
 float LTC2508_code_to_voltage(int32_t code, float vref)
@@ -94,6 +96,24 @@ void send_pulses(uint8_t pin, uint16_t num_of_pulses)
   output_low(pin);                        // Leave CS low
 }
 
+// Decodes the DF from the W7:W0 byte read after the data
+static uint16_t LTC2508_decode_DF(uint8_t w)
+{
+  switch (w)
+  {
+    case 0x85:
+      return 256;
+    case 0xA5:
+      return 1024;
+    case 0xC5:
+      return 4096;
+    case 0xE5:
+      return 16384;
+    default:
+      return 0;
+  }
+}
+
 // Reads 5 bytes of data on SPI - D31:D0 + W7:W0
 uint32_t LTC2508_read_data(uint8_t QUIKEVAL_CS, uint16_t *DF)
 {
@@ -109,22 +129,28 @@ uint32_t LTC2508_read_data(uint8_t QUIKEVAL_CS, uint16_t *DF)
   code = (code << 8) | rx[2];
   code = (code << 8) | rx[1];
 
-  switch (rx[0])
-  {
-    case 0x85:
-      *DF = 256;
-      break;
-    case 0xA5:
-      *DF = 1024;
-      break;
-    case 0xC5:
-      *DF = 4096;
-      break;
-    case 0xE5:
-      *DF = 16384;
-      break;
-    default:
-      *DF = 0;
-  }
+  *DF = LTC2508_decode_DF(rx[0]);
   return code;
-}
\ No newline at end of file
+}
+
+// Sends a SYNC pulse, then streams one sample every DF MCLK pulses
+int8_t LTC2508_stream_begin(uint32_t mclk_hz, uint16_t DF)
+{
+  output_low(MCLK_pin);
+  pinMode(LTC2508_SYNC, OUTPUT);
+  digitalWrite(LTC2508_SYNC, HIGH);     // Restarts the filter, so its outputs line up with the reads
+  digitalWrite(LTC2508_SYNC, LOW);
+  return lt_stream_begin(mclk_hz, DF, 5);
+}
+
+// Takes the oldest sample out of the ring
+int8_t LTC2508_stream_read(int32_t *code, uint16_t *DF)
+{
+  uint8_t frame[5];
+
+  if (lt_stream_read(frame))
+    return 1;
+  *code = ((uint32_t)frame[0] << 24) | ((uint32_t)frame[1] << 16) | ((uint16_t)frame[2] << 8) | frame[3];
+  *DF = LTC2508_decode_DF(frame[4]);
+  return 0;
+}
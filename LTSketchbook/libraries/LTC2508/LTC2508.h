@@ -66,6 +66,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DF_4096      0x8200
 #define CONFIG_DF_16384     0x8600
 
+#ifndef LTC2508_SYNC
+#define LTC2508_SYNC      QUIKEVAL_GPIO   //!< Pin connected to SYNC
+#endif
+
 #define CS_LOW          0x00
 #define CS_HIGH         0x08
 
@@ -78,4 +82,14 @@ void send_pulses(uint8_t pin, uint16_t num_of_pulses);
 //! Reads 5 bytes of data on SPI - D31:D0 + W7:W0
 uint32_t LTC2508_read_data(uint8_t QUIKEVAL_CS, uint16_t *DF);
 
+//! Sends a SYNC pulse, then drives MCLK from Timer1 on MCLK_pin and reads one filtered
+//! sample every DF MCLK pulses into the LT_Stream ring. The DF must already be set through
+//! the sneaker port, and SPI enabled. Use LT_Stream for the rates, overruns and lt_stream_end().
+//! @return 0 on success, 1 if the rates cannot be made by the timers
+int8_t LTC2508_stream_begin(uint32_t mclk_hz, uint16_t DF);
+
+//! Takes the oldest sample out of the LT_Stream ring, and the DF it was filtered with.
+//! @return 0 on success, 1 if there is no sample yet
+int8_t LTC2508_stream_read(int32_t *code, uint16_t *DF);
+
 #endif
\ No newline at end of file
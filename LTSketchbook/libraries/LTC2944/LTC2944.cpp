@@ -120,50 +120,37 @@ int8_t LTC2944_read_16_bits(uint8_t i2c_address, uint8_t adc_command, uint16_t *
 float LTC2944_code_to_coulombs(uint16_t adc_code, float resistor, uint16_t prescalar)
 // The function converts the 16-bit RAW adc_code to Coulombs
 {
-  float coulomb_charge;
-  coulomb_charge =  1000*(float)(adc_code*LTC2944_CHARGE_lsb*prescalar*50E-3)/(resistor*4096);
-  coulomb_charge = coulomb_charge*3.6f;
-  return(coulomb_charge);
+  return(LT_code_to_float(adc_code, 0, 1000*(LTC2944_CHARGE_lsb*prescalar*50E-3)/(resistor*4096)*3.6f));
 }
 
 float LTC2944_code_to_mAh(uint16_t adc_code, float resistor, uint16_t prescalar )
 // The function converts the 16-bit RAW adc_code to mAh
 {
-  float mAh_charge;
-  mAh_charge = 1000*(float)(adc_code*LTC2944_CHARGE_lsb*prescalar*50E-3)/(resistor*4096);
-  return(mAh_charge);
+  return(LT_code_to_float(adc_code, 0, 1000*(LTC2944_CHARGE_lsb*prescalar*50E-3)/(resistor*4096)));
 }
 
 float LTC2944_code_to_voltage(uint16_t adc_code)
 // The function converts the 16-bit RAW adc_code to Volts
 {
-  float voltage;
-  voltage = ((float)adc_code/(65535))*LTC2944_FULLSCALE_VOLTAGE;
-  return(voltage);
+  return(LT_code_to_float(adc_code, 0, LTC2944_FULLSCALE_VOLTAGE/65535));
 }
 
 float LTC2944_code_to_current(uint16_t adc_code, float resistor)
 // The function converts the 16-bit RAW adc_code to Amperes
 {
-  float current;
-  current = (((float)adc_code-32767)/(32767))*((float)(LTC2944_FULLSCALE_CURRENT)/resistor);
-  return(current);
+  return(LT_code_to_float(adc_code, 32767, LTC2944_FULLSCALE_CURRENT/resistor/32767));
 }
 
 float LTC2944_code_to_kelvin_temperature(uint16_t adc_code)
 // The function converts the 16-bit RAW adc_code to Kelvin
 {
-  float temperature;
-  temperature = adc_code*((float)(LTC2944_FULLSCALE_TEMPERATURE)/65535);
-  return(temperature);
+  return(LT_code_to_float(adc_code, 0, LTC2944_FULLSCALE_TEMPERATURE/65535));
 }
 
 float LTC2944_code_to_celcius_temperature(uint16_t adc_code)
 // The function converts the 16-bit RAW adc_code to Celcius
 {
-  float temperature;
-  temperature = adc_code*((float)(LTC2944_FULLSCALE_TEMPERATURE)/65535) - 273.15;
-  return(temperature);
+  return(LT_code_to_float(adc_code, 0, LTC2944_FULLSCALE_TEMPERATURE/65535) - 273.15);
 }
 
 // Used to set and clear bits in a control register.  bits_to_set will be bitwise OR'd with the register.
@@ -77,6 +77,7 @@ Read charge, current, and voltage.
 #define LTC2944_H
 
 #include <Wire.h>
+#include "LT_Convert.h"
 
 
 /*!
@@ -211,13 +212,13 @@ Read charge, current, and voltage.
 */
 /*! @name Conversion Constants
 @{ */
-const float LTC2944_CHARGE_lsb = 0.34E-3;
-const float LTC2944_VOLTAGE_lsb = 1.068E-3;
-const float LTC2944_CURRENT_lsb = 29.3E-6;
-const float LTC2944_TEMPERATURE_lsb = 0.25;
-const float LTC2944_FULLSCALE_VOLTAGE = 70;
-const float LTC2944_FULLSCALE_CURRENT = 60E-3;
-const float LTC2944_FULLSCALE_TEMPERATURE = 510;
+constexpr float LTC2944_CHARGE_lsb = 0.34E-3;
+constexpr float LTC2944_VOLTAGE_lsb = 1.068E-3;
+constexpr float LTC2944_CURRENT_lsb = 29.3E-6;
+constexpr float LTC2944_TEMPERATURE_lsb = 0.25;
+constexpr float LTC2944_FULLSCALE_VOLTAGE = 70;
+constexpr float LTC2944_FULLSCALE_CURRENT = 60E-3;
+constexpr float LTC2944_FULLSCALE_TEMPERATURE = 510;
 //! @}
 
 //! @}
@@ -288,4 +289,51 @@ float LTC2944_code_to_kelvin_temperature(uint16_t adc_code           //!< The RA
 float LTC2944_code_to_celcius_temperature(uint16_t adc_code          //!< The RAW ADC value
                                          );
 
+//! Makes the scale from ACR codes to microamp hours, for LT_convert() and LT_convert_array_u16().
+//! @return the scale, worked out by the compiler for a constant resistor and prescalar
+constexpr LT_scale LTC2944_charge_scale_microamp_hours(double resistor,      //!< The sense resistor value
+    uint16_t prescalar    //!< The prescalar value
+                                                      )
+{
+  return LT_make_scale(1e6 * LTC2944_CHARGE_lsb * prescalar * 50E-3 / (resistor * 4096));
+}
+
+//! Makes the scale from ACR codes to millicoulombs, for LT_convert() and LT_convert_array_u16().
+//! @return the scale, worked out by the compiler for a constant resistor and prescalar
+constexpr LT_scale LTC2944_charge_scale_millicoulombs(double resistor,       //!< The sense resistor value
+    uint16_t prescalar     //!< The prescalar value
+                                                     )
+{
+  return LT_make_scale(3.6e6 * LTC2944_CHARGE_lsb * prescalar * 50E-3 / (resistor * 4096));
+}
+
+//! Makes the scale from voltage codes to microvolts, for LT_convert() and LT_convert_array_u16().
+//! @return the scale
+constexpr LT_scale LTC2944_voltage_scale_microvolts()
+{
+  return LT_make_scale(LTC2944_FULLSCALE_VOLTAGE * 1e6 / 65535);
+}
+
+//! Makes the scale from current codes to microamps, for LT_convert() and LT_convert_array_u16().
+//! @return the scale, worked out by the compiler for a constant resistor
+constexpr LT_scale LTC2944_current_scale_microamps(double resistor     //!< The sense resistor value
+                                                  )
+{
+  return LT_make_scale(LTC2944_FULLSCALE_CURRENT * 1e6 / resistor / 32767, 32767);
+}
+
+//! Makes the scale from temperature codes to millikelvin, for LT_convert() and LT_convert_array_u16().
+//! @return the scale
+constexpr LT_scale LTC2944_temperature_scale_millikelvin()
+{
+  return LT_make_scale(LTC2944_FULLSCALE_TEMPERATURE * 1e3 / 65535);
+}
+
+//! Makes the scale from temperature codes to thousandths of a degree Celcius, for LT_convert() and LT_convert_array_u16().
+//! @return the scale
+constexpr LT_scale LTC2944_temperature_scale_millicelcius()
+{
+  return LT_make_scale(LTC2944_FULLSCALE_TEMPERATURE * 1e3 / 65535, 0, -273150);
+}
+
 #endif  // LTC2944_H
@@ -194,38 +194,28 @@ int8_t LTC2946_read_32_bits(uint8_t i2c_address, uint8_t adc_command, uint32_t *
 float LTC2946_VIN_code_to_voltage(uint16_t adc_code, float LTC2946_VIN_lsb)
 // Returns the VIN Voltage in Volts
 {
-  float voltage;
-  voltage = (float)adc_code*LTC2946_VIN_lsb;    //! 1) Calculate voltage from code and lsb
-  return(voltage);
+  return(LT_code_to_float(adc_code, 0, LTC2946_VIN_lsb));
 }
 
 // Calculate the LTC2946 ADIN voltage
 float LTC2946_ADIN_code_to_voltage(uint16_t adc_code, float LTC2946_ADIN_lsb)
 // Returns the ADIN Voltage in Volts
 {
-  float adc_voltage;
-  adc_voltage = (float)adc_code*LTC2946_ADIN_lsb;   //! 1) Calculate voltage from code and ADIN lsb
-  return(adc_voltage);
+  return(LT_code_to_float(adc_code, 0, LTC2946_ADIN_lsb));
 }
 
 // Calculate the LTC2946 current with a sense resistor
 float LTC2946_code_to_current(uint16_t adc_code, float resistor, float LTC2946_DELTA_SENSE_lsb)
 // Returns the LTC2946 current in Amps
 {
-  float voltage, current;
-  voltage = (float)adc_code*LTC2946_DELTA_SENSE_lsb;    //! 1) Calculate voltage from ADC code and delta sense lsb
-  current = voltage/resistor;                           //! 2) Calculate current, I = V/R
-  return(current);
+  return(LT_code_to_float(adc_code, 0, LTC2946_DELTA_SENSE_lsb / resistor));
 }
 
 // Calculate the LTC2946 power
 float LTC2946_code_to_power(int32_t adc_code, float resistor, float LTC2946_Power_lsb)
 // Returns The LTC2946 power in Watts
 {
-  float power;
-  power = (float)adc_code*LTC2946_Power_lsb/resistor;  //! 1) Calculate Power using Power lsb and resistor
-
-  return(power);
+  return(LT_code_to_float(adc_code, 0, LTC2946_Power_lsb / resistor));
 }
 
 
@@ -233,20 +223,14 @@ float LTC2946_code_to_power(int32_t adc_code, float resistor, float LTC2946_Powe
 float LTC2946_code_to_energy(int32_t adc_code,float resistor, float LTC2946_Power_lsb, float LTC2946_TIME_lsb)
 // Returns the LTC2946 energy in Joules
 {
-  float energy_lsb, energy;
-  energy_lsb=(float)(LTC2946_Power_lsb/resistor)*65536*LTC2946_TIME_lsb;   //! 1) Calculate Energy lsb from Power lsb and Time lsb
-  energy = adc_code*energy_lsb;                               //! 2) Calculate Energy using Energy lsb and adc code
-  return(energy);
+  return(LT_code_to_float(adc_code, 0, (LTC2946_Power_lsb/resistor)*65536*LTC2946_TIME_lsb));
 }
 
 // Calculate the LTC2946 Coulombs
 float LTC2946_code_to_coulombs(int32_t adc_code, float resistor, float LTC2946_DELTA_SENSE_lsb, float LTC2946_TIME_lsb)
 // Returns the LTC2946 Coulombs
 {
-  float coulomb_lsb, coulombs;
-  coulomb_lsb=(float)(LTC2946_DELTA_SENSE_lsb/resistor)*16*LTC2946_TIME_lsb;   //! 1) Calculate Coulomb lsb Current lsb and Time lsb
-  coulombs = adc_code*coulomb_lsb;                                             //! 2) Calculate Coulombs using Coulomb lsb and adc code
-  return(coulombs);
+  return(LT_code_to_float(adc_code, 0, (LTC2946_DELTA_SENSE_lsb/resistor)*16*LTC2946_TIME_lsb));
 }
 
 //Calculate the LTC2946 Time in Seconds
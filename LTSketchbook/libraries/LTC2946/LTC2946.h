@@ -127,6 +127,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LTC2946_H
 
 #include <Wire.h>
+#include "LT_Convert.h"
 
 //! Use table to select address
 /*!
@@ -682,4 +683,53 @@ float LTC2946_code_to_time(float time_code,             //!< Time adc code
                           );
 
 
+//! Makes the scale from VIN or ADIN codes to microvolts, for LT_convert() and LT_convert_array_u16().
+//! @return the scale, worked out by the compiler for a constant lsb
+constexpr LT_scale LTC2946_voltage_scale_microvolts(double LTC2946_lsb    //!< VIN or ADIN lsb weight
+                                                   )
+{
+  return LT_make_scale(LTC2946_lsb * 1e6);
+}
+
+//! Makes the scale from DELTA_SENSE codes to microamps, for LT_convert() and LT_convert_array_u16().
+//! @return the scale, worked out by the compiler for a constant resistor and lsb
+constexpr LT_scale LTC2946_current_scale_microamps(double resistor,                 //!< Resistor value
+    double LTC2946_DELTA_SENSE_lsb   //!< Delta sense lsb weight
+                                                  )
+{
+  return LT_make_scale(LTC2946_DELTA_SENSE_lsb / resistor * 1e6);
+}
+
+//! Makes the scale from POWER codes to microwatts, for LT_convert() and LT_convert_array().
+//! The full scale power, 2^24 codes, must be below 2147W.
+//! @return the scale, worked out by the compiler for a constant resistor and lsb
+constexpr LT_scale LTC2946_power_scale_microwatts(double resistor,            //!< Resistor value
+    double LTC2946_Power_lsb    //!< Power lsb weight
+                                                 )
+{
+  return LT_make_scale(LTC2946_Power_lsb / resistor * 1e6);
+}
+
+//! Makes the scale from ENERGY codes to millijoules, for LT_convert() and LT_convert_array().
+//! The result fits in 32 bits up to 2147kJ.
+//! @return the scale, worked out by the compiler for constant arguments
+constexpr LT_scale LTC2946_energy_scale_millijoules(double resistor,            //!< Resistor value
+    double LTC2946_Power_lsb,   //!< Power lsb weight
+    double LTC2946_TIME_lsb     //!< Time lsb weight
+                                                   )
+{
+  return LT_make_scale(LTC2946_Power_lsb / resistor * 65536 * LTC2946_TIME_lsb * 1e3);
+}
+
+//! Makes the scale from CHARGE codes to millicoulombs, for LT_convert() and LT_convert_array().
+//! The result fits in 32 bits up to 2147kC.
+//! @return the scale, worked out by the compiler for constant arguments
+constexpr LT_scale LTC2946_charge_scale_millicoulombs(double resistor,                  //!< Resistor value
+    double LTC2946_DELTA_SENSE_lsb,   //!< Delta sense lsb weight
+    double LTC2946_TIME_lsb           //!< Time lsb weight
+                                                     )
+{
+  return LT_make_scale(LTC2946_DELTA_SENSE_lsb / resistor * 16 * LTC2946_TIME_lsb * 1e3);
+}
+
 #endif  // LTC2946_H
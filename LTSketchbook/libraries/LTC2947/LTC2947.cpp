@@ -81,16 +81,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 boolean LTC2947_SPI_Mode_Enabled = false;
 uint8_t LTC2947_I2C_Slave_Addr = LTC2947_I2C_ADDR_LL;
+uint8_t LTC2947_Page_Shadow = LTC2947_PAGE_UNKNOWN;
 
 void LTC2947_InitI2C(uint8_t slvAddr)
 {
   LTC2947_SPI_Mode_Enabled = false;
   LTC2947_I2C_Slave_Addr = slvAddr;
+  LTC2947_Page_Shadow = LTC2947_PAGE_UNKNOWN;
 }
 
 void LTC2947_InitSPI()
 {
   LTC2947_SPI_Mode_Enabled = true;
+  LTC2947_Page_Shadow = LTC2947_PAGE_UNKNOWN;
 }
 
 boolean LTC2947_Abs(uint8_t *bytes, uint8_t length)
@@ -246,20 +249,27 @@ void LTC2947_DoubleToBytes_Test()
 
 double LTC2947_SignedBytesToDouble(uint8_t *signedBytes, uint8_t length, double lsb)
 {
-  // reserve memory for unsigned bytes
-  uint8_t *unsignedBytes = (uint8_t *)malloc(length);
-  // copy signed bytes to unsigned bytes
-  memcpy(unsignedBytes, signedBytes, length);
-  // calculate absolute value of the signed bytes and store sign
-  // this function will change the unsigned bytes, for this reason
-  // we copied the original unsigned bytes to a new array
-  boolean sign = LTC2947_Abs(unsignedBytes, length);
-  // convert the unsigned bytes to a double value
-  double absDouble = LTC2947_UnsignedBytesToDouble(unsignedBytes, length, lsb);
-  // free the allocated memory of the copied array
-  free(unsignedBytes);
-  // recover the previously stored sign to return a signed value
-  return sign ? -absDouble : absDouble;
+  // NOTE: as for LTC2947_UnsignedBytesToDouble the returned value will not
+  // reflect the full precission of 48-bit values, use LTC2947_AccuToUnits instead
+  double ret = (int8_t)(*signedBytes); // MSB carries the sign!
+
+  while (length > 1)
+  {
+    signedBytes++; // go to next byte
+    length--;
+    ret = ret * 256.0 + (*signedBytes); // lower bytes are unsigned
+  }
+  return ret*lsb;
+}
+
+int64_t LTC2947_6BytesToInt64(byte *bytes)
+{
+  // sign extension by the MSB
+  int64_t ret = (int8_t)(*bytes);
+
+  for (uint8_t i = 1; i < 6; i++)
+    ret = ret * 256 + bytes[i];
+  return ret;
 }
 
 int32_t LTC2947_4BytesToInt32(byte *bytes)
@@ -569,6 +579,7 @@ int16_t LTC2947_wake_up()
   byte data[1];
   unsigned long wakeupStart = millis(), wakeupTime;
   LTC2947_WR_BYTE(LTC2947_REG_OPCTL, 0);//! any serial transaction will wakeup LTC2947
+  LTC2947_Page_Shadow = LTC2947_PAGE_UNKNOWN; //! page may have changed while in shutdown
   do
   {
     delay(1);
@@ -592,31 +603,108 @@ boolean LTC2947_GetCurrentPageSelect()
 {
   uint8_t currentPageCtrl;
   LTC2947_RD_BYTE(LTC2947_REG_PGCTL, &currentPageCtrl);
-  return bitMaskSetChk(currentPageCtrl, LTC2947_BM_PGCTL_PAGE);
+  boolean page = bitMaskSetChk(currentPageCtrl, LTC2947_BM_PGCTL_PAGE);
+  LTC2947_Page_Shadow = page;
+  return page;
 }
 
 void LTC2947_SetPageSelect(boolean page)
 {
   LTC2947_WR_BYTE(LTC2947_REG_PGCTL, page ? LTC2947_BM_PGCTL_PAGE : 0); // switch page
+  LTC2947_Page_Shadow = page;
+}
+
+void LTC2947_EnsurePageSelect(boolean page)
+{
+  if (LTC2947_Page_Shadow != (uint8_t)page)
+    LTC2947_SetPageSelect(page);
+}
+
+//! Where a result lies in the register map and how it is scaled
+typedef struct
+{
+  uint8_t address;  //!< Register address of the MSB (page 0)
+  uint8_t width;    //!< Number of bytes, MSB first
+  boolean sig;      //!< True for signed value, false for unsigned
+  float lsb;        //!< LSB in A, W, V or degree celcius
+  float offset;     //!< Added after scaling
+} LTC2947_Snapshot_Field;
+
+//! Decode table of the results, indexed by LTC2947_Snapshot_Value
+//! Note: definitions in LTC2947.h are given in mA, mW, mV
+static const LTC2947_Snapshot_Field LTC2947_snapshot_fields[LTC2947_SNAPSHOT_VALUES] =
+{
+  {LTC2947_VAL_I, 3, true, LTC2947_LSB_I * 1e-3, 0.0},
+  {LTC2947_VAL_P, 3, true, LTC2947_LSB_P * 1e-3, 0.0},
+  {LTC2947_VAL_V, 2, true, LTC2947_LSB_V * 1e-3, 0.0},
+  {LTC2947_VAL_TEMP, 2, true, LTC2947_LSB_TEMP, LTC2947_OFFS_TEMP},
+  {LTC2947_VAL_VDVCC, 2, true, LTC2947_LSB_VDVCC * 1e-3, 0.0}
+};
+
+//! Decodes all results of the table out of a block read starting at register start
+static void LTC2947_DecodeSnapshot(byte *bytes, uint8_t start, int32_t *value)
+{
+  for (uint8_t i = 0; i < LTC2947_SNAPSHOT_VALUES; i++)
+  {
+    const LTC2947_Snapshot_Field *field = &LTC2947_snapshot_fields[i];
+    byte *msb = bytes + (field->address - start);
+
+    // sign extension by the MSB, lower bytes are unsigned
+    int32_t ret = field->sig ? (int8_t)(*msb) : *msb;
+    for (uint8_t j = 1; j < field->width; j++)
+      ret = ret * 256 + msb[j];
+    value[i] = ret;
+  }
+}
+
+//! Scales a decoded result with the LSB and offset of the table
+static float LTC2947_ValueToFloat(int32_t value, uint8_t index)
+{
+  return value * LTC2947_snapshot_fields[index].lsb + LTC2947_snapshot_fields[index].offset;
+}
+
+float LTC2947_SnapshotToFloat(const LTC2947_Snapshot *snap, uint8_t index)
+{
+  return LTC2947_ValueToFloat(snap->value[index], index);
+}
+
+int8_t LTC2947_Read_Snapshot(LTC2947_Snapshot *snap, boolean accus)
+{
+  // byte array to store register values
+  byte bytes[LTC2947_SNAPSHOT_LENGTH];
+
+  // all results are on page 0
+  LTC2947_EnsurePageSelect(false);
+
+  // read STATUS to STATVDVCC, I[23:0] P[23:0] and V[15:0] TEMP[15:0] VDVCC[15:0] at once
+  if (LTC2947_RD_BYTES(LTC2947_SNAPSHOT_START, sizeof(bytes), bytes) != 0)
+    return 1;
+
+  memcpy(snap->status, bytes, sizeof(snap->status));
+  LTC2947_DecodeSnapshot(bytes, LTC2947_SNAPSHOT_START, snap->value);
+
+  if (accus)
+    return LTC2947_Read_All_Accus(&snap->accu1, &snap->accu2);
+  return 0;
 }
 
 void LTC2947_Read_I_P_V_TEMP_VCC(float *I, float *P, float *V, float *TEMP, float *VCC)
 {
   // byte array to store register values
-  byte bytes[12];
+  byte bytes[LTC2947_VAL_VDVCC + 2 - LTC2947_VAL_I];
+  int32_t value[LTC2947_SNAPSHOT_VALUES];
 
-  // read measurement results from device
-  LTC2947_RD_BYTES(LTC2947_VAL_I, 6, bytes);      // I[23:0] P[23:0] starting at data[0]
-  LTC2947_RD_BYTES(LTC2947_VAL_V, 6, bytes + 6);  // V[15:0] TEMP[15:0] VDVCC[15:0] starting at data[6]
+  // read measurement results from device in one block:
+  // I[23:0] P[23:0] starting at data[0], V[15:0] TEMP[15:0] VDVCC[15:0] starting at data[16]
+  LTC2947_RD_BYTES(LTC2947_VAL_I, sizeof(bytes), bytes);
+  LTC2947_DecodeSnapshot(bytes, LTC2947_VAL_I, value);
 
   // convert to floating point values
-  // Note: definitions in LTC2947.h are given in mA, mW, mV
-  // so they have to be mutliplied by 1e-3 to get A, W, V respectively
-  *I = LTC2947_3BytesToInt32(bytes) * LTC2947_LSB_I * 1e-3;                            // calc current in amps
-  *P = LTC2947_3BytesToInt32(bytes + 3) * LTC2947_LSB_P * 1e-3;                        // calc power in watts
-  *V = LTC2947_2BytesToInt16(bytes + 6) * LTC2947_LSB_V * 1e-3;                        // calc voltage in volts
-  *TEMP = LTC2947_2BytesToInt16(bytes + 6 + 2) * LTC2947_LSB_TEMP + LTC2947_OFFS_TEMP; // calc temperature in degree celcius
-  *VCC = LTC2947_2BytesToInt16(bytes + 6 + 4) * LTC2947_LSB_VDVCC * 1e-3;              // calc supply voltage in volts
+  *I = LTC2947_ValueToFloat(value[LTC2947_SNAPSHOT_I], LTC2947_SNAPSHOT_I);  // calc current in amps
+  *P = LTC2947_ValueToFloat(value[LTC2947_SNAPSHOT_P], LTC2947_SNAPSHOT_P);  // calc power in watts
+  *V = LTC2947_ValueToFloat(value[LTC2947_SNAPSHOT_V], LTC2947_SNAPSHOT_V);  // calc voltage in volts
+  *TEMP = LTC2947_ValueToFloat(value[LTC2947_SNAPSHOT_TEMP], LTC2947_SNAPSHOT_TEMP);  // calc temperature in degree celcius
+  *VCC = LTC2947_ValueToFloat(value[LTC2947_SNAPSHOT_VDVCC], LTC2947_SNAPSHOT_VDVCC);  // calc supply voltage in volts
 }
 
 void LTC2947_Read_Abs_C_E_TB(boolean accuSet1, double *C, boolean *signC, double *E, boolean *signE, double *TB)
@@ -647,24 +735,61 @@ void LTC2947_Read_Abs_C_E_TB(boolean accuSet1, double *C, boolean *signC, double
 }
 
 void LTC2947_Read_C_E_TB(boolean accuSet1, double *C, double *E, double *TB)
+{
+  LTC2947_Accus accu;
+
+  // read measurement results from device
+  LTC2947_Read_Accus(accuSet1, &accu);
+
+  // convert counts to double values in As, Ws and s
+  *C = accu.C * LTC2947_LSB_C1;
+  *E = accu.E * LTC2947_LSB_E1;
+  *TB = accu.TB * LTC2947_LSB_TB1;
+}
+
+//! Decodes C[47:0] E[47:0] TB[31:0] of one accumulator set
+static void LTC2947_BytesToAccus(byte *bytes, LTC2947_Accus *accu)
+{
+  accu->C = LTC2947_6BytesToInt64(bytes);
+  accu->E = LTC2947_6BytesToInt64(bytes + 6);
+  accu->TB = LTC2947_4BytesToUInt32(bytes + 12);
+}
+
+int8_t LTC2947_Read_Accus(boolean accuSet1, LTC2947_Accus *accu)
 {
   // byte array to store register values
   byte bytes[16];
 
-  // read measurement results from device
-  if (accuSet1)
-    // read accumulated quantities set 1: C1[47:0] E1[47:0] TB1[31:0]
-    LTC2947_RD_BYTES(LTC2947_VAL_C1, 16, bytes);
-  else
-    // read accumulated quantities set 2: C2[47:0] E2[47:0] TB2[31:0]
-    LTC2947_RD_BYTES(LTC2947_VAL_C2, 16, bytes);
+  // read accumulated quantities set 1: C1[47:0] E1[47:0] TB1[31:0]
+  // or set 2: C2[47:0] E2[47:0] TB2[31:0]
+  if (LTC2947_RD_BYTES(accuSet1 ? LTC2947_VAL_C1 : LTC2947_VAL_C2, 16, bytes) != 0)
+    return 1;
 
-  // convert signed bytes to double value in As
-  *C = LTC2947_SignedBytesToDouble(bytes, 6, LTC2947_LSB_C1);
+  LTC2947_BytesToAccus(bytes, accu);
+  return 0;
+}
 
-  // convert signed bytes to double value in Ws
-  *E = LTC2947_SignedBytesToDouble(bytes + 6, 6, LTC2947_LSB_E1);
+int8_t LTC2947_Read_All_Accus(LTC2947_Accus *accu1, LTC2947_Accus *accu2)
+{
+  // byte array to store register values, set 2 starts right after set 1
+  byte bytes[LTC2947_VAL_C2 - LTC2947_VAL_C1 + 16];
 
-  // calc time in seconds
-  *TB = LTC2947_4BytesToUInt32(bytes + 6 + 6) * LTC2947_LSB_TB1;
+  // read C1[47:0] E1[47:0] TB1[31:0] C2[47:0] E2[47:0] TB2[31:0] at once
+  if (LTC2947_RD_BYTES(LTC2947_VAL_C1, sizeof(bytes), bytes) != 0)
+    return 1;
+
+  LTC2947_BytesToAccus(bytes, accu1);
+  LTC2947_BytesToAccus(bytes + (LTC2947_VAL_C2 - LTC2947_VAL_C1), accu2);
+  return 0;
+}
+
+int64_t LTC2947_AccuToUnits(int64_t count, const LT_scale *scale)
+{
+  // count * fraction needs up to 80 bits, so the 48-bit count is split in
+  // two 24-bit halves whose products with the fraction fit 64 bits
+  int64_t c = count - scale->code_offset;
+  int64_t high = (c >> 24) * scale->fraction;
+  int64_t low = (c & 0xFFFFFF) * scale->fraction;
+
+  return c * scale->whole + ((high + (low >> 24) + 0x80) >> 8) + scale->output_bias;
 }
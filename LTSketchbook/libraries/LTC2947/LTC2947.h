@@ -71,6 +71,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #undef LTC2947_DEBUG
 
 #include "arduino.h"
+#include "LT_Convert.h"
 
 #define bitMaskSetChk(value, bitMask) (((value) & (bitMask)) == (bitMask))
 #define bitMaskClrChk(value, bitMask) (((value) & (bitMask)) == 0)
@@ -1329,6 +1330,12 @@ int32_t LTC2947_4BytesToInt32(
   byte *bytes //!< 4 byte array (MSB first)
 );
 
+//! Converts an array of 6 bytes to a sign extended 64-bit integer, e.g. a 48-bit accumulator
+//! @return 64-bit signed integer
+int64_t LTC2947_6BytesToInt64(
+  byte *bytes //!< 6 byte array (MSB first)
+);
+
 //! Converts an unsigned value of arbitrary number of bytes to a floating point value with the scaling factor lsb
 //! The input value must be usigned, use LTC2947_Abs to convert the bytes to an absolute (positive) value or use
 //! LTC2947_SignedBytesToDouble instead.
@@ -1440,6 +1447,110 @@ void LTC2947_Read_C_E_TB(
   double *TB      //!< Time in s
 );
 
+//! Raw counts of one accumulator set (C1, E1, TB1 or C2, E2, TB2).
+//! Kept as integers, so no precision is lost to the 32-bit double of the Arduino.
+typedef struct
+{
+  int64_t C;    //!< Charge in LSBs of LTC2947_LSB_C1, 48-bit signed
+  int64_t E;    //!< Energy in LSBs of LTC2947_LSB_E1, 48-bit signed
+  uint32_t TB;  //!< Time in LSBs of LTC2947_LSB_TB1
+} LTC2947_Accus;
+
+//! Reads the raw charge (C), energy (E) and time (TB) counts of one accumulator set
+//! in a single block read.
+//! Make sure LTC2947's page 0 is selected before calling this function.
+//! Use LTC2947_SetPageSelect to change page if necessary
+//! @return 0 if successful, 1 if not successful
+int8_t LTC2947_Read_Accus(
+  boolean accuSet1,   //!< True: Read C1, E1, TB1. False: Read C2, E2, TB2.
+  LTC2947_Accus *accu //!< Raw counts
+);
+
+//! Reads the raw counts of both accumulator sets in a single block read of
+//! the whole accumulator range (C1 to TB2), so both sets are read at the same time.
+//! Make sure LTC2947's page 0 is selected before calling this function.
+//! Use LTC2947_SetPageSelect to change page if necessary
+//! @return 0 if successful, 1 if not successful
+int8_t LTC2947_Read_All_Accus(
+  LTC2947_Accus *accu1, //!< Raw counts of C1, E1, TB1
+  LTC2947_Accus *accu2  //!< Raw counts of C2, E2, TB2
+);
+
+//! Scale from a C1 or C2 count to nanocoulombs (nAs), for LTC2947_AccuToUnits
+//! @return the scale
+constexpr LT_scale LTC2947_charge_scale_nanocoulombs()
+{
+  return LT_make_scale(LTC2947_LSB_C1 * 1e9);
+}
+
+//! Scale from an E1 or E2 count to microjoules (uWs), for LTC2947_AccuToUnits
+//! @return the scale
+constexpr LT_scale LTC2947_energy_scale_microjoules()
+{
+  return LT_make_scale(LTC2947_LSB_E1 * 1e6);
+}
+
+//! Scale from a TB1 or TB2 count to microseconds, for LTC2947_AccuToUnits
+//! @return the scale
+constexpr LT_scale LTC2947_time_scale_microseconds()
+{
+  return LT_make_scale(LTC2947_LSB_TB1 * 1e6);
+}
+
+//! Converts a raw accumulator count to fixed-point units with the full 48-bit range.
+//! The scale is applied in integer arithmetic, so the result is rounded to the nearest
+//! unit and off by at most one more unit per 2^33 counts.
+//! @return the count in the units of the scale
+int64_t LTC2947_AccuToUnits(
+  int64_t count,        //!< Raw count, e.g. LTC2947_Accus.C
+  const LT_scale *scale //!< e.g. LTC2947_charge_scale_nanocoulombs()
+);
+
+//! First register of the window read by LTC2947_Read_Snapshot
+#define LTC2947_SNAPSHOT_START LTC2947_REG_STATUS
+//! Bytes of the window read by LTC2947_Read_Snapshot, STATUS to VDVCC[7:0]
+#define LTC2947_SNAPSHOT_LENGTH (LTC2947_VAL_VDVCC + 2 - LTC2947_REG_STATUS)
+
+//! Index of a result in LTC2947_Snapshot.value
+enum LTC2947_Snapshot_Value
+{
+  LTC2947_SNAPSHOT_I,       //!< Current I[23:0], signed
+  LTC2947_SNAPSHOT_P,       //!< Power P[23:0], signed
+  LTC2947_SNAPSHOT_V,       //!< Voltage V[15:0], signed
+  LTC2947_SNAPSHOT_TEMP,    //!< Temperature TEMP[15:0], signed
+  LTC2947_SNAPSHOT_VDVCC,   //!< Supply voltage VDVCC[15:0], signed
+  LTC2947_SNAPSHOT_VALUES   //!< Number of results
+};
+
+//! Raw results of one LTC2947_Read_Snapshot call
+typedef struct
+{
+  uint8_t status[8];                        //!< STATUS to STATVDVCC as read, see LTC2947_BM_STATUS_UPDATE
+  int32_t value[LTC2947_SNAPSHOT_VALUES];   //!< Sign extended results, indexed by LTC2947_Snapshot_Value
+  LTC2947_Accus accu1;                      //!< Raw counts of C1, E1, TB1 if read
+  LTC2947_Accus accu2;                      //!< Raw counts of C2, E2, TB2 if read
+} LTC2947_Snapshot;
+
+//! Reads the status and all measurement results (I, P, V, TEMP, VDVCC) in a single
+//! block read and decodes them, optionally followed by a second block read of both
+//! accumulator sets. Selects page 0 through LTC2947_EnsurePageSelect, so no page
+//! control transfer is needed while page 0 stays selected.
+//! The UPDATE bit of status[0] is set if the results were updated since the last
+//! read of STATUS, so polling this function at or above the update rate of the
+//! device logs every result exactly once.
+//! @return 0 if successful, 1 if not successful
+int8_t LTC2947_Read_Snapshot(
+  LTC2947_Snapshot *snap, //!< Raw results
+  boolean accus           //!< True: also read accu1 and accu2. False: leave them unchanged.
+);
+
+//! Converts a result of a snapshot to volts, amps, watts or degree celcius
+//! @return the result in floating point number format
+float LTC2947_SnapshotToFloat(
+  const LTC2947_Snapshot *snap, //!< Snapshot read by LTC2947_Read_Snapshot
+  uint8_t index                 //!< e.g. LTC2947_SNAPSHOT_I
+);
+
 //! read single byte from SPI interface
 //! @return always 0
 int8_t LTC2947_SpiRdByte(
@@ -1548,6 +1659,12 @@ int16_t LTC2947_wake_up();
 //! @return true: page 1 is selected, false: page 0
 boolean LTC2947_GetCurrentPageSelect();
 
+//! Selects a memory page like LTC2947_SetPageSelect, but writes the page control
+//! register only if the page differs from the last one written or read by this library
+void LTC2947_EnsurePageSelect(
+  boolean page //!< false: select page 0, true: select page 1
+);
+
 //! reads the current GPIO pin state
 //! Make sure LTC2947's page 0 is selected before calling this function.
 //! Use LTC2947_SetPageSelect to change page if necessary
@@ -1575,6 +1692,11 @@ void LTC2947_GPIO_SetPinState(
 extern boolean LTC2947_SPI_Mode_Enabled;
 //! set by LTC2947_InitI2C to set slave address for I2C operation
 extern uint8_t LTC2947_I2C_Slave_Addr;
+//! page selected on the device as last written or read by this library,
+//! LTC2947_PAGE_UNKNOWN after LTC2947_InitI2C / LTC2947_InitSPI
+extern uint8_t LTC2947_Page_Shadow;
+//! LTC2947_Page_Shadow value until the page is written or read
+#define LTC2947_PAGE_UNKNOWN 0xFF
 
 /** @name serial communication wrapper macros
 *  LTC2947's I2C / Spi functions are wrapped to common serial communication functions
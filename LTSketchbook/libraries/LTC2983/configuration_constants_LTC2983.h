@@ -320,6 +320,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define VOUT_CH_BASE                     (uint16_t) 0x0060
 #define READ_CH_BASE                     (uint16_t) 0x0010
 #define CONVERSION_RESULT_MEMORY_BASE    (uint16_t) 0x0010
+#define GLOBAL_CONFIGURATION_REGISTER    (uint16_t) 0x00F0
+#define MULTIPLE_CHANNEL_MASK_REGISTER   (uint16_t) 0x00F4
+#define MUX_CONFIGURATION_DELAY_REGISTER (uint16_t) 0x00FF
+#define CUSTOM_DATA_BASE                 (uint16_t) 0x0250
+#define CUSTOM_DATA_END                  (uint16_t) 0x03D0
 //**********************************************************************************************************
 // -- MISC CONSTANTS --
 //**********************************************************************************************************
@@ -328,4 +333,5 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONVERSION_CONTROL_BYTE (uint8_t) 0x80
 
 #define VOLTAGE                 (uint8_t) 0x01
-#define TEMPERATURE             (uint8_t) 0x02
\ No newline at end of file
+#define TEMPERATURE             (uint8_t) 0x02
+#define NUMBER_OF_CHANNELS      20      // Channels in the memory map; the LTC2986 uses the first 10
\ No newline at end of file
@@ -274,6 +274,308 @@ void print_fault_data(uint8_t fault_byte)
     Serial.println(F("CONFIGURATION ERROR !!!!!!"));
 }
 
+// *********************************
+// Multiple channels
+// *********************************
+// Converts every channel set in channel_mask (bit 0 is channel 1) in one
+// multiple conversion, instead of one conversion cycle per channel.
+void convert_channels(uint8_t chip_select, uint32_t channel_mask)
+{
+  transfer_four_bytes(chip_select, WRITE_TO_RAM, MULTIPLE_CHANNEL_MASK_REGISTER, channel_mask & 0xFFFFF);
+
+  // Start conversion, channel 0 selects the channels in the mask
+  transfer_byte(chip_select, WRITE_TO_RAM, COMMAND_STATUS_REGISTER, CONVERSION_CONTROL_BYTE);
+
+  wait_for_process_to_finish(chip_select);
+}
+
+
+// Reads the words of count channels from first_channel on in one transaction.
+// base_address is CONVERSION_RESULT_MEMORY_BASE for the results, or
+// VOUT_CH_BASE for the raw voltage or resistance.
+void read_results(uint8_t chip_select, uint16_t base_address, uint8_t first_channel, uint8_t count, uint32_t *raw_data)
+{
+  uint8_t header[3];
+  spi_segment segments[2];
+  uint16_t start_address = get_start_address(base_address, first_channel);
+  uint32_t swap;
+  uint8_t i;
+
+  header[0] = READ_FROM_RAM;
+  header[1] = highByte(start_address);
+  header[2] = lowByte(start_address);
+
+  // Read last byte first, which leaves each word a little endian integer,
+  // but the words in reverse order
+  segments[0].tx = header;
+  segments[0].rx = 0;
+  segments[0].length = 3;
+  segments[0].flags = 0;
+  segments[1].tx = 0;
+  segments[1].rx = (uint8_t *)raw_data;
+  segments[1].length = 4 * count;
+  segments[1].flags = LT_SPI_REVERSE;
+
+  spi_transaction(chip_select, segments, 2);
+
+  for (i = 0; i < count / 2; i++)
+  {
+    swap = raw_data[i];
+    raw_data[i] = raw_data[count - 1 - i];
+    raw_data[count - 1 - i] = swap;
+  }
+}
+
+
+void decode_result(uint32_t raw_data, uint8_t channel_output, struct conversion_result *result)
+{
+  int32_t signed_data = raw_data & 0xFFFFFF;
+
+  // Convert the 24 LSB's into a signed 32-bit integer
+  if (signed_data & 0x800000)
+    signed_data = signed_data | 0xFF000000;
+
+  result->raw = signed_data;
+  if (channel_output == VOLTAGE)
+    result->value = float(signed_data) / 2097152;
+  else
+    result->value = float(signed_data) / 1024;
+
+  // 8 MSB's show the fault data
+  result->fault = raw_data >> 24;
+}
+
+
+// Converts the channels in channel_mask, reads all their results in one burst and
+// decodes them into results[channel - 1]. Channels in voltage_mask are decoded as
+// volts, the others as temperatures. Returns the number of channels converted.
+uint8_t measure_channels(uint8_t chip_select, uint32_t channel_mask, uint32_t voltage_mask, struct conversion_result results[NUMBER_OF_CHANNELS])
+{
+  uint32_t raw_data[NUMBER_OF_CHANNELS];
+  uint8_t first = NUMBER_OF_CHANNELS;
+  uint8_t last = 0;
+  uint8_t converted = 0;
+  uint8_t i;
+
+  for (i = 0; i < NUMBER_OF_CHANNELS; i++)
+  {
+    if (channel_mask & ((uint32_t)1 << i))
+    {
+      if (first == NUMBER_OF_CHANNELS)
+        first = i;
+      last = i;
+      converted++;
+    }
+  }
+  if (converted == 0)
+    return 0;
+
+  convert_channels(chip_select, channel_mask);
+  read_results(chip_select, CONVERSION_RESULT_MEMORY_BASE, first + 1, last - first + 1, raw_data);
+
+  for (i = first; i <= last; i++)
+  {
+    if (channel_mask & ((uint32_t)1 << i))
+      decode_result(raw_data[i - first], (voltage_mask & ((uint32_t)1 << i)) ? VOLTAGE : TEMPERATURE, &results[i]);
+  }
+  return converted;
+}
+
+// ******************************
+// Configuration image
+// ******************************
+// The channel assignments and custom tables are put together in a buffer and
+// written with one block write, instead of one transaction per word, then read
+// back to check them. A device that already holds the image, because only the
+// Linduino was reset, is found by its CRC and not written at all.
+
+#define IMAGE_CHUNK 32    // Bytes read back at a time when checking the device
+
+
+// CRC-16-CCITT, polynomial 0x1021
+static uint16_t image_crc_update(uint16_t crc, const uint8_t *data, uint16_t length)
+{
+  uint8_t i;
+
+  while (length--)
+  {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (i = 0; i < 8; i++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+
+// Checks that length bytes from a RAM address are in the image buffer and in the given region
+static int8_t image_check(struct config_image *image, uint16_t address, uint16_t length, uint16_t region_start, uint16_t region_end)
+{
+  if (address < region_start || address + length > region_end || address + length - CH_ADDRESS_BASE > image->size)
+    return 1;
+  return 0;
+}
+
+
+// Puts a big endian word of 1 to 4 bytes into the image at a RAM address that has been checked
+static void image_put(struct config_image *image, uint16_t address, uint32_t value, uint8_t bytes)
+{
+  uint16_t offset = address - CH_ADDRESS_BASE;
+  uint8_t i;
+
+  for (i = bytes; i > 0; i--)
+  {
+    image->data[offset + i - 1] = (uint8_t)value;
+    value >>= 8;
+  }
+  if (offset + bytes > image->used)
+    image->used = offset + bytes;
+  image->crc_valid = 0;
+}
+
+
+// Reads or writes a block of RAM in one transaction, the address incrementing
+static void transfer_block(uint8_t chip_select, uint8_t ram_read_or_write, uint16_t start_address, uint8_t *data, uint16_t length)
+{
+  uint8_t header[3];
+  spi_segment segments[2];
+
+  header[0] = ram_read_or_write;
+  header[1] = highByte(start_address);
+  header[2] = lowByte(start_address);
+
+  segments[0].tx = header;
+  segments[0].rx = 0;
+  segments[0].length = 3;
+  segments[0].flags = 0;
+  segments[1].tx = (ram_read_or_write == WRITE_TO_RAM) ? data : 0;
+  segments[1].rx = (ram_read_or_write == READ_FROM_RAM) ? data : 0;
+  segments[1].length = length;
+  segments[1].flags = 0;
+
+  spi_transaction(chip_select, segments, 2);
+}
+
+
+void image_begin(struct config_image *image, uint8_t *buffer, uint16_t size)
+{
+  memset(buffer, 0, size);
+  image->data = buffer;
+  image->size = size;
+  // Channels that are not assigned are written as unassigned
+  image->used = (size < 4 * NUMBER_OF_CHANNELS) ? size : 4 * NUMBER_OF_CHANNELS;
+  image->global_config = TEMP_UNIT__C | REJECTION__50_60_HZ;
+  image->mux_delay = 0;
+  image->crc_valid = 0;
+}
+
+
+int8_t image_assign_channel(struct config_image *image, uint8_t channel_number, uint32_t channel_assignment_data)
+{
+  uint16_t start_address = get_start_address(CH_ADDRESS_BASE, channel_number);
+
+  if (channel_number < 1 || image_check(image, start_address, 4, CH_ADDRESS_BASE, CUSTOM_DATA_BASE))
+    return 1;
+  image_put(image, start_address, channel_assignment_data, 4);
+  return 0;
+}
+
+
+int8_t image_custom_table(struct config_image *image, struct table_coeffs *coefficients, uint16_t start_address, uint8_t table_length)
+{
+  uint8_t i;
+
+  if (image_check(image, start_address, 6 * table_length, CUSTOM_DATA_BASE, CUSTOM_DATA_END))
+    return 1;
+  for (i = 0; i < table_length; i++)
+  {
+    image_put(image, start_address + 6 * i, coefficients[i].measurement, 3);
+    image_put(image, start_address + 6 * i + 3, coefficients[i].temperature, 3);
+  }
+  return 0;
+}
+
+
+int8_t image_custom_steinhart_hart(struct config_image *image, uint32_t steinhart_hart_coeffs[6], uint16_t start_address)
+{
+  uint8_t i;
+
+  if (image_check(image, start_address, 4 * 6, CUSTOM_DATA_BASE, CUSTOM_DATA_END))
+    return 1;
+  for (i = 0; i < 6; i++)
+    image_put(image, start_address + 4 * i, steinhart_hart_coeffs[i], 4);
+  return 0;
+}
+
+
+void image_global_parameters(struct config_image *image, uint8_t global_config, uint8_t mux_delay)
+{
+  image->global_config = global_config;
+  image->mux_delay = mux_delay;
+  image->crc_valid = 0;
+}
+
+
+// CRC of the image, worked out once and kept until the image changes
+uint16_t image_crc(struct config_image *image)
+{
+  if (!image->crc_valid)
+  {
+    image->crc = image_crc_update(0xFFFF, image->data, image->used);
+    image->crc = image_crc_update(image->crc, &image->global_config, 1);
+    image->crc = image_crc_update(image->crc, &image->mux_delay, 1);
+    image->crc_valid = 1;
+  }
+  return image->crc;
+}
+
+
+// CRC of what the device holds where the image goes
+static uint16_t device_crc(uint8_t chip_select, uint16_t used)
+{
+  uint8_t chunk[IMAGE_CHUNK];
+  uint16_t crc = 0xFFFF;
+  uint16_t offset;
+  uint16_t length;
+
+  for (offset = 0; offset < used; offset += length)
+  {
+    length = (used - offset > IMAGE_CHUNK) ? IMAGE_CHUNK : used - offset;
+    transfer_block(chip_select, READ_FROM_RAM, CH_ADDRESS_BASE + offset, chunk, length);
+    crc = image_crc_update(crc, chunk, length);
+  }
+  chunk[0] = transfer_byte(chip_select, READ_FROM_RAM, GLOBAL_CONFIGURATION_REGISTER, 0);
+  chunk[1] = transfer_byte(chip_select, READ_FROM_RAM, MUX_CONFIGURATION_DELAY_REGISTER, 0);
+  return image_crc_update(crc, chunk, 2);
+}
+
+
+// Writes the image unless the device already holds it, and reads it back
+int8_t configure_from_image(uint8_t chip_select, struct config_image *image)
+{
+  uint8_t chunk[IMAGE_CHUNK];
+  uint16_t offset;
+  uint16_t length;
+
+  if (device_crc(chip_select, image->used) == image_crc(image))
+    return IMAGE_ALREADY_CONFIGURED;
+
+  transfer_block(chip_select, WRITE_TO_RAM, CH_ADDRESS_BASE, image->data, image->used);
+  transfer_byte(chip_select, WRITE_TO_RAM, GLOBAL_CONFIGURATION_REGISTER, image->global_config);
+  transfer_byte(chip_select, WRITE_TO_RAM, MUX_CONFIGURATION_DELAY_REGISTER, image->mux_delay);
+
+  for (offset = 0; offset < image->used; offset += length)
+  {
+    length = (image->used - offset > IMAGE_CHUNK) ? IMAGE_CHUNK : image->used - offset;
+    transfer_block(chip_select, READ_FROM_RAM, CH_ADDRESS_BASE + offset, chunk, length);
+    if (memcmp(chunk, image->data + offset, length) != 0)
+      return IMAGE_VERIFY_FAILED;
+  }
+  if (transfer_byte(chip_select, READ_FROM_RAM, GLOBAL_CONFIGURATION_REGISTER, 0) != image->global_config
+      || transfer_byte(chip_select, READ_FROM_RAM, MUX_CONFIGURATION_DELAY_REGISTER, 0) != image->mux_delay)
+    return IMAGE_VERIFY_FAILED;
+  return IMAGE_WRITTEN;
+}
+
 // *********************
 // SPI RAM data transfer
 // *********************
@@ -284,22 +586,24 @@ void print_fault_data(uint8_t fault_byte)
 uint32_t transfer_four_bytes(uint8_t chip_select, uint8_t ram_read_or_write, uint16_t start_address, uint32_t input_data)
 {
   uint32_t output_data;
-  uint8_t tx[7], rx[7];
+  uint8_t header[3];
+  spi_segment segments[2];
 
-  tx[6] = ram_read_or_write;
-  tx[5] = highByte(start_address);
-  tx[4] = lowByte(start_address);
-  tx[3] = (uint8_t)(input_data >> 24);
-  tx[2] = (uint8_t)(input_data >> 16);
-  tx[1] = (uint8_t)(input_data >> 8);
-  tx[0] = (uint8_t) input_data;
+  header[0] = ram_read_or_write;
+  header[1] = highByte(start_address);
+  header[2] = lowByte(start_address);
 
-  spi_transfer_block(chip_select, tx, rx, 7);
+  // The data word goes straight from and to the integers, MSB first
+  segments[0].tx = header;
+  segments[0].rx = 0;
+  segments[0].length = 3;
+  segments[0].flags = 0;
+  segments[1].tx = (const uint8_t *)&input_data;
+  segments[1].rx = (uint8_t *)&output_data;
+  segments[1].length = 4;
+  segments[1].flags = LT_SPI_REVERSE;
 
-  output_data = (uint32_t) rx[3] << 24 |
-                (uint32_t) rx[2] << 16 |
-                (uint32_t) rx[1] << 8  |
-                (uint32_t) rx[0];
+  spi_transaction(chip_select, segments, 2);
 
   return output_data;
 }
@@ -307,14 +611,24 @@ uint32_t transfer_four_bytes(uint8_t chip_select, uint8_t ram_read_or_write, uin
 
 uint8_t transfer_byte(uint8_t chip_select, uint8_t ram_read_or_write, uint16_t start_address, uint8_t input_data)
 {
-  uint8_t tx[4], rx[4];
-
-  tx[3] = ram_read_or_write;
-  tx[2] = (uint8_t)(start_address >> 8);
-  tx[1] = (uint8_t)start_address;
-  tx[0] = input_data;
-  spi_transfer_block(chip_select, tx, rx, 4);
-  return rx[0];
+  uint8_t header[3], output_data;
+  spi_segment segments[2];
+
+  header[0] = ram_read_or_write;
+  header[1] = (uint8_t)(start_address >> 8);
+  header[2] = (uint8_t)start_address;
+
+  segments[0].tx = header;
+  segments[0].rx = 0;
+  segments[0].length = 3;
+  segments[0].flags = 0;
+  segments[1].tx = &input_data;
+  segments[1].rx = &output_data;
+  segments[1].length = 1;
+  segments[1].flags = 0;
+
+  spi_transaction(chip_select, segments, 2);
+  return output_data;
 }
 
 
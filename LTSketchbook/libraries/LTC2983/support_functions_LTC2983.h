@@ -69,6 +69,44 @@ void print_conversion_result(uint32_t raw_conversion_result, uint8_t channel_out
 void read_voltage_or_resistance_results(uint8_t chip_select, uint8_t channel_number);
 void print_fault_data(uint8_t fault_byte);
 
+//! A conversion result, decoded
+struct conversion_result
+{
+  int32_t raw;        //!< 24 bit result, sign extended
+  float value;        //!< Temperature, or volts when the channel output is VOLTAGE
+  uint8_t fault;      //!< Fault bits, see the status byte constants
+};
+
+void convert_channels(uint8_t chip_select, uint32_t channel_mask);
+void read_results(uint8_t chip_select, uint16_t base_address, uint8_t first_channel, uint8_t count, uint32_t *raw_data);
+void decode_result(uint32_t raw_data, uint8_t channel_output, struct conversion_result *result);
+uint8_t measure_channels(uint8_t chip_select, uint32_t channel_mask, uint32_t voltage_mask, struct conversion_result results[NUMBER_OF_CHANNELS]);
+
+//! Image of the configuration RAM, from CH_ADDRESS_BASE up to the end of the
+//! custom data it holds, and of the global configuration registers
+struct config_image
+{
+  uint8_t *data;          //!< Buffer for the image, data[0] is CH_ADDRESS_BASE
+  uint16_t size;          //!< Bytes in the buffer
+  uint16_t used;          //!< Bytes of the image in use, never less than the channel assignments
+  uint8_t global_config;  //!< GLOBAL_CONFIGURATION_REGISTER, TEMP_UNIT__ and REJECTION__ constants
+  uint8_t mux_delay;      //!< MUX_CONFIGURATION_DELAY_REGISTER, in 100us steps
+  uint16_t crc;           //!< CRC of the image, valid when crc_valid is set
+  uint8_t crc_valid;      //!< Cleared whenever the image changes
+};
+
+#define IMAGE_WRITTEN             0   //!< configure_from_image() wrote the image and read it back
+#define IMAGE_ALREADY_CONFIGURED  1   //!< The device already held the image, nothing was written
+#define IMAGE_VERIFY_FAILED       -1  //!< The image read back different from what was written
+
+void image_begin(struct config_image *image, uint8_t *buffer, uint16_t size);
+int8_t image_assign_channel(struct config_image *image, uint8_t channel_number, uint32_t channel_assignment_data);
+int8_t image_custom_table(struct config_image *image, struct table_coeffs *coefficients, uint16_t start_address, uint8_t table_length);
+int8_t image_custom_steinhart_hart(struct config_image *image, uint32_t steinhart_hart_coeffs[6], uint16_t start_address);
+void image_global_parameters(struct config_image *image, uint8_t global_config, uint8_t mux_delay);
+uint16_t image_crc(struct config_image *image);
+int8_t configure_from_image(uint8_t chip_select, struct config_image *image);
+
 
 
 uint32_t transfer_four_bytes(uint8_t chip_select, uint8_t read_or_write, uint16_t start_address, uint32_t input_data);
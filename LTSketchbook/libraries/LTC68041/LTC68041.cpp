@@ -70,6 +70,7 @@ Copyright 2013 Linear Technology Corp. (LTC)
 #include <Arduino.h>
 #include "Linduino.h"
 #include "LT_SPI.h"
+#include "LTC68xx.h"
 #include "LTC68041.h"
 #include <SPI.h>
 
@@ -81,6 +82,63 @@ Copyright 2013 Linear Technology Corp. (LTC)
 uint8_t ADCV[2]; //!< Cell Voltage conversion command.
 uint8_t ADAX[2]; //!< GPIO conversion command.
 
+//! LTC6804 core for the LTC68xx library
+typedef LTC68xx<LTC6804_1_traits> LTC6804_core;
+
+//! SPI transport of the LTC6804 library
+struct LTC6804_bus
+{
+  static inline void select()
+  {
+    output_low(LTC6804_CS);
+  }
+  static inline void deselect()
+  {
+    output_high(LTC6804_CS);
+  }
+  static inline void write_read(uint8_t *tx, uint8_t tx_len, uint8_t *rx, uint8_t rx_len)
+  {
+    spi_write_read(tx, tx_len, rx, rx_len);
+  }
+};
+
+//! Stores cell or GPIO register groups in a two dimensional code array
+template <uint8_t CODES>
+struct LTC6804_code_sink
+{
+  uint16_t (*codes)[CODES];
+  LTC6804_code_sink(uint16_t (*codes_)[CODES]) : codes(codes_) {}
+  void operator()(uint8_t ic, uint8_t reg, const uint8_t *data, uint8_t /*pec_error*/)
+  {
+    LTC6804_core::parse_codes(data, &codes[ic][(reg - 1)*LTC68XX_CODES_IN_REG]);
+  }
+};
+
+//! Stores configuration register groups, with their PEC, in a two dimensional array
+struct LTC6804_cfg_sink
+{
+  uint8_t (*r_config)[8];
+  LTC6804_cfg_sink(uint8_t (*r_config_)[8]) : r_config(r_config_) {}
+  void operator()(uint8_t ic, uint8_t /*reg*/, const uint8_t *data, uint8_t /*pec_error*/)
+  {
+    for (uint8_t current_byte = 0; current_byte < LTC68XX_REG_LEN; current_byte++)
+    {
+      r_config[ic][current_byte] = data[current_byte];
+    }
+  }
+};
+
+//! Takes the configuration of each IC from a two dimensional array
+struct LTC6804_cfg_source
+{
+  uint8_t (*config)[6];
+  LTC6804_cfg_source(uint8_t (*config_)[6]) : config(config_) {}
+  const uint8_t *operator()(uint8_t ic)
+  {
+    return config[ic];
+  }
+};
+
 
 /*!
   \brief This function will initialize all 6804 variables and the SPI port.
@@ -118,18 +176,13 @@ void set_adc(uint8_t MD, //ADC Mode
              uint8_t CHG //GPIO Channels to be measured
             )
 {
-  uint8_t md_bits;
-
-  md_bits = (MD & 0x02) >> 1;
-  ADCV[0] = md_bits + 0x02;
-  md_bits = (MD & 0x01) << 7;
-  ADCV[1] =  md_bits + 0x60 + (DCP<<4) + CH;
-
-  md_bits = (MD & 0x02) >> 1;
-  ADAX[0] = md_bits + 0x04;
-  md_bits = (MD & 0x01) << 7;
-  ADAX[1] = md_bits + 0x60 + CHG ;
+  uint16_t adcv = LTC6804_core::chip::adcv(MD, DCP, CH);
+  uint16_t adax = LTC6804_core::chip::adax(MD, CHG);
 
+  ADCV[0] = (uint8_t)(adcv >> 8);
+  ADCV[1] = (uint8_t)adcv;
+  ADAX[0] = (uint8_t)(adax >> 8);
+  ADAX[1] = (uint8_t)adax;
 }
 
 
@@ -153,27 +206,8 @@ Command Code:
 ***********************************************************************************************/
 void LTC6804_adcv()
 {
-
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  //1
-  cmd[0] = ADCV[0];
-  cmd[1] = ADCV[1];
-
-  //2
-  cmd_pec = pec15_calc(2, ADCV);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-  //3
   wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake. This command can be removed.
-
-  //4
-  output_low(LTC6804_CS);
-  spi_write_array(4,cmd);
-  output_high(LTC6804_CS);
-
+  LTC6804_core::command<LTC6804_bus>((ADCV[0] << 8) | ADCV[1]);
 }
 /*
   LTC6804_adcv Function sequence:
@@ -205,20 +239,8 @@ Command Code:
 *********************************************************************************************************/
 void LTC6804_adax()
 {
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  cmd[0] = ADAX[0];
-  cmd[1] = ADAX[1];
-  cmd_pec = pec15_calc(2, ADAX);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
   wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake. This command can be removed.
-  output_low(LTC6804_CS);
-  spi_write_array(4,cmd);
-  output_high(LTC6804_CS);
-
+  LTC6804_core::command<LTC6804_bus>((ADAX[0] << 8) | ADAX[1]);
 }
 /*
   LTC6804_adax Function sequence:
@@ -270,94 +292,12 @@ uint8_t LTC6804_rdcv(uint8_t reg, // Controls which cell voltage register is rea
                      uint16_t cell_codes[][12] // Array of the parsed cell codes
                     )
 {
+  LTC6804_code_sink<12> sink(cell_codes);
+  uint8_t errors;
 
-  const uint8_t NUM_RX_BYT = 8;
-  const uint8_t BYT_IN_REG = 6;
-  const uint8_t CELL_IN_REG = 3;
-
-  uint8_t *cell_data;
-  uint8_t pec_error = 0;
-  uint16_t parsed_cell;
-  uint16_t received_pec;
-  uint16_t data_pec;
-  uint8_t data_counter=0; //data counter
-  cell_data = (uint8_t *) malloc((NUM_RX_BYT*total_ic)*sizeof(uint8_t));
-  //1.a
-  if (reg == 0)
-  {
-    //a.i
-    for (uint8_t cell_reg = 1; cell_reg<5; cell_reg++)                    //executes once for each of the LTC6804 cell voltage registers
-    {
-      data_counter = 0;
-      LTC6804_rdcv_reg(cell_reg, total_ic,cell_data );                //Reads a single Cell voltage register
-
-      for (uint8_t current_ic = 0 ; current_ic < total_ic; current_ic++)      // executes for every LTC6804 in the daisy chain
-      {
-        // current_ic is used as the IC counter
-
-        //a.ii
-        for (uint8_t current_cell = 0; current_cell<CELL_IN_REG; current_cell++)  // This loop parses the read back data into cell voltages, it
-        {
-          // loops once for each of the 3 cell voltage codes in the register
-
-          parsed_cell = cell_data[data_counter] + (cell_data[data_counter + 1] << 8);//Each cell code is received as two bytes and is combined to
-          // create the parsed cell voltage code
-
-          cell_codes[current_ic][current_cell  + ((cell_reg - 1) * CELL_IN_REG)] = parsed_cell;
-          data_counter = data_counter + 2;                       //Because cell voltage codes are two bytes the data counter
-          //must increment by two for each parsed cell code
-        }
-        //a.iii
-        received_pec = (cell_data[data_counter] << 8) + cell_data[data_counter+1]; //The received PEC for the current_ic is transmitted as the 7th and 8th
-        //after the 6 cell voltage data bytes
-        data_pec = pec15_calc(BYT_IN_REG, &cell_data[current_ic * NUM_RX_BYT]);
-        if (received_pec != data_pec)
-        {
-          pec_error = -1;                             //The pec_error variable is simply set negative if any PEC errors
-          //are detected in the serial data
-        }
-        data_counter=data_counter+2;                        //Because the transmitted PEC code is 2 bytes long the data_counter
-        //must be incremented by 2 bytes to point to the next ICs cell voltage data
-      }
-    }
-  }
-//1.b
-  else
-  {
-    //b.i
-    LTC6804_rdcv_reg(reg, total_ic,cell_data);
-    for (uint8_t current_ic = 0 ; current_ic < total_ic; current_ic++)        // executes for every LTC6804 in the daisy chain
-    {
-      // current_ic is used as the IC counter
-      //b.ii
-      for (uint8_t current_cell = 0; current_cell < CELL_IN_REG; current_cell++)  // This loop parses the read back data into cell voltages, it
-      {
-        // loops once for each of the 3 cell voltage codes in the register
-
-        parsed_cell = cell_data[data_counter] + (cell_data[data_counter+1]<<8); //Each cell code is received as two bytes and is combined to
-        // create the parsed cell voltage code
-
-        cell_codes[current_ic][current_cell + ((reg - 1) * CELL_IN_REG)] = 0x0000FFFF & parsed_cell;
-        data_counter= data_counter + 2;                       //Because cell voltage codes are two bytes the data counter
-        //must increment by two for each parsed cell code
-      }
-      //b.iii
-      received_pec = (cell_data[data_counter] << 8 )+ cell_data[data_counter + 1]; //The received PEC for the current_ic is transmitted as the 7th and 8th
-      //after the 6 cell voltage data bytes
-      data_pec = pec15_calc(BYT_IN_REG, &cell_data[current_ic * NUM_RX_BYT]);
-      if (received_pec != data_pec)
-      {
-        pec_error = -1;                             //The pec_error variable is simply set negative if any PEC errors
-        //are detected in the serial data
-      }
-      data_counter= data_counter + 2;                       //Because the transmitted PEC code is 2 bytes long the data_counter
-      //must be incremented by 2 bytes to point to the next ICs cell voltage data
-    }
-  }
-
-//2
-  free(cell_data);
-  return(pec_error);
+  wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake. This command can be removed.
+  errors = LTC6804_core::read_cells<LTC6804_bus>(reg, total_ic, false, sink);
+  return((errors != 0) ? -1 : 0);
 }
 /*
   LTC6804_rdcv Sequence
@@ -412,45 +352,8 @@ void LTC6804_rdcv_reg(uint8_t reg, //Determines which cell voltage register is r
                       uint8_t *data //An array of the unparsed cell codes
                      )
 {
-  const uint8_t REG_LEN = 8; //number of bytes in each ICs register + 2 bytes for the PEC
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  //1
-  if (reg == 1)     //1: RDCVA
-  {
-    cmd[1] = 0x04;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 2) //2: RDCVB
-  {
-    cmd[1] = 0x06;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 3) //3: RDCVC
-  {
-    cmd[1] = 0x08;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 4) //4: RDCVD
-  {
-    cmd[1] = 0x0A;
-    cmd[0] = 0x00;
-  }
-
-  //2
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-  //3
   wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake. This command can be removed.
-
-  //4
-  output_low(LTC6804_CS);
-  spi_write_read(cmd,4,data,(REG_LEN*total_ic));
-  output_high(LTC6804_CS);
-
+  LTC6804_core::read_raw<LTC6804_bus>(LTC6804_core::chip::rdcv(reg), total_ic, data);
 }
 /*
   LTC6804_rdcv_reg Function Process:
@@ -497,98 +400,12 @@ int8_t LTC6804_rdaux(uint8_t reg, //Determines which GPIO voltage register is re
                      uint16_t aux_codes[][6]//A two dimensional array of the gpio voltage codes.
                     )
 {
+  LTC6804_code_sink<6> sink(aux_codes);
+  uint8_t errors;
 
-
-  const uint8_t NUM_RX_BYT = 8;
-  const uint8_t BYT_IN_REG = 6;
-  const uint8_t GPIO_IN_REG = 3;
-
-  uint8_t *data;
-  uint8_t data_counter = 0;
-  int8_t pec_error = 0;
-  uint16_t parsed_aux;
-  uint16_t received_pec;
-  uint16_t data_pec;
-  data = (uint8_t *) malloc((NUM_RX_BYT*total_ic)*sizeof(uint8_t));
-  //1.a
-  if (reg == 0)
-  {
-    //a.i
-    for (uint8_t gpio_reg = 1; gpio_reg<3; gpio_reg++)                //executes once for each of the LTC6804 aux voltage registers
-    {
-      data_counter = 0;
-      LTC6804_rdaux_reg(gpio_reg, total_ic,data);                 //Reads the raw auxiliary register data into the data[] array
-
-      for (uint8_t current_ic = 0 ; current_ic < total_ic; current_ic++)      // executes for every LTC6804 in the daisy chain
-      {
-        // current_ic is used as the IC counter
-
-        //a.ii
-        for (uint8_t current_gpio = 0; current_gpio< GPIO_IN_REG; current_gpio++) // This loop parses the read back data into GPIO voltages, it
-        {
-          // loops once for each of the 3 gpio voltage codes in the register
-
-          parsed_aux = data[data_counter] + (data[data_counter+1]<<8);              //Each gpio codes is received as two bytes and is combined to
-          // create the parsed gpio voltage code
-
-          aux_codes[current_ic][current_gpio +((gpio_reg-1)*GPIO_IN_REG)] = parsed_aux;
-          data_counter=data_counter+2;                        //Because gpio voltage codes are two bytes the data counter
-          //must increment by two for each parsed gpio voltage code
-
-        }
-        //a.iii
-        received_pec = (data[data_counter]<<8)+ data[data_counter+1];          //The received PEC for the current_ic is transmitted as the 7th and 8th
-        //after the 6 gpio voltage data bytes
-        data_pec = pec15_calc(BYT_IN_REG, &data[current_ic*NUM_RX_BYT]);
-        if (received_pec != data_pec)
-        {
-          pec_error = -1;                             //The pec_error variable is simply set negative if any PEC errors
-          //are detected in the received serial data
-        }
-
-        data_counter=data_counter+2;                        //Because the transmitted PEC code is 2 bytes long the data_counter
-        //must be incremented by 2 bytes to point to the next ICs gpio voltage data
-      }
-
-
-    }
-
-  }
-  else
-  {
-    //b.i
-    LTC6804_rdaux_reg(reg, total_ic, data);
-    for (int current_ic = 0 ; current_ic < total_ic; current_ic++)            // executes for every LTC6804 in the daisy chain
-    {
-      // current_ic is used as an IC counter
-
-      //b.ii
-      for (int current_gpio = 0; current_gpio<GPIO_IN_REG; current_gpio++)    // This loop parses the read back data. Loops
-      {
-        // once for each aux voltage in the register
-
-        parsed_aux = (data[data_counter] + (data[data_counter+1]<<8));        //Each gpio codes is received as two bytes and is combined to
-        // create the parsed gpio voltage code
-        aux_codes[current_ic][current_gpio +((reg-1)*GPIO_IN_REG)] = parsed_aux;
-        data_counter=data_counter+2;                      //Because gpio voltage codes are two bytes the data counter
-        //must increment by two for each parsed gpio voltage code
-      }
-      //b.iii
-      received_pec = (data[data_counter]<<8) + data[data_counter+1];         //The received PEC for the current_ic is transmitted as the 7th and 8th
-      //after the 6 gpio voltage data bytes
-      data_pec = pec15_calc(BYT_IN_REG, &data[current_ic*NUM_RX_BYT]);
-      if (received_pec != data_pec)
-      {
-        pec_error = -1;                               //The pec_error variable is simply set negative if any PEC errors
-        //are detected in the received serial data
-      }
-
-      data_counter=data_counter+2;                        //Because the transmitted PEC code is 2 bytes long the data_counter
-      //must be incremented by 2 bytes to point to the next ICs gpio voltage data
-    }
-  }
-  free(data);
-  return (pec_error);
+  wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake. This command can be removed.
+  errors = LTC6804_core::read_aux<LTC6804_bus>(reg, total_ic, false, sink);
+  return((errors != 0) ? -1 : 0);
 }
 /*
   LTC6804_rdaux Sequence
@@ -640,38 +457,8 @@ void LTC6804_rdaux_reg(uint8_t reg, //Determines which GPIO voltage register is
                        uint8_t *data //Array of the unparsed auxiliary codes
                       )
 {
-  const uint8_t REG_LEN = 8; // number of bytes in the register + 2 bytes for the PEC
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  //1
-  if (reg == 1)     //Read back auxiliary group A
-  {
-    cmd[1] = 0x0C;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 2)  //Read back auxiliary group B
-  {
-    cmd[1] = 0x0e;
-    cmd[0] = 0x00;
-  }
-  else          //Read back auxiliary group A
-  {
-    cmd[1] = 0x0C;
-    cmd[0] = 0x00;
-  }
-  //2
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-  //3
   wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake, this command can be removed.
-  //4
-  output_low(LTC6804_CS);
-  spi_write_read(cmd,4,data,(REG_LEN*total_ic));
-  output_high(LTC6804_CS);
-
+  LTC6804_core::read_raw<LTC6804_bus>(LTC6804_core::chip::rdaux(reg), total_ic, data);
 }
 /*
   LTC6804_rdaux_reg Function Process:
@@ -698,25 +485,8 @@ Command Code:
 ************************************************************/
 void LTC6804_clrcell()
 {
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  //1
-  cmd[0] = 0x07;
-  cmd[1] = 0x11;
-
-  //2
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec );
-
-  //3
   wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake. This command can be removed.
-
-  //4
-  output_low(LTC6804_CS);
-  spi_write_read(cmd,4,0,0);
-  output_high(LTC6804_CS);
+  LTC6804_core::command<LTC6804_bus>(LTC6804_core::chip::CLRCELL);
 }
 /*
   LTC6804_clrcell Function sequence:
@@ -745,24 +515,8 @@ Command Code:
 ***************************************************************/
 void LTC6804_clraux()
 {
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  //1
-  cmd[0] = 0x07;
-  cmd[1] = 0x12;
-
-  //2
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-  //3
   wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake.This command can be removed.
-  //4
-  output_low(LTC6804_CS);
-  spi_write_read(cmd,4,0,0);
-  output_high(LTC6804_CS);
+  LTC6804_core::command<LTC6804_bus>(LTC6804_core::chip::CLRAUX);
 }
 /*
   LTC6804_clraux Function sequence:
@@ -806,48 +560,10 @@ void LTC6804_wrcfg(uint8_t total_ic, //The number of ICs being written to
                    uint8_t config[][6] //A two dimensional array of the configuration data that will be written
                   )
 {
-  const uint8_t BYTES_IN_REG = 6;
-  const uint8_t CMD_LEN = 4+(8*total_ic);
-  uint8_t *cmd;
-  uint16_t cfg_pec;
-  uint8_t cmd_index; //command counter
-
-  cmd = (uint8_t *)malloc(CMD_LEN*sizeof(uint8_t));
-
-  //1
-  cmd[0] = 0x00;
-  cmd[1] = 0x01;
-  cmd[2] = 0x3d;
-  cmd[3] = 0x6e;
-
-  //2
-  cmd_index = 4;
-  for (uint8_t current_ic = total_ic; current_ic > 0; current_ic--)       // executes for each LTC6804 in daisy chain, this loops starts with
-  {
-    // the last IC on the stack. The first configuration written is
-    // received by the last IC in the daisy chain
+  LTC6804_cfg_source source(config);
 
-    for (uint8_t current_byte = 0; current_byte < BYTES_IN_REG; current_byte++) // executes for each of the 6 bytes in the CFGR register
-    {
-      // current_byte is the byte counter
-
-      cmd[cmd_index] = config[current_ic-1][current_byte];            //adding the config data to the array to be sent
-      cmd_index = cmd_index + 1;
-    }
-    //3
-    cfg_pec = (uint16_t)pec15_calc(BYTES_IN_REG, &config[current_ic-1][0]);   // calculating the PEC for each ICs configuration register data
-    cmd[cmd_index] = (uint8_t)(cfg_pec >> 8);
-    cmd[cmd_index + 1] = (uint8_t)cfg_pec;
-    cmd_index = cmd_index + 2;
-  }
-
-  //4
   wakeup_idle ();                                 //This will guarantee that the LTC6804 isoSPI port is awake.This command can be removed.
-  //5
-  output_low(LTC6804_CS);
-  spi_write_array(CMD_LEN, cmd);
-  output_high(LTC6804_CS);
-  free(cmd);
+  LTC6804_core::write_reg<LTC6804_bus>(LTC6804_core::chip::WRCFGA, total_ic, false, source);
 }
 /*
   WRCFG Sequence:
@@ -892,50 +608,12 @@ int8_t LTC6804_rdcfg(uint8_t total_ic, //Number of ICs in the system
                      uint8_t r_config[][8] //A two dimensional array that the function stores the read configuration data.
                     )
 {
-  const uint8_t BYTES_IN_REG = 8;
+  LTC6804_cfg_sink sink(r_config);
+  uint8_t errors;
 
-  uint8_t cmd[4];
-  uint8_t *rx_data;
-  int8_t pec_error = 0;
-  uint16_t data_pec;
-  uint16_t received_pec;
-
-  rx_data = (uint8_t *) malloc((8*total_ic)*sizeof(uint8_t));
-
-  //1
-  cmd[0] = 0x00;
-  cmd[1] = 0x02;
-  cmd[2] = 0x2b;
-  cmd[3] = 0x0A;
-
-  //2
   wakeup_idle (); //This will guarantee that the LTC6804 isoSPI port is awake. This command can be removed.
-  //3
-  output_low(LTC6804_CS);
-  spi_write_read(cmd, 4, rx_data, (BYTES_IN_REG*total_ic));         //Read the configuration data of all ICs on the daisy chain into
-  output_high(LTC6804_CS);                          //rx_data[] array
-
-  for (uint8_t current_ic = 0; current_ic < total_ic; current_ic++)       //executes for each LTC6804 in the daisy chain and packs the data
-  {
-    //into the r_config array as well as check the received Config data
-    //for any bit errors
-    //4.a
-    for (uint8_t current_byte = 0; current_byte < BYTES_IN_REG; current_byte++)
-    {
-      r_config[current_ic][current_byte] = rx_data[current_byte + (current_ic*BYTES_IN_REG)];
-    }
-    //4.b
-    received_pec = (r_config[current_ic][6]<<8) + r_config[current_ic][7];
-    data_pec = pec15_calc(6, &r_config[current_ic][0]);
-    if (received_pec != data_pec)
-    {
-      pec_error = -1;
-    }
-  }
-
-  free(rx_data);
-  //5
-  return(pec_error);
+  errors = LTC6804_core::read_reg<LTC6804_bus>(LTC6804_core::chip::RDCFGA, 0, total_ic, false, sink);
+  return((errors != 0) ? -1 : 0);
 }
 /*
   RDCFG Sequence:
@@ -972,32 +650,6 @@ void wakeup_sleep()
   delay(1); // Guarantees the LTC6804 will be in standby
   output_high(LTC6804_CS);
 }
-/*!**********************************************************
- \brief calaculates  and returns the CRC15
-
-  @param[in] uint8_t len: the length of the data array being passed to the function
-
-  @param[in] uint8_t data[] : the array of data that the PEC will be generated from
-
-
-  @returns The calculated pec15 as an unsigned int
-***********************************************************/
-uint16_t pec15_calc(uint8_t len, //Number of bytes that will be used to calculate a PEC
-                    uint8_t *data //Array of data that will be used to calculate  a PEC
-                   )
-{
-  uint16_t remainder,addr;
-
-  remainder = 16;//initialize the PEC
-  for (uint8_t i = 0; i<len; i++) // loops for each byte in data array
-  {
-    addr = ((remainder>>7)^data[i])&0xff;//calculate PEC table address
-    remainder = (remainder<<8)^crc15Table[addr];
-  }
-  return(remainder*2);//The CRC15 has a 0 in the LSB so the remainder must be multiplied by 2
-}
-
-
 /*!
  \brief Writes an array of bytes out of the SPI port
 
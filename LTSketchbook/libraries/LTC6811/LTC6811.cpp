@@ -213,10 +213,7 @@ uint8_t LTC6811_rdcv(uint8_t reg, // Controls which cell voltage register is rea
                      cell_asic ic[] // Array of the parsed cell codes
                     )
 {
-
-  int8_t pec_error = 0;
-  pec_error = LTC681x_rdcv(reg,total_ic,ic);
-  return(pec_error);
+  return(LTC681x_rdcv_chip<LTC6811_traits>(reg,total_ic,ic));
 }
 
 /*
@@ -229,9 +226,7 @@ int8_t LTC6811_rdaux(uint8_t reg, //Determines which GPIO voltage register is re
                      cell_asic ic[]//A two dimensional array of the gpio voltage codes.
                     )
 {
-  int8_t pec_error = 0;
-  LTC681x_rdaux(reg,total_ic,ic);
-  return (pec_error);
+  return(LTC681x_rdaux_chip<LTC6811_traits>(reg,total_ic,ic));
 }
 
 /*
@@ -245,9 +240,7 @@ int8_t LTC6811_rdstat(uint8_t reg, //Determines which Stat  register is read bac
                       cell_asic ic[]
                      )
 {
-  int8_t pec_error = 0;
-  pec_error = LTC681x_rdstat(reg,total_ic,ic);
-  return (pec_error);
+  return(LTC681x_rdstat_chip<LTC6811_traits>(reg,total_ic,ic));
 }
 
 /*
@@ -413,6 +406,18 @@ void LTC6811_run_openwire(uint8_t total_ic, cell_asic ic[])
 {
   LTC681x_run_openwire(total_ic,ic);
 }
+
+//Prepares an open wire test run by LTC6811_ow_step()
+void LTC6811_ow_start(ow_test *ow, uint8_t total_ic, cell_asic ic[], uint16_t *pu_codes)
+{
+  LTC681x_ow_start(ow, total_ic, ic, pu_codes);
+}
+
+//Advances an open wire test without waiting for the ADC
+uint8_t LTC6811_ow_step(ow_test *ow, uint8_t total_ic, cell_asic ic[])
+{
+  return(LTC681x_ow_step(ow, total_ic, ic));
+}
 // Runs the ADC overlap test for the IC
 uint16_t LTC6811_run_adc_overlap(uint8_t total_ic, cell_asic ic[])
 {
@@ -508,4 +513,4 @@ void LTC6811_set_cfgr_uv(uint8_t nIC, cell_asic ic[],uint16_t uv)
 void LTC6811_set_cfgr_ov(uint8_t nIC, cell_asic ic[],uint16_t ov)
 {
   LTC681x_set_cfgr_ov( nIC, ic, ov);
-}
\ No newline at end of file
+}
\ No newline at end of file
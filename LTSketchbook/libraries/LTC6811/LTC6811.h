@@ -325,6 +325,20 @@ int16_t LTC6811_run_adc_redundancy_st(uint8_t adc_mode,
 void LTC6811_run_openwire(uint8_t total_ic,
                           cell_asic ic[]);
 
+/*! Prepares an open wire test that is run by calling LTC6811_ow_step()*/
+void LTC6811_ow_start(ow_test *ow,          //!< Test state
+                      uint8_t total_ic,     //!< Number of ICs in the daisy chain
+                      cell_asic ic[],       //!< ASIC Variable
+                      uint16_t *pu_codes    //!< total_ic*12 codes kept between the pull up and pull down conversions
+                     );
+
+/*! Advances an open wire test without waiting for the ADC, see LTC681x_ow_step()
+ @return the state of the test, OW_DONE when finished*/
+uint8_t LTC6811_ow_step(ow_test *ow,        //!< Test state
+                        uint8_t total_ic,   //!< Number of ICs in the daisy chain
+                        cell_asic ic[]      //!< ASIC Variable
+                       );
+
 void LTC6811_set_discharge(int Cell,
                            uint8_t total_ic,
                            cell_asic ic[]);
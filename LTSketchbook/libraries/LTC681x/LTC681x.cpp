@@ -72,131 +72,81 @@ void wakeup_sleep(uint8_t total_ic)
   }
 }
 
-//Generic function to write 68xx commands. Function calculated PEC for tx_cmd data
-void cmd_68(uint8_t tx_cmd[2])
+//Takes the data written by write_68() from consecutive 6 byte blocks
+struct LTC681x_array_source
 {
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-  uint8_t md_bits;
-
-  cmd[0] = tx_cmd[0];
-  cmd[1] =  tx_cmd[1];
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-  cs_low(CS_PIN);
-  spi_write_array(4,cmd);
-  cs_high(CS_PIN);
-}
+  uint8_t *data;
+  LTC681x_array_source(uint8_t *data_) : data(data_) {}
+  const uint8_t *operator()(uint8_t block)
+  {
+    return &data[block*6];
+  }
+};
 
-//Generic function to write 68xx commands and write payload data. Function calculated PEC for tx_cmd data
-void write_68(uint8_t total_ic , uint8_t tx_cmd[2], uint8_t data[])
+//Takes the data of a register write from the tx_data of an ic_register in cell_asic
+struct LTC681x_reg_source
 {
-  const uint8_t BYTES_IN_REG = 6;
-  const uint8_t CMD_LEN = 4+(8*total_ic);
-  uint8_t *cmd;
-  uint16_t data_pec;
-  uint16_t cmd_pec;
-  uint8_t cmd_index;
-
-  cmd = (uint8_t *)malloc(CMD_LEN*sizeof(uint8_t));
-  cmd[0] = tx_cmd[0];
-  cmd[1] = tx_cmd[1];
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-  cmd_index = 4;
-  for (uint8_t current_ic = total_ic; current_ic > 0; current_ic--)       // executes for each LTC681x in daisy chain, this loops starts with
+  cell_asic *ic;
+  ic_register cell_asic::*reg;
+  LTC681x_reg_source(cell_asic *ic_, ic_register cell_asic::*reg_) : ic(ic_), reg(reg_) {}
+  const uint8_t *operator()(uint8_t stack_ic)
   {
-    // the last IC on the stack. The first configuration written is
-    // received by the last IC in the daisy chain
-
-    for (uint8_t current_byte = 0; current_byte < BYTES_IN_REG; current_byte++)
-    {
-      cmd[cmd_index] = data[((current_ic-1)*6)+current_byte];
-      cmd_index = cmd_index + 1;
-    }
-
-    data_pec = (uint16_t)pec15_calc(BYTES_IN_REG, &data[(current_ic-1)*6]);    // calculating the PEC for each Iss configuration register data
-    cmd[cmd_index] = (uint8_t)(data_pec >> 8);
-    cmd[cmd_index + 1] = (uint8_t)data_pec;
-    cmd_index = cmd_index + 2;
+    return (ic[stack_ic].*reg).tx_data;
   }
+};
 
-
-  cs_low(CS_PIN);
-  spi_write_array(CMD_LEN, cmd);
-  cs_high(CS_PIN);
-  free(cmd);
-}
-
-//Generic function to write 68xx commands and read data. Function calculated PEC for tx_cmd data
-int8_t read_68( uint8_t total_ic, uint8_t tx_cmd[2], uint8_t *rx_data)
+//Stores a register read in the rx_data of an ic_register in cell_asic
+struct LTC681x_reg_sink
 {
-  const uint8_t BYTES_IN_REG = 8;
-  uint8_t cmd[4];
-  uint8_t data[256];
-  int8_t pec_error = 0;
-  uint16_t cmd_pec;
-  uint16_t data_pec;
-  uint16_t received_pec;
-
-  // data = (uint8_t *) malloc((8*total_ic)*sizeof(uint8_t)); // This is a problem because it can fail
-
-  cmd[0] = tx_cmd[0];
-  cmd[1] = tx_cmd[1];
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-
-  cs_low(CS_PIN);
-  spi_write_read(cmd, 4, data, (BYTES_IN_REG*total_ic));         //Read the configuration data of all ICs on the daisy chain into
-  cs_high(CS_PIN);                          //rx_data[] array
-
-  for (uint8_t current_ic = 0; current_ic < total_ic; current_ic++)       //executes for each LTC681x in the daisy chain and packs the data
+  cell_asic *ic;
+  ic_register cell_asic::*reg;
+  LTC681x_reg_sink(cell_asic *ic_, ic_register cell_asic::*reg_) : ic(ic_), reg(reg_) {}
+  void operator()(uint8_t stack_ic, uint8_t /*group*/, const uint8_t *data, uint8_t pec_error)
   {
-    //into the r_comm array as well as check the received Config data
-    //for any bit errors
-    for (uint8_t current_byte = 0; current_byte < BYTES_IN_REG; current_byte++)
+    for (uint8_t byte = 0; byte < LTC68XX_REG_LEN; byte++)
     {
-      rx_data[(current_ic*8)+current_byte] = data[current_byte + (current_ic*BYTES_IN_REG)];
-    }
-    received_pec = (rx_data[(current_ic*8)+6]<<8) + rx_data[(current_ic*8)+7];
-    data_pec = pec15_calc(6, &rx_data[current_ic*8]);
-    if (received_pec != data_pec)
-    {
-      pec_error = -1;
+      (ic[stack_ic].*reg).rx_data[byte] = data[byte];
     }
+    (ic[stack_ic].*reg).rx_pec_match = pec_error;
   }
+};
 
+//Writes one register of every IC in the daisy chain from cell_asic
+static void LTC681x_write_reg(uint16_t cmd, uint8_t total_ic, cell_asic ic[], ic_register cell_asic::*reg)
+{
+  LTC681x_reg_source source(ic, reg);
+  LTC681x_core::write_reg<LTC681x_bus>(cmd, total_ic, ic[0].isospi_reverse, source);
+}
 
-  return(pec_error);
+//Reads one register of every IC in the daisy chain into cell_asic
+static int8_t LTC681x_read_reg(uint16_t cmd, uint8_t total_ic, cell_asic ic[], ic_register cell_asic::*reg)
+{
+  LTC681x_reg_sink sink(ic, reg);
+  uint8_t errors = LTC681x_core::read_reg<LTC681x_bus>(cmd, 0, total_ic, ic[0].isospi_reverse, sink);
+  return (errors != 0) ? -1 : 0;
 }
 
+//Generic function to write 68xx commands. Function calculated PEC for tx_cmd data
+void cmd_68(uint8_t tx_cmd[2])
+{
+  LTC681x_core::command<LTC681x_bus>((tx_cmd[0] << 8) | tx_cmd[1]);
+}
 
-/*
-  Calculates  and returns the CRC15
-  */
-uint16_t pec15_calc(uint8_t len, //Number of bytes that will be used to calculate a PEC
-                    uint8_t *data //Array of data that will be used to calculate  a PEC
-                   )
+//Generic function to write 68xx commands and write payload data. Function calculated PEC for tx_cmd data
+void write_68(uint8_t total_ic , uint8_t tx_cmd[2], uint8_t data[])
 {
-  uint16_t remainder,addr;
+  LTC681x_array_source source(data);
+  LTC681x_core::write_reg<LTC681x_bus>((tx_cmd[0] << 8) | tx_cmd[1], total_ic, false, source);
+}
 
-  remainder = 16;//initialize the PEC
-  for (uint8_t i = 0; i<len; i++) // loops for each byte in data array
-  {
-    addr = ((remainder>>7)^data[i])&0xff;//calculate PEC table address
-#ifdef MBED
-    remainder = (remainder<<8)^crc15Table[addr];
-#else
-    remainder = (remainder<<8)^pgm_read_word_near(crc15Table+addr);
-#endif
-  }
-  return(remainder*2);//The CRC15 has a 0 in the LSB so the remainder must be multiplied by 2
+//Generic function to write 68xx commands and read data. Function calculated PEC for tx_cmd data
+int8_t read_68( uint8_t total_ic, uint8_t tx_cmd[2], uint8_t *rx_data)
+{
+  uint8_t errors = LTC681x_core::read_raw<LTC681x_bus>((tx_cmd[0] << 8) | tx_cmd[1], total_ic, rx_data);
+  return (errors != 0) ? -1 : 0;
 }
 
+
 //Starts cell voltage conversion
 void LTC681x_adcv(
   uint8_t MD, //ADC Mode
@@ -204,14 +154,7 @@ void LTC681x_adcv(
   uint8_t CH //Cell Channels to be measured
 )
 {
-  uint8_t cmd[4];
-  uint8_t md_bits;
-
-  md_bits = (MD & 0x02) >> 1;
-  cmd[0] = md_bits + 0x02;
-  md_bits = (MD & 0x01) << 7;
-  cmd[1] =  md_bits + 0x60 + (DCP<<4) + CH;
-  cmd_68(cmd);
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::adcv(MD, DCP, CH));
 }
 
 
@@ -317,18 +260,11 @@ uint8_t LTC681x_pladc()
 {
   uint8_t cmd[4];
   uint8_t adc_state = 0xFF;
-  uint16_t cmd_pec;
-
-  cmd[0] = 0x07;
-  cmd[1] = 0x14;
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
 
+  LTC681x_core::cmd_frame(LTC681x_core::chip::PLADC, cmd);
   cs_low(CS_PIN);
   spi_write_array(4,cmd);
-// adc_state = spi_read_byte(0xFF);
+  adc_state = spi_read_byte(0xFF);
 
   cs_high(CS_PIN);
   return(adc_state);
@@ -341,15 +277,8 @@ uint32_t LTC681x_pollAdc()
   uint8_t finished = 0;
   uint8_t current_time = 0;
   uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-
-  cmd[0] = 0x07;
-  cmd[1] = 0x14;
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
 
+  LTC681x_core::cmd_frame(LTC681x_core::chip::PLADC, cmd);
   cs_low(CS_PIN);
   spi_write_array(4,cmd);
 
@@ -378,15 +307,7 @@ void LTC681x_adax(
   uint8_t CHG //GPIO Channels to be measured)
 )
 {
-  uint8_t cmd[4];
-  uint8_t md_bits;
-
-  md_bits = (MD & 0x02) >> 1;
-  cmd[0] = md_bits + 0x04;
-  md_bits = (MD & 0x01) << 7;
-  cmd[1] = md_bits + 0x60 + CHG ;
-  cmd_68(cmd);
-
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::adax(MD, CHG));
 }
 
 //Start an GPIO Redundancy test
@@ -411,14 +332,7 @@ void LTC681x_adstat(
   uint8_t CHST //GPIO Channels to be measured
 )
 {
-  uint8_t cmd[4];
-  uint8_t md_bits;
-
-  md_bits = (MD & 0x02) >> 1;
-  cmd[0] = md_bits + 0x04;
-  md_bits = (MD & 0x01) << 7;
-  cmd[1] = md_bits + 0x68 + CHST ;
-  cmd_68(cmd);
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::adstat(MD, CHST));
 }
 
 // Start a Status register redundancy test Conversion
@@ -445,13 +359,7 @@ void LTC681x_adow(
   uint8_t PUP //Discharge Permit
 )
 {
-  uint8_t cmd[2];
-  uint8_t md_bits;
-  md_bits = (MD & 0x02) >> 1;
-  cmd[0] = md_bits + 0x02;
-  md_bits = (MD & 0x01) << 7;
-  cmd[1] =  md_bits + 0x28 + (PUP<<6) ;//+ CH;
-  cmd_68(cmd);
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::adow(MD, PUP));
 }
 
 // Reads the raw cell voltage register data
@@ -460,91 +368,17 @@ void LTC681x_rdcv_reg(uint8_t reg, //Determines which cell voltage register is r
                       uint8_t *data //An array of the unparsed cell codes
                      )
 {
-  const uint8_t REG_LEN = 8; //number of bytes in each ICs register + 2 bytes for the PEC
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  if (reg == 1)     //1: RDCVA
-  {
-    cmd[1] = 0x04;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 2) //2: RDCVB
-  {
-    cmd[1] = 0x06;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 3) //3: RDCVC
-  {
-    cmd[1] = 0x08;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 4) //4: RDCVD
-  {
-    cmd[1] = 0x0A;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 5) //4: RDCVE
-  {
-    cmd[1] = 0x09;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 6) //4: RDCVF
-  {
-    cmd[1] = 0x0B;
-    cmd[0] = 0x00;
-  }
-
-
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-  cs_low(CS_PIN);
-  spi_write_read(cmd,4,data,(REG_LEN*total_ic));
-  cs_high(CS_PIN);
-
+  LTC681x_core::read_raw<LTC681x_bus>(LTC681x_core::chip::rdcv(reg), total_ic, data);
 }
 
 //helper function that parses voltage measurement registers
 int8_t parse_cells(uint8_t current_ic, uint8_t cell_reg, uint8_t cell_data[], uint16_t *cell_codes, uint8_t *ic_pec)
 {
+  uint8_t *data = &cell_data[current_ic*NUM_RX_BYT];
 
-  const uint8_t BYT_IN_REG = 6;
-  const uint8_t CELL_IN_REG = 3;
-  int8_t pec_error = 0;
-  uint16_t parsed_cell;
-  uint16_t received_pec;
-  uint16_t data_pec;
-  uint8_t data_counter = current_ic*NUM_RX_BYT; //data counter
-
-
-  for (uint8_t current_cell = 0; current_cell<CELL_IN_REG; current_cell++)  // This loop parses the read back data into cell voltages, it
-  {
-    // loops once for each of the 3 cell voltage codes in the register
-
-    parsed_cell = cell_data[data_counter] + (cell_data[data_counter + 1] << 8);//Each cell code is received as two bytes and is combined to
-    // create the parsed cell voltage code
-    cell_codes[current_cell  + ((cell_reg - 1) * CELL_IN_REG)] = parsed_cell;
-    data_counter = data_counter + 2;                       //Because cell voltage codes are two bytes the data counter
-    //must increment by two for each parsed cell code
-  }
-
-  received_pec = (cell_data[data_counter] << 8) | cell_data[data_counter+1]; //The received PEC for the current_ic is transmitted as the 7th and 8th
-  //after the 6 cell voltage data bytes
-  data_pec = pec15_calc(BYT_IN_REG, &cell_data[(current_ic) * NUM_RX_BYT]);
-
-  if (received_pec != data_pec)
-  {
-    pec_error = 1;                             //The pec_error variable is simply set negative if any PEC errors
-    ic_pec[cell_reg-1]=1;
-  }
-  else
-  {
-    ic_pec[cell_reg-1]=0;
-  }
-  data_counter=data_counter+2;
-  return(pec_error);
+  LTC681x_core::parse_codes(data, &cell_codes[(cell_reg - 1)*LTC68XX_CODES_IN_REG]);
+  ic_pec[cell_reg-1] = LTC681x_core::reg_pec_error(data);
+  return(ic_pec[cell_reg-1]);
 }
 
 /*
@@ -557,45 +391,7 @@ void LTC681x_rdaux_reg(uint8_t reg, //Determines which GPIO voltage register is
                        uint8_t *data //Array of the unparsed auxiliary codes
                       )
 {
-  const uint8_t REG_LEN = 8; // number of bytes in the register + 2 bytes for the PEC
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-
-  if (reg == 1)     //Read back auxiliary group A
-  {
-    cmd[1] = 0x0C;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 2)  //Read back auxiliary group B
-  {
-    cmd[1] = 0x0e;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 3)  //Read back auxiliary group C
-  {
-    cmd[1] = 0x0D;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 4)  //Read back auxiliary group D
-  {
-    cmd[1] = 0x0F;
-    cmd[0] = 0x00;
-  }
-  else          //Read back auxiliary group A
-  {
-    cmd[1] = 0x0C;
-    cmd[0] = 0x00;
-  }
-
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-  cs_low(CS_PIN);
-  spi_write_read(cmd,4,data,(REG_LEN*total_ic));
-  cs_high(CS_PIN);
-
+  LTC681x_core::read_raw<LTC681x_bus>(LTC681x_core::chip::rdaux(reg), total_ic, data);
 }
 
 /*
@@ -608,36 +404,7 @@ void LTC681x_rdstat_reg(uint8_t reg, //Determines which stat register is read ba
                         uint8_t *data //Array of the unparsed stat codes
                        )
 {
-  const uint8_t REG_LEN = 8; // number of bytes in the register + 2 bytes for the PEC
-  uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-
-  if (reg == 1)     //Read back statiliary group A
-  {
-    cmd[1] = 0x10;
-    cmd[0] = 0x00;
-  }
-  else if (reg == 2)  //Read back statiliary group B
-  {
-    cmd[1] = 0x12;
-    cmd[0] = 0x00;
-  }
-
-  else          //Read back statiliary group A
-  {
-    cmd[1] = 0x10;
-    cmd[0] = 0x00;
-  }
-
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
-
-  cs_low(CS_PIN);
-  spi_write_read(cmd,4,data,(REG_LEN*total_ic));
-  cs_high(CS_PIN);
-
+  LTC681x_core::read_raw<LTC681x_bus>(LTC681x_core::chip::rdstat(reg), total_ic, data);
 }
 
 /*
@@ -647,8 +414,7 @@ after the command is sent.
 */
 void LTC681x_clrcell()
 {
-  uint8_t cmd[2]= {0x07 , 0x11};
-  cmd_68(cmd);
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::CLRCELL);
 }
 
 
@@ -659,8 +425,7 @@ after the command is sent.
 */
 void LTC681x_clraux()
 {
-  uint8_t cmd[2]= {0x07 , 0x12};
-  cmd_68(cmd);
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::CLRAUX);
 }
 
 
@@ -672,8 +437,7 @@ after the command is sent.
 */
 void LTC681x_clrstat()
 {
-  uint8_t cmd[2]= {0x07 , 0x13};
-  cmd_68(cmd);
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::CLRSTAT);
 }
 /*
 The command clears the Sctrl registers and initializes
@@ -688,8 +452,7 @@ void LTC681x_clrsctrl()
 //Starts the Mux Decoder diagnostic self test
 void LTC681x_diagn()
 {
-  uint8_t cmd[2] = {0x07 , 0x15};
-  cmd_68(cmd);
+  LTC681x_core::command<LTC681x_bus>(LTC681x_core::chip::DIAGN);
 }
 
 //Reads and parses the LTC681x cell voltage registers.
@@ -698,54 +461,10 @@ uint8_t LTC681x_rdcv(uint8_t reg, // Controls which cell voltage register is rea
                      cell_asic ic[] // Array of the parsed cell codes
                     )
 {
-  int8_t pec_error = 0;
-  uint8_t *cell_data;
-  uint8_t c_ic = 0;
-  cell_data = (uint8_t *) malloc((NUM_RX_BYT*total_ic)*sizeof(uint8_t));
-
-  if (reg == 0)
-  {
-    for (uint8_t cell_reg = 1; cell_reg<ic[0].ic_reg.num_cv_reg+1; cell_reg++)                   //executes once for each of the LTC6811 cell voltage registers
-    {
-      LTC681x_rdcv_reg(cell_reg, total_ic,cell_data );
-      for (int current_ic = 0; current_ic<total_ic; current_ic++)
-      {
-        if (ic->isospi_reverse == false)
-        {
-          c_ic = current_ic;
-        }
-        else
-        {
-          c_ic = total_ic - current_ic - 1;
-        }
-        pec_error = pec_error + parse_cells(current_ic,cell_reg, cell_data,
-                                            &ic[c_ic].cells.c_codes[0],
-                                            &ic[c_ic].cells.pec_match[0]);
-      }
-    }
-  }
-
-  else
-  {
-    LTC681x_rdcv_reg(reg, total_ic,cell_data);
-
-    for (int current_ic = 0; current_ic<total_ic; current_ic++)
-    {
-      if (ic->isospi_reverse == false)
-      {
-        c_ic = current_ic;
-      }
-      else
-      {
-        c_ic = total_ic - current_ic - 1;
-      }
-      pec_error = pec_error + parse_cells(current_ic,reg, &cell_data[8*c_ic],
-                                          &ic[c_ic].cells.c_codes[0],
-                                          &ic[c_ic].cells.pec_match[0]);
-    }
-  }
+  LTC681x_cell_sink sink(ic);
+  uint8_t pec_error = LTC681x_core::read_cells<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, sink,
+                      ic[0].ic_reg.num_cv_reg);
   LTC681x_check_pec(total_ic,CELL,ic);
-  free(cell_data);
   return(pec_error);
 }
 
@@ -761,56 +480,11 @@ int8_t LTC681x_rdaux(uint8_t reg, //Determines which GPIO voltage register is re
                      cell_asic ic[]//A two dimensional array of the gpio voltage codes.
                     )
 {
-  uint8_t *data;
-  int8_t pec_error = 0;
-  uint8_t c_ic =0;
-  data = (uint8_t *) malloc((NUM_RX_BYT*total_ic)*sizeof(uint8_t));
-
-  if (reg == 0)
-  {
-    for (uint8_t gpio_reg = 1; gpio_reg<ic[0].ic_reg.num_gpio_reg+1; gpio_reg++)                 //executes once for each of the LTC6811 aux voltage registers
-    {
-      LTC681x_rdaux_reg(gpio_reg, total_ic,data);                 //Reads the raw auxiliary register data into the data[] array
-      for (int current_ic = 0; current_ic<total_ic; current_ic++)
-      {
-        if (ic->isospi_reverse == false)
-        {
-          c_ic = current_ic;
-        }
-        else
-        {
-          c_ic = total_ic - current_ic - 1;
-        }
-        pec_error = parse_cells(current_ic,gpio_reg, data,
-                                &ic[c_ic].aux.a_codes[0],
-                                &ic[c_ic].aux.pec_match[0]);
-
-      }
-    }
-  }
-  else
-  {
-    LTC681x_rdaux_reg(reg, total_ic, data);
-
-    for (int current_ic = 0; current_ic<total_ic; current_ic++)
-    {
-      if (ic->isospi_reverse == false)
-      {
-        c_ic = current_ic;
-      }
-      else
-      {
-        c_ic = total_ic - current_ic - 1;
-      }
-      pec_error = parse_cells(current_ic,reg, data,
-                              &ic[c_ic].aux.a_codes[0],
-                              &ic[c_ic].aux.pec_match[0]);
-    }
-
-  }
+  LTC681x_aux_sink sink(ic);
+  uint8_t errors = LTC681x_core::read_aux<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, sink,
+                   ic[0].ic_reg.num_gpio_reg);
   LTC681x_check_pec(total_ic,AUX,ic);
-  free(data);
-  return (pec_error);
+  return ((errors != 0) ? 1 : 0);
 }
 
 // Reads and parses the LTC681x stat registers.
@@ -818,144 +492,11 @@ int8_t LTC681x_rdstat(uint8_t reg, //Determines which Stat  register is read bac
                       uint8_t total_ic,//the number of ICs in the system
                       cell_asic ic[]
                      )
-
 {
-
-  const uint8_t BYT_IN_REG = 6;
-  const uint8_t GPIO_IN_REG = 3;
-
-  uint8_t *data;
-  uint8_t data_counter = 0;
-  int8_t pec_error = 0;
-  uint16_t parsed_stat;
-  uint16_t received_pec;
-  uint16_t data_pec;
-  uint8_t c_ic = 0;
-  data = (uint8_t *) malloc((NUM_RX_BYT*total_ic)*sizeof(uint8_t));
-
-  if (reg == 0)
-  {
-
-    for (uint8_t stat_reg = 1; stat_reg< 3; stat_reg++)                      //executes once for each of the LTC6811 stat voltage registers
-    {
-      data_counter = 0;
-      LTC681x_rdstat_reg(stat_reg, total_ic,data);                            //Reads the raw statiliary register data into the data[] array
-
-      for (uint8_t current_ic = 0 ; current_ic < total_ic; current_ic++)      // executes for every LTC6811 in the daisy chain
-      {
-        if (ic->isospi_reverse == false)
-        {
-          c_ic = current_ic;
-        }
-        else
-        {
-          c_ic = total_ic - current_ic - 1;
-        }
-        // current_ic is used as the IC counter
-        if (stat_reg ==1)
-        {
-          for (uint8_t current_gpio = 0; current_gpio< GPIO_IN_REG; current_gpio++) // This loop parses the read back data into GPIO voltages, it
-          {
-            // loops once for each of the 3 gpio voltage codes in the register
-
-            parsed_stat = data[data_counter] + (data[data_counter+1]<<8);              //Each gpio codes is received as two bytes and is combined to
-            ic[c_ic].stat.stat_codes[current_gpio] = parsed_stat;
-            data_counter=data_counter+2;                                               //Because gpio voltage codes are two bytes the data counter
-
-          }
-        }
-        else if (stat_reg == 2)
-        {
-          parsed_stat = data[data_counter] + (data[data_counter+1]<<8);              //Each gpio codes is received as two bytes and is combined to
-          data_counter = data_counter +2;
-          ic[c_ic].stat.stat_codes[3] = parsed_stat;
-          ic[c_ic].stat.flags[0] = data[data_counter++];
-          ic[c_ic].stat.flags[1] = data[data_counter++];
-          ic[c_ic].stat.flags[2] = data[data_counter++];
-          ic[c_ic].stat.mux_fail[0] = (data[data_counter] & 0x02)>>1;
-          ic[c_ic].stat.thsd[0] = data[data_counter++] & 0x01;
-        }
-
-        received_pec = (data[data_counter]<<8)+ data[data_counter+1];          //The received PEC for the current_ic is transmitted as the 7th and 8th
-        //after the 6 gpio voltage data bytes
-        data_pec = pec15_calc(BYT_IN_REG, &data[current_ic*NUM_RX_BYT]);
-
-        if (received_pec != data_pec)
-        {
-          pec_error = -1; //The pec_error variable is simply set negative if any PEC errors
-          ic[c_ic].stat.pec_match[stat_reg-1]=1;
-          //are detected in the received serial data
-        }
-        else
-        {
-          ic[c_ic].stat.pec_match[stat_reg-1]=0;
-        }
-
-        data_counter=data_counter+2;                        //Because the transmitted PEC code is 2 bytes long the data_counter
-        //must be incremented by 2 bytes to point to the next ICs gpio voltage data
-      }
-
-
-    }
-
-  }
-  else
-  {
-
-    LTC681x_rdstat_reg(reg, total_ic, data);
-    for (int current_ic = 0 ; current_ic < total_ic; current_ic++)            // executes for every LTC6811 in the daisy chain
-    {
-      // current_ic is used as an IC counter
-      if (ic->isospi_reverse == false)
-      {
-        c_ic = current_ic;
-      }
-      else
-      {
-        c_ic = total_ic - current_ic - 1;
-      }
-      if (reg ==1)
-      {
-        for (uint8_t current_gpio = 0; current_gpio< GPIO_IN_REG; current_gpio++) // This loop parses the read back data into GPIO voltages, it
-        {
-          // loops once for each of the 3 gpio voltage codes in the register
-          parsed_stat = data[data_counter] + (data[data_counter+1]<<8);              //Each gpio codes is received as two bytes and is combined to
-          // create the parsed gpio voltage code
-
-          ic[c_ic].stat.stat_codes[current_gpio] = parsed_stat;
-          data_counter=data_counter+2;                        //Because gpio voltage codes are two bytes the data counter
-          //must increment by two for each parsed gpio voltage code
-
-        }
-      }
-      else if (reg == 2)
-      {
-        parsed_stat = data[data_counter++] + (data[data_counter++]<<8);              //Each gpio codes is received as two bytes and is combined to
-        ic[c_ic].stat.stat_codes[3] = parsed_stat;
-        ic[c_ic].stat.flags[0] = data[data_counter++];
-        ic[c_ic].stat.flags[1] = data[data_counter++];
-        ic[c_ic].stat.flags[2] = data[data_counter++];
-        ic[c_ic].stat.mux_fail[0] = (data[data_counter] & 0x02)>>1;
-        ic[c_ic].stat.thsd[0] = data[data_counter++] & 0x01;
-      }
-
-
-      received_pec = (data[data_counter]<<8)+ data[data_counter+1];          //The received PEC for the current_ic is transmitted as the 7th and 8th
-      //after the 6 gpio voltage data bytes
-      data_pec = pec15_calc(BYT_IN_REG, &data[current_ic*NUM_RX_BYT]);
-      if (received_pec != data_pec)
-      {
-        pec_error = -1;                             //The pec_error variable is simply set negative if any PEC errors
-        ic[c_ic].stat.pec_match[reg-1]=1;
-
-      }
-
-      data_counter=data_counter+2;
-    }
-  }
+  LTC681x_stat_sink sink(ic);
+  uint8_t errors = LTC681x_core::read_stat<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, sink);
   LTC681x_check_pec(total_ic,STAT,ic);
-  free(data);
-  return (pec_error);
+  return ((errors != 0) ? -1 : 0);
 }
 
 //Write the LTC681x CFGRA
@@ -963,94 +504,23 @@ void LTC681x_wrcfg(uint8_t total_ic, //The number of ICs being written to
                    cell_asic ic[]
                   )
 {
-  uint8_t cmd[2] = {0x00 , 0x01} ;
-  uint8_t write_buffer[256];
-  uint8_t write_count = 0;
-  uint8_t c_ic = 0;
-  for (uint8_t current_ic = 0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == true)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-
-    for (uint8_t data = 0; data<6; data++)
-    {
-      write_buffer[write_count] = ic[c_ic].config.tx_data[data];
-      write_count++;
-    }
-  }
-  write_68(total_ic, cmd, write_buffer);
+  LTC681x_write_reg(LTC681x_core::chip::WRCFGA, total_ic, ic, &cell_asic::config);
 }
 
 //Write the LTC681x CFGRB
 void LTC681x_wrcfgb(uint8_t total_ic, //The number of ICs being written to
                     cell_asic ic[]
                    )
-{
-  uint8_t cmd[2] = {0x00 , 0x24} ;
-  uint8_t write_buffer[256];
-  uint8_t write_count = 0;
-  uint8_t c_ic = 0;
-  for (uint8_t current_ic = 0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == true)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-
-    for (uint8_t data = 0; data<6; data++)
-    {
-      write_buffer[write_count] = ic[c_ic].configb.tx_data[data];
-      write_count++;
-    }
-  }
-  write_68(total_ic, cmd, write_buffer);
-}
-
-//Read CFGA
-int8_t LTC681x_rdcfg(uint8_t total_ic, //Number of ICs in the system
-                     cell_asic ic[]
-                    )
-{
-  uint8_t cmd[2]= {0x00 , 0x02};
-  uint8_t read_buffer[256];
-  int8_t pec_error = 0;
-  uint16_t data_pec;
-  uint16_t calc_pec;
-  uint8_t c_ic = 0;
-  pec_error = read_68(total_ic, cmd, read_buffer);
-  for (uint8_t current_ic = 0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == false)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-
-    for (int byte=0; byte<8; byte++)
-    {
-      ic[c_ic].config.rx_data[byte] = read_buffer[byte+(8*current_ic)];
-    }
-    calc_pec = pec15_calc(6,&read_buffer[8*current_ic]);
-    data_pec = read_buffer[7+(8*current_ic)] | (read_buffer[6+(8*current_ic)]<<8);
-    if (calc_pec != data_pec )
-    {
-      ic[c_ic].config.rx_pec_match = 1;
-    }
-    else ic[c_ic].config.rx_pec_match = 0;
-  }
+{
+  LTC681x_write_reg(LTC681x_core::chip::WRCFGB, total_ic, ic, &cell_asic::configb);
+}
+
+//Read CFGA
+int8_t LTC681x_rdcfg(uint8_t total_ic, //Number of ICs in the system
+                     cell_asic ic[]
+                    )
+{
+  int8_t pec_error = LTC681x_read_reg(LTC681x_core::chip::RDCFGA, total_ic, ic, &cell_asic::config);
   LTC681x_check_pec(total_ic,CFGR,ic);
   return(pec_error);
 }
@@ -1060,36 +530,7 @@ int8_t LTC681x_rdcfgb(uint8_t total_ic, //Number of ICs in the system
                       cell_asic ic[]
                      )
 {
-  uint8_t cmd[2]= {0x00 , 0x26};
-  uint8_t read_buffer[256];
-  int8_t pec_error = 0;
-  uint16_t data_pec;
-  uint16_t calc_pec;
-  uint8_t c_ic = 0;
-  pec_error = read_68(total_ic, cmd, read_buffer);
-  for (uint8_t current_ic = 0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == false)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-
-    for (int byte=0; byte<8; byte++)
-    {
-      ic[c_ic].configb.rx_data[byte] = read_buffer[byte+(8*current_ic)];
-    }
-    calc_pec = pec15_calc(6,&read_buffer[8*current_ic]);
-    data_pec = read_buffer[7+(8*current_ic)] | (read_buffer[6+(8*current_ic)]<<8);
-    if (calc_pec != data_pec )
-    {
-      ic[c_ic].configb.rx_pec_match = 1;
-    }
-    else ic[c_ic].configb.rx_pec_match = 0;
-  }
+  int8_t pec_error = LTC681x_read_reg(LTC681x_core::chip::RDCFGB, total_ic, ic, &cell_asic::configb);
   LTC681x_check_pec(total_ic,CFGRB,ic);
   return(pec_error);
 }
@@ -1268,68 +709,177 @@ int16_t LTC681x_run_adc_redundancy_st(uint8_t adc_mode, uint8_t adc_reg, uint8_t
 //Runs the datasheet algorithm for open wire
 void LTC681x_run_openwire(uint8_t total_ic, cell_asic ic[])
 {
-  uint16_t OPENWIRE_THRESHOLD = 4000;
-  const uint8_t  N_CHANNELS = ic[0].ic_reg.cell_channels;
-
-  cell_asic pullUp_cell_codes[total_ic];
-  cell_asic pullDwn_cell_codes[total_ic];
-  cell_asic openWire_delta[total_ic];
-  int8_t error;
+  uint16_t pu_codes[total_ic*ic[0].ic_reg.cell_channels];
+  ow_test ow;
 
   wakeup_sleep(total_ic);
-  LTC681x_adow(MD_7KHZ_3KHZ,PULL_UP_CURRENT);
-  LTC681x_pollAdc();
-  wakeup_idle(total_ic);
-  LTC681x_adow(MD_7KHZ_3KHZ,PULL_UP_CURRENT);
-  LTC681x_pollAdc();
-  wakeup_idle(total_ic);
-  error = LTC681x_rdcv(0, total_ic,pullUp_cell_codes);
-
-  wakeup_idle(total_ic);
-  LTC681x_adow(MD_7KHZ_3KHZ,PULL_DOWN_CURRENT);
-  LTC681x_pollAdc();
-  wakeup_idle(total_ic);
-  LTC681x_adow(MD_7KHZ_3KHZ,PULL_DOWN_CURRENT);
-  LTC681x_pollAdc();
-  wakeup_idle(total_ic);
-  error = LTC681x_rdcv(0, total_ic,pullDwn_cell_codes);
+  LTC681x_ow_start(&ow, total_ic, ic, pu_codes);
+  while (LTC681x_ow_step(&ow, total_ic, ic) != OW_DONE)
+  {
+    if (LTC681x_ow_busy(&ow))
+    {
+      LTC681x_pollAdc();
+    }
+  }
+}
 
-  for (int cic=0; cic<total_ic; cic++)
+//Keeps the pull up cell codes of the open wire test
+struct LTC681x_ow_pu_sink
+{
+  ow_test *ow;
+  uint8_t cells;
+  LTC681x_ow_pu_sink(ow_test *ow_, uint8_t cells_) : ow(ow_), cells(cells_) {}
+  void operator()(uint8_t stack_ic, uint8_t reg, const uint8_t *data, uint8_t pec_error)
   {
-    ic[cic].system_open_wire =0;
-    for (int cell=0; cell<N_CHANNELS; cell++)
+    uint16_t codes[LTC68XX_CODES_IN_REG];
+
+    LTC681x_core::parse_codes(data, codes);
+    for (uint8_t i = 0; i < LTC68XX_CODES_IN_REG; i++)
     {
-      if (pullDwn_cell_codes[cic].cells.c_codes[cell]>pullUp_cell_codes[cic].cells.c_codes[cell])
-      {
-        openWire_delta[cic].cells.c_codes[cell] = pullDwn_cell_codes[cic].cells.c_codes[cell] - pullUp_cell_codes[cic].cells.c_codes[cell]  ;
-      }
-      else
+      uint8_t cell = (reg - 1)*LTC68XX_CODES_IN_REG + i;
+      if (cell < cells)
       {
-        openWire_delta[cic].cells.c_codes[cell] = 0;
+        // 0xFFFF can not be exceeded by a pull down code and is not 0, so unread cells are never flagged
+        ow->pu_codes[stack_ic*cells + cell] = pec_error ? 0xFFFF : codes[i];
       }
-
     }
   }
-  for (int cic=0; cic<total_ic; cic++)
+};
+
+//Compares the pull down cell codes with the kept pull up codes as they are read
+struct LTC681x_ow_pd_sink
+{
+  ow_test *ow;
+  cell_asic *ic;
+  uint8_t cells;
+  LTC681x_ow_pd_sink(ow_test *ow_, cell_asic *ic_, uint8_t cells_) : ow(ow_), ic(ic_), cells(cells_) {}
+  void operator()(uint8_t stack_ic, uint8_t reg, const uint8_t *data, uint8_t pec_error)
   {
-    for (int cell=1; cell<N_CHANNELS; cell++)
+    uint16_t codes[LTC68XX_CODES_IN_REG];
+
+    if (pec_error)
+    {
+      return;
+    }
+    LTC681x_core::parse_codes(data, codes);
+    for (uint8_t i = 0; i < LTC68XX_CODES_IN_REG; i++)
     {
+      uint8_t cell = (reg - 1)*LTC68XX_CODES_IN_REG + i;
+      uint16_t pu;
 
-      if (openWire_delta[cic].cells.c_codes[cell]>OPENWIRE_THRESHOLD)
+      if (cell >= cells)
       {
-        ic[cic].system_open_wire += (1<<cell);
-
+        break;
+      }
+      pu = ow->pu_codes[stack_ic*cells + cell];
+      if (cell == 0)
+      {
+        if (pu == 0)      // Pull up CELL1 = 0: C0 open
+        {
+          ic[stack_ic].system_open_wire |= 1;
+        }
+      }
+      else if (codes[i] > pu && (codes[i] - pu) > OPENWIRE_THRESHOLD)   // Pull up minus pull down CELL(n+1) < -400mV: C(n) open
+      {
+        ic[stack_ic].system_open_wire |= (1L << cell);
+      }
+      if (cell == cells - 1 && codes[i] == 0)    // Pull down CELL(top) = 0: C(top) open
+      {
+        ic[stack_ic].system_open_wire |= (1L << cells);
       }
     }
-    if (pullUp_cell_codes[cic].cells.c_codes[0] == 0)
+  }
+};
+
+//Picks the ADC mode that gives the open wire pull currents enough time in the least total conversion time
+uint8_t LTC681x_ow_mode(uint8_t adcopt, uint8_t *md)
+{
+  const uint32_t min_pull_us = 2*LTC681x_core::chip::conv_time_us(MD_7KHZ_3KHZ, 0, LTC681x_core::chip::adcv_steps);
+  uint32_t best_us = 0xFFFFFFFF;
+  uint8_t best_repeats = 2;
+
+  *md = MD_7KHZ_3KHZ;
+  for (uint8_t mode = MD_422HZ_1KHZ; mode <= MD_26HZ_2KHZ; mode++)
+  {
+    uint32_t conv_us = LTC681x_core::chip::conv_time_us(mode, adcopt, LTC681x_core::chip::adcv_steps);
+    uint8_t repeats = (uint8_t)((min_pull_us + conv_us - 1)/conv_us);
+    if ((uint32_t)repeats*conv_us < best_us)
     {
-      ic[cic].system_open_wire += 1;
+      best_us = (uint32_t)repeats*conv_us;
+      best_repeats = repeats;
+      *md = mode;
     }
-    if (pullUp_cell_codes[cic].cells.c_codes[N_CHANNELS-1] == 0)
+  }
+  return(best_repeats);
+}
+
+//Prepares an open wire test
+void LTC681x_ow_start(ow_test *ow, uint8_t /*total_ic*/, cell_asic ic[], uint16_t *pu_codes)
+{
+  ow->pu_codes = pu_codes;
+  ow->repeats = LTC681x_ow_mode(ic[0].config.tx_data[0] & 0x01, &ow->md);
+  ow->count = 0;
+  ow->polls = 0;
+  ow->tries = 0;
+  ow->pec_errors = 0;
+  ow->state = OW_PULL_UP;
+}
+
+//Advances an open wire test by at most one ADOW command or one read of the cell registers
+uint8_t LTC681x_ow_step(ow_test *ow, uint8_t total_ic, cell_asic ic[])
+{
+  const uint8_t cells = ic[0].ic_reg.cell_channels;
+  uint8_t errors;
+
+  if (ow->state != OW_PULL_UP && ow->state != OW_PULL_DOWN)
+  {
+    return(ow->state);
+  }
+
+  wakeup_idle(total_ic);
+  if (ow->count > 0 && LTC681x_pladc() == 0 && ++ow->polls < 20000)
+  {
+    return(ow->state);      // ADOW still converting, the poll limit stops a missing chain from hanging the test
+  }
+  if (ow->count < ow->repeats)
+  {
+    LTC681x_adow(ow->md, ow->state == OW_PULL_UP ? PULL_UP_CURRENT : PULL_DOWN_CURRENT);
+    ow->count++;
+    ow->polls = 0;
+    return(ow->state);
+  }
+
+  ow->tries++;
+  if (ow->state == OW_PULL_UP)
+  {
+    LTC681x_ow_pu_sink sink(ow, cells);
+    errors = LTC681x_core::read_cells<LTC681x_bus>(0, total_ic, ic[0].isospi_reverse, sink, ic[0].ic_reg.num_cv_reg);
+  }
+  else
+  {
+    LTC681x_ow_pd_sink sink(ow, ic, cells);
+    for (uint8_t cic = 0; cic < total_ic; cic++)
     {
-      ic[cic].system_open_wire += (1<<(N_CHANNELS));
+      ic[cic].system_open_wire = 0;
     }
+    errors = LTC681x_core::read_cells<LTC681x_bus>(0, total_ic, ic[0].isospi_reverse, sink, ic[0].ic_reg.num_cv_reg);
   }
+  if (errors != 0 && ow->tries < 3)
+  {
+    return(ow->state);      // The registers still hold the ADOW results, read them again on the next step
+  }
+
+  ow->pec_errors += errors;
+  ow->count = 0;
+  ow->tries = 0;
+  ow->state = (ow->state == OW_PULL_UP) ? OW_PULL_DOWN : OW_DONE;
+  return(ow->state);
+}
+
+//Returns true while ADOW results are waiting in the cell registers
+bool LTC681x_ow_busy(ow_test *ow)
+{
+  return (ow->state == OW_PULL_UP || ow->state == OW_PULL_DOWN) && ow->count > 0;
 }
 
 // Runs the ADC overlap test for the IC
@@ -1435,6 +985,241 @@ void LTC681x_reset_crc_count(uint8_t total_ic, cell_asic ic[])
   }
 }
 
+//Returns the pec_match flags of the register groups of one type
+static uint8_t *LTC681x_pec_flags(uint8_t type, cell_asic *ic)
+{
+  switch (type)
+  {
+    case AUX:
+      return ic->aux.pec_match;
+    case STAT:
+      return ic->stat.pec_match;
+    default:
+      return ic->cells.pec_match;
+  }
+}
+
+//Returns the PEC error counters of the register groups of one type
+static uint16_t *LTC681x_pec_counters(uint8_t type, cell_asic *ic)
+{
+  switch (type)
+  {
+    case AUX:
+      return ic->crc_count.aux_pec;
+    case STAT:
+      return ic->crc_count.stat_pec;
+    default:
+      return ic->crc_count.cell_pec;
+  }
+}
+
+//Returns the number of register groups of one type
+static uint8_t LTC681x_num_groups(uint8_t type, cell_asic *ic)
+{
+  switch (type)
+  {
+    case AUX:
+      return ic->ic_reg.num_gpio_reg;
+    case STAT:
+      return sizeof(ic->stat.pec_match);
+    default:
+      return ic->ic_reg.num_cv_reg;
+  }
+}
+
+//Passes a re-read register group on to sink only for the ICs whose last read of it failed
+template <class SINK>
+struct LTC681x_retry_sink
+{
+  cell_asic *ic;
+  uint8_t type;
+  SINK &sink;
+  uint8_t errors;
+  uint8_t link_errors;
+  LTC681x_retry_sink(cell_asic *ic_, uint8_t type_, SINK &sink_) : ic(ic_), type(type_), sink(sink_), errors(0), link_errors(0) {}
+  void operator()(uint8_t stack_ic, uint8_t reg, const uint8_t *data, uint8_t pec_error)
+  {
+    link_errors += pec_error;
+    if (LTC681x_pec_flags(type, &ic[stack_ic])[reg - 1])
+    {
+      sink(stack_ic, reg, data, pec_error);
+      if (pec_error)
+      {
+        errors++;
+        ic[stack_ic].crc_count.pec_count++;
+        LTC681x_pec_counters(type, &ic[stack_ic])[reg - 1]++;
+      }
+    }
+  }
+};
+
+//Reads one register group of every IC, updating only the ICs where it failed last time
+template <class SINK>
+static uint8_t LTC681x_reread_group(uint8_t type, uint8_t reg, uint8_t total_ic, cell_asic ic[], SINK &sink, pec_monitor *mon)
+{
+  LTC681x_retry_sink<SINK> retry(ic, type, sink);
+
+  switch (type)
+  {
+    case AUX:
+      LTC681x_core::read_aux<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, retry);
+      break;
+    case STAT:
+      LTC681x_core::read_stat<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, retry);
+      break;
+    default:
+      LTC681x_core::read_cells<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, retry);
+      break;
+  }
+  if (mon != 0)
+  {
+    LTC681x_pec_monitor_update(mon, total_ic, retry.link_errors);
+  }
+  return(retry.errors);
+}
+
+//Finds the register groups with a PEC error in the last read
+uint8_t LTC681x_pec_failed_groups(uint8_t type, uint8_t total_ic, cell_asic ic[])
+{
+  uint8_t failed = 0;
+
+  for (uint8_t current_ic = 0; current_ic < total_ic; current_ic++)
+  {
+    const uint8_t *flags = LTC681x_pec_flags(type, &ic[current_ic]);
+    for (uint8_t group = 0; group < LTC681x_num_groups(type, &ic[current_ic]); group++)
+    {
+      if (flags[group])
+      {
+        failed |= (1 << group);
+      }
+    }
+  }
+  return(failed);
+}
+
+//Re-reads only the register groups that had a PEC error in the last read
+uint8_t LTC681x_reread(uint8_t type, uint8_t total_ic, cell_asic ic[], uint8_t max_tries, pec_monitor *mon)
+{
+  uint8_t failed = LTC681x_pec_failed_groups(type, total_ic, ic);
+  uint8_t errors = 0;
+
+  for (uint8_t group = 0; group < 8; group++)
+  {
+    uint8_t group_errors = 1;
+
+    for (uint8_t tries = 0; (failed & (1 << group)) && group_errors != 0 && tries < max_tries; tries++)
+    {
+      wakeup_idle(total_ic);
+      if (type == AUX)
+      {
+        LTC681x_aux_sink sink(ic);
+        group_errors = LTC681x_reread_group(type, group + 1, total_ic, ic, sink, mon);
+      }
+      else if (type == STAT)
+      {
+        LTC681x_stat_sink sink(ic);
+        group_errors = LTC681x_reread_group(type, group + 1, total_ic, ic, sink, mon);
+      }
+      else
+      {
+        LTC681x_cell_sink sink(ic);
+        group_errors = LTC681x_reread_group(type, group + 1, total_ic, ic, sink, mon);
+      }
+    }
+  }
+
+  for (uint8_t current_ic = 0; current_ic < total_ic; current_ic++)
+  {
+    const uint8_t *flags = LTC681x_pec_flags(type, &ic[current_ic]);
+    for (uint8_t group = 0; group < LTC681x_num_groups(type, &ic[current_ic]); group++)
+    {
+      errors += flags[group];
+    }
+  }
+  return(errors);
+}
+
+//Sets up a PEC error rate monitor
+void LTC681x_pec_monitor_init(pec_monitor *mon, uint32_t max_hz, uint32_t min_hz, uint16_t window, uint16_t max_errors, uint8_t recover)
+{
+  mon->max_hz = max_hz;
+  mon->min_hz = min_hz;
+  mon->spi_hz = max_hz;
+  mon->window = window;
+  mon->max_errors = max_errors;
+  mon->recover = recover;
+  mon->clean = 0;
+  mon->reads = 0;
+  mon->errors = 0;
+  set_spi_freq(max_hz);
+}
+
+//Counts reads and PEC errors, and halves or doubles the SCK frequency at the end of each window
+uint32_t LTC681x_pec_monitor_update(pec_monitor *mon, uint16_t reads, uint16_t errors)
+{
+  uint32_t spi_hz = mon->spi_hz;
+
+  mon->reads += reads;
+  mon->errors += errors;
+  if (mon->reads < mon->window)
+  {
+    return(mon->spi_hz);
+  }
+
+  if (mon->errors > mon->max_errors)
+  {
+    mon->clean = 0;
+    spi_hz = (mon->spi_hz/2 > mon->min_hz) ? mon->spi_hz/2 : mon->min_hz;
+  }
+  else if (mon->errors <= mon->max_errors/4 && ++mon->clean >= mon->recover)
+  {
+    mon->clean = 0;
+    spi_hz = (mon->spi_hz*2 < mon->max_hz) ? mon->spi_hz*2 : mon->max_hz;
+  }
+  else if (mon->errors > mon->max_errors/4)
+  {
+    mon->clean = 0;
+  }
+  mon->reads = 0;
+  mon->errors = 0;
+
+  if (spi_hz != mon->spi_hz)
+  {
+    mon->spi_hz = spi_hz;
+    set_spi_freq(spi_hz);
+  }
+  return(mon->spi_hz);
+}
+
+//Sends the codes of the last reads as one binary datalog frame
+void LTC681x_datalog(LTC68xx_datalog *log, uint8_t total_ic, cell_asic ic[], bool cells, bool aux, bool stat, uint32_t timestamp)
+{
+  LTC68xx_datalog_begin(log, total_ic,
+                        cells ? ic[0].ic_reg.cell_channels : 0,
+                        aux ? ic[0].ic_reg.aux_channels : 0,
+                        stat ? ic[0].ic_reg.stat_channels : 0,
+                        timestamp);
+  for (uint8_t current_ic = 0; current_ic < total_ic; current_ic++)
+  {
+    uint16_t pec_errors = 0;
+
+    for (uint8_t i = 0; cells && i < ic[current_ic].ic_reg.num_cv_reg; i++)
+    {
+      pec_errors |= (ic[current_ic].cells.pec_match[i] ? 1 : 0) << i;
+    }
+    for (uint8_t i = 0; aux && i < ic[current_ic].ic_reg.num_gpio_reg; i++)
+    {
+      pec_errors |= (ic[current_ic].aux.pec_match[i] ? 1 : 0) << (LTC68XX_DATALOG_AUX_PEC + i);
+    }
+    for (uint8_t i = 0; stat && i < sizeof(ic[current_ic].stat.pec_match); i++)
+    {
+      pec_errors |= (ic[current_ic].stat.pec_match[i] ? 1 : 0) << (LTC68XX_DATALOG_STAT_PEC + i);
+    }
+    LTC68xx_datalog_ic(log, pec_errors, ic[current_ic].cells.c_codes, ic[current_ic].aux.a_codes, ic[current_ic].stat.stat_codes);
+  }
+  LTC68xx_datalog_end(log);
+}
+
 //Helper function to intialize CFG variables.
 void LTC681x_init_cfg(uint8_t total_ic, cell_asic ic[])
 {
@@ -1525,28 +1310,7 @@ void LTC681x_wrcomm(uint8_t total_ic, //The number of ICs being written to
                     cell_asic ic[]
                    )
 {
-  uint8_t cmd[2]= {0x07 , 0x21};
-  uint8_t write_buffer[256];
-  uint8_t write_count = 0;
-  uint8_t c_ic = 0;
-  for (uint8_t current_ic = 0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == true)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-
-    for (uint8_t data = 0; data<6; data++)
-    {
-      write_buffer[write_count] = ic[c_ic].com.tx_data[data];
-      write_count++;
-    }
-  }
-  write_68(total_ic, cmd, write_buffer);
+  LTC681x_write_reg(LTC681x_core::chip::WRCOMM, total_ic, ic, &cell_asic::com);
 }
 
 /*
@@ -1556,37 +1320,7 @@ int8_t LTC681x_rdcomm(uint8_t total_ic, //Number of ICs in the system
                       cell_asic ic[]
                      )
 {
-  uint8_t cmd[2]= {0x07 , 0x22};
-  uint8_t read_buffer[256];
-  int8_t pec_error = 0;
-  uint16_t data_pec;
-  uint16_t calc_pec;
-  uint8_t c_ic=0;
-  pec_error = read_68(total_ic, cmd, read_buffer);
-  for (uint8_t current_ic = 0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == false)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-
-    for (int byte=0; byte<8; byte++)
-    {
-      ic[c_ic].com.rx_data[byte] = read_buffer[byte+(8*current_ic)];
-    }
-    calc_pec = pec15_calc(6,&read_buffer[8*current_ic]);
-    data_pec = read_buffer[7+(8*current_ic)] | (read_buffer[6+(8*current_ic)]<<8);
-    if (calc_pec != data_pec )
-    {
-      ic[c_ic].com.rx_pec_match = 1;
-    }
-    else ic[c_ic].com.rx_pec_match = 0;
-  }
-  return(pec_error);
+  return(LTC681x_read_reg(LTC681x_core::chip::RDCOMM, total_ic, ic, &cell_asic::com));
 }
 
 /*
@@ -1596,14 +1330,8 @@ void LTC681x_stcomm()
 {
 
   uint8_t cmd[4];
-  uint16_t cmd_pec;
-
-  cmd[0] = 0x07;
-  cmd[1] = 0x23;
-  cmd_pec = pec15_calc(2, cmd);
-  cmd[2] = (uint8_t)(cmd_pec >> 8);
-  cmd[3] = (uint8_t)(cmd_pec);
 
+  LTC681x_core::cmd_frame(LTC681x_core::chip::STCOMM, cmd);
   cs_low(CS_PIN);
   spi_write_array(4,cmd);
   for (int i = 0; i<9; i++)
@@ -1620,38 +1348,14 @@ void LTC681x_wrpwm(uint8_t total_ic,
                    cell_asic ic[]
                   )
 {
-  uint8_t cmd[2];
-  uint8_t write_buffer[256];
-  uint8_t write_count = 0;
-  uint8_t c_ic = 0;
   if (pwmReg == 0)
   {
-    cmd[0] = 0x00;
-    cmd[1] = 0x20;
+    LTC681x_write_reg(0x020, total_ic, ic, &cell_asic::pwm);    //WRPWM
   }
   else
   {
-    cmd[0] = 0x00;
-    cmd[1] = 0x1C;
-  }
-
-  for (uint8_t current_ic = 0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == true)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-    for (uint8_t data = 0; data<6; data++)
-    {
-      write_buffer[write_count] = ic[c_ic].pwm.tx_data[data];
-      write_count++;
-    }
+    LTC681x_write_reg(0x01C, total_ic, ic, &cell_asic::pwm);    //WRPSB
   }
-  write_68(total_ic, cmd, write_buffer);
 }
 
 
@@ -1663,49 +1367,9 @@ int8_t LTC681x_rdpwm(uint8_t total_ic, //Number of ICs in the system
                      cell_asic ic[]
                     )
 {
-  const uint8_t BYTES_IN_REG = 8;
-
-  uint8_t cmd[4];
-  uint8_t read_buffer[256];
-  int8_t pec_error = 0;
-  uint16_t data_pec;
-  uint16_t calc_pec;
-  uint8_t c_ic = 0;
-
   if (pwmReg == 0)
   {
-    cmd[0] = 0x00;
-    cmd[1] = 0x22;
-  }
-  else
-  {
-    cmd[0] = 0x00;
-    cmd[1] = 0x1E;
-  }
-
-
-  pec_error = read_68(total_ic, cmd, read_buffer);
-  for (uint8_t current_ic =0; current_ic<total_ic; current_ic++)
-  {
-    if (ic->isospi_reverse == false)
-    {
-      c_ic = current_ic;
-    }
-    else
-    {
-      c_ic = total_ic - current_ic - 1;
-    }
-    for (int byte=0; byte<8; byte++)
-    {
-      ic[c_ic].pwm.rx_data[byte] = read_buffer[byte+(8*current_ic)];
-    }
-    calc_pec = pec15_calc(6,&read_buffer[8*current_ic]);
-    data_pec = read_buffer[7+(8*current_ic)] | (read_buffer[6+(8*current_ic)]<<8);
-    if (calc_pec != data_pec )
-    {
-      ic[c_ic].pwm.rx_pec_match = 1;
-    }
-    else ic[c_ic].pwm.rx_pec_match = 0;
+    return(LTC681x_read_reg(0x022, total_ic, ic, &cell_asic::pwm));    //RDPWM
   }
-  return(pec_error);
+  return(LTC681x_read_reg(0x01E, total_ic, ic, &cell_asic::pwm));      //RDPSB
 }
@@ -50,6 +50,9 @@ Copyright 2015 Linear Technology Corp. (LTC)
 #include <Arduino.h>
 #endif
 
+#include "LTC68xx.h"
+#include "bms_hardware.h"
+
 #define IC_LTC6813
 
 #define MD_422HZ_1KHZ 0
@@ -91,6 +94,12 @@ Copyright 2015 Linear Technology Corp. (LTC)
 #define PULL_UP_CURRENT 1
 #define PULL_DOWN_CURRENT 0
 
+#define OW_IDLE 0         //!< Open wire test not started
+#define OW_PULL_UP 1      //!< Open wire test running the pull up current conversions
+#define OW_PULL_DOWN 2    //!< Open wire test running the pull down current conversions
+#define OW_DONE 3         //!< Open wire test finished, results in system_open_wire
+#define OPENWIRE_THRESHOLD 4000   //!< Pull down minus pull up cell code above which a wire is open (400mV)
+
 
 
 #define NUM_RX_BYT 8
@@ -169,15 +178,35 @@ typedef struct
   long system_open_wire;
 } cell_asic;
 
+//! PEC error rate monitor that lowers the SCK frequency of a noisy chain, see LTC681x_pec_monitor_update().
+typedef struct
+{
+  uint32_t max_hz;      //!< Fastest SCK frequency
+  uint32_t min_hz;      //!< Slowest SCK frequency
+  uint32_t spi_hz;      //!< Current SCK frequency
+  uint16_t window;      //!< Register group reads in each evaluation window
+  uint16_t max_errors;  //!< PEC errors in a window above which the frequency is halved
+  uint8_t recover;      //!< Quiet windows (max_errors/4 or fewer errors) after which the frequency is doubled again
+  uint8_t clean;        //!< Quiet windows so far
+  uint16_t reads;       //!< Register group reads in the current window
+  uint16_t errors;      //!< PEC errors in the current window
+} pec_monitor;
+
+//! State of an open wire test run with LTC681x_ow_step().
+typedef struct
+{
+  uint16_t *pu_codes;   //!< Pull up cell codes, cell_channels per IC, supplied by the caller
+  uint8_t state;        //!< OW_IDLE, OW_PULL_UP, OW_PULL_DOWN or OW_DONE
+  uint8_t md;           //!< ADC mode of the ADOW conversions
+  uint8_t repeats;      //!< ADOW conversions needed for each current direction
+  uint8_t count;        //!< ADOW conversions started in the current direction
+  uint16_t polls;       //!< PLADC polls of the running conversion
+  uint8_t tries;        //!< Reads of the current direction's results
+  uint8_t pec_errors;   //!< Register groups left unread after the retries, those cells are not checked
+} ow_test;
 
 
 
-/*!   calculates  and returns the CRC15
-  @returns The calculated pec15 as an unsigned int
-*/
-uint16_t pec15_calc(uint8_t len, //!< the length of the data array being passed to the function
-                    uint8_t *data //!<  the array of data that the PEC will be generated from
-                   );
 
 /*!  Wake isoSPI up from idle state */
 void wakeup_idle(uint8_t total_ic);//!< number of ICs in the daisy chain
@@ -207,7 +236,7 @@ int8_t read_68( uint8_t total_ic, //!< number of ICs in the daisy chain
 void LTC681x_diagn();
 
 //! Sends the poll adc command
-//! @returns 1 byte read back after a pladc command. If the byte is not 0xFF ADC conversion has completed
+//! @returns 1 byte read back after a pladc command. The byte is 0 while a conversion is running and 0xFF when the ADC has finished
 uint8_t LTC681x_pladc();
 
 //! This function will block operation until the ADC has finished it's conversion
@@ -500,6 +529,49 @@ int16_t LTC681x_run_adc_redundancy_st(uint8_t adc_mode,
 void LTC681x_run_openwire(uint8_t total_ic,
                           cell_asic ic[]);
 
+/*! Picks the ADC mode for the open wire test
+
+ The datasheet algorithm runs ADOW at least twice in 7kHz mode for each
+ current direction, to give the pull currents time to move an open C pin.
+ That total conversion time is kept as the minimum and the mode reaching it
+ in the least time is chosen: 7kHz (2 ADOWs) with ADCOPT=0 and 14kHz
+ (4 ADOWs) with ADCOPT=1.
+ @return the number of ADOW conversions needed for each current direction
+ */
+uint8_t LTC681x_ow_mode(uint8_t adcopt, //!< ADCOPT bit of the configuration register
+                        uint8_t *md     //!< Returns the ADC mode to use
+                       );
+
+/*! Prepares an open wire test that is run by calling LTC681x_ow_step()
+
+ Only the pull up cell codes are kept between the two halves of the test,
+ in an array of total_ic*cell_channels codes supplied by the caller.
+ */
+void LTC681x_ow_start(ow_test *ow,          //!< Test state
+                      uint8_t total_ic,     //!< Number of ICs in the daisy chain
+                      cell_asic ic[],       //!< ASIC Variable, the configuration gives ADCOPT
+                      uint16_t *pu_codes    //!< total_ic*ic[0].ic_reg.cell_channels codes
+                     );
+
+/*! Advances an open wire test without waiting for the ADC
+
+ Each call does at most one short SPI transaction: it checks the running
+ conversion with PLADC and, once it has finished, starts the next ADOW or reads
+ the results of a current direction. Call it from the main loop; other
+ conversions may run whenever LTC681x_ow_busy() is false. When the test is
+ done the open wires are in system_open_wire: bit n is set when C(n) is open.
+ @return the state of the test, OW_DONE when finished
+ */
+uint8_t LTC681x_ow_step(ow_test *ow,        //!< Test state
+                        uint8_t total_ic,   //!< Number of ICs in the daisy chain
+                        cell_asic ic[]      //!< ASIC Variable, receives system_open_wire
+                       );
+
+/*! @return true while the open wire test has ADOW results in the cell registers that are not read yet.
+ Starting another conversion then would corrupt the test.*/
+bool LTC681x_ow_busy(ow_test *ow  //!< Test state
+                    );
+
 /*! Helper Function that runs the ADC Overlap test*/
 uint16_t LTC681x_run_adc_overlap(uint8_t total_ic,
                                  cell_asic ic[]);
@@ -512,6 +584,54 @@ void LTC681x_check_pec(uint8_t total_ic,
 void LTC681x_reset_crc_count(uint8_t total_ic,
                              cell_asic ic[]);
 
+/*! Helper Function that finds the register groups with a PEC error in the last read
+ @return bit g-1 set for each register group g of type that had a PEC error on any IC*/
+uint8_t LTC681x_pec_failed_groups(uint8_t type,      //!< CELL, AUX or STAT
+                                  uint8_t total_ic,  //!< Number of ICs in the daisy chain
+                                  cell_asic ic[]     //!< ASIC Variable
+                                 );
+
+/*! Re-reads only the register groups that had a PEC error in the last read
+
+ Each failing group is read again from the whole daisy chain, but only the ICs
+ whose copy failed are updated, so good codes are never replaced. The pec_match
+ flags and the PEC counters are updated as the groups are read.
+ @return the number of IC register groups that still have a PEC error*/
+uint8_t LTC681x_reread(uint8_t type,       //!< CELL, AUX or STAT
+                       uint8_t total_ic,   //!< Number of ICs in the daisy chain
+                       cell_asic ic[],     //!< ASIC Variable
+                       uint8_t max_tries,  //!< Reads of each failing group at most
+                       pec_monitor *mon    //!< Monitor told about the re-reads, may be 0
+                      );
+
+/*! Sets up a PEC error rate monitor and sets the SCK frequency to max_hz*/
+void LTC681x_pec_monitor_init(pec_monitor *mon,    //!< Monitor
+                              uint32_t max_hz,     //!< Fastest SCK frequency
+                              uint32_t min_hz,     //!< Slowest SCK frequency
+                              uint16_t window,     //!< Register group reads in each evaluation window
+                              uint16_t max_errors, //!< PEC errors in a window above which the frequency is halved
+                              uint8_t recover      //!< Quiet windows (max_errors/4 or fewer errors) after which the frequency is doubled again
+                             );
+
+/*! Counts register group reads and PEC errors, and at the end of each window
+ halves or doubles the SCK frequency with set_spi_freq()
+ @return the SCK frequency now in use*/
+uint32_t LTC681x_pec_monitor_update(pec_monitor *mon,  //!< Monitor
+                                    uint16_t reads,    //!< Register group reads, one per IC per group
+                                    uint16_t errors    //!< Register group reads that had a PEC error
+                                   );
+
+/*! Sends the codes of the last reads as one binary datalog frame, see LTC68xx.h for the format.
+ The PEC error bitmap of each IC is built from the pec_match flags of the logged groups.*/
+void LTC681x_datalog(LTC68xx_datalog *log,  //!< Encoder, set up with LTC68xx_datalog_init()
+                     uint8_t total_ic,      //!< Number of ICs in the daisy chain
+                     cell_asic ic[],        //!< ASIC Variable
+                     bool cells,            //!< Log the cell codes
+                     bool aux,              //!< Log the GPIO and reference codes
+                     bool stat,             //!< Log the status codes
+                     uint32_t timestamp     //!< Time of the scan in milliseconds
+                    );
+
 /*! Helper Function to initialize the CFGR data structures*/
 void LTC681x_init_cfg(uint8_t total_ic,
                       cell_asic ic[]);
@@ -555,57 +675,137 @@ void LTC681x_set_cfgr_ov(uint8_t nIC,
 
 
 
-#ifdef MBED
-//This needs a PROGMEM =  when using with a LINDUINO
-const uint16_t crc15Table[256] {0x0,0xc599, 0xceab, 0xb32, 0xd8cf, 0x1d56, 0x1664, 0xd3fd, 0xf407, 0x319e, 0x3aac,  //!<precomputed CRC15 Table
-                                0xff35, 0x2cc8, 0xe951, 0xe263, 0x27fa, 0xad97, 0x680e, 0x633c, 0xa6a5, 0x7558, 0xb0c1,
-                                0xbbf3, 0x7e6a, 0x5990, 0x9c09, 0x973b, 0x52a2, 0x815f, 0x44c6, 0x4ff4, 0x8a6d, 0x5b2e,
-                                0x9eb7, 0x9585, 0x501c, 0x83e1, 0x4678, 0x4d4a, 0x88d3, 0xaf29, 0x6ab0, 0x6182, 0xa41b,
-                                0x77e6, 0xb27f, 0xb94d, 0x7cd4, 0xf6b9, 0x3320, 0x3812, 0xfd8b, 0x2e76, 0xebef, 0xe0dd,
-                                0x2544, 0x2be, 0xc727, 0xcc15, 0x98c, 0xda71, 0x1fe8, 0x14da, 0xd143, 0xf3c5, 0x365c,
-                                0x3d6e, 0xf8f7,0x2b0a, 0xee93, 0xe5a1, 0x2038, 0x7c2, 0xc25b, 0xc969, 0xcf0, 0xdf0d,
-                                0x1a94, 0x11a6, 0xd43f, 0x5e52, 0x9bcb, 0x90f9, 0x5560, 0x869d, 0x4304, 0x4836, 0x8daf,
-                                0xaa55, 0x6fcc, 0x64fe, 0xa167, 0x729a, 0xb703, 0xbc31, 0x79a8, 0xa8eb, 0x6d72, 0x6640,
-                                0xa3d9, 0x7024, 0xb5bd, 0xbe8f, 0x7b16, 0x5cec, 0x9975, 0x9247, 0x57de, 0x8423, 0x41ba,
-                                0x4a88, 0x8f11, 0x57c, 0xc0e5, 0xcbd7, 0xe4e, 0xddb3, 0x182a, 0x1318, 0xd681, 0xf17b,
-                                0x34e2, 0x3fd0, 0xfa49, 0x29b4, 0xec2d, 0xe71f, 0x2286, 0xa213, 0x678a, 0x6cb8, 0xa921,
-                                0x7adc, 0xbf45, 0xb477, 0x71ee, 0x5614, 0x938d, 0x98bf, 0x5d26, 0x8edb, 0x4b42, 0x4070,
-                                0x85e9, 0xf84, 0xca1d, 0xc12f, 0x4b6, 0xd74b, 0x12d2, 0x19e0, 0xdc79, 0xfb83, 0x3e1a, 0x3528,
-                                0xf0b1, 0x234c, 0xe6d5, 0xede7, 0x287e, 0xf93d, 0x3ca4, 0x3796, 0xf20f, 0x21f2, 0xe46b, 0xef59,
-                                0x2ac0, 0xd3a, 0xc8a3, 0xc391, 0x608, 0xd5f5, 0x106c, 0x1b5e, 0xdec7, 0x54aa, 0x9133, 0x9a01,
-                                0x5f98, 0x8c65, 0x49fc, 0x42ce, 0x8757, 0xa0ad, 0x6534, 0x6e06, 0xab9f, 0x7862, 0xbdfb, 0xb6c9,
-                                0x7350, 0x51d6, 0x944f, 0x9f7d, 0x5ae4, 0x8919, 0x4c80, 0x47b2, 0x822b, 0xa5d1, 0x6048, 0x6b7a,
-                                0xaee3, 0x7d1e, 0xb887, 0xb3b5, 0x762c, 0xfc41, 0x39d8, 0x32ea, 0xf773, 0x248e, 0xe117, 0xea25,
-                                0x2fbc, 0x846, 0xcddf, 0xc6ed, 0x374, 0xd089, 0x1510, 0x1e22, 0xdbbb, 0xaf8, 0xcf61, 0xc453,
-                                0x1ca, 0xd237, 0x17ae, 0x1c9c, 0xd905, 0xfeff, 0x3b66, 0x3054, 0xf5cd, 0x2630, 0xe3a9, 0xe89b,
-                                0x2d02, 0xa76f, 0x62f6, 0x69c4, 0xac5d, 0x7fa0, 0xba39, 0xb10b, 0x7492, 0x5368, 0x96f1, 0x9dc3,
-                                0x585a, 0x8ba7, 0x4e3e, 0x450c, 0x8095
-                               };
-
-#else
-const uint16_t crc15Table[256] PROGMEM =  {0x0,0xc599, 0xceab, 0xb32, 0xd8cf, 0x1d56, 0x1664, 0xd3fd, 0xf407, 0x319e, 0x3aac,  //!<precomputed CRC15 Table
-                               0xff35, 0x2cc8, 0xe951, 0xe263, 0x27fa, 0xad97, 0x680e, 0x633c, 0xa6a5, 0x7558, 0xb0c1,
-                               0xbbf3, 0x7e6a, 0x5990, 0x9c09, 0x973b, 0x52a2, 0x815f, 0x44c6, 0x4ff4, 0x8a6d, 0x5b2e,
-                               0x9eb7, 0x9585, 0x501c, 0x83e1, 0x4678, 0x4d4a, 0x88d3, 0xaf29, 0x6ab0, 0x6182, 0xa41b,
-                               0x77e6, 0xb27f, 0xb94d, 0x7cd4, 0xf6b9, 0x3320, 0x3812, 0xfd8b, 0x2e76, 0xebef, 0xe0dd,
-                               0x2544, 0x2be, 0xc727, 0xcc15, 0x98c, 0xda71, 0x1fe8, 0x14da, 0xd143, 0xf3c5, 0x365c,
-                               0x3d6e, 0xf8f7,0x2b0a, 0xee93, 0xe5a1, 0x2038, 0x7c2, 0xc25b, 0xc969, 0xcf0, 0xdf0d,
-                               0x1a94, 0x11a6, 0xd43f, 0x5e52, 0x9bcb, 0x90f9, 0x5560, 0x869d, 0x4304, 0x4836, 0x8daf,
-                               0xaa55, 0x6fcc, 0x64fe, 0xa167, 0x729a, 0xb703, 0xbc31, 0x79a8, 0xa8eb, 0x6d72, 0x6640,
-                               0xa3d9, 0x7024, 0xb5bd, 0xbe8f, 0x7b16, 0x5cec, 0x9975, 0x9247, 0x57de, 0x8423, 0x41ba,
-                               0x4a88, 0x8f11, 0x57c, 0xc0e5, 0xcbd7, 0xe4e, 0xddb3, 0x182a, 0x1318, 0xd681, 0xf17b,
-                               0x34e2, 0x3fd0, 0xfa49, 0x29b4, 0xec2d, 0xe71f, 0x2286, 0xa213, 0x678a, 0x6cb8, 0xa921,
-                               0x7adc, 0xbf45, 0xb477, 0x71ee, 0x5614, 0x938d, 0x98bf, 0x5d26, 0x8edb, 0x4b42, 0x4070,
-                               0x85e9, 0xf84, 0xca1d, 0xc12f, 0x4b6, 0xd74b, 0x12d2, 0x19e0, 0xdc79, 0xfb83, 0x3e1a, 0x3528,
-                               0xf0b1, 0x234c, 0xe6d5, 0xede7, 0x287e, 0xf93d, 0x3ca4, 0x3796, 0xf20f, 0x21f2, 0xe46b, 0xef59,
-                               0x2ac0, 0xd3a, 0xc8a3, 0xc391, 0x608, 0xd5f5, 0x106c, 0x1b5e, 0xdec7, 0x54aa, 0x9133, 0x9a01,
-                               0x5f98, 0x8c65, 0x49fc, 0x42ce, 0x8757, 0xa0ad, 0x6534, 0x6e06, 0xab9f, 0x7862, 0xbdfb, 0xb6c9,
-                               0x7350, 0x51d6, 0x944f, 0x9f7d, 0x5ae4, 0x8919, 0x4c80, 0x47b2, 0x822b, 0xa5d1, 0x6048, 0x6b7a,
-                               0xaee3, 0x7d1e, 0xb887, 0xb3b5, 0x762c, 0xfc41, 0x39d8, 0x32ea, 0xf773, 0x248e, 0xe117, 0xea25,
-                               0x2fbc, 0x846, 0xcddf, 0xc6ed, 0x374, 0xd089, 0x1510, 0x1e22, 0xdbbb, 0xaf8, 0xcf61, 0xc453,
-                               0x1ca, 0xd237, 0x17ae, 0x1c9c, 0xd905, 0xfeff, 0x3b66, 0x3054, 0xf5cd, 0x2630, 0xe3a9, 0xe89b,
-                               0x2d02, 0xa76f, 0x62f6, 0x69c4, 0xac5d, 0x7fa0, 0xba39, 0xb10b, 0x7492, 0x5368, 0x96f1, 0x9dc3,
-                               0x585a, 0x8ba7, 0x4e3e, 0x450c, 0x8095
-                                          };
-#endif
+/*
+ Core of the LTC681x functions
+
+ The register framing, PEC checking and parsing shared with the LTC6804
+ libraries lives in the LTC68xx core. The structures below connect it to
+ the bms_hardware SPI port and to the cell_asic data structure. The
+ LTC681x_*_chip() templates read with the register counts of a fixed part,
+ the LTC681x_* functions with the counts set in ic[0].ic_reg.
+*/
+
+//! LTC681x core with the LTC6813 command set, which includes every LTC6811 command
+typedef LTC68xx<LTC6813_traits> LTC681x_core;
+
+//! SPI transport of the LTC681x libraries
+struct LTC681x_bus
+{
+  static inline void select()
+  {
+    cs_low(CS_PIN);
+  }
+  static inline void deselect()
+  {
+    cs_high(CS_PIN);
+  }
+  static inline void write_read(uint8_t *tx, uint8_t tx_len, uint8_t *rx, uint8_t rx_len)
+  {
+    spi_write_read(tx, tx_len, rx, rx_len);
+  }
+};
+
+//! Stores cell voltage register groups in cell_asic
+struct LTC681x_cell_sink
+{
+  cell_asic *ic;
+  LTC681x_cell_sink(cell_asic *ic_) : ic(ic_) {}
+  void operator()(uint8_t stack_ic, uint8_t reg, const uint8_t *data, uint8_t pec_error)
+  {
+    LTC681x_core::parse_codes(data, &ic[stack_ic].cells.c_codes[(reg - 1)*LTC68XX_CODES_IN_REG]);
+    ic[stack_ic].cells.pec_match[reg - 1] = pec_error;
+  }
+};
+
+//! Stores auxiliary register groups in cell_asic
+struct LTC681x_aux_sink
+{
+  cell_asic *ic;
+  LTC681x_aux_sink(cell_asic *ic_) : ic(ic_) {}
+  void operator()(uint8_t stack_ic, uint8_t reg, const uint8_t *data, uint8_t pec_error)
+  {
+    const uint8_t max_codes = sizeof(ic[0].aux.a_codes)/sizeof(ic[0].aux.a_codes[0]);
+    uint16_t codes[LTC68XX_CODES_IN_REG];
+
+    LTC681x_core::parse_codes(data, codes);
+    for (uint8_t i = 0; i < LTC68XX_CODES_IN_REG; i++)
+    {
+      uint8_t code = (reg - 1)*LTC68XX_CODES_IN_REG + i;
+      if (code < max_codes)       // AUXD of the LTC6813 only has room for GPIO9
+      {
+        ic[stack_ic].aux.a_codes[code] = codes[i];
+      }
+    }
+    ic[stack_ic].aux.pec_match[reg - 1] = pec_error;
+  }
+};
+
+//! Stores status register groups in cell_asic
+struct LTC681x_stat_sink
+{
+  cell_asic *ic;
+  LTC681x_stat_sink(cell_asic *ic_) : ic(ic_) {}
+  void operator()(uint8_t stack_ic, uint8_t reg, const uint8_t *data, uint8_t pec_error)
+  {
+    st *stat = &ic[stack_ic].stat;
+
+    if (reg == 1)
+    {
+      LTC681x_core::parse_codes(data, &stat->stat_codes[0]);
+    }
+    else
+    {
+      stat->stat_codes[3] = data[0] | (data[1] << 8);
+      stat->flags[0] = data[2];
+      stat->flags[1] = data[3];
+      stat->flags[2] = data[4];
+      stat->mux_fail[0] = (data[5] & 0x02) >> 1;
+      stat->thsd[0] = data[5] & 0x01;
+    }
+    stat->pec_match[reg - 1] = pec_error;
+  }
+};
+
+//! Reads and parses the cell voltage registers of a fixed part.
+//! @return the number of register groups received with a PEC error
+template <class CHIP>
+uint8_t LTC681x_rdcv_chip(uint8_t reg,        //!< Register group, 1 = A, 0 for all
+                          uint8_t total_ic,   //!< the number of ICs in the system
+                          cell_asic ic[]      //!< Measurement Data Structure
+                         )
+{
+  LTC681x_cell_sink sink(ic);
+  uint8_t pec_error = LTC68xx<CHIP>::template read_cells<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, sink);
+  LTC681x_check_pec(total_ic, CELL, ic);
+  return pec_error;
+}
+
+//! Reads and parses the auxiliary registers of a fixed part.
+//! @return 0 if all data was received without PEC errors, 1 if not
+template <class CHIP>
+int8_t LTC681x_rdaux_chip(uint8_t reg,        //!< Register group, 1 = A, 0 for all
+                          uint8_t total_ic,   //!< the number of ICs in the system
+                          cell_asic ic[]      //!< Measurement Data Structure
+                         )
+{
+  LTC681x_aux_sink sink(ic);
+  uint8_t errors = LTC68xx<CHIP>::template read_aux<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, sink);
+  LTC681x_check_pec(total_ic, AUX, ic);
+  return (errors != 0) ? 1 : 0;
+}
+
+//! Reads and parses the status registers of a fixed part.
+//! @return 0 if all data was received without PEC errors, -1 if not
+template <class CHIP>
+int8_t LTC681x_rdstat_chip(uint8_t reg,       //!< Register group, 1 = A, 0 for all
+                           uint8_t total_ic,  //!< the number of ICs in the system
+                           cell_asic ic[]     //!< Measurement Data Structure
+                          )
+{
+  LTC681x_stat_sink sink(ic);
+  uint8_t errors = LTC68xx<CHIP>::template read_stat<LTC681x_bus>(reg, total_ic, ic[0].isospi_reverse, sink);
+  LTC681x_check_pec(total_ic, STAT, ic);
+  return (errors != 0) ? -1 : 0;
+}
+
 #endif
@@ -67,6 +67,23 @@ void delay_m(uint16_t milli)
   delay(milli);
 }
 
+/*
+Sets the SCK frequency to the fastest rate the SPI port can make that is not above spi_hz
+*/
+void set_spi_freq(uint32_t spi_hz)
+{
+  const uint8_t dividers[7] = {SPI_CLOCK_DIV2, SPI_CLOCK_DIV4, SPI_CLOCK_DIV8, SPI_CLOCK_DIV16,
+                               SPI_CLOCK_DIV32, SPI_CLOCK_DIV64, SPI_CLOCK_DIV128
+                              };
+  uint8_t i = 0;
+
+  while (i < 6 && (F_CPU >> (i + 1)) > spi_hz)
+  {
+    i++;
+  }
+  SPI.setClockDivider(dividers[i]);
+}
+
 /*
 Writes an array of bytes out of the SPI port
 */
@@ -57,7 +57,10 @@ void delay_u(uint16_t micro);
 
 void delay_m(uint16_t milli);
 
-void set_spi_freq();
+/*
+Sets the SCK frequency to the fastest rate the SPI port can make that is not above spi_hz
+*/
+void set_spi_freq(uint32_t spi_hz);
 
 
 /*
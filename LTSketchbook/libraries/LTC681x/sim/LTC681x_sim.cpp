@@ -0,0 +1,1019 @@
+/*!
+  LTC681x daisy chain simulator
+@verbatim
+  See LTC681x_sim.h.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "LTC681x_sim.h"
+
+#define CORE_SLEEP 0
+#define CORE_STANDBY 1
+#define CORE_REFUP 2
+
+#define PORT_IDLE 0
+#define PORT_WAKING 1
+#define PORT_READY 2
+
+#define FRAME_MAX (4 + 8*SIM_MAX_IC + 16)
+#define NO_CMD 0xFFFF
+
+#define ADOW_NONE 0
+#define ADOW_PUP 1
+#define ADOW_PDN 2
+
+//! ADC measurement that completes at a later time
+typedef struct
+{
+  uint16_t cmd;                 //!< 11 bit ADC command, NO_CMD when nothing is pending
+  uint64_t done_ns;             //!< Time at which the results appear in the registers
+} sim_conversion;
+
+//! State of one device in the chain
+typedef struct
+{
+  uint8_t core;
+  uint8_t port;
+  uint64_t port_ready_ns;       //!< Valid while port is PORT_WAKING
+  uint64_t last_activity_ns;
+
+  uint8_t cfga[6];
+  uint8_t cfgb[6];
+  uint8_t comm[6];
+  uint8_t pwm[6];
+  uint8_t psb[6];
+  uint8_t sctrl[6];
+  uint16_t cv[SIM_MAX_CELLS];
+  uint16_t aux[12];             //!< AUXA-AUXD as 16 bit words, REF2 at index 5
+  uint16_t stat[4];             //!< SC, ITMP, VA, VD
+  uint8_t flags[3];             //!< Cell OV/UV flags of STATB
+  uint8_t stat_misc;            //!< THSD, MUXFAIL and REV byte of STATB
+
+  sim_conversion conv;
+
+  int32_t cell_in[SIM_MAX_CELLS];
+  uint16_t gpio_in[SIM_MAX_GPIO];
+  uint32_t open_wire;
+
+  uint16_t frame_cmd;           //!< Command decoded in the current frame, NO_CMD if none
+  uint8_t frame_rx[FRAME_MAX];  //!< Bytes this device received in the current frame
+} sim_device;
+
+static ltc681x_sim_cfg sim_cfg;
+static ltc681x_sim_stats sim_stats;
+static sim_device sim_dev[SIM_MAX_IC];   // indexed by position in the chain, 0 is nearest the master
+static uint64_t sim_now_ns;
+static uint8_t sim_cs_level = 1;
+static uint8_t sim_reach;                // devices that see the current frame
+static uint16_t sim_frame_len;
+static uint32_t sim_rng_state;
+static uint64_t sim_mosi_skip;           // error free bits before the next injected error
+static uint64_t sim_miso_skip;
+static float sim_mosi_ber;               // bit error rates at the current SCK frequency
+static float sim_miso_ber;
+
+//! Conversion time of the first channel and of a complete 6 step cell conversion in us,
+//! indexed by (MD<<1)|ADCOPT. Typical values from the LTC6811 datasheet.
+static const uint32_t conv_time_us[8][2] =
+{
+  {2135, 12807},  // 422Hz
+  {1130, 6500},   // 1kHz
+  {201, 1113},    // 27kHz
+  {230, 1288},    // 14kHz
+  {405, 2335},    // 7kHz
+  {501, 3033},    // 3kHz
+  {34208, 201317},// 26Hz
+  {754, 4407}     // 2kHz
+};
+
+static uint32_t sim_rand()
+{
+  // xorshift32
+  uint32_t x = sim_rng_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  sim_rng_state = x;
+  return x;
+}
+
+// Number of error free bits before the next error, geometrically distributed
+static uint64_t sim_next_error(float ber)
+{
+  if (ber <= 0.0f)
+  {
+    return UINT64_MAX;
+  }
+  if (ber >= 1.0f)
+  {
+    return 0;
+  }
+  double u = ((double)sim_rand() + 1.0) / 4294967297.0;
+  return (uint64_t)floor(log(u) / log(1.0 - (double)ber));
+}
+
+// Pass one byte over one isoSPI link, flipping bits as the error rate dictates
+static uint8_t sim_link(uint8_t data, uint64_t *skip, float ber, uint32_t *counter)
+{
+  while (*skip < 8)
+  {
+    data ^= (uint8_t)(0x80 >> *skip);
+    (*counter)++;
+    *skip += 1 + sim_next_error(ber);
+  }
+  if (*skip != UINT64_MAX)
+  {
+    *skip -= 8;
+  }
+  return data;
+}
+
+// Bitwise CRC15, independent from the table driven pec15_calc() in the library
+static uint16_t sim_pec15(const uint8_t *data, uint8_t len)
+{
+  uint16_t remainder = 16;
+  for (uint8_t i = 0; i < len; i++)
+  {
+    for (int8_t bit = 7; bit >= 0; bit--)
+    {
+      uint8_t din = ((data[i] >> bit) & 0x01) ^ ((remainder >> 14) & 0x01);
+      remainder = (remainder << 1) & 0x7FFF;
+      if (din)
+      {
+        remainder ^= 0x4599;
+      }
+    }
+  }
+  return (uint16_t)(remainder << 1);
+}
+
+static uint8_t sim_cells()
+{
+  return (sim_cfg.part == SIM_LTC6813) ? 18 : 12;
+}
+
+static uint8_t sim_stack_pos(uint8_t chain_pos)
+{
+  return sim_cfg.isospi_reverse ? (uint8_t)(sim_cfg.total_ic - chain_pos - 1) : chain_pos;
+}
+
+static void sim_reset_registers(sim_device *dev)
+{
+  memset(dev->cfga, 0, sizeof(dev->cfga));
+  memset(dev->cfgb, 0, sizeof(dev->cfgb));
+  dev->cfga[0] = 0xF8;          // GPIO pull downs off
+  dev->cfgb[0] = 0x0F;
+  memset(dev->comm, 0, sizeof(dev->comm));
+  memset(dev->pwm, 0, sizeof(dev->pwm));
+  memset(dev->psb, 0, sizeof(dev->psb));
+  memset(dev->sctrl, 0, sizeof(dev->sctrl));
+  memset(dev->cv, 0xFF, sizeof(dev->cv));
+  memset(dev->aux, 0xFF, sizeof(dev->aux));
+  memset(dev->stat, 0xFF, sizeof(dev->stat));
+  memset(dev->flags, 0xFF, sizeof(dev->flags));
+  dev->stat_misc = 0xFF;
+  dev->conv.cmd = NO_CMD;
+}
+
+// Random noise in +/- noise_codes
+static int32_t sim_noise()
+{
+  if (sim_cfg.noise_codes == 0)
+  {
+    return 0;
+  }
+  return (int32_t)(sim_rand() % (2u*sim_cfg.noise_codes + 1)) - sim_cfg.noise_codes;
+}
+
+static uint16_t sim_clamp(int32_t code)
+{
+  if (code < 0)
+  {
+    return 0;
+  }
+  if (code > 0xFFFF)
+  {
+    return 0xFFFF;
+  }
+  return (uint16_t)code;
+}
+
+// Cell voltages as measured with open input wires. adow selects the open wire
+// current sources: C(n) is pulled up towards C(n+1) or down towards C(n-1).
+static void sim_measure_cells(const sim_device *dev, uint8_t adow, uint16_t *out)
+{
+  const uint8_t n = sim_cells();
+  int32_t wire[SIM_MAX_CELLS + 1];
+
+  wire[0] = 0;
+  for (uint8_t i = 0; i < n; i++)
+  {
+    wire[i+1] = wire[i] + dev->cell_in[i];
+  }
+
+  if (adow == ADOW_PUP)
+  {
+    for (int8_t w = n - 1; w >= 0; w--)
+    {
+      if (dev->open_wire & (1UL << w))
+      {
+        wire[w] = wire[w+1];
+      }
+    }
+  }
+  else if (adow == ADOW_PDN)
+  {
+    for (uint8_t w = 1; w <= n; w++)
+    {
+      if (dev->open_wire & (1UL << w))
+      {
+        wire[w] = wire[w-1];
+      }
+    }
+  }
+  else
+  {
+    for (uint8_t w = 1; w < n; w++)
+    {
+      if (dev->open_wire & (1UL << w))
+      {
+        wire[w] = (wire[w-1] + wire[w+1])/2;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < n; i++)
+  {
+    out[i] = sim_clamp(wire[i+1] - wire[i] + sim_noise());
+  }
+}
+
+static uint16_t sim_selftest_code(const sim_device *dev, uint8_t md, uint8_t st)
+{
+  uint8_t adcopt = dev->cfga[0] & 0x01;
+  if (md == 1 && adcopt == 0)
+  {
+    return (st == 1) ? 0x9565 : 0x6A9A;
+  }
+  if (md == 1)
+  {
+    return (st == 1) ? 0x9553 : 0x6AAC;
+  }
+  return (st == 1) ? 0x9555 : 0x6AAA;
+}
+
+static void sim_update_flags(sim_device *dev)
+{
+  uint16_t vuv = (uint16_t)(((dev->cfga[2] & 0x0F) << 8) | dev->cfga[1]);
+  uint16_t vov = (uint16_t)((dev->cfga[3] << 4) | (dev->cfga[2] >> 4));
+  uint32_t uv = ((uint32_t)vuv + 1) * 16;
+  uint32_t ov = (uint32_t)vov * 16;
+
+  memset(dev->flags, 0, sizeof(dev->flags));
+  for (uint8_t i = 0; i < 12; i++)
+  {
+    if (dev->cv[i] <= uv)
+    {
+      dev->flags[i/4] |= (uint8_t)(0x01 << (2*(i%4)));
+    }
+    if (dev->cv[i] > ov)
+    {
+      dev->flags[i/4] |= (uint8_t)(0x02 << (2*(i%4)));
+    }
+  }
+}
+
+static void sim_measure_gpio(sim_device *dev, uint8_t chg)
+{
+  const uint8_t gpios = (sim_cfg.part == SIM_LTC6813) ? 9 : 5;
+  for (uint8_t g = 0; g < gpios; g++)
+  {
+    // CHG 1-5 select GPIO1&6, GPIO2&7, ... CHG 6 selects only the second reference
+    if (chg == 0 || (chg <= 5 && (g % 5) == chg - 1))
+    {
+      uint8_t idx = (g < 5) ? g : g + 1;   // GPIO6-9 follow REF2 in AUXC/AUXD
+      dev->aux[idx] = sim_clamp(dev->gpio_in[g] + sim_noise());
+    }
+  }
+  if (chg == 0 || chg == 6)
+  {
+    dev->aux[5] = sim_clamp(30000 + sim_noise());
+  }
+}
+
+static void sim_measure_stat(sim_device *dev, uint8_t chst)
+{
+  if (chst == 0 || chst == 1)
+  {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < sim_cells(); i++)
+    {
+      sum += dev->cell_in[i];
+    }
+    dev->stat[0] = sim_clamp((int32_t)(sum/20));
+  }
+  if (chst == 0 || chst == 2)
+  {
+    dev->stat[1] = sim_clamp(22350 + sim_noise());   // 25C
+  }
+  if (chst == 0 || chst == 3)
+  {
+    dev->stat[2] = sim_clamp(50000 + sim_noise());
+  }
+  if (chst == 0 || chst == 4)
+  {
+    dev->stat[3] = sim_clamp(30000 + sim_noise());
+  }
+  dev->stat_misc = 0x00;
+}
+
+// Number of conversion steps of an ADC command, and 0 if cmd is not an ADC command
+static uint8_t sim_adc_steps(uint16_t cmd)
+{
+  uint8_t ch = cmd & 0x07;
+  if ((cmd & 0x66F) == 0x46F) return 8;                          // ADCVAX
+  if ((cmd & 0x66F) == 0x467) return 7;                          // ADCVSC
+  if ((cmd & 0x668) == 0x260) return (ch == 0) ? 6 : 1;          // ADCV
+  if ((cmd & 0x628) == 0x228) return 6;                          // ADOW
+  if ((cmd & 0x61F) == 0x207) return 6;                          // CVST
+  if ((cmd & 0x66F) == 0x201) return 1;                          // ADOL
+  if ((cmd & 0x678) == 0x460 || (cmd & 0x678) == 0x400)          // ADAX, ADAXD
+  {
+    if (ch != 0) return 1;
+    return (sim_cfg.part == SIM_LTC6813) ? 10 : 6;
+  }
+  if ((cmd & 0x61F) == 0x407) return (sim_cfg.part == SIM_LTC6813) ? 10 : 6;  // AXST
+  if ((cmd & 0x678) == 0x468 || (cmd & 0x678) == 0x408) return (ch == 0) ? 4 : 1; // ADSTAT, ADSTATD
+  if ((cmd & 0x61F) == 0x40F) return 4;                          // STATST
+  if (cmd == 0x715) return 2;                                    // DIAGN
+  return 0;
+}
+
+// Write the results of a finished conversion into the registers
+static void sim_complete_conversion(sim_device *dev)
+{
+  const uint16_t cmd = dev->conv.cmd;
+  const uint8_t md = (cmd >> 7) & 0x03;
+  const uint8_t ch = cmd & 0x07;
+  const uint8_t st = (cmd >> 5) & 0x03;
+  uint16_t cells[SIM_MAX_CELLS];
+
+  dev->conv.cmd = NO_CMD;
+  if ((cmd & 0x66F) == 0x46F || (cmd & 0x66F) == 0x467)     // ADCVAX, ADCVSC
+  {
+    sim_measure_cells(dev, ADOW_NONE, cells);
+    memcpy(dev->cv, cells, sim_cells()*sizeof(uint16_t));
+    sim_update_flags(dev);
+    if ((cmd & 0x0F) == 0x0F)
+    {
+      sim_measure_gpio(dev, 1);
+      sim_measure_gpio(dev, 2);
+    }
+    else
+    {
+      sim_measure_stat(dev, 1);
+    }
+  }
+  else if ((cmd & 0x668) == 0x260)                          // ADCV
+  {
+    sim_measure_cells(dev, ADOW_NONE, cells);
+    for (uint8_t i = 0; i < sim_cells(); i++)
+    {
+      if (ch == 0 || (i % 6) == ch - 1)
+      {
+        dev->cv[i] = cells[i];
+      }
+    }
+    sim_update_flags(dev);
+  }
+  else if ((cmd & 0x628) == 0x228)                          // ADOW
+  {
+    sim_measure_cells(dev, (cmd & 0x40) ? ADOW_PUP : ADOW_PDN, cells);
+    memcpy(dev->cv, cells, sim_cells()*sizeof(uint16_t));
+  }
+  else if ((cmd & 0x61F) == 0x207)                          // CVST
+  {
+    for (uint8_t i = 0; i < sim_cells(); i++)
+    {
+      dev->cv[i] = sim_selftest_code(dev, md, st);
+    }
+  }
+  else if ((cmd & 0x66F) == 0x201)                          // ADOL
+  {
+    sim_measure_cells(dev, ADOW_NONE, cells);
+    dev->cv[6] = cells[6];
+    dev->cv[7] = sim_clamp(cells[6] + sim_noise());
+    if (sim_cfg.part == SIM_LTC6813)
+    {
+      dev->cv[12] = cells[12];
+      dev->cv[13] = sim_clamp(cells[12] + sim_noise());
+    }
+  }
+  else if ((cmd & 0x678) == 0x460 || (cmd & 0x678) == 0x400)  // ADAX, ADAXD
+  {
+    sim_measure_gpio(dev, ch);
+  }
+  else if ((cmd & 0x61F) == 0x407)                          // AXST
+  {
+    for (uint8_t i = 0; i < 12; i++)
+    {
+      dev->aux[i] = sim_selftest_code(dev, md, st);
+    }
+  }
+  else if ((cmd & 0x678) == 0x468 || (cmd & 0x678) == 0x408)  // ADSTAT, ADSTATD
+  {
+    sim_measure_stat(dev, ch);
+  }
+  else if ((cmd & 0x61F) == 0x40F)                          // STATST
+  {
+    for (uint8_t i = 0; i < 4; i++)
+    {
+      dev->stat[i] = sim_selftest_code(dev, md, st);
+    }
+  }
+  else if (cmd == 0x715)                                    // DIAGN
+  {
+    dev->stat_misc &= (uint8_t)~0x02;
+  }
+}
+
+// Bring timeouts and pending conversions of every device up to date
+static void sim_update(uint64_t now)
+{
+  for (uint8_t k = 0; k < sim_cfg.total_ic; k++)
+  {
+    sim_device *dev = &sim_dev[k];
+
+    if (dev->conv.cmd != NO_CMD && now >= dev->conv.done_ns)
+    {
+      dev->last_activity_ns = dev->conv.done_ns;
+      sim_complete_conversion(dev);
+      if ((dev->cfga[0] & 0x04) == 0)
+      {
+        dev->core = CORE_STANDBY;
+      }
+    }
+    if (dev->port == PORT_WAKING && now >= dev->port_ready_ns)
+    {
+      dev->port = PORT_READY;
+      dev->last_activity_ns = dev->port_ready_ns;
+      if (dev->core == CORE_SLEEP)
+      {
+        dev->core = CORE_STANDBY;
+      }
+    }
+    if (dev->core != CORE_SLEEP && dev->conv.cmd == NO_CMD &&
+        now - dev->last_activity_ns > (uint64_t)sim_cfg.t_sleep_ms*1000000ULL)
+    {
+      dev->core = CORE_SLEEP;
+      dev->port = PORT_IDLE;
+      sim_reset_registers(dev);
+      sim_stats.sleeps++;
+    }
+    if (dev->port == PORT_READY &&
+        now - dev->last_activity_ns > (uint64_t)sim_cfg.t_idle_us*1000)
+    {
+      dev->port = PORT_IDLE;
+    }
+  }
+}
+
+// Fill an 8 byte register group as the device shifts it out, with its PEC
+static bool sim_read_group(const sim_device *dev, uint16_t cmd, uint8_t *out)
+{
+  const uint16_t *words = 0;
+  const bool is_6813 = (sim_cfg.part == SIM_LTC6813);
+
+  switch (cmd)
+  {
+    case 0x002:
+      memcpy(out, dev->cfga, 6);
+      break;
+    case 0x026:
+      if (!is_6813) return false;
+      memcpy(out, dev->cfgb, 6);
+      break;
+    case 0x004:
+      words = &dev->cv[0];
+      break;
+    case 0x006:
+      words = &dev->cv[3];
+      break;
+    case 0x008:
+      words = &dev->cv[6];
+      break;
+    case 0x00A:
+      words = &dev->cv[9];
+      break;
+    case 0x009:
+      if (!is_6813) return false;
+      words = &dev->cv[12];
+      break;
+    case 0x00B:
+      if (!is_6813) return false;
+      words = &dev->cv[15];
+      break;
+    case 0x00C:
+      words = &dev->aux[0];
+      break;
+    case 0x00E:
+      words = &dev->aux[3];
+      break;
+    case 0x00D:
+      if (!is_6813) return false;
+      words = &dev->aux[6];
+      break;
+    case 0x00F:
+      if (!is_6813) return false;
+      words = &dev->aux[9];
+      break;
+    case 0x010:
+      words = &dev->stat[0];
+      break;
+    case 0x012:
+      out[0] = (uint8_t)dev->stat[3];
+      out[1] = (uint8_t)(dev->stat[3] >> 8);
+      memcpy(&out[2], dev->flags, 3);
+      out[5] = dev->stat_misc;
+      break;
+    case 0x016:
+      memcpy(out, dev->sctrl, 6);
+      break;
+    case 0x022:
+      memcpy(out, dev->pwm, 6);
+      break;
+    case 0x01E:
+      if (!is_6813) return false;
+      memcpy(out, dev->psb, 6);
+      break;
+    case 0x722:
+      memcpy(out, dev->comm, 6);
+      break;
+    default:
+      return false;
+  }
+  if (words != 0)
+  {
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      out[2*i] = (uint8_t)words[i];
+      out[2*i + 1] = (uint8_t)(words[i] >> 8);
+    }
+  }
+  uint16_t pec = sim_pec15(out, 6);
+  out[6] = (uint8_t)(pec >> 8);
+  out[7] = (uint8_t)pec;
+  return true;
+}
+
+static uint8_t *sim_write_target(sim_device *dev, uint16_t cmd)
+{
+  const bool is_6813 = (sim_cfg.part == SIM_LTC6813);
+  switch (cmd)
+  {
+    case 0x001:
+      return dev->cfga;
+    case 0x024:
+      return is_6813 ? dev->cfgb : 0;
+    case 0x014:
+      return dev->sctrl;
+    case 0x020:
+      return dev->pwm;
+    case 0x01C:
+      return is_6813 ? dev->psb : 0;
+    case 0x721:
+      return dev->comm;
+    default:
+      return 0;
+  }
+}
+
+static bool sim_is_known_command(uint16_t cmd)
+{
+  uint8_t dummy[8];
+  if (sim_adc_steps(cmd) != 0 || sim_write_target(&sim_dev[0], cmd) != 0)
+  {
+    return true;
+  }
+  if (sim_read_group(&sim_dev[0], cmd, dummy))
+  {
+    return true;
+  }
+  switch (cmd)
+  {
+    case 0x711:   // CLRCELL
+    case 0x712:   // CLRAUX
+    case 0x713:   // CLRSTAT
+    case 0x714:   // PLADC
+    case 0x723:   // STCOMM
+    case 0x018:   // CLRSCTRL
+    case 0x028:   // MUTE
+    case 0x029:   // UNMUTE
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Act on a command once its 4 bytes have been received
+static void sim_execute(sim_device *dev, uint16_t cmd)
+{
+  uint8_t steps = sim_adc_steps(cmd);
+
+  if (steps != 0)
+  {
+    const uint8_t md = (cmd >> 7) & 0x03;
+    const uint8_t adcopt = dev->cfga[0] & 0x01;
+    const uint32_t *t = conv_time_us[(md << 1) | adcopt];
+    uint64_t t_us = t[0] + (uint64_t)(t[1] - t[0])*(steps - 1)/5;
+    if (cmd == 0x715)
+    {
+      t_us = 400;
+    }
+    if (dev->core != CORE_REFUP)
+    {
+      t_us += sim_cfg.t_refup_us;
+      dev->core = CORE_REFUP;
+    }
+    dev->conv.cmd = cmd;
+    dev->conv.done_ns = sim_now_ns + t_us*1000;
+    sim_stats.conversions++;
+    return;
+  }
+  switch (cmd)
+  {
+    case 0x711:
+      memset(dev->cv, 0xFF, sizeof(dev->cv));
+      break;
+    case 0x712:
+      memset(dev->aux, 0xFF, sizeof(dev->aux));
+      break;
+    case 0x713:
+      memset(dev->stat, 0xFF, sizeof(dev->stat));
+      memset(dev->flags, 0xFF, sizeof(dev->flags));
+      dev->stat_misc = 0xFF;
+      break;
+    case 0x018:
+      memset(dev->sctrl, 0, sizeof(dev->sctrl));
+      break;
+    default:
+      break;
+  }
+}
+
+// Apply a write command at the end of the frame. The device keeps the last
+// 8 bytes that reached it before the rest of the frame was shifted further
+// down the chain.
+static void sim_finish_write(uint8_t chain_pos)
+{
+  sim_device *dev = &sim_dev[chain_pos];
+  uint8_t *target = sim_write_target(dev, dev->frame_cmd);
+  uint16_t payload = sim_frame_len - 4;
+  uint16_t need = 8*(chain_pos + 1);
+
+  if (target == 0 || payload < need)
+  {
+    return;
+  }
+  const uint8_t *data = &dev->frame_rx[4 + payload - need];
+  uint16_t pec = (uint16_t)((data[6] << 8) | data[7]);
+  if (pec != sim_pec15(data, 6))
+  {
+    sim_stats.data_pec_errors++;
+    return;
+  }
+  memcpy(target, data, 6);
+  if (target == dev->cfga && (dev->cfga[0] & 0x04))
+  {
+    dev->core = CORE_REFUP;
+  }
+}
+
+void LTC681x_sim_default_cfg(ltc681x_sim_cfg *cfg)
+{
+  cfg->part = SIM_LTC6811;
+  cfg->total_ic = 1;
+  cfg->isospi_reverse = false;
+  cfg->spi_hz = 1000000;
+  cfg->byte_overhead_ns = 1500;
+  cfg->cs_overhead_ns = 4000;
+  cfg->t_wake_us = 300;
+  cfg->t_ready_us = 10;
+  cfg->t_idle_us = 5500;
+  cfg->t_sleep_ms = 2000;
+  cfg->t_refup_us = 3500;
+  cfg->mosi_ber = 0.0f;
+  cfg->miso_ber = 0.0f;
+  cfg->ber_ref_hz = 0;
+  cfg->noise_codes = 0;
+  cfg->seed = 1;
+}
+
+void LTC681x_sim_init(const ltc681x_sim_cfg *cfg)
+{
+  sim_cfg = *cfg;
+  if (sim_cfg.total_ic > SIM_MAX_IC)
+  {
+    sim_cfg.total_ic = SIM_MAX_IC;
+  }
+  memset(&sim_stats, 0, sizeof(sim_stats));
+  sim_now_ns = 0;
+  sim_cs_level = 1;
+  sim_reach = 0;
+  sim_frame_len = 0;
+  sim_rng_state = (cfg->seed != 0) ? cfg->seed : 1;
+
+  for (uint8_t k = 0; k < SIM_MAX_IC; k++)
+  {
+    sim_device *dev = &sim_dev[k];
+    memset(dev, 0, sizeof(*dev));
+    dev->core = CORE_SLEEP;
+    dev->port = PORT_IDLE;
+    sim_reset_registers(dev);
+    dev->frame_cmd = NO_CMD;
+  }
+  // A default pack with distinct voltages on every cell, 3.3V + 1mV*cell + 10mV*ic
+  for (uint8_t ic = 0; ic < sim_cfg.total_ic; ic++)
+  {
+    for (uint8_t cell = 0; cell < SIM_MAX_CELLS; cell++)
+    {
+      LTC681x_sim_set_cell(ic, cell, (uint16_t)(33000 + 10*cell + 100*ic));
+    }
+    for (uint8_t g = 0; g < SIM_MAX_GPIO; g++)
+    {
+      LTC681x_sim_set_gpio(ic, g, (uint16_t)(10000 + 1000*g));
+    }
+  }
+  LTC681x_sim_set_ber(cfg->mosi_ber, cfg->miso_ber);
+}
+
+void LTC681x_sim_set_ber(float mosi_ber, float miso_ber)
+{
+  float scale = 1.0f;
+
+  sim_cfg.mosi_ber = mosi_ber;
+  sim_cfg.miso_ber = miso_ber;
+  if (sim_cfg.ber_ref_hz != 0)
+  {
+    scale = (float)sim_cfg.spi_hz/sim_cfg.ber_ref_hz;
+    scale = scale*scale;
+  }
+  sim_mosi_ber = (mosi_ber*scale < 1.0f) ? mosi_ber*scale : 1.0f;
+  sim_miso_ber = (miso_ber*scale < 1.0f) ? miso_ber*scale : 1.0f;
+  sim_mosi_skip = sim_next_error(sim_mosi_ber);
+  sim_miso_skip = sim_next_error(sim_miso_ber);
+}
+
+void LTC681x_sim_set_spi_hz(uint32_t spi_hz)
+{
+  sim_cfg.spi_hz = (spi_hz != 0) ? spi_hz : 1;
+  LTC681x_sim_set_ber(sim_cfg.mosi_ber, sim_cfg.miso_ber);
+}
+
+uint32_t LTC681x_sim_get_spi_hz()
+{
+  return sim_cfg.spi_hz;
+}
+
+static sim_device *sim_stack_device(uint8_t stack_ic)
+{
+  if (stack_ic >= sim_cfg.total_ic)
+  {
+    return 0;
+  }
+  return &sim_dev[sim_stack_pos(stack_ic)];
+}
+
+void LTC681x_sim_set_cell(uint8_t stack_ic, uint8_t cell, uint16_t code)
+{
+  sim_device *dev = sim_stack_device(stack_ic);
+  if (dev != 0 && cell < SIM_MAX_CELLS)
+  {
+    dev->cell_in[cell] = code;
+  }
+}
+
+void LTC681x_sim_set_gpio(uint8_t stack_ic, uint8_t gpio, uint16_t code)
+{
+  sim_device *dev = sim_stack_device(stack_ic);
+  if (dev != 0 && gpio < SIM_MAX_GPIO)
+  {
+    dev->gpio_in[gpio] = code;
+  }
+}
+
+void LTC681x_sim_set_open_wire(uint8_t stack_ic, uint32_t wires)
+{
+  sim_device *dev = sim_stack_device(stack_ic);
+  if (dev != 0)
+  {
+    dev->open_wire = wires;
+  }
+}
+
+uint16_t LTC681x_sim_get_cell(uint8_t stack_ic, uint8_t cell)
+{
+  sim_device *dev = sim_stack_device(stack_ic);
+  if (dev == 0 || cell >= SIM_MAX_CELLS)
+  {
+    return 0;
+  }
+  return (uint16_t)dev->cell_in[cell];
+}
+
+uint8_t LTC681x_sim_cell_channels()
+{
+  return sim_cells();
+}
+
+uint64_t LTC681x_sim_time_ns()
+{
+  return sim_now_ns;
+}
+
+void LTC681x_sim_advance_ns(uint64_t ns)
+{
+  sim_now_ns += ns;
+}
+
+void LTC681x_sim_cs(uint8_t level)
+{
+  level = (level != 0);
+  sim_now_ns += sim_cfg.cs_overhead_ns;
+  if (level == sim_cs_level)
+  {
+    return;
+  }
+  sim_cs_level = level;
+  sim_update(sim_now_ns);
+
+  if (level == 0)
+  {
+    // Falling edge: the frame travels as far as the first device that is not ready,
+    // and that device starts to wake up.
+    sim_stats.frames++;
+    sim_frame_len = 0;
+    sim_reach = 0;
+    while (sim_reach < sim_cfg.total_ic && sim_dev[sim_reach].port == PORT_READY)
+    {
+      sim_dev[sim_reach].frame_cmd = NO_CMD;
+      sim_dev[sim_reach].last_activity_ns = sim_now_ns;
+      sim_reach++;
+    }
+    if (sim_reach < sim_cfg.total_ic)
+    {
+      sim_device *dev = &sim_dev[sim_reach];
+      sim_stats.short_frames++;
+      if (dev->port == PORT_IDLE)
+      {
+        dev->port = PORT_WAKING;
+        dev->port_ready_ns = sim_now_ns + 1000ULL*((dev->core == CORE_SLEEP) ? sim_cfg.t_wake_us : sim_cfg.t_ready_us);
+        sim_stats.wakeups++;
+      }
+    }
+  }
+  else
+  {
+    for (uint8_t k = 0; k < sim_reach; k++)
+    {
+      if (sim_dev[k].frame_cmd != NO_CMD)
+      {
+        sim_finish_write(k);
+      }
+      sim_dev[k].last_activity_ns = sim_now_ns;
+    }
+    sim_reach = 0;
+  }
+}
+
+uint8_t LTC681x_sim_transfer(uint8_t tx)
+{
+  uint8_t rx = 0xFF;
+  const uint16_t pos = sim_frame_len;
+
+  sim_stats.bytes++;
+  sim_now_ns += 8000000000ULL/sim_cfg.spi_hz + sim_cfg.byte_overhead_ns;
+  if (sim_cs_level != 0)
+  {
+    return rx;
+  }
+
+  // Master to chain, one link per device
+  uint8_t data = tx;
+  for (uint8_t k = 0; k < sim_reach; k++)
+  {
+    data = sim_link(data, &sim_mosi_skip, sim_mosi_ber, &sim_stats.mosi_bit_errors);
+    if (pos < FRAME_MAX)
+    {
+      sim_dev[k].frame_rx[pos] = data;
+    }
+  }
+
+  if (pos == 3)
+  {
+    bool accepted = false;
+    for (uint8_t k = 0; k < sim_reach; k++)
+    {
+      sim_device *dev = &sim_dev[k];
+      uint16_t pec = (uint16_t)((dev->frame_rx[2] << 8) | dev->frame_rx[3]);
+      uint16_t cmd = (uint16_t)(((dev->frame_rx[0] & 0x07) << 8) | dev->frame_rx[1]);
+      if (pec != sim_pec15(dev->frame_rx, 2))
+      {
+        sim_stats.cmd_pec_errors++;
+        continue;
+      }
+      if (!sim_is_known_command(cmd))
+      {
+        continue;
+      }
+      dev->frame_cmd = cmd;
+      sim_execute(dev, cmd);
+      accepted = true;
+    }
+    if (accepted)
+    {
+      sim_stats.commands++;
+    }
+  }
+  else if (pos >= 4 && sim_reach > 0)
+  {
+    const uint16_t cmd = sim_dev[0].frame_cmd;
+    if (cmd == 0x714)
+    {
+      // PLADC: SDO is held low until every device has finished converting
+      sim_update(sim_now_ns);
+      rx = 0xFF;
+      for (uint8_t k = 0; k < sim_reach; k++)
+      {
+        if (sim_dev[k].conv.cmd != NO_CMD)
+        {
+          rx = 0x00;
+        }
+      }
+    }
+    else
+    {
+      // Read data: device k's register group is shifted out after those of devices 0..k-1
+      const uint16_t idx = pos - 4;
+      const uint8_t src = (uint8_t)(idx/8);
+      uint8_t group[8];
+      if (src < sim_reach && sim_dev[src].frame_cmd != NO_CMD &&
+          sim_read_group(&sim_dev[src], sim_dev[src].frame_cmd, group))
+      {
+        rx = group[idx % 8];
+        for (int8_t k = src; k >= 0; k--)
+        {
+          rx = sim_link(rx, &sim_miso_skip, sim_miso_ber, &sim_stats.miso_bit_errors);
+        }
+      }
+    }
+  }
+  sim_frame_len++;
+  return rx;
+}
+
+const ltc681x_sim_stats *LTC681x_sim_get_stats()
+{
+  return &sim_stats;
+}
+
+void LTC681x_sim_reset_stats()
+{
+  memset(&sim_stats, 0, sizeof(sim_stats));
+}
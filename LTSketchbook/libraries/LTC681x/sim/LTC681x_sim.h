@@ -0,0 +1,174 @@
+/*!
+  LTC681x daisy chain simulator
+@verbatim
+  Host (Linux) model of a chain of LTC6811/LTC6813 battery monitors as seen
+  from the master's SPI port through an isoSPI interface. It is driven by
+  bms_hardware_sim.cpp, which replaces bms_hardware.cpp when the BMS library
+  is built on a PC, so LTC681x.cpp runs unmodified against the model.
+
+  Modelled behaviour:
+   - command decoding with PEC15 checking on every device
+   - configuration, cell, auxiliary, status, COMM, PWM and S control registers
+   - conversion time per ADC mode and ADCOPT, reference power up (REFON)
+   - PLADC polling
+   - isoSPI idle and core sleep timeouts, wake-up of one device per pulse
+   - reversed isoSPI chains (device nearest the master is the top of stack)
+   - open cell input wires for the ADOW algorithm
+   - random bit errors on each isoSPI link, independently for both directions,
+     optionally growing with the SCK frequency like a marginal cable
+
+  Time is virtual: SPI bytes, chip select edges and delay_u()/delay_m() advance
+  a nanosecond clock, so results do not depend on the speed of the host.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LTC681X_SIM_H
+#define LTC681X_SIM_H
+
+#include <stdint.h>
+
+#define SIM_LTC6811 0
+#define SIM_LTC6813 1
+
+#define SIM_MAX_IC 32          //!< read_68() buffers hold 256 bytes, 8 per IC
+#define SIM_MAX_CELLS 18
+#define SIM_MAX_GPIO 9
+
+//! Simulator set up. Fill with LTC681x_sim_default_cfg() and change what is needed.
+typedef struct
+{
+  uint8_t part;                 //!< SIM_LTC6811 or SIM_LTC6813
+  uint8_t total_ic;             //!< Number of devices in the chain
+  bool isospi_reverse;          //!< Device nearest the master is the top of the stack
+  uint32_t spi_hz;              //!< SCK frequency used to time each byte
+  uint32_t byte_overhead_ns;    //!< Software overhead per SPI byte on the master
+  uint32_t cs_overhead_ns;      //!< Time taken by each chip select edge
+  uint32_t t_wake_us;           //!< Core wake up time from sleep (tWAKE)
+  uint32_t t_ready_us;          //!< isoSPI port wake up time from idle (tREADY)
+  uint32_t t_idle_us;           //!< isoSPI idle timeout (tIDLE)
+  uint32_t t_sleep_ms;          //!< Watchdog timeout into sleep (tSLEEP)
+  uint32_t t_refup_us;          //!< Reference power up time when REFON=0 (tREFUP)
+  float mosi_ber;               //!< Probability of a bit error per bit per link, master to chain
+  float miso_ber;               //!< Probability of a bit error per bit per link, chain to master
+  uint32_t ber_ref_hz;          //!< When not 0, the error rates apply at this SCK frequency and scale with its square
+  uint16_t noise_codes;         //!< Peak random noise added to each conversion, in 100uV codes
+  uint32_t seed;                //!< Seed for noise and error injection
+} ltc681x_sim_cfg;
+
+//! Counters kept by the simulator. Cleared by LTC681x_sim_init() and LTC681x_sim_reset_stats().
+typedef struct
+{
+  uint32_t frames;              //!< Chip select low periods
+  uint32_t bytes;               //!< Bytes clocked on the master's SPI port
+  uint32_t commands;            //!< Commands accepted by any device
+  uint32_t cmd_pec_errors;      //!< Commands dropped by a device because of a bad command PEC
+  uint32_t data_pec_errors;     //!< Writes dropped by a device because of a bad data PEC
+  uint32_t short_frames;        //!< Frames that did not reach every device (device idle or asleep)
+  uint32_t wakeups;             //!< Devices woken from idle or sleep
+  uint32_t sleeps;              //!< Devices that timed out into sleep
+  uint32_t conversions;         //!< ADC commands started, counted once per device
+  uint32_t mosi_bit_errors;     //!< Bits flipped on the way to the chain
+  uint32_t miso_bit_errors;     //!< Bits flipped on the way back to the master
+} ltc681x_sim_stats;
+
+//! Fill a configuration with DC2259 like defaults: one LTC6811, 1MHz SCK, no errors.
+void LTC681x_sim_default_cfg(ltc681x_sim_cfg *cfg  //!< Configuration to fill
+                            );
+
+//! Power up the chain described by cfg. All devices start asleep.
+void LTC681x_sim_init(const ltc681x_sim_cfg *cfg  //!< Chain configuration
+                     );
+
+//! Change the bit error rates without resetting the chain.
+void LTC681x_sim_set_ber(float mosi_ber,  //!< Probability of a bit error per bit per link, master to chain
+                         float miso_ber   //!< Probability of a bit error per bit per link, chain to master
+                        );
+
+//! Change the SCK frequency, as set_spi_freq() does on the Linduino.
+void LTC681x_sim_set_spi_hz(uint32_t spi_hz  //!< SCK frequency used to time each byte
+                           );
+
+//! @return the SCK frequency
+uint32_t LTC681x_sim_get_spi_hz();
+
+//! Set the voltage across one cell input.
+void LTC681x_sim_set_cell(uint8_t stack_ic,  //!< Position in the stack, 0 is the bottom
+                          uint8_t cell,      //!< Cell number, 0 is C1-C0
+                          uint16_t code      //!< Cell voltage in 100uV codes
+                         );
+
+//! Set the voltage on one GPIO input.
+void LTC681x_sim_set_gpio(uint8_t stack_ic,  //!< Position in the stack, 0 is the bottom
+                          uint8_t gpio,      //!< GPIO number, 0 is GPIO1
+                          uint16_t code      //!< GPIO voltage in 100uV codes
+                         );
+
+//! Disconnect cell input wires. Bit n of wires opens C(n), bit 0 is C0.
+void LTC681x_sim_set_open_wire(uint8_t stack_ic,  //!< Position in the stack, 0 is the bottom
+                               uint32_t wires     //!< Bit mask of open wires
+                              );
+
+//! @return the voltage across one cell input in 100uV codes
+uint16_t LTC681x_sim_get_cell(uint8_t stack_ic,  //!< Position in the stack, 0 is the bottom
+                              uint8_t cell       //!< Cell number, 0 is C1-C0
+                             );
+
+//! @return the number of cell inputs on the simulated part
+uint8_t LTC681x_sim_cell_channels();
+
+//! @return the virtual time in nanoseconds since LTC681x_sim_init()
+uint64_t LTC681x_sim_time_ns();
+
+//! Let virtual time pass, for delays on the master.
+void LTC681x_sim_advance_ns(uint64_t ns  //!< Time to add to the clock
+                           );
+
+//! Drive the chip select line. Edges start and end isoSPI frames.
+void LTC681x_sim_cs(uint8_t level  //!< 0 for low, anything else for high
+                   );
+
+//! Clock one byte through the SPI port.
+//! @return the byte received by the master
+uint8_t LTC681x_sim_transfer(uint8_t tx  //!< Byte sent by the master
+                            );
+
+//! @return the simulator counters
+const ltc681x_sim_stats *LTC681x_sim_get_stats();
+
+//! Clear the simulator counters.
+void LTC681x_sim_reset_stats();
+
+#endif
@@ -0,0 +1,130 @@
+/*!
+  LTC681x hardware library for the host simulator
+@verbatim
+  Implements the functions of bms_hardware.h on top of the LTC681x chain
+  simulator instead of the Linduino SPI port. Build this file in place of
+  bms_hardware.cpp, see bms_sim_bench.cpp for the command line.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <Arduino.h>
+#include <stdint.h>
+#include "bms_hardware.h"
+#include "LTC681x_sim.h"
+
+void cs_low(uint8_t pin)
+{
+  LTC681x_sim_cs(0);
+}
+
+void cs_high(uint8_t pin)
+{
+  LTC681x_sim_cs(1);
+}
+
+void delay_u(uint16_t micro)
+{
+  LTC681x_sim_advance_ns(1000ULL*micro);
+}
+
+void delay_m(uint16_t milli)
+{
+  LTC681x_sim_advance_ns(1000000ULL*milli);
+}
+
+void set_spi_freq(uint32_t spi_hz)
+{
+  LTC681x_sim_set_spi_hz(spi_hz);
+}
+
+/*
+Writes an array of bytes out of the SPI port
+*/
+void spi_write_array(uint8_t len, // Option: Number of bytes to be written on the SPI port
+                     uint8_t data[] //Array of bytes to be written on the SPI port
+                    )
+{
+  for (uint8_t i = 0; i < len; i++)
+  {
+    LTC681x_sim_transfer(data[i]);
+  }
+}
+
+/*
+ Writes and read a set number of bytes using the SPI port.
+
+*/
+void spi_write_read(uint8_t tx_Data[],//array of data to be written on SPI port
+                    uint8_t tx_len, //length of the tx data arry
+                    uint8_t *rx_data,//Input: array that will store the data read by the SPI port
+                    uint8_t rx_len //Option: number of bytes to be read from the SPI port
+                   )
+{
+  for (uint8_t i = 0; i < tx_len; i++)
+  {
+    LTC681x_sim_transfer(tx_Data[i]);
+  }
+
+  for (uint8_t i = 0; i < rx_len; i++)
+  {
+    rx_data[i] = LTC681x_sim_transfer(0xFF);
+  }
+}
+
+uint8_t spi_read_byte(uint8_t tx_dat)
+{
+  return(LTC681x_sim_transfer(0xFF));
+}
+
+// Arduino timing functions on the simulator clock
+unsigned long millis()
+{
+  return (unsigned long)(LTC681x_sim_time_ns()/1000000ULL);
+}
+
+unsigned long micros()
+{
+  return (unsigned long)(LTC681x_sim_time_ns()/1000ULL);
+}
+
+void delay(unsigned long ms)
+{
+  LTC681x_sim_advance_ns(1000000ULL*ms);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  LTC681x_sim_advance_ns(1000ULL*us);
+}
@@ -0,0 +1,335 @@
+/*!
+  LTC681x chain benchmark on the host simulator
+@verbatim
+  Runs the LTC681x library against a simulated chain of LTC6811/LTC6813s and
+  reports:
+   - full chain scan rate (ADCV, PLADC poll, RDCV of every register group)
+     in simulated time, together with the host CPU time spent in the library
+   - PEC error recovery for a sweep of isoSPI bit error rates: scans that
+     needed a re-read, scans lost after the retry limit and scans where bad
+     data got past the PEC check
+   - the same with LTC681x_reread(), which reads again only the failing
+     register groups, and with the PEC error monitor lowering SCK on a link
+     whose error rate grows with frequency
+
+  Build from the LTC681x library directory:
+    g++ -O2 -Isim -I. -I../LTC6811 -I../LTC68xx sim/bms_sim_bench.cpp sim/LTC681x_sim.cpp
+        sim/bms_hardware_sim.cpp LTC681x.cpp ../LTC6811/LTC6811.cpp ../LTC68xx/LTC68xx.cpp
+        -o bms_sim_bench
+
+  Options:
+    -n <ics>     devices in the chain (default 8, max 32)
+    -p <part>    6811 or 6813 (default 6811)
+    -m <md>      ADC mode MD 0-3 (default 2, 7kHz)
+    -f <hz>      SCK frequency (default 1000000)
+    -s <scans>   scans per measurement (default 200)
+    -b <ber>     bit error rate per link, both directions (default: sweep)
+    -R <retries> re-reads allowed after a PEC error (default 3)
+    -r           reversed isoSPI chain
+    -a           also convert and read the AUX and STAT groups in every scan
+    -T           re-read only the failing register groups (LTC681x_reread)
+    -A <min_hz>  adapt SCK between min_hz and -f with the PEC error monitor
+    -L <ref_hz>  the error rate set with -b applies at ref_hz and grows with
+                 the square of the SCK frequency (default: min_hz of -A)
+
+  Output is comma separated, one line per measurement.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "LTC681x.h"
+#include "LTC6811.h"
+#include "bms_hardware.h"
+#include "LTC681x_sim.h"
+
+//! Result of one benchmark run
+typedef struct
+{
+  uint32_t scans;
+  uint64_t sim_ns;
+  uint64_t host_ns;
+  uint32_t bytes;
+  uint32_t pec_scans;       //!< Scans whose first read had a PEC error
+  uint32_t retries;         //!< Register group re-reads issued
+  uint32_t lost_scans;      //!< Scans still failing after the retry limit
+  uint32_t silent_errors;   //!< Cell codes that passed the PEC check but were wrong
+  uint32_t end_hz;          //!< SCK frequency at the end of the run
+} bench_result;
+
+static uint8_t total_ic = 8;
+static uint8_t part = SIM_LTC6811;
+static uint8_t adc_mode = MD_7KHZ_3KHZ;
+static uint32_t spi_hz = 1000000;
+static uint32_t num_scans = 200;
+static uint8_t max_retries = 3;
+static bool reverse = false;
+static bool full_scan = false;
+static bool targeted = false;
+static uint32_t adapt_min_hz = 0;
+static uint32_t ber_ref_hz = 0;
+static pec_monitor monitor;
+
+static cell_asic bms_ic[SIM_MAX_IC];
+
+static uint64_t host_time_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void init_chain(float ber)
+{
+  ltc681x_sim_cfg cfg;
+
+  LTC681x_sim_default_cfg(&cfg);
+  cfg.part = part;
+  cfg.total_ic = total_ic;
+  cfg.isospi_reverse = reverse;
+  cfg.spi_hz = spi_hz;
+  cfg.ber_ref_hz = (ber_ref_hz != 0) ? ber_ref_hz : adapt_min_hz;
+  LTC681x_sim_init(&cfg);
+
+  memset(bms_ic, 0, sizeof(bms_ic));
+  LTC681x_init_cfg(total_ic, bms_ic);
+  LTC6811_reset_crc_count(total_ic, bms_ic);
+  LTC6811_init_reg_limits(total_ic, bms_ic);
+  if (part == SIM_LTC6813)
+  {
+    for (uint8_t cic = 0; cic < total_ic; cic++)
+    {
+      bms_ic[cic].ic_reg.cell_channels = 18;
+      bms_ic[cic].ic_reg.aux_channels = 9;
+      bms_ic[cic].ic_reg.num_cv_reg = 6;
+      bms_ic[cic].ic_reg.num_gpio_reg = 4;
+    }
+  }
+  bms_ic[0].isospi_reverse = reverse;
+
+  // Configure the chain error free, then turn on error injection
+  wakeup_sleep(total_ic);
+  LTC681x_wrcfg(total_ic, bms_ic);
+  LTC681x_sim_set_ber(ber, ber);
+  if (adapt_min_hz != 0)
+  {
+    LTC681x_pec_monitor_init(&monitor, spi_hz, adapt_min_hz, 16*total_ic, 2*total_ic, 4);
+  }
+}
+
+static uint32_t count_silent_errors()
+{
+  uint32_t errors = 0;
+  for (uint8_t cic = 0; cic < total_ic; cic++)
+  {
+    for (uint8_t cell = 0; cell < bms_ic[cic].ic_reg.cell_channels; cell++)
+    {
+      if (bms_ic[cic].cells.c_codes[cell] != LTC681x_sim_get_cell(cic, cell))
+      {
+        errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+// One measurement loop pass, as in the DC2259 sketch, with whole chain or targeted re-reads on PEC errors
+static void run_scans(float ber, bench_result *result)
+{
+  memset(result, 0, sizeof(*result));
+  init_chain(ber);
+  LTC681x_sim_reset_stats();
+
+  uint64_t sim_start = LTC681x_sim_time_ns();
+  uint64_t host_start = host_time_ns();
+
+  for (uint32_t scan = 0; scan < num_scans; scan++)
+  {
+    uint8_t error;
+    uint8_t tries = 0;
+
+    wakeup_idle(total_ic);
+    LTC681x_adcv(adc_mode, DCP_DISABLED, CELL_CH_ALL);
+    LTC681x_pollAdc();
+    wakeup_idle(total_ic);
+    error = LTC681x_rdcv(0, total_ic, bms_ic);
+    if (adapt_min_hz != 0)
+    {
+      LTC681x_pec_monitor_update(&monitor, total_ic*bms_ic[0].ic_reg.num_cv_reg, error);
+    }
+    if (error != 0)
+    {
+      result->pec_scans++;
+    }
+    if (targeted && error != 0)
+    {
+      uint32_t frames = LTC681x_sim_get_stats()->frames;
+      error = LTC681x_reread(CELL, total_ic, bms_ic, max_retries, adapt_min_hz != 0 ? &monitor : 0);
+      tries = (LTC681x_sim_get_stats()->frames - frames)/(total_ic + 1);  // wakeup_idle() and one read per group
+    }
+    while (!targeted && error != 0 && tries < max_retries)
+    {
+      wakeup_idle(total_ic);
+      error = LTC681x_rdcv(0, total_ic, bms_ic);
+      if (adapt_min_hz != 0)
+      {
+        LTC681x_pec_monitor_update(&monitor, total_ic*bms_ic[0].ic_reg.num_cv_reg, error);
+      }
+      tries++;
+    }
+    result->retries += targeted ? tries : tries*bms_ic[0].ic_reg.num_cv_reg;
+    if (error != 0)
+    {
+      result->lost_scans++;
+    }
+    else
+    {
+      result->silent_errors += count_silent_errors();
+    }
+
+    if (full_scan)
+    {
+      wakeup_idle(total_ic);
+      LTC681x_adax(adc_mode, AUX_CH_ALL);
+      LTC681x_pollAdc();
+      wakeup_idle(total_ic);
+      LTC681x_rdaux(0, total_ic, bms_ic);
+      wakeup_idle(total_ic);
+      LTC681x_adstat(adc_mode, STAT_CH_ALL);
+      LTC681x_pollAdc();
+      wakeup_idle(total_ic);
+      LTC681x_rdstat(0, total_ic, bms_ic);
+    }
+  }
+
+  result->host_ns = host_time_ns() - host_start;
+  result->sim_ns = LTC681x_sim_time_ns() - sim_start;
+  result->scans = num_scans;
+  result->bytes = LTC681x_sim_get_stats()->bytes;
+  result->end_hz = LTC681x_sim_get_spi_hz();
+}
+
+static void print_result(float ber, const bench_result *r)
+{
+  double scan_ms = (double)r->sim_ns/r->scans/1e6;
+  printf("%u,%u,%u,%lu,%g,%u,%.3f,%.1f,%.2f,%lu,%u,%u,%u,%u,%lu\n",
+         part == SIM_LTC6813 ? 6813 : 6811,
+         total_ic,
+         adc_mode,
+         (unsigned long)spi_hz,
+         ber,
+         r->scans,
+         scan_ms,
+         1000.0/scan_ms,
+         (double)r->host_ns/r->scans/1e3,
+         (unsigned long)(r->bytes/r->scans),
+         r->pec_scans,
+         r->retries,
+         r->lost_scans,
+         r->silent_errors,
+         (unsigned long)r->end_hz);
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [-n ics] [-p 6811|6813] [-m md] [-f sck_hz] [-s scans] [-b ber] [-R retries] [-r] [-a] [-T] [-A min_hz] [-L ref_hz]\n", name);
+  exit(1);
+}
+
+int main(int argc, char **argv)
+{
+  float sweep[] = {0.0f, 1e-6f, 1e-5f, 1e-4f, 1e-3f};
+  uint8_t sweep_len = sizeof(sweep)/sizeof(sweep[0]);
+  float ber = -1.0f;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const char *opt = argv[i];
+    const char *val = (i + 1 < argc) ? argv[i + 1] : 0;
+
+    if (strcmp(opt, "-r") == 0)
+    {
+      reverse = true;
+      continue;
+    }
+    if (strcmp(opt, "-a") == 0)
+    {
+      full_scan = true;
+      continue;
+    }
+    if (strcmp(opt, "-T") == 0)
+    {
+      targeted = true;
+      continue;
+    }
+    if (val == 0)
+    {
+      usage(argv[0]);
+    }
+    i++;
+    if (strcmp(opt, "-n") == 0) total_ic = (uint8_t)atoi(val);
+    else if (strcmp(opt, "-p") == 0) part = (atoi(val) == 6813) ? SIM_LTC6813 : SIM_LTC6811;
+    else if (strcmp(opt, "-m") == 0) adc_mode = (uint8_t)(atoi(val) & 0x03);
+    else if (strcmp(opt, "-f") == 0) spi_hz = (uint32_t)atol(val);
+    else if (strcmp(opt, "-s") == 0) num_scans = (uint32_t)atol(val);
+    else if (strcmp(opt, "-b") == 0) ber = (float)atof(val);
+    else if (strcmp(opt, "-R") == 0) max_retries = (uint8_t)atoi(val);
+    else if (strcmp(opt, "-A") == 0) adapt_min_hz = (uint32_t)atol(val);
+    else if (strcmp(opt, "-L") == 0) ber_ref_hz = (uint32_t)atol(val);
+    else usage(argv[0]);
+  }
+  if (total_ic == 0 || total_ic > SIM_MAX_IC || spi_hz == 0 || num_scans == 0)
+  {
+    usage(argv[0]);
+  }
+  if (ber >= 0.0f)
+  {
+    sweep[0] = ber;
+    sweep_len = 1;
+  }
+
+  printf("part,ics,md,sck_hz,ber,scans,scan_ms,scans_per_s,host_us_per_scan,bytes_per_scan,pec_scans,group_rereads,lost_scans,silent_errors,end_sck_hz\n");
+  for (uint8_t i = 0; i < sweep_len; i++)
+  {
+    bench_result result;
+    run_scans(sweep[i], &result);
+    print_result(sweep[i], &result);
+  }
+  return 0;
+}
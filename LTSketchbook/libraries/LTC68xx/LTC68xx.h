@@ -0,0 +1,557 @@
+/*!
+  LTC68xx: Common core of the LTC6804/LTC6811/LTC6813 Multicell Battery Monitor libraries
+
+@verbatim
+  The LTC6804-1, LTC6804-2, LTC6811 and LTC6813 share one command set, one
+  register group layout (6 data bytes followed by a 15 bit PEC) and one
+  framing on the SPI/isoSPI bus. They differ in the number of register
+  groups and channels, in whether the devices are daisy chained or
+  individually addressed, and in a few command codes.
+
+  This header describes each part with a chip traits structure holding
+  those differences as compile time constants, and implements the shared
+  PEC calculation, command/read/write framing and register parsing once in
+  the LTC68xx<CHIP> template. For a fixed chip the register group loops have
+  constant bounds and the addressed/daisy chain branches are resolved by the
+  compiler, so only the code needed for that part is generated.
+
+  The part libraries (LTC68041, LTC68042, LTC681x, LTC6811) keep their
+  existing C style functions as thin wrappers over this core. They supply
+  the SPI transport as a BUS structure with the static functions
+
+    static void select();       // chip select low
+    static void deselect();     // chip select high
+    static void write_read(uint8_t *tx, uint8_t tx_len, uint8_t *rx, uint8_t rx_len);
+
+  It also encodes the binary datalog frame used by the sketches to stream a
+  whole chain scan to a PC (decoded by host/ltc68xx_datalog.py). All values
+  are little endian:
+
+    A5 68                 sync
+    version               LTC68XX_DATALOG_VERSION
+    total_ic
+    cells, aux, stat      codes per IC in each block, 0 when not logged
+    sequence              frame counter, wraps at 255
+    timestamp             uint32, milliseconds
+    per IC, in stack order:
+      pec_errors          uint16, bit n = cell group n+1, bit 8+n = aux group n+1,
+                          bit 12+n = stat group n+1 had a PEC error
+      codes               uint16 raw codes: cells, then aux, then stat
+    crc                   uint16 CRC-16/CCITT (0x1021, start 0xFFFF) of every byte
+                          from version to the last code
+
+  A scan of 8 LTC6811s with cells, GPIOs and status is 382 bytes.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LTC68xx
+    Header for the common LTC6804/LTC6811/LTC6813 core
+*/
+
+#ifndef LTC68XX_H
+#define LTC68XX_H
+
+#include <stdint.h>
+
+#define LTC68XX_BYTES_IN_REG 6    //!< Data bytes in a register group
+#define LTC68XX_REG_LEN 8         //!< Bytes of a register group on the bus, data and PEC
+#define LTC68XX_CODES_IN_REG 3    //!< 16 bit codes in a cell, aux or stat register group
+
+//! Calculates and returns the PEC15 of len bytes of data.
+//! There is one PEC15 table in program memory shared by all LTC68xx libraries.
+//! @return The calculated pec15
+uint16_t pec15_calc(uint8_t len,    //!< Number of bytes that will be used to calculate a PEC
+                    uint8_t *data   //!< Array of data that will be used to calculate a PEC
+                   );
+
+#define LTC68XX_DATALOG_SYNC0 0xA5     //!< First byte of a datalog frame
+#define LTC68XX_DATALOG_SYNC1 0x68     //!< Second byte of a datalog frame
+#define LTC68XX_DATALOG_VERSION 1      //!< Frame layout version
+#define LTC68XX_DATALOG_AUX_PEC 8      //!< First bit of the aux groups in the pec_errors bitmap
+#define LTC68XX_DATALOG_STAT_PEC 12    //!< First bit of the stat groups in the pec_errors bitmap
+
+//! Sends bytes of a datalog frame, for example with Serial.write()
+typedef void (*LTC68xx_datalog_write)(const uint8_t *data, uint8_t len);
+
+//! Datalog frame encoder. Frames are streamed through write, nothing is buffered.
+typedef struct
+{
+  LTC68xx_datalog_write write;  //!< Output of the encoded bytes
+  uint16_t crc;                 //!< CRC of the frame so far
+  uint8_t sequence;             //!< Sequence number of the next frame
+  uint8_t cells;                //!< Cell codes per IC in the current frame
+  uint8_t aux;                  //!< Aux codes per IC in the current frame
+  uint8_t stat;                 //!< Stat codes per IC in the current frame
+} LTC68xx_datalog;
+
+//! Updates a CRC-16/CCITT with len bytes of data.
+//! @return the new CRC
+uint16_t LTC68xx_datalog_crc(uint16_t crc,          //!< CRC so far, 0xFFFF to start
+                             const uint8_t *data,   //!< Bytes to add
+                             uint8_t len            //!< Number of bytes
+                            );
+
+//! Sets up a datalog encoder. The sequence number starts at 0.
+void LTC68xx_datalog_init(LTC68xx_datalog *log,         //!< Encoder
+                          LTC68xx_datalog_write write   //!< Output of the encoded bytes
+                         );
+
+//! Starts a frame and sends its header. Follow with total_ic calls to
+//! LTC68xx_datalog_ic() and one call to LTC68xx_datalog_end().
+void LTC68xx_datalog_begin(LTC68xx_datalog *log,  //!< Encoder
+                           uint8_t total_ic,      //!< Number of ICs in the frame
+                           uint8_t cells,         //!< Cell codes per IC, 0 to leave them out
+                           uint8_t aux,           //!< Aux codes per IC, 0 to leave them out
+                           uint8_t stat,          //!< Stat codes per IC, 0 to leave them out
+                           uint32_t timestamp     //!< Time of the scan in milliseconds
+                          );
+
+//! Sends the block of one IC. Arrays of blocks that are not logged may be 0.
+void LTC68xx_datalog_ic(LTC68xx_datalog *log,        //!< Encoder
+                        uint16_t pec_errors,         //!< Register groups that had a PEC error, see LTC68XX_DATALOG_AUX_PEC
+                        const uint16_t *cell_codes,  //!< Cell codes of the IC
+                        const uint16_t *aux_codes,   //!< Aux codes of the IC
+                        const uint16_t *stat_codes   //!< Stat codes of the IC
+                       );
+
+//! Sends the CRC that ends the frame.
+void LTC68xx_datalog_end(LTC68xx_datalog *log  //!< Encoder
+                        );
+
+//! Command codes and conversion times shared by every part.
+struct LTC68xx_traits_base
+{
+  //! @name Command codes
+  //! @{
+  static constexpr uint16_t WRCFGA = 0x001;
+  static constexpr uint16_t RDCFGA = 0x002;
+  static constexpr uint16_t WRCFGB = 0x024;
+  static constexpr uint16_t RDCFGB = 0x026;
+  static constexpr uint16_t WRCOMM = 0x721;
+  static constexpr uint16_t RDCOMM = 0x722;
+  static constexpr uint16_t STCOMM = 0x723;
+  static constexpr uint16_t CLRCELL = 0x711;
+  static constexpr uint16_t CLRAUX = 0x712;
+  static constexpr uint16_t CLRSTAT = 0x713;
+  static constexpr uint16_t PLADC = 0x714;
+  static constexpr uint16_t DIAGN = 0x715;
+  //! @}
+
+  //! @return the read command of cell voltage register group reg (1 = A)
+  static constexpr uint16_t rdcv(uint8_t reg)
+  {
+    return (reg == 2) ? 0x006 : (reg == 3) ? 0x008 : (reg == 4) ? 0x00A :
+           (reg == 5) ? 0x009 : (reg == 6) ? 0x00B : 0x004;
+  }
+
+  //! @return the read command of auxiliary register group reg (1 = A)
+  static constexpr uint16_t rdaux(uint8_t reg)
+  {
+    return (reg == 2) ? 0x00E : (reg == 3) ? 0x00D : (reg == 4) ? 0x00F : 0x00C;
+  }
+
+  //! @return the read command of status register group reg (1 = A)
+  static constexpr uint16_t rdstat(uint8_t reg)
+  {
+    return (reg == 2) ? 0x012 : 0x010;
+  }
+
+  //! @return the ADCV command: cell conversion
+  static constexpr uint16_t adcv(uint8_t md, uint8_t dcp, uint8_t ch)
+  {
+    return 0x260 | ((md & 0x03) << 7) | ((dcp & 0x01) << 4) | (ch & 0x07);
+  }
+
+  //! @return the ADOW command: open wire conversion
+  static constexpr uint16_t adow(uint8_t md, uint8_t pup)
+  {
+    return 0x228 | ((md & 0x03) << 7) | ((pup & 0x01) << 6);
+  }
+
+  //! @return the ADAX command: GPIO and 2nd reference conversion
+  static constexpr uint16_t adax(uint8_t md, uint8_t chg)
+  {
+    return 0x460 | ((md & 0x03) << 7) | (chg & 0x07);
+  }
+
+  //! @return the ADSTAT command: status group conversion
+  static constexpr uint16_t adstat(uint8_t md, uint8_t chst)
+  {
+    return 0x468 | ((md & 0x03) << 7) | (chst & 0x07);
+  }
+
+  //! Conversion time of the first channel in us, indexed by (MD<<1)|ADCOPT.
+  //! Typical values from the LTC6811 datasheet, the LTC6804 and LTC6813 ADC is the same.
+  static constexpr uint32_t t_first_us(uint8_t mode)
+  {
+    return (mode == 0) ? 2135 : (mode == 1) ? 1130 : (mode == 2) ? 201 : (mode == 3) ? 230 :
+           (mode == 4) ? 405 : (mode == 5) ? 501 : (mode == 6) ? 34208 : 754;
+  }
+
+  //! Conversion time of a complete 6 step conversion in us, indexed by (MD<<1)|ADCOPT.
+  static constexpr uint32_t t_six_us(uint8_t mode)
+  {
+    return (mode == 0) ? 12807 : (mode == 1) ? 6500 : (mode == 2) ? 1113 : (mode == 3) ? 1288 :
+           (mode == 4) ? 2335 : (mode == 5) ? 3033 : (mode == 6) ? 201317 : 4407;
+  }
+
+  //! @return the typical time in us of a conversion of steps channels
+  static constexpr uint32_t conv_time_us(uint8_t md, uint8_t adcopt, uint8_t steps)
+  {
+    return t_first_us(((md & 0x03) << 1) | (adcopt & 0x01)) +
+           (t_six_us(((md & 0x03) << 1) | (adcopt & 0x01)) - t_first_us(((md & 0x03) << 1) | (adcopt & 0x01)))*(steps - 1)/5;
+  }
+};
+
+//! LTC6804-1: daisy chained, 12 cells
+struct LTC6804_1_traits : LTC68xx_traits_base
+{
+  static constexpr uint8_t cell_channels = 12;   //!< Cell inputs
+  static constexpr uint8_t num_cv_reg = 4;       //!< Cell voltage register groups
+  static constexpr uint8_t aux_channels = 6;     //!< GPIO1-5 and the 2nd reference
+  static constexpr uint8_t num_gpio_reg = 2;     //!< Auxiliary register groups
+  static constexpr uint8_t stat_channels = 4;    //!< SOC, ITMP, VA and VD
+  static constexpr uint8_t num_stat_reg = 2;     //!< Status register groups
+  static constexpr bool addressed = false;       //!< Devices are individually addressed instead of daisy chained
+  static constexpr bool has_cfgb = false;        //!< Has a second configuration register group
+  static constexpr uint8_t adcv_steps = 6;       //!< Conversion steps of ADCV on all cells
+  static constexpr uint8_t adax_steps = 6;       //!< Conversion steps of ADAX on all GPIOs
+  static constexpr uint8_t adstat_steps = 4;     //!< Conversion steps of ADSTAT on all channels
+
+  //! @return the typical ADCV time in us for all cells
+  static constexpr uint32_t adcv_time_us(uint8_t md, uint8_t adcopt)
+  {
+    return conv_time_us(md, adcopt, adcv_steps);
+  }
+};
+
+//! LTC6804-2: individually addressed, 12 cells
+struct LTC6804_2_traits : LTC6804_1_traits
+{
+  static constexpr bool addressed = true;
+};
+
+//! LTC6811-1: daisy chained, 12 cells
+struct LTC6811_traits : LTC6804_1_traits
+{
+};
+
+//! LTC6813-1: daisy chained, 18 cells, 9 GPIOs
+struct LTC6813_traits : LTC68xx_traits_base
+{
+  static constexpr uint8_t cell_channels = 18;
+  static constexpr uint8_t num_cv_reg = 6;
+  static constexpr uint8_t aux_channels = 10;    //!< GPIO1-9 and the 2nd reference
+  static constexpr uint8_t num_gpio_reg = 4;
+  static constexpr uint8_t stat_channels = 4;
+  static constexpr uint8_t num_stat_reg = 2;
+  static constexpr bool addressed = false;
+  static constexpr bool has_cfgb = true;
+  static constexpr uint8_t adcv_steps = 6;
+  static constexpr uint8_t adax_steps = 10;
+  static constexpr uint8_t adstat_steps = 4;
+
+  static constexpr uint32_t adcv_time_us(uint8_t md, uint8_t adcopt)
+  {
+    return conv_time_us(md, adcopt, adcv_steps);
+  }
+};
+
+/*! Command framing, register parsing and bus transactions for one part.
+
+ Register groups read from the bus are handed to a SINK, called as
+ sink(stack_ic, reg, data, pec_error) with the 8 received bytes of the group;
+ register groups written are taken from a SOURCE, called as source(stack_ic)
+ and returning the 6 data bytes for that device. stack_ic is the position of
+ the device in the caller's arrays, see stack_ic().
+*/
+template <class CHIP>
+class LTC68xx
+{
+  public:
+    typedef CHIP chip;
+
+    //! Builds a command frame: 2 command bytes and their PEC.
+    //! The address is only used by addressed parts, where address 0xFF sends a broadcast command.
+    static inline void cmd_frame(uint16_t cmd,        //!< 11 bit command code
+                                 uint8_t tx[4],       //!< Frame
+                                 uint8_t address = 0xFF  //!< Device address (LTC6804-2)
+                                )
+    {
+      uint16_t cmd_pec;
+
+      tx[0] = (uint8_t)(cmd >> 8);
+      if (CHIP::addressed && address != 0xFF)
+      {
+        tx[0] |= 0x80 | (address << 3);
+      }
+      tx[1] = (uint8_t)cmd;
+      cmd_pec = pec15_calc(2, tx);
+      tx[2] = (uint8_t)(cmd_pec >> 8);
+      tx[3] = (uint8_t)(cmd_pec);
+    }
+
+    //! @return 0 if the PEC of a received register group matches its data, 1 if not
+    static inline uint8_t reg_pec_error(const uint8_t *reg  //!< 8 bytes received for one device
+                                       )
+    {
+      uint16_t received_pec = (reg[6] << 8) | reg[7];
+      return (received_pec != pec15_calc(LTC68XX_BYTES_IN_REG, (uint8_t *)reg)) ? 1 : 0;
+    }
+
+    //! Unpacks the three little endian 16 bit codes of a cell, aux or stat register group.
+    static inline void parse_codes(const uint8_t *reg,  //!< 8 bytes received for one device
+                                   uint16_t *codes      //!< First of the three codes to fill
+                                  )
+    {
+      for (uint8_t i = 0; i < LTC68XX_CODES_IN_REG; i++)
+      {
+        codes[i] = reg[2*i] | (reg[2*i + 1] << 8);
+      }
+    }
+
+    //! @return the caller's array index of the device at position chain_ic on the bus, 0 nearest the master
+    static inline uint8_t stack_ic(uint8_t chain_ic,   //!< Position on the bus
+                                   uint8_t total_ic,   //!< Number of devices
+                                   bool reverse        //!< isoSPI connected to the top of the stack
+                                  )
+    {
+      return reverse ? (uint8_t)(total_ic - chain_ic - 1) : chain_ic;
+    }
+
+    //! Sends a command without data.
+    template <class BUS>
+    static void command(uint16_t cmd  //!< 11 bit command code
+                       )
+    {
+      uint8_t tx[4];
+
+      cmd_frame(cmd, tx);
+      BUS::select();
+      BUS::write_read(tx, 4, 0, 0);
+      BUS::deselect();
+    }
+
+    //! Reads one register group from every device and passes each one to sink as it arrives.
+    //! No buffer for the whole chain is needed.
+    //! @return the number of devices whose data had a PEC error
+    template <class BUS, class SINK>
+    static uint8_t read_reg(uint16_t cmd,      //!< Read command
+                            uint8_t reg,       //!< Register group number passed to the sink
+                            uint8_t total_ic,  //!< Number of devices
+                            bool reverse,      //!< isoSPI connected to the top of the stack
+                            SINK &sink         //!< Receives the register group of each device
+                           )
+    {
+      uint8_t tx[4];
+      uint8_t data[LTC68XX_REG_LEN];
+      uint8_t errors = 0;
+
+      if (!CHIP::addressed)
+      {
+        cmd_frame(cmd, tx);
+        BUS::select();
+      }
+      for (uint8_t chain_ic = 0; chain_ic < total_ic; chain_ic++)
+      {
+        uint8_t pec_error;
+
+        if (CHIP::addressed)
+        {
+          cmd_frame(cmd, tx, chain_ic);
+          BUS::select();
+          BUS::write_read(tx, 4, data, LTC68XX_REG_LEN);
+          BUS::deselect();
+        }
+        else
+        {
+          // The first device's data follows the command, the rest is clocked out in the same frame
+          BUS::write_read(tx, (chain_ic == 0) ? 4 : 0, data, LTC68XX_REG_LEN);
+        }
+        pec_error = reg_pec_error(data);
+        errors += pec_error;
+        sink(stack_ic(chain_ic, total_ic, reverse), reg, data, pec_error);
+      }
+      if (!CHIP::addressed)
+      {
+        BUS::deselect();
+      }
+      return errors;
+    }
+
+    //! Writes one register group of every device with the data returned by source.
+    //! Daisy chained data is sent to the device furthest from the master first.
+    template <class BUS, class SOURCE>
+    static void write_reg(uint16_t cmd,      //!< Write command
+                          uint8_t total_ic,  //!< Number of devices
+                          bool reverse,      //!< isoSPI connected to the top of the stack
+                          SOURCE &source     //!< Returns the 6 data bytes of a device
+                         )
+    {
+      uint8_t tx[4];
+      uint8_t data[LTC68XX_REG_LEN];
+
+      if (!CHIP::addressed)
+      {
+        cmd_frame(cmd, tx);
+        BUS::select();
+        BUS::write_read(tx, 4, 0, 0);
+      }
+      for (uint8_t i = 0; i < total_ic; i++)
+      {
+        uint8_t chain_ic = CHIP::addressed ? i : (uint8_t)(total_ic - i - 1);
+        const uint8_t *src = source(stack_ic(chain_ic, total_ic, reverse));
+        uint16_t data_pec;
+
+        for (uint8_t current_byte = 0; current_byte < LTC68XX_BYTES_IN_REG; current_byte++)
+        {
+          data[current_byte] = src[current_byte];
+        }
+        data_pec = pec15_calc(LTC68XX_BYTES_IN_REG, data);
+        data[6] = (uint8_t)(data_pec >> 8);
+        data[7] = (uint8_t)data_pec;
+        if (CHIP::addressed)
+        {
+          cmd_frame(cmd, tx, chain_ic);
+          BUS::select();
+          BUS::write_read(tx, 4, 0, 0);
+          BUS::write_read(data, LTC68XX_REG_LEN, 0, 0);
+          BUS::deselect();
+        }
+        else
+        {
+          BUS::write_read(data, LTC68XX_REG_LEN, 0, 0);
+        }
+      }
+      if (!CHIP::addressed)
+      {
+        BUS::deselect();
+      }
+    }
+
+    //! Reads cell voltage register group reg, or all of them when reg is 0.
+    //! @return the number of register groups received with a PEC error
+    template <class BUS, class SINK>
+    static uint8_t read_cells(uint8_t reg,        //!< Register group, 1 = A, 0 for all
+                              uint8_t total_ic,   //!< Number of devices
+                              bool reverse,       //!< isoSPI connected to the top of the stack
+                              SINK &sink,         //!< Receives each register group
+                              uint8_t num_reg = CHIP::num_cv_reg  //!< Groups read when reg is 0
+                             )
+    {
+      uint8_t errors = 0;
+      uint8_t first = (reg == 0) ? 1 : reg;
+      uint8_t last = (reg == 0) ? num_reg : reg;
+
+      for (uint8_t cell_reg = first; cell_reg <= last; cell_reg++)
+      {
+        errors += read_reg<BUS>(CHIP::rdcv(cell_reg), cell_reg, total_ic, reverse, sink);
+      }
+      return errors;
+    }
+
+    //! Reads auxiliary register group reg, or all of them when reg is 0.
+    //! @return the number of register groups received with a PEC error
+    template <class BUS, class SINK>
+    static uint8_t read_aux(uint8_t reg,
+                            uint8_t total_ic,
+                            bool reverse,
+                            SINK &sink,
+                            uint8_t num_reg = CHIP::num_gpio_reg
+                           )
+    {
+      uint8_t errors = 0;
+      uint8_t first = (reg == 0) ? 1 : reg;
+      uint8_t last = (reg == 0) ? num_reg : reg;
+
+      for (uint8_t gpio_reg = first; gpio_reg <= last; gpio_reg++)
+      {
+        errors += read_reg<BUS>(CHIP::rdaux(gpio_reg), gpio_reg, total_ic, reverse, sink);
+      }
+      return errors;
+    }
+
+    //! Reads status register group reg, or all of them when reg is 0.
+    //! @return the number of register groups received with a PEC error
+    template <class BUS, class SINK>
+    static uint8_t read_stat(uint8_t reg,
+                             uint8_t total_ic,
+                             bool reverse,
+                             SINK &sink,
+                             uint8_t num_reg = CHIP::num_stat_reg
+                            )
+    {
+      uint8_t errors = 0;
+      uint8_t first = (reg == 0) ? 1 : reg;
+      uint8_t last = (reg == 0) ? num_reg : reg;
+
+      for (uint8_t stat_reg = first; stat_reg <= last; stat_reg++)
+      {
+        errors += read_reg<BUS>(CHIP::rdstat(stat_reg), stat_reg, total_ic, reverse, sink);
+      }
+      return errors;
+    }
+
+    //! Reads register group reg of every device into consecutive 8 byte blocks of data,
+    //! in bus order. Used by the *_reg functions of the part libraries.
+    template <class BUS>
+    static uint8_t read_raw(uint16_t cmd,      //!< Read command
+                            uint8_t total_ic,  //!< Number of devices
+                            uint8_t *data      //!< LTC68XX_REG_LEN bytes per device
+                           )
+    {
+      raw_sink sink(data);
+      return read_reg<BUS>(cmd, 0, total_ic, false, sink);
+    }
+
+  private:
+    //! Copies register groups into a byte array in bus order
+    struct raw_sink
+    {
+      uint8_t *data;
+      raw_sink(uint8_t *d) : data(d) {}
+      void operator()(uint8_t ic, uint8_t /*reg*/, const uint8_t *rx, uint8_t /*pec_error*/)
+      {
+        for (uint8_t i = 0; i < LTC68XX_REG_LEN; i++)
+        {
+          data[ic*LTC68XX_REG_LEN + i] = rx[i];
+        }
+      }
+    };
+};
+
+#endif  // LTC68XX_H
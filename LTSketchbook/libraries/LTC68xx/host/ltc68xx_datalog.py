@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""
+LTC68xx binary datalog decoder
+
+Reads the binary frames sent by the LTC68xx sketches in binary datalog mode,
+from a capture file or a serial port, checks them and writes one CSV row per
+IC and frame. The frame layout is described in LTC68xx.h. Text printed by the
+sketch between frames (menus, prompts) is skipped.
+
+Usage:
+  python3 ltc68xx_datalog.py capture.bin -o scan.csv
+  python3 ltc68xx_datalog.py --port /dev/ttyACM0 -o scan.csv      (needs pyserial)
+
+Options:
+  -o FILE     CSV output, default stdout
+  --raw       write the raw 16 bit codes instead of volts
+  --port DEV  read from a serial port instead of a file
+  --baud N    serial baud rate, default 115200
+  --frames N  stop after N good frames
+
+A summary of good frames, CRC errors, lost frames (sequence gaps) and
+register groups with PEC errors is printed to stderr at the end.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+
+SYNC = b'\xa5\x68'
+VERSION = 1
+HEADER_LEN = 10          # version to timestamp
+LSB = 0.0001             # volts per code
+STAT_NAMES = ['SOC', 'ITMP', 'VA', 'VD']
+MAX_CELLS = 18           # LTC6813
+MAX_AUX = 12
+MAX_STAT = 4
+
+
+def crc16(data):
+    """CRC-16/CCITT, polynomial 0x1021 MSB first, start 0xFFFF."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def frame_len(total_ic, cells, aux, stat):
+    return len(SYNC) + HEADER_LEN + total_ic * 2 * (1 + cells + aux + stat) + 2
+
+
+def stat_value(index, code):
+    """Status codes in the units printed by the sketches."""
+    if index == 0:
+        return code * LSB * 20              # sum of cells
+    if index == 1:
+        return code * LSB / 0.0075 - 273    # internal die temperature
+    return code * LSB
+
+
+class Frame(object):
+    def __init__(self, sequence, timestamp, cells, aux, stat, ics):
+        self.sequence = sequence
+        self.timestamp = timestamp
+        self.cells = cells
+        self.aux = aux
+        self.stat = stat
+        self.ics = ics          # list of (pec_errors, codes)
+
+
+class Decoder(object):
+    """Finds and checks frames in a byte stream fed in arbitrary pieces."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.good = 0
+        self.crc_errors = 0
+        self.lost = 0
+        self.pec_groups = 0
+        self.last_sequence = None
+
+    def feed(self, data):
+        self.buf += data
+        frames = []
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                del self.buf[:max(0, len(self.buf) - 1)]
+                return frames
+            del self.buf[:start]
+            if len(self.buf) < len(SYNC) + HEADER_LEN:
+                return frames
+            version, total_ic, cells, aux, stat, sequence, timestamp = \
+                struct.unpack_from('<BBBBBBI', self.buf, len(SYNC))
+            if version != VERSION or total_ic == 0 or cells > MAX_CELLS or aux > MAX_AUX or stat > MAX_STAT:
+                del self.buf[:1]
+                continue
+            length = frame_len(total_ic, cells, aux, stat)
+            if len(self.buf) < length:
+                return frames
+            body = bytes(self.buf[len(SYNC):length - 2])
+            crc, = struct.unpack_from('<H', self.buf, length - 2)
+            if crc16(body) != crc:
+                # Not a frame, or a damaged one: look for the next sync
+                self.crc_errors += 1
+                del self.buf[:1]
+                continue
+            del self.buf[:length]
+            frames.append(self._decode(body, total_ic, cells, aux, stat, sequence, timestamp))
+
+    def finish(self):
+        """At the end of the input, drops an incomplete frame and decodes anything behind it."""
+        frames = []
+        while self.buf.find(SYNC) >= 0:
+            del self.buf[:self.buf.find(SYNC) + 1]
+            frames += self.feed(b'')
+        return frames
+
+    def _decode(self, body, total_ic, cells, aux, stat, sequence, timestamp):
+        per_ic = 1 + cells + aux + stat
+        words = struct.unpack_from('<%dH' % (total_ic * per_ic), body, HEADER_LEN)
+        ics = []
+        for ic in range(total_ic):
+            block = words[ic * per_ic:(ic + 1) * per_ic]
+            ics.append((block[0], block[1:]))
+            self.pec_groups += bin(block[0]).count('1')
+        if self.last_sequence is not None:
+            self.lost += (sequence - self.last_sequence - 1) & 0xFF
+        self.last_sequence = sequence
+        self.good += 1
+        return Frame(sequence, timestamp, cells, aux, stat, ics)
+
+
+def csv_header(frame):
+    cols = ['sequence', 'timestamp_ms', 'ic', 'pec_errors']
+    cols += ['cell%d' % (i + 1) for i in range(frame.cells)]
+    cols += ['aux%d' % (i + 1) for i in range(frame.aux)]
+    cols += [STAT_NAMES[i] if i < len(STAT_NAMES) else 'stat%d' % (i + 1) for i in range(frame.stat)]
+    return ','.join(cols)
+
+
+def csv_rows(frame, raw):
+    rows = []
+    for ic, (pec_errors, codes) in enumerate(frame.ics):
+        values = ['%u' % frame.sequence, '%u' % frame.timestamp, '%d' % (ic + 1), '0x%04x' % pec_errors]
+        for i, code in enumerate(codes):
+            if raw:
+                values.append('%u' % code)
+            elif i < frame.cells + frame.aux:
+                values.append('%.4f' % (code * LSB))
+            else:
+                values.append('%.4f' % stat_value(i - frame.cells - frame.aux, code))
+        rows.append(','.join(values))
+    return rows
+
+
+def open_input(args):
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=1)
+        return lambda: port.read(4096)
+    f = open(args.capture, 'rb')
+    return lambda: f.read(65536)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode LTC68xx binary datalog frames to CSV')
+    parser.add_argument('capture', nargs='?', help='binary capture file')
+    parser.add_argument('-o', '--output', help='CSV output file, default stdout')
+    parser.add_argument('--raw', action='store_true', help='write raw codes instead of volts')
+    parser.add_argument('--port', help='serial port to read instead of a file')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--frames', type=int, default=0, help='stop after this many good frames')
+    args = parser.parse_args()
+    if not args.capture and not args.port:
+        parser.error('give a capture file or --port')
+
+    read = open_input(args)
+    out = open(args.output, 'w') if args.output else sys.stdout
+    decoder = Decoder()
+    header = None
+    try:
+        while True:
+            data = read()
+            if not data:
+                if args.port:
+                    continue
+                frames = decoder.finish()
+            else:
+                frames = decoder.feed(data)
+            for frame in frames:
+                if csv_header(frame) != header:
+                    header = csv_header(frame)
+                    out.write(header + '\n')
+                for row in csv_rows(frame, args.raw):
+                    out.write(row + '\n')
+                if args.frames and decoder.good >= args.frames:
+                    raise KeyboardInterrupt
+            if not data:
+                break
+    except KeyboardInterrupt:
+        pass
+    if out is not sys.stdout:
+        out.close()
+    sys.stderr.write('%d frames, %d CRC errors, %d lost frames, %d register groups with PEC errors\n' %
+                     (decoder.good, decoder.crc_errors, decoder.lost, decoder.pec_groups))
+
+
+if __name__ == '__main__':
+    main()
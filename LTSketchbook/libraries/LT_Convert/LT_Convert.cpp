@@ -0,0 +1,68 @@
+/*!
+LT_Convert: Fixed-point conversion of ADC codes to engineering units.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! @ingroup Linduino
+//! @{
+//! @defgroup LT_Convert LT_Convert: Fixed-point conversion of ADC codes to engineering units.
+//! @}
+
+/*! @file
+    @ingroup LT_Convert
+    Library for LT_Convert: Fixed-point conversion of ADC codes to engineering units.
+*/
+
+#include <stdint.h>
+#include "LT_Convert.h"
+
+// The scale is copied into a local so that it is loaded once, not per code.
+void LT_convert_array(const int32_t *codes, int32_t *values, uint16_t count, const LT_scale *scale)
+{
+  LT_scale s = *scale;
+  uint16_t i;
+
+  for (i = 0; i < count; i++)
+    values[i] = LT_convert(codes[i], &s);
+}
+
+void LT_convert_array_u16(const uint16_t *codes, int32_t *values, uint16_t count, const LT_scale *scale)
+{
+  LT_scale s = *scale;
+  uint16_t i;
+
+  for (i = 0; i < count; i++)
+    values[i] = LT_convert(codes[i], &s);
+}
@@ -0,0 +1,184 @@
+/*!
+LT_Convert: Fixed-point conversion of ADC codes to engineering units.
+
+@verbatim
+  A scale turns a raw code into an integer in the units it was made for,
+  microvolts, microamps, millikelvin and so on, with 32 bit arithmetic and
+  one 32 x 32 -> 64 bit multiply of which only the high word is kept:
+
+      c     = code - code_offset
+      value = c * whole + high_word(c * fraction) + output_bias
+
+  whole is the units per code rounded to an integer, and fraction the rest,
+  -1/2 to 1/2 unit, times 2^32. The high word is picked out of the product
+  rather than shifted, and everything else is 32 bit, so there is no 64 bit
+  shift or add, which avr-gcc turns into libgcc calls, the shift a loop.
+  The high word is rounded with the top bit of the low word, which puts the
+  result within one unit of the exact value.
+
+  LT_make_scale() is constexpr: a scale made from constants, such as the
+  scale of a part at a fixed reference, is worked out by the compiler, and
+  LT_convert() with it compiles to the two multiplies and the adds. The same
+  function makes a scale at run time, for instance from a sense resistor
+  entered by the user; do that once, not per code. On AVR double is 32 bits,
+  so the units per code are good to 24 bits either way, well under one
+  output unit for results up to a few million units.
+
+  Each part library has builders for its ranges, LTC2378_scale_microvolts()
+  and the like, and keeps its float functions as thin wrappers around
+  LT_code_to_float().
+
+  Example:
+
+    constexpr LT_scale adc_scale = LTC2378_scale_microvolts(5.0, 0);
+
+    LTC2378_read(LTC2378_CS, &adc_code);
+    microvolts = LT_convert(adc_code, &adc_scale);
+
+    LT_convert_array(codes, microvolts, 256, &adc_scale);   // Block of codes
+
+  The result and code - code_offset must fit in 32 bits: pick units that
+  leave room for the full scale of the part.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LT_Convert
+    Library Header File for LT_Convert: Fixed-point conversion of ADC codes to engineering units.
+*/
+
+#ifndef LT_CONVERT_H
+#define LT_CONVERT_H
+
+#include <stdint.h>
+
+//! Conversion from codes to one unit, made by LT_make_scale()
+typedef struct
+{
+  int32_t whole;          //!< Units per code, rounded to an integer
+  int32_t fraction;       //!< Units per code less whole, times 2^32
+  int32_t code_offset;    //!< Code that reads as output_bias
+  int32_t output_bias;    //!< Units added after scaling
+} LT_scale;
+
+//! @return units_per_code rounded to an integer
+constexpr int32_t LT_scale_whole(double units_per_code    //!< Output units per code, positive
+                                )
+{
+  return (int32_t)(units_per_code + 0.5);
+}
+
+//! @return x rounded to the nearest integer, within the int32_t range
+constexpr int32_t LT_scale_round(double x   //!< Value to round
+                                )
+{
+  return (x >= 2147483647.0) ? 2147483647 : (x >= 0) ? (int32_t)(x + 0.5) : -(int32_t)(-x + 0.5);
+}
+
+//! Makes the scale for value = (code - code_offset) * units_per_code + output_bias.
+//! constexpr, so a scale made from constants costs nothing at run time.
+//! @return the scale
+constexpr LT_scale LT_make_scale(double units_per_code,     //!< Output units per code, positive and below 2^30
+                                 int32_t code_offset = 0,   //!< Code that reads as output_bias
+                                 int32_t output_bias = 0    //!< Units added after scaling
+                                )
+{
+  return LT_scale {LT_scale_whole(units_per_code),
+                   LT_scale_round((units_per_code - LT_scale_whole(units_per_code)) * 4294967296.0),
+                   code_offset, output_bias
+                  };
+}
+
+//! @return the high word of a * b, rounded with the top bit of the low word
+inline int32_t LT_mul_high(int32_t a,   //!< Multiplicand
+                           int32_t b    //!< Multiplier
+                          )
+{
+  // The words of the product are picked out rather than shifted: avr-gcc makes
+  // any 64 bit shift a libgcc call. AVR, ARM and x86 are all little endian.
+  union
+  {
+    int64_t product;
+    struct
+    {
+      uint32_t low;
+      int32_t high;
+    } words;
+  } p;
+
+  p.product = (int64_t)a * b;
+  return p.words.high + (int32_t)(p.words.low >> 31);
+}
+
+//! Converts one code, to within one unit.
+//! @return the code in the units of the scale
+inline int32_t LT_convert(int32_t code,               //!< Raw code, sign extended or offset binary as the scale expects
+                          const LT_scale *scale       //!< Scale made by LT_make_scale()
+                         )
+{
+  // Unsigned, so that c * whole may wrap: the fraction brings the sum back in range
+  uint32_t c = (uint32_t)code - (uint32_t)scale->code_offset;
+
+  return (int32_t)(c * (uint32_t)scale->whole + (uint32_t)LT_mul_high((int32_t)c, scale->fraction)
+                   + (uint32_t)scale->output_bias);
+}
+
+//! Converts count codes, as LT_convert() does for one. values may be codes,
+//! to convert in place.
+void LT_convert_array(const int32_t *codes,     //!< Raw codes
+                      int32_t *values,          //!< Codes in the units of the scale
+                      uint16_t count,           //!< Number of codes
+                      const LT_scale *scale     //!< Scale made by LT_make_scale()
+                     );
+
+//! Converts count 16 bit register codes, as LT_convert() does for one.
+void LT_convert_array_u16(const uint16_t *codes,  //!< Raw codes
+                          int32_t *values,        //!< Codes in the units of the scale
+                          uint16_t count,         //!< Number of codes
+                          const LT_scale *scale   //!< Scale made by LT_make_scale()
+                         );
+
+//! Float counterpart of LT_convert(), for the float code_to functions of the part libraries.
+//! @return (code - code_offset) * units_per_code
+inline float LT_code_to_float(int32_t code,           //!< Raw code
+                              int32_t code_offset,    //!< Code that reads as 0
+                              float units_per_code    //!< Output units per code
+                             )
+{
+  return (float)(code - code_offset) * units_per_code;
+}
+
+#endif  // LT_CONVERT_H
@@ -0,0 +1,9 @@
+/*!
+Wire.h stand-in for the LT_Convert benchmark. The I2C part headers include
+Wire.h, but the benchmark only uses their conversion scales.
+*/
+
+#ifndef LT_CONVERT_HOST_WIRE_H
+#define LT_CONVERT_HOST_WIRE_H
+
+#endif
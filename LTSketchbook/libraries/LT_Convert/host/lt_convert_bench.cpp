@@ -0,0 +1,357 @@
+/*!
+LT_Convert benchmark
+@verbatim
+  Times the conversion of raw codes to engineering units on a PC for every
+  part and range with an LT_Convert scale: the float formula each library
+  used per code before LT_Convert, LT_convert() one code at a time with a
+  constexpr scale, and LT_convert_array() over the whole block. Every integer
+  result is checked against the exact value worked out in double precision,
+  and the largest error is reported in output units, next to the error of
+  the old float formula. The check is repeated with the scale made the way
+  an AVR makes it, with 32 bit doubles: that error is bounded by how well a
+  32 bit float holds the lsb weight, a few parts in 10^8, and not by the
+  integer arithmetic.
+
+  Build, from LT_Convert:
+    g++ -O2 -std=gnu++11 -Ihost -I../LT_SMBUS/linux -I../LT_Trace/host -I. -I../Linduino \
+        -I../LTC2378 -I../LTC2338 -I../LTC24XX_general -I../LTC2946 -I../LTC2944 \
+        host/lt_convert_bench.cpp LT_Convert.cpp -o lt_convert_bench
+
+  Run:
+    ./lt_convert_bench [-n codes] [-p passes]
+
+    -n codes    random codes per range, default 4096
+    -p passes   times each block is converted, default 200
+
+  Exits with 1 if any integer result is more than one unit from the exact value.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "LT_Convert.h"
+#include "LTC2378.h"
+#include "LTC2338.h"
+#include "LTC24XX_general.h"
+#include "LTC2946.h"
+#include "LTC2944.h"
+
+// Demo board values
+#define VREF              5.0
+#define SENSE_RESISTOR    0.02
+#define PRESCALAR         4096
+#define DELTA_SENSE_LSB   2.5006105E-05
+#define VIN_LSB           2.5006105E-02
+#define POWER_LSB         6.25305E-07
+#define TIME_LSB          (4101.00/250000.00)
+
+typedef float (*float_formula)(int32_t code);
+
+//! One part and range
+typedef struct
+{
+  const char *name;
+  const char *units;
+  LT_scale scale;             // As the sketch would make it, constexpr
+  double units_per_code;      // For the exact value
+  int32_t code_offset;
+  int32_t output_bias;
+  int64_t code_min;           // Range of codes the part returns
+  int64_t code_max;
+  float_formula legacy;       // The library's float formula before LT_Convert
+  double legacy_units;        // Units per unit of the float formula's result
+} conversion;
+
+// The float formulas the libraries used per code, as they were
+static float ltc2378_legacy(int32_t code)
+{
+  float voltage = (float)code;
+  voltage = voltage / (pow(2, 31) - 1);
+  return voltage * (float)VREF + 0.1;
+}
+
+static float ltc2338_legacy(int32_t code)
+{
+  float voltage = (float)code;
+  voltage = voltage / (pow(2, 31) - 1);
+  return voltage * (float)VREF;
+}
+
+static float ltc24xx_se_legacy(int32_t code)
+{
+  float voltage;
+  code -= 0x20000000;
+  voltage = (float)code;
+  voltage = voltage / 268435456.0;
+  return voltage * (float)VREF;
+}
+
+static float ltc24xx_diff_legacy(int32_t code)
+{
+  float voltage;
+  code -= 0x20000000;
+  voltage = (float)code;
+  voltage = voltage / 536870912.0;
+  return voltage * (float)VREF;
+}
+
+static float ltc2946_vin_legacy(int32_t code)
+{
+  return (float)code * (float)VIN_LSB;
+}
+
+static float ltc2946_current_legacy(int32_t code)
+{
+  float voltage = (float)code * (float)DELTA_SENSE_LSB;
+  return voltage / (float)SENSE_RESISTOR;
+}
+
+static float ltc2946_power_legacy(int32_t code)
+{
+  return (float)code * (float)POWER_LSB / (float)SENSE_RESISTOR;
+}
+
+static float ltc2946_energy_legacy(int32_t code)
+{
+  float energy_lsb = (float)(POWER_LSB / SENSE_RESISTOR) * 65536 * (float)TIME_LSB;
+  return code * energy_lsb;
+}
+
+static float ltc2946_charge_legacy(int32_t code)
+{
+  float coulomb_lsb = (float)(DELTA_SENSE_LSB / SENSE_RESISTOR) * 16 * (float)TIME_LSB;
+  return code * coulomb_lsb;
+}
+
+static float ltc2944_mah_legacy(int32_t code)
+{
+  return 1000 * (float)(code * LTC2944_CHARGE_lsb * PRESCALAR * 50E-3) / (float)(SENSE_RESISTOR * 4096);
+}
+
+static float ltc2944_voltage_legacy(int32_t code)
+{
+  return ((float)code / (65535)) * LTC2944_FULLSCALE_VOLTAGE;
+}
+
+static float ltc2944_current_legacy(int32_t code)
+{
+  return (((float)code - 32767) / (32767)) * ((float)(LTC2944_FULLSCALE_CURRENT) / (float)SENSE_RESISTOR);
+}
+
+static float ltc2944_celcius_legacy(int32_t code)
+{
+  return code * ((float)(LTC2944_FULLSCALE_TEMPERATURE) / 65535) - 273.15;
+}
+
+#define RANGE(name, units, scale, per_code, offset, bias, lo, hi, legacy, legacy_units) \
+  {name, units, scale, per_code, offset, bias, lo, hi, legacy, legacy_units}
+
+static const conversion conversions[] =
+{
+  RANGE("LTC2378 5V", "uV", LTC2378_scale_microvolts(VREF, 0), VREF * 1e6 / 2147483647.0, 0, 100000,
+  -2147483647LL, 2147483647LL, ltc2378_legacy, 1e6),
+  RANGE("LTC2338 5V", "uV", LTC2338_scale_microvolts(VREF), VREF * 1e6 / 2147483647.0, 0, 0,
+  -2147483647LL, 2147483647LL, ltc2338_legacy, 1e6),
+  RANGE("LTC24XX SE 5V", "uV", LTC24XX_SE_scale_microvolts(VREF), VREF * 1e6 / 268435456.0, 0x20000000, 0,
+  0x1FFFFFFFLL, 0x30000000LL, ltc24xx_se_legacy, 1e6),
+  RANGE("LTC24XX diff 5V", "uV", LTC24XX_diff_scale_microvolts(VREF), VREF * 1e6 / 536870912.0, 0x20000000, 0,
+  0x00000001LL, 0x3FFFFFFFLL, ltc24xx_diff_legacy, 1e6),
+  RANGE("LTC2946 VIN", "uV", LTC2946_voltage_scale_microvolts(VIN_LSB), VIN_LSB * 1e6, 0, 0,
+  0, 4095, ltc2946_vin_legacy, 1e6),
+  RANGE("LTC2946 current", "uA", LTC2946_current_scale_microamps(SENSE_RESISTOR, DELTA_SENSE_LSB),
+  DELTA_SENSE_LSB / SENSE_RESISTOR * 1e6, 0, 0, 0, 4095, ltc2946_current_legacy, 1e6),
+  RANGE("LTC2946 power", "uW", LTC2946_power_scale_microwatts(SENSE_RESISTOR, POWER_LSB),
+  POWER_LSB / SENSE_RESISTOR * 1e6, 0, 0, 0, 0xFFFFFF, ltc2946_power_legacy, 1e6),
+  RANGE("LTC2946 energy", "mJ", LTC2946_energy_scale_millijoules(SENSE_RESISTOR, POWER_LSB, TIME_LSB),
+  POWER_LSB / SENSE_RESISTOR * 65536 * TIME_LSB * 1e3, 0, 0, 0, 60000000, ltc2946_energy_legacy, 1e3),
+  RANGE("LTC2946 charge", "mC", LTC2946_charge_scale_millicoulombs(SENSE_RESISTOR, DELTA_SENSE_LSB, TIME_LSB),
+  DELTA_SENSE_LSB / SENSE_RESISTOR * 16 * TIME_LSB * 1e3, 0, 0, 0, 2147483647LL, ltc2946_charge_legacy, 1e3),
+  RANGE("LTC2944 charge", "uAh", LTC2944_charge_scale_microamp_hours(SENSE_RESISTOR, PRESCALAR),
+  1e6 * (double)LTC2944_CHARGE_lsb * PRESCALAR * 50E-3 / (SENSE_RESISTOR * 4096), 0, 0, 0, 65535,
+  ltc2944_mah_legacy, 1e3),
+  RANGE("LTC2944 voltage", "uV", LTC2944_voltage_scale_microvolts(), (double)LTC2944_FULLSCALE_VOLTAGE * 1e6 / 65535,
+  0, 0, 0, 65535, ltc2944_voltage_legacy, 1e6),
+  RANGE("LTC2944 current", "uA", LTC2944_current_scale_microamps(SENSE_RESISTOR),
+  (double)LTC2944_FULLSCALE_CURRENT * 1e6 / SENSE_RESISTOR / 32767, 32767, 0, 0, 65535, ltc2944_current_legacy, 1e6),
+  RANGE("LTC2944 temperature", "mdegC", LTC2944_temperature_scale_millicelcius(),
+  (double)LTC2944_FULLSCALE_TEMPERATURE * 1e3 / 65535, 0, -273150, 0, 65535, ltc2944_celcius_legacy, 1e3),
+};
+
+#define CONVERSIONS (sizeof(conversions) / sizeof(conversions[0]))
+
+// The compiler works the scales out: these fail to build if it cannot.
+static_assert(LTC2378_scale_microvolts(VREF, 0).fraction != 0, "LTC2378 scale is not constexpr");
+static_assert(LTC2944_temperature_scale_millicelcius().whole > 0, "LTC2944 scale is not constexpr");
+
+static volatile float float_sink;
+static volatile int32_t int_sink;
+
+static double now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double exact(const conversion *c, int32_t code)
+{
+  return ((double)code - c->code_offset) * c->units_per_code + c->output_bias;
+}
+
+// Makes the scale the way an AVR makes it, where double is a 32 bit float
+static LT_scale avr_scale(const conversion *c)
+{
+  float units = (float)c->units_per_code;
+  int32_t whole = (int32_t)(units + 0.5f);
+  float fraction = (units - (float)whole) * 4294967296.0f;
+  LT_scale scale = {whole, 0, c->code_offset, c->output_bias};
+
+  if (fraction >= 2147483647.0f)
+    scale.fraction = 2147483647;
+  else
+    scale.fraction = (fraction >= 0) ? (int32_t)(fraction + 0.5f) : -(int32_t)(-fraction + 0.5f);
+  return scale;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t codes_per_range = 4096;
+  uint32_t passes = 200;
+  std::vector<int32_t> codes, values;
+  int failed = 0;
+  size_t n;
+  uint32_t i, pass;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:p:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n':
+        codes_per_range = strtoul(optarg, NULL, 0);
+        break;
+      case 'p':
+        passes = strtoul(optarg, NULL, 0);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n codes] [-p passes]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (codes_per_range == 0 || codes_per_range > 65535 || passes == 0)
+  {
+    fprintf(stderr, "codes must be 1 to 65535 and passes at least 1\n");
+    return 2;
+  }
+  codes.resize(codes_per_range);
+  values.resize(codes_per_range);
+  srand(1);
+
+  printf("%-20s %-4s %9s %9s %9s %10s %10s %10s\n", "range", "unit", "float ns", "int ns", "array ns",
+         "int error", "avr error", "float err");
+  for (n = 0; n < CONVERSIONS; n++)
+  {
+    const conversion *c = &conversions[n];
+    LT_scale avr = avr_scale(c);
+    double float_error = 0, int_error = 0, avr_error = 0;
+    double t0, t_float, t_int, t_array;
+
+    for (i = 0; i < codes_per_range; i++)
+    {
+      uint64_t r = ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+      codes[i] = (int32_t)(c->code_min + (int64_t)(r % (uint64_t)(c->code_max - c->code_min + 1)));
+    }
+    codes[0] = (int32_t)c->code_min;
+    codes[codes_per_range - 1] = (int32_t)c->code_max;
+
+    for (i = 0; i < codes_per_range; i++)
+    {
+      double e = exact(c, codes[i]);
+      double d = fabs(LT_convert(codes[i], &c->scale) - e);
+      if (d > int_error)
+        int_error = d;
+      d = fabs(LT_convert(codes[i], &avr) - e);
+      if (d > avr_error)
+        avr_error = d;
+      d = fabs(c->legacy(codes[i]) * c->legacy_units - e);
+      if (d > float_error)
+        float_error = d;
+    }
+
+    t0 = now_ns();
+    for (pass = 0; pass < passes; pass++)
+      for (i = 0; i < codes_per_range; i++)
+        float_sink = c->legacy(codes[i]);
+    t_float = (now_ns() - t0) / ((double)passes * codes_per_range);
+
+    t0 = now_ns();
+    for (pass = 0; pass < passes; pass++)
+      for (i = 0; i < codes_per_range; i++)
+        int_sink = LT_convert(codes[i], &c->scale);
+    t_int = (now_ns() - t0) / ((double)passes * codes_per_range);
+
+    t0 = now_ns();
+    for (pass = 0; pass < passes; pass++)
+    {
+      LT_convert_array(&codes[0], &values[0], codes_per_range, &c->scale);
+      int_sink = values[pass % codes_per_range];
+    }
+    t_array = (now_ns() - t0) / ((double)passes * codes_per_range);
+
+    for (i = 0; i < codes_per_range; i++)
+    {
+      if (values[i] != LT_convert(codes[i], &c->scale))
+      {
+        printf("%s: LT_convert_array() and LT_convert() differ at code %ld\n", c->name, (long)codes[i]);
+        failed = 1;
+        break;
+      }
+    }
+    if (int_error > 1.0)
+      failed = 1;
+
+    printf("%-20s %-4s %9.2f %9.2f %9.2f %10.3f %10.3f %10.3f\n", c->name, c->units, t_float, t_int, t_array,
+           int_error, avr_error, float_error);
+  }
+  printf("%s\n", failed ? "FAILED" : "all results within one unit");
+  return failed;
+}
@@ -0,0 +1,218 @@
+/*!
+LT_Decimate: Oversampling and decimation filters for SAR ADC codes, such as those of the LTC2378, LTC2338, LTC2370 and LTC2380.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! @ingroup Linduino
+//! @{
+//! @defgroup LT_Decimate LT_Decimate: Oversampling and decimation filters for SAR ADC codes.
+//! @}
+
+/*! @file
+    @ingroup LT_Decimate
+    Library for LT_Decimate: Oversampling and decimation filters for SAR ADC codes.
+*/
+
+#include <stdint.h>
+#include "LT_Decimate.h"
+
+// Shifts left for a positive count and right for a negative one
+static uint64_t decimate_shift(uint64_t value, int8_t count)
+{
+  return count >= 0 ? value << count : value >> -count;
+}
+
+// Integer square root, rounded down
+static uint32_t decimate_sqrt(uint64_t value)
+{
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  while (bit > value)
+    bit >>= 2;
+  while (bit != 0)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+static void decimate_clear_statistics(LT_decimator *decimator)
+{
+  decimator->sum_squares = 0;
+  decimator->sum = 0;
+  decimator->min = INT32_MAX;
+  decimator->max = INT32_MIN;
+}
+
+int8_t LT_decimate_begin(LT_decimator *decimator, uint8_t order, uint16_t ratio, uint8_t code_bits, uint8_t flags)
+{
+  uint8_t log2_ratio = 0;
+
+  if (order < 1 || order > LT_DECIMATE_ORDER_MAX || ratio == 0 || (ratio & (ratio - 1)) != 0)
+    return 1;
+  while ((1U << log2_ratio) != ratio)
+    log2_ratio++;
+  if (code_bits < 1 || code_bits + order * log2_ratio > 32)
+    return 1;
+
+  decimator->ratio = ratio;
+  decimator->order = order;
+  decimator->log2_ratio = log2_ratio;
+  decimator->code_shift = 32 - code_bits;
+  decimator->value_shift = 32 - code_bits - order * log2_ratio;
+  decimator->flags = flags;
+  LT_decimate_reset(decimator);
+  return 0;
+}
+
+void LT_decimate_reset(LT_decimator *decimator)
+{
+  uint8_t i;
+
+  for (i = 0; i < LT_DECIMATE_ORDER_MAX; i++)
+  {
+    decimator->integrator[i] = 0;
+    decimator->comb[i] = 0;
+  }
+  decimate_clear_statistics(decimator);
+  decimator->count = 0;
+  decimator->settling = decimator->order - 1;
+}
+
+// Works out the statistics of the block that just ended, and clears them
+static void decimate_statistics(LT_decimator *decimator, LT_decimate_output *output)
+{
+  uint8_t L = decimator->log2_ratio;
+  int8_t j2 = 2 * decimator->code_shift;
+  // R^2 times the variance; sum and sum_squares are bounded so that neither term overflows
+  uint64_t spread = (decimator->sum_squares << L) - (uint64_t)((int64_t)decimator->sum * decimator->sum);
+
+  output->min = (int32_t)((uint32_t)decimator->min << decimator->code_shift);
+  output->max = (int32_t)((uint32_t)decimator->max << decimator->code_shift);
+  output->rms = decimate_sqrt(decimate_shift(decimator->sum_squares, j2 - L));
+  output->ac_rms = decimate_sqrt(decimate_shift(spread, j2 - 2 * L));
+  if (decimator->flags & LT_DECIMATE_OFFSET_BINARY)
+  {
+    output->min ^= INT32_MIN;
+    output->max ^= INT32_MIN;
+  }
+  decimate_clear_statistics(decimator);
+}
+
+uint8_t LT_decimate_feed(LT_decimator *decimator, int32_t adc_code, LT_decimate_output *output)
+{
+  uint32_t value;
+  int32_t code;
+  uint8_t i;
+
+  if (decimator->flags & LT_DECIMATE_OFFSET_BINARY)
+    adc_code ^= INT32_MIN;
+  code = adc_code >> decimator->code_shift;
+
+  value = (uint32_t)code;
+  for (i = 0; i < decimator->order; i++)
+  {
+    decimator->integrator[i] += value;
+    value = decimator->integrator[i];
+  }
+
+  if (decimator->flags & LT_DECIMATE_STATISTICS)
+  {
+    decimator->sum += code;
+    if (decimator->code_shift >= 16)
+      decimator->sum_squares += (uint32_t)(code * code);
+    else
+      decimator->sum_squares += (uint64_t)((int64_t)code * code);
+    if (code < decimator->min)
+      decimator->min = code;
+    if (code > decimator->max)
+      decimator->max = code;
+  }
+
+  if (++decimator->count < decimator->ratio)
+    return 0;
+  decimator->count = 0;
+
+  // Combs, at the output rate
+  for (i = 0; i < decimator->order; i++)
+  {
+    uint32_t delayed = decimator->comb[i];
+    decimator->comb[i] = value;
+    value -= delayed;
+  }
+
+  if (decimator->settling)
+  {
+    decimator->settling--;
+    decimate_clear_statistics(decimator);
+    return 0;
+  }
+
+  if (decimator->flags & LT_DECIMATE_STATISTICS)
+    decimate_statistics(decimator, output);
+  output->value = (int32_t)(value << decimator->value_shift);
+  if (decimator->flags & LT_DECIMATE_OFFSET_BINARY)
+    output->value ^= INT32_MIN;
+  return 1;
+}
+
+uint16_t LT_decimate_block(LT_decimator *decimator, const int32_t *adc_codes, uint16_t count, LT_decimate_output *outputs)
+{
+  uint16_t results = 0;
+  uint16_t i;
+
+  for (i = 0; i < count; i++)
+    results += LT_decimate_feed(decimator, adc_codes[i], &outputs[results]);
+  return results;
+}
+
+void LT_decimate_read(LT_decimator *decimator, LT_decimate_read_function read, uint8_t cs, LT_decimate_output *output)
+{
+  int32_t adc_code;
+
+  do
+  {
+    read(cs, &adc_code);
+  }
+  while (!LT_decimate_feed(decimator, adc_code, output));
+}
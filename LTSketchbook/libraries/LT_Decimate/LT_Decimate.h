@@ -0,0 +1,168 @@
+/*!
+LT_Decimate: Oversampling and decimation filters for SAR ADC codes, such as those of the LTC2378, LTC2338, LTC2370 and LTC2380.
+
+@verbatim
+  The filter takes the raw 32 bit codes of the SAR read functions, one per
+  conversion, and gives one result every "ratio" codes. Order 1 is a boxcar
+  average of each block of ratio codes. Orders 2 to 4 are CIC filters: that
+  many integrators run at the conversion rate and that many combs at the
+  output rate, which rejects more of the noise above the output rate for the
+  same ratio, at the cost of order - 1 blocks of settling after
+  LT_decimate_begin(). Those first results are not given out.
+
+  The integrators are 32 bit and allowed to wrap: only the bits the result
+  needs are kept, so code_bits + order * log2(ratio) must be 32 or less.
+  Drop code bits that are noise to go further, the result is the same.
+  ratio must be a power of two, so the gain of the filter, ratio^order, is
+  taken out with a shift.
+
+  Per code, the filter is order 32 bit adds and nothing else. With
+  LT_DECIMATE_STATISTICS the smallest and largest code, the RMS and the RMS
+  about the mean (the noise) of each block are kept as well, for one more
+  add and a square. The square is 32 bit for codes of 16 bits or less.
+
+  The result is left justified in 32 bits like the codes it was made from,
+  with the extra resolution in the low bits, so the part's conversion
+  (LTC2378_code_to_voltage(), or LT_convert() with the part's scale) applies
+  to it unchanged. Offset binary parts such as the LTC2370 set
+  LT_DECIMATE_OFFSET_BINARY and get offset binary results back.
+
+  Example, 16 conversions per result:
+
+    LT_decimator filter;
+    LT_decimate_output result;
+
+    LT_decimate_begin(&filter, 2, 16, 20, LT_DECIMATE_STATISTICS);
+    LT_decimate_read(&filter, LTC2378_read, LTC2378_CS, &result);
+    microvolts = LT_convert(result.value, &scale);
+
+  Example, an LTC2370-16 averaged over 64 conversions. LTC2370_read() gives
+  a uint32_t, so the filter reads with LTC2370_read_code(), which gives the
+  same code as an int32_t:
+
+    LT_decimate_begin(&filter, 1, 64, 16, LT_DECIMATE_OFFSET_BINARY);
+    LT_decimate_read(&filter, LTC2370_read_code, LTC2370_CS, &result);
+    volts = LTC2370_code_to_voltage((uint32_t)result.value, vref);
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LT_Decimate
+    Library Header File for LT_Decimate: Oversampling and decimation filters for SAR ADC codes.
+*/
+
+#ifndef LT_DECIMATE_H
+#define LT_DECIMATE_H
+
+#include <stdint.h>
+
+#define LT_DECIMATE_ORDER_MAX 4               //!< Highest filter order
+
+//! @name Flags for LT_decimate_begin()
+//! @{
+#define LT_DECIMATE_STATISTICS     0x01       //!< Keep min, max and RMS of each block
+#define LT_DECIMATE_OFFSET_BINARY  0x02       //!< Codes are offset binary, as from LTC2370_read_code()
+//! @}
+
+//! One result of the filter
+typedef struct
+{
+  int32_t value;      //!< Filtered code, left justified like the codes
+  int32_t min;        //!< Smallest code of the block, with LT_DECIMATE_STATISTICS
+  int32_t max;        //!< Largest code of the block, with LT_DECIMATE_STATISTICS
+  uint32_t rms;       //!< RMS of the codes of the block, left justified, with LT_DECIMATE_STATISTICS
+  uint32_t ac_rms;    //!< RMS of the codes of the block about their mean, left justified, with LT_DECIMATE_STATISTICS
+} LT_decimate_output;
+
+//! State of one filter. Set up by LT_decimate_begin().
+typedef struct
+{
+  uint32_t integrator[LT_DECIMATE_ORDER_MAX];   //!< Run at the conversion rate, wrapping
+  uint32_t comb[LT_DECIMATE_ORDER_MAX];         //!< Last integrator outputs, at the output rate
+  uint64_t sum_squares;                         //!< Of the codes of the block
+  int32_t sum;                                  //!< Of the codes of the block
+  int32_t min;                                  //!< Of the codes of the block
+  int32_t max;                                  //!< Of the codes of the block
+  uint16_t count;                               //!< Codes so far in the block
+  uint16_t ratio;                               //!< Codes per result
+  uint8_t order;                                //!< 1 for a boxcar, 2 to 4 for CIC
+  uint8_t log2_ratio;                           //!< log2(ratio)
+  uint8_t code_shift;                           //!< 32 - code_bits
+  uint8_t value_shift;                          //!< Left justifies the integrator output
+  uint8_t settling;                             //!< Results still to drop after begin
+  uint8_t flags;                                //!< LT_DECIMATE_ flags
+} LT_decimator;
+
+//! Read function of a SAR ADC library, such as LTC2378_read()
+typedef void (*LT_decimate_read_function)(uint8_t cs, int32_t *adc_code);
+
+//! Sets up a filter and clears it.
+//! @return 0 on success, 1 if order, ratio or code_bits is out of range
+int8_t LT_decimate_begin(LT_decimator *decimator,   //!< Filter to set up
+                         uint8_t order,             //!< 1 for a boxcar, 2 to LT_DECIMATE_ORDER_MAX for CIC
+                         uint16_t ratio,            //!< Codes per result, a power of two from 1 to 32768
+                         uint8_t code_bits,         //!< Bits of each code used, from the top: the ADC resolution or less
+                         uint8_t flags              //!< LT_DECIMATE_STATISTICS, LT_DECIMATE_OFFSET_BINARY
+                        );
+
+//! Clears a filter, keeping its settings, for instance after a gap in the codes.
+void LT_decimate_reset(LT_decimator *decimator    //!< Filter set up by LT_decimate_begin()
+                      );
+
+//! Filters one code.
+//! @return 1 if output holds a new result, 0 if not
+uint8_t LT_decimate_feed(LT_decimator *decimator,     //!< Filter set up by LT_decimate_begin()
+                         int32_t adc_code,            //!< Code as returned by the read function
+                         LT_decimate_output *output   //!< Result, written when one is ready
+                        );
+
+//! Filters count codes, as LT_decimate_feed() does one at a time.
+//! @return the number of results written to outputs, at most count / ratio + 1
+uint16_t LT_decimate_block(LT_decimator *decimator,     //!< Filter set up by LT_decimate_begin()
+                           const int32_t *adc_codes,    //!< Codes as returned by the read function
+                           uint16_t count,              //!< Number of codes
+                           LT_decimate_output *outputs  //!< Results
+                          );
+
+//! Reads and filters codes back to back until the next result is ready. Nothing but the
+//! integer filter is done between reads, so the ADC is read as fast as the SPI port allows.
+void LT_decimate_read(LT_decimator *decimator,        //!< Filter set up by LT_decimate_begin()
+                      LT_decimate_read_function read, //!< Read function of the ADC library
+                      uint8_t cs,                     //!< Chip select pin of the ADC
+                      LT_decimate_output *output      //!< Result
+                     );
+
+#endif  // LT_DECIMATE_H
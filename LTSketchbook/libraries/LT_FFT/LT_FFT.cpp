@@ -0,0 +1,201 @@
+/*!
+LT_FFT: Fixed-point FFT for spectra of ADC samples.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! @ingroup Linduino
+//! @{
+//! @defgroup LT_FFT LT_FFT: Fixed-point FFT for spectra of ADC samples.
+//! @}
+
+/*! @file
+    @ingroup LT_FFT
+    Library for LT_FFT: Fixed-point FFT for spectra of ADC samples.
+*/
+
+#include <stdint.h>
+#include "LT_FFT.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#define PROGMEM
+#define pgm_read_word_near(addr) (*(const uint16_t *)(addr))
+#endif
+
+#define FFT_QUARTER (LT_FFT_MAX_POINTS / 4)
+
+// sin(2 pi k / LT_FFT_MAX_POINTS) in Q15, for k = 0 to LT_FFT_MAX_POINTS / 4
+static const int16_t fft_sine[FFT_QUARTER + 1] PROGMEM =
+{
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+  2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+  4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+  7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+  9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+  11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+  14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+  16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+  18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+  20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+  23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+  25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+  26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+  28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+  29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+  30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+  31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+  31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+  32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+  32757, 32761, 32765, 32766, 32767
+};
+
+// sin(2 pi k / LT_FFT_MAX_POINTS) in Q15, for any k
+static int16_t fft_sin(uint16_t k)
+{
+  k &= LT_FFT_MAX_POINTS - 1;
+  if (k <= FFT_QUARTER)
+    return (int16_t)pgm_read_word_near(&fft_sine[k]);
+  if (k <= 2 * FFT_QUARTER)
+    return (int16_t)pgm_read_word_near(&fft_sine[2 * FFT_QUARTER - k]);
+  if (k <= 3 * FFT_QUARTER)
+    return -(int16_t)pgm_read_word_near(&fft_sine[k - 2 * FFT_QUARTER]);
+  return -(int16_t)pgm_read_word_near(&fft_sine[4 * FFT_QUARTER - k]);
+}
+
+// Q15 product, rounded
+static int16_t fft_multiply(int16_t a, int16_t b)
+{
+  return (int16_t)(((int32_t)a * b + 0x4000) >> 15);
+}
+
+int8_t LT_fft(int16_t *re, int16_t *im, uint8_t log2_points)
+{
+  uint16_t points, size, half, step, i, j, k, bit;
+  int16_t t;
+
+  if (log2_points < 1 || log2_points > LT_FFT_MAX_LOG2)
+    return 1;
+  points = 1U << log2_points;
+
+  // Bit reversed order
+  for (i = 1, j = 0; i < points; i++)
+  {
+    for (bit = points >> 1; j & bit; bit >>= 1)
+      j ^= bit;
+    j |= bit;
+    if (i < j)
+    {
+      t = re[i];
+      re[i] = re[j];
+      re[j] = t;
+      t = im[i];
+      im[i] = im[j];
+      im[j] = t;
+    }
+  }
+
+  // Butterflies, each stage halved so that no magnitude grows
+  for (size = 2, step = LT_FFT_MAX_POINTS / 2; size <= points; size <<= 1, step >>= 1)
+  {
+    half = size >> 1;
+    for (k = 0; k < half; k++)
+    {
+      int16_t wr = fft_sin(k * step + FFT_QUARTER);   // cos(2 pi k / size)
+      int16_t wi = -fft_sin(k * step);                // -sin(2 pi k / size)
+
+      for (i = k; i < points; i += size)
+      {
+        uint16_t m = i + half;
+        int16_t tr = fft_multiply(wr, re[m]) - fft_multiply(wi, im[m]);
+        int16_t ti = fft_multiply(wr, im[m]) + fft_multiply(wi, re[m]);
+        int16_t ur = re[i];
+        int16_t ui = im[i];
+
+        re[i] = (int16_t)(((int32_t)ur + tr) >> 1);
+        im[i] = (int16_t)(((int32_t)ui + ti) >> 1);
+        re[m] = (int16_t)(((int32_t)ur - tr) >> 1);
+        im[m] = (int16_t)(((int32_t)ui - ti) >> 1);
+      }
+    }
+  }
+  return 0;
+}
+
+// w(n) = (1 - cos(2 pi n / points)) / 2
+void LT_fft_window(int16_t *samples, uint8_t log2_points)
+{
+  uint16_t points = 1U << log2_points;
+  uint16_t step = LT_FFT_MAX_POINTS >> log2_points;
+  uint16_t n;
+
+  for (n = 0; n < points; n++)
+  {
+    int16_t w = (int16_t)((32767 - (int32_t)fft_sin(n * step + FFT_QUARTER) + 1) >> 1);
+    samples[n] = fft_multiply(samples[n], w);
+  }
+}
+
+// Integer square root of a 32 bit value, rounded down
+static uint16_t fft_sqrt(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit = (uint32_t)1 << 30;
+
+  while (bit > value)
+    bit >>= 2;
+  while (bit != 0)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+void LT_fft_magnitude(const int16_t *re, const int16_t *im, uint16_t *magnitude, uint16_t bins)
+{
+  uint16_t k;
+
+  for (k = 0; k < bins; k++)
+    magnitude[k] = fft_sqrt((uint32_t)((int32_t)re[k] * re[k]) + (uint32_t)((int32_t)im[k] * im[k]));
+}
@@ -0,0 +1,93 @@
+/*!
+LT_FFT: Fixed-point FFT for spectra of ADC samples.
+
+@verbatim
+  Radix-2 decimation in time FFT on 16 bit (Q15) samples, in place, with a
+  Hann window and the magnitude of each bin. It takes 2 to 1024 points; on a
+  Linduino, 128 or 256 points fit in RAM with the sketch, at 4 bytes a point.
+
+  Every stage halves its results, so no magnitude grows and bin k of the
+  result is X[k] / points. Samples must be within +/-32767 (complex samples
+  within a magnitude of 32767) so that nothing overflows. A full scale sine at the center
+  of a bin reads 16384 in that bin, half the amplitude, without a window,
+  and 8192 through the Hann window, whose coherent gain is one half.
+
+  The twiddle factors come from a quarter wave sine table of 257 words in
+  program memory, so no RAM and no floating point are used.
+
+  Example, a spectrum of 128 real samples:
+
+    LT_fft_window(re, 7);           // re holds the samples, DC removed
+    memset(im, 0, sizeof(im));
+    LT_fft(re, im, 7);
+    LT_fft_magnitude(re, im, magnitude, 65);   // Bins 0 to 64
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LT_FFT
+    Library Header File for LT_FFT: Fixed-point FFT for spectra of ADC samples.
+*/
+
+#ifndef LT_FFT_H
+#define LT_FFT_H
+
+#include <stdint.h>
+
+#define LT_FFT_MAX_LOG2   10      //!< log2 of the most points
+#define LT_FFT_MAX_POINTS 1024    //!< Most points
+
+//! Transforms points = 2^log2_points complex samples in place. The result is
+//! in the natural order, scaled by 1 / points.
+//! @return 0 on success, 1 if log2_points is out of range
+int8_t LT_fft(int16_t *re,            //!< Real parts, samples in, spectrum out
+              int16_t *im,            //!< Imaginary parts, 0 for real samples
+              uint8_t log2_points     //!< 1 to LT_FFT_MAX_LOG2
+             );
+
+//! Multiplies 2^log2_points samples by a Hann window, in place.
+void LT_fft_window(int16_t *samples,        //!< Samples, DC removed for the cleanest spectrum
+                   uint8_t log2_points      //!< 1 to LT_FFT_MAX_LOG2
+                  );
+
+//! Works out the magnitude of each bin, rounded down.
+void LT_fft_magnitude(const int16_t *re,      //!< Real parts from LT_fft()
+                      const int16_t *im,      //!< Imaginary parts from LT_fft()
+                      uint16_t *magnitude,    //!< Magnitudes, may be im to save RAM
+                      uint16_t bins           //!< Bins to work out, points / 2 + 1 for real samples
+                     );
+
+#endif  // LT_FFT_H
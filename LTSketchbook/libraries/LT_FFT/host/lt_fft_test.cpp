@@ -0,0 +1,264 @@
+/*!
+LT_FFT host test
+@verbatim
+  Checks LT_fft() against a double precision DFT and times it on a PC, for
+  each size from 16 to 1024 points:
+
+    - random real and complex samples: largest error of any bin, in LSBs
+      of the scaled result, and the signal to error ratio of the spectrum
+    - a full scale sine at the center of a bin through LT_fft_window():
+      the peak bin, which should read 8192, and the highest other bin
+      outside the window's main lobe, in dB below the peak
+    - time per transform, next to a textbook float FFT of the same size
+
+  Build, from LT_FFT:
+    g++ -O2 -I. host/lt_fft_test.cpp LT_FFT.cpp -o lt_fft_test
+
+  Run:
+    ./lt_fft_test [-p passes]
+
+    -p passes   transforms timed per size, default 2000
+
+  Exits with 1 if a bin is off by more than log2(points) + 2 LSBs, or the
+  sine does not read within 1% of 8192.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <complex>
+#include <vector>
+#include "LT_FFT.h"
+
+typedef std::complex<double> cplx;
+
+static volatile int16_t sink;
+
+static double now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// X[k] / points, in double
+static void dft(const int16_t *re, const int16_t *im, uint16_t points, std::vector<cplx> &out)
+{
+  uint16_t k, n;
+
+  out.assign(points, cplx(0, 0));
+  for (k = 0; k < points; k++)
+  {
+    cplx sum(0, 0);
+    for (n = 0; n < points; n++)
+      sum += cplx(re[n], im[n]) * std::polar(1.0, -2 * M_PI * (double)((uint32_t)k * n % points) / points);
+    out[k] = sum / (double)points;
+  }
+}
+
+// Textbook float FFT, for the time comparison
+static void float_fft(float *re, float *im, uint16_t points)
+{
+  uint16_t i, j, bit, size, k;
+
+  for (i = 1, j = 0; i < points; i++)
+  {
+    for (bit = points >> 1; j & bit; bit >>= 1)
+      j ^= bit;
+    j |= bit;
+    if (i < j)
+    {
+      float t = re[i];
+      re[i] = re[j];
+      re[j] = t;
+      t = im[i];
+      im[i] = im[j];
+      im[j] = t;
+    }
+  }
+  for (size = 2; size <= points; size <<= 1)
+  {
+    for (k = 0; k < size / 2; k++)
+    {
+      float wr = cosf(2 * (float)M_PI * k / size);
+      float wi = -sinf(2 * (float)M_PI * k / size);
+      for (i = k; i < points; i += size)
+      {
+        uint16_t m = i + size / 2;
+        float tr = wr * re[m] - wi * im[m];
+        float ti = wr * im[m] + wi * re[m];
+        re[m] = re[i] - tr;
+        im[m] = im[i] - ti;
+        re[i] += tr;
+        im[i] += ti;
+      }
+    }
+  }
+}
+
+// Largest error of any bin in LSBs, and the signal to error ratio in dB
+static void compare(const int16_t *re, const int16_t *im, const std::vector<cplx> &expected, uint16_t points,
+                    double *worst, double *ratio_db)
+{
+  double signal = 0, error = 0;
+  uint16_t k;
+
+  *worst = 0;
+  for (k = 0; k < points; k++)
+  {
+    double e = std::abs(cplx(re[k], im[k]) - expected[k]);
+    if (e > *worst)
+      *worst = e;
+    signal += std::norm(expected[k]);
+    error += e * e;
+  }
+  *ratio_db = 10 * log10(signal / error);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t passes = 2000;
+  int failed = 0;
+  uint8_t log2_points;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "p:")) != -1)
+  {
+    if (opt == 'p')
+      passes = strtoul(optarg, NULL, 0);
+    else
+    {
+      fprintf(stderr, "usage: %s [-p passes]\n", argv[0]);
+      return 2;
+    }
+  }
+  srand(1);
+
+  printf("%6s %10s %8s %10s %8s %8s %9s %10s %10s\n", "points", "real LSB", "real dB", "cplx LSB", "cplx dB",
+         "peak", "spur dB", "fixed us", "float us");
+  for (log2_points = 4; log2_points <= LT_FFT_MAX_LOG2; log2_points++)
+  {
+    uint16_t points = 1U << log2_points;
+    uint16_t bins = points / 2 + 1;
+    uint16_t bin = points / 8;
+    std::vector<int16_t> re(points), im(points), in_re(points), in_im(points);
+    std::vector<uint16_t> magnitude(bins);
+    std::vector<float> fre(points), fim(points);
+    std::vector<cplx> expected;
+    double real_lsb, real_db, cplx_lsb, cplx_db, spur = 0, t0, t_fixed, t_float;
+    uint16_t n, k;
+    uint32_t pass;
+
+    // Random real samples
+    for (n = 0; n < points; n++)
+    {
+      in_re[n] = (int16_t)(rand() % 65535 - 32767);
+      in_im[n] = 0;
+    }
+    re = in_re;
+    im = in_im;
+    LT_fft(&re[0], &im[0], log2_points);
+    dft(&in_re[0], &in_im[0], points, expected);
+    compare(&re[0], &im[0], expected, points, &real_lsb, &real_db);
+
+    // Random complex samples, within a magnitude of 32767
+    for (n = 0; n < points; n++)
+    {
+      double a = 2 * M_PI * rand() / RAND_MAX, r = 32767.0 * rand() / RAND_MAX;
+      in_re[n] = (int16_t)(r * cos(a));
+      in_im[n] = (int16_t)(r * sin(a));
+    }
+    re = in_re;
+    im = in_im;
+    LT_fft(&re[0], &im[0], log2_points);
+    dft(&in_re[0], &in_im[0], points, expected);
+    compare(&re[0], &im[0], expected, points, &cplx_lsb, &cplx_db);
+
+    // Full scale sine at the center of a bin, windowed
+    for (n = 0; n < points; n++)
+    {
+      re[n] = (int16_t)lrint(32767 * sin(2 * M_PI * bin * n / points));
+      im[n] = 0;
+    }
+    LT_fft_window(&re[0], log2_points);
+    LT_fft(&re[0], &im[0], log2_points);
+    LT_fft_magnitude(&re[0], &im[0], &magnitude[0], bins);
+    for (k = 0; k < bins; k++)
+    {
+      if ((k + 1 < bin || k > bin + 1) && magnitude[k] > spur)
+        spur = magnitude[k];
+    }
+    spur = spur > 0 ? 20 * log10(spur / magnitude[bin]) : -20 * log10(magnitude[bin]);
+
+    t0 = now_ns();
+    for (pass = 0; pass < passes; pass++)
+    {
+      re = in_re;
+      im = in_im;
+      LT_fft(&re[0], &im[0], log2_points);
+      sink = re[pass & (points - 1)];
+    }
+    t_fixed = (now_ns() - t0) / passes / 1000;
+
+    t0 = now_ns();
+    for (pass = 0; pass < passes; pass++)
+    {
+      for (n = 0; n < points; n++)
+      {
+        fre[n] = in_re[n];
+        fim[n] = in_im[n];
+      }
+      float_fft(&fre[0], &fim[0], points);
+      sink = (int16_t)fre[pass & (points - 1)];
+    }
+    t_float = (now_ns() - t0) / passes / 1000;
+
+    printf("%6u %10.2f %8.1f %10.2f %8.1f %8u %9.1f %10.2f %10.2f\n", points, real_lsb, real_db, cplx_lsb, cplx_db,
+           magnitude[bin], spur, t_fixed, t_float);
+    if (real_lsb > log2_points + 2 || cplx_lsb > log2_points + 2 || fabs(magnitude[bin] - 8192.0) > 82)
+      failed = 1;
+  }
+
+  if (LT_fft(NULL, NULL, 0) != 1 || LT_fft(NULL, NULL, LT_FFT_MAX_LOG2 + 1) != 1)
+    failed = 1;
+  printf("%s\n", failed ? "FAILED" : "all sizes within bounds");
+  return failed;
+}
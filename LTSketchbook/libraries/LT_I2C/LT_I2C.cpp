@@ -83,308 +83,395 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <util/delay.h>
 #include "Linduino.h"
 #include "LT_I2C.h"
+#include "LT_Trace.h"
 
 //! CPU master clock frequency
 #ifndef F_CPU
 #define F_CPU 16000000UL
 #endif
 
-// Read a byte, store in "value".
-int8_t i2c_read_byte(uint8_t address, uint8_t *value)
+// Transaction engine state. i2c_queue[i2c_head] is the transaction on the bus.
+static i2c_transfer *volatile i2c_queue[I2C_QUEUE_LEN];
+static volatile uint8_t i2c_head = 0;
+static volatile uint8_t i2c_count = 0;
+static volatile uint16_t i2c_pos = 0;        // Bytes written or read in the current phase
+static volatile uint8_t i2c_reading = 0;     // Current phase is the read after address+R
+static volatile uint16_t i2c_rx_total = 0;   // Bytes to clock in the read phase, with the count and PEC
+static volatile uint16_t i2c_rx_room = 0;    // Bytes of the read phase that are stored in rx
+static volatile uint8_t i2c_error = 0;       // The device sent a block longer than rx
+static volatile uint8_t i2c_steps = 0;       // Counts engine steps, for the i2c_wait() timeout
+
+// Replaced by LT_I2C_ISR.h when the sketch installs the TWI interrupt handler
+uint8_t __attribute__((weak)) i2c_isr_installed()
 {
-  uint8_t ret=0;
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_READ_BIT);                // Write the I2C 7-bit address with R bit
-  if (ret != 0)                                   // Returns 1 if failed
-    return(1);
-
-  *value = i2c_read(WITH_NACK);                           // Read byte from I2C Bus with NAK
-  i2c_stop();                                     //I2C STOP
-  return(0);                                      // Return success
+  return 0;
+}
 
+// TWCR bits that let the TWI run the next step, with the interrupt enabled if installed
+static uint8_t i2c_go()
+{
+  return (1<<TWINT) | (1<<TWEN) | (i2c_isr_installed() ? (1<<TWIE) : 0);
 }
 
-// Write "value" byte to device at "address"
-int8_t i2c_write_byte(uint8_t address, uint8_t value)
+// Adds one byte to the SMBus PEC, a CRC-8 with polynomial x^8 + x^2 + x + 1
+static uint8_t i2c_pec_add(uint8_t pec, uint8_t data)
 {
-  int8_t ret= 0 ;
+  uint8_t i;
 
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);        //Write the I2C 7 bit address with W bit
-  ret |= i2c_write(value);            //Write value
-  i2c_stop();                         //I2C STOP
-  if (ret!=0)                            // Returns 1 if failed
-    return(1);
-  return(0);                          // Returns 0 if success
+  pec ^= data;
+  for (i = 0; i < 8; i++)
+    pec = (pec & 0x80) ? (uint8_t)((pec << 1) ^ 0x07) : (uint8_t)(pec << 1);
+  return pec;
 }
 
-// Read a byte of data at register specified by "command", store in "value"
-int8_t i2c_read_byte_data(uint8_t address, uint8_t command, uint8_t *value)
+// True if the transaction has a read phase
+static uint8_t i2c_has_read(i2c_transfer *x)
 {
-  int8_t ret = 0;
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);        // Write 7 bit address with W bit
-  if (ret!=0)   //If NACK return 1
-  {
-    i2c_stop();                         //I2C STOP
-    return(1);
-  }
-  ret|= i2c_write(command);                 // Set register to be read to command
-  if (ret!=0)   //If NACK return 1
-  {
-    i2c_stop();                         //I2C STOP
-    return(1);
-  }
-  if (i2c_start()!=0)                                 //I2C repeated START
-  {
-    i2c_stop();                                 //Attempt to issue I2C STOP
-    return(1);                                  //Stop and return 0 if START fail
-  }
-  ret |= i2c_write((address<<1)|I2C_READ_BIT);     // Write 7 bit address with R bit
-  *value = i2c_read(WITH_NACK);               // Read byte from buffer with NAK
-  i2c_stop();                         // I2C STOP
-  if (ret!=0)                         //If there was a NAK return 1
-    return(1);
-  return(0);                     // Return success
+  return (x->rx_len != 0) || (x->flags & I2C_XFER_BLOCK);
 }
 
-// Write a byte of data to register specified by "command"
-int8_t i2c_write_byte_data(uint8_t address, uint8_t command, uint8_t value)
+// Bytes in the write phase: the command bytes, tx, and the PEC when nothing is read back
+static uint16_t i2c_write_len(i2c_transfer *x)
 {
-  int8_t ret = 0;
+  uint16_t len = x->command_len + x->tx_len;
 
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);        // Write 7 bit address with W bit
-  ret|= i2c_write(command);                 // Set register to be read to command
-  ret|= i2c_write(value);
-  i2c_stop();                        // I2C STOP
+  if ((x->flags & I2C_XFER_PEC) && len != 0 && !i2c_has_read(x))
+    len++;
+  return len;
+}
 
-  if (ret!=0)                         //If there was a NAK return 1
-    return(1);
-  return(0);                     // Return success
+// Byte i of the write phase: the command bytes, then tx, then the PEC
+static uint8_t i2c_tx_byte(i2c_transfer *x, uint16_t i)
+{
+  if (i < x->command_len)
+    return x->command[i];
+  i -= x->command_len;
+  if (i >= x->tx_len)
+    return x->pec;
+  return (x->flags & I2C_XFER_REVERSE) ? x->tx[x->tx_len - 1 - i] : x->tx[i];
 }
 
-// Read a 16-bit word of data from register specified by "command"
-int8_t i2c_read_word_data(uint8_t address, uint8_t command, uint16_t *value)
+// Adds a finished transaction to the bus trace, with both phases in bus order
+static void i2c_trace(i2c_transfer *x, int8_t result)
 {
-  int8_t ret = 0;
+  uint8_t reverse = (x->flags & I2C_XFER_REVERSE) ? 1 : 0;
+  uint8_t kind = LT_TRACE_I2C;
+  uint16_t rx_len = result ? 0 : x->rx_len;
+  uint16_t pos;
+
+  if (result)
+    kind |= LT_TRACE_FAILED;
+  if (x->flags & I2C_XFER_PEC)
+    kind |= LT_TRACE_PEC;
+  if (x->flags & I2C_XFER_BLOCK)
+    kind |= LT_TRACE_BLOCK;
+  pos = lt_trace_open(kind, x->address, x->command_len + x->tx_len, rx_len);
+  if (pos == LT_TRACE_NONE)
+    return;
+  pos = lt_trace_write(pos, x->command, x->command_len, 0);
+  pos = lt_trace_write(pos, x->tx, x->tx_len, reverse);
+  lt_trace_write(pos, x->rx, rx_len, reverse);
+}
 
-  union
-  {
-    uint8_t b[2];
-    uint16_t w;
-  } data;
+// A block read that ended before the byte count came in still has the size of the
+// buffer in rx_len; it read nothing. running is 1 for the transaction on the bus.
+static void i2c_block_count(i2c_transfer *x, uint8_t running)
+{
+  if ((x->flags & I2C_XFER_BLOCK) && !(running && i2c_reading && i2c_pos != 0))
+    x->rx_len = 0;
+}
 
+// Ends the transaction on the bus, and sends STOP, or STOP and START when more are queued
+static void i2c_finish(int8_t result)
+{
+  i2c_transfer *x = i2c_queue[i2c_head];
+
+  i2c_block_count(x, 1);
+  i2c_head = (i2c_head + 1) % I2C_QUEUE_LEN;
+  i2c_count--;
+  i2c_pos = 0;
+  i2c_reading = 0;
+  i2c_error = 0;
+  if (i2c_count != 0)
+    TWCR = i2c_go() | (1<<TWSTO) | (1<<TWSTA);  // STOP, then START the next one
+  else
+    TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO);
+  if (lt_trace_buf)
+    i2c_trace(x, result);
+  x->status = result;
+  if (x->callback)
+    x->callback(x);
+}
 
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);        // Write 7 bit address with W bit
-  if (ret!=0)   //If NACK return 1
+// Runs one step of the engine after the TWI set TWINT. The TWI is always given
+// the next step before a byte is stored or added to the PEC, so that work is
+// done while the bus is busy.
+void i2c_engine_isr()
+{
+  i2c_transfer *x = i2c_queue[i2c_head];
+  uint16_t write_len = i2c_write_len(x);
+  uint8_t status = TWSR & 0xF8;
+  uint8_t block = (x->flags & I2C_XFER_BLOCK) ? 1 : 0;
+  uint8_t data;
+  uint16_t i;
+
+  i2c_steps++;
+  switch (status)
   {
-    i2c_stop();                         //I2C STOP
-    return(1);
+    case STATUS_START:
+    case STATUS_REPEATED_START:
+      if (write_len == 0 && i2c_has_read(x))
+        i2c_reading = 1;                                  // Read only, no command
+      data = (x->address<<1) | (i2c_reading ? I2C_READ_BIT : I2C_WRITE_BIT);
+      TWDR = data;
+      TWCR = i2c_go();
+      if (x->flags & I2C_XFER_PEC)
+        x->pec = i2c_pec_add(x->pec, data);
+      break;
+
+    case STATUS_ADDRESS_WRITE_ACK:
+    case STATUS_WRITE_ACK:
+      if (i2c_pos < write_len)
+      {
+        data = i2c_tx_byte(x, i2c_pos);
+        i2c_pos++;
+        TWDR = data;
+        TWCR = i2c_go();
+        if (x->flags & I2C_XFER_PEC)
+          x->pec = i2c_pec_add(x->pec, data);
+      }
+      else if (i2c_has_read(x))
+      {
+        i2c_reading = 1;
+        i2c_pos = 0;
+        TWCR = i2c_go() | (1<<TWSTA);                     // Repeated START for the read
+      }
+      else
+        i2c_finish(0);
+      break;
+
+    case STATUS_ADDRESS_READ_ACK:
+      i2c_rx_room = x->rx_len;
+      i2c_rx_total = x->rx_len + block + ((x->flags & I2C_XFER_PEC) ? 1 : 0);
+      TWCR = i2c_go() | ((i2c_rx_total > 1) ? (1<<TWEA) : 0);
+      break;
+
+    case STATUS_READ_ACK:
+    case STATUS_READ_NACK:
+      data = TWDR;
+      i = i2c_pos++;
+      if (block && i == 0)
+      {
+        // The byte count: read that many bytes, or fail if they do not fit in rx
+        x->rx_len = data;
+        if (data > i2c_rx_room)
+          i2c_error = 1;
+        else
+          i2c_rx_room = data;
+        i2c_rx_total = 1 + i2c_rx_room + ((x->flags & I2C_XFER_PEC) ? 1 : 0);
+        if (status == STATUS_READ_ACK && i2c_rx_total <= i2c_pos)
+          i2c_rx_total = i2c_pos + 1;                     // Count of 0 was ACKed, NACK one more byte
+      }
+      if (status == STATUS_READ_ACK)
+        TWCR = i2c_go() | ((i2c_rx_total - i2c_pos > 1) ? (1<<TWEA) : 0);
+      if (i >= block && i - block < i2c_rx_room)
+      {
+        i -= block;
+        x->rx[(x->flags & I2C_XFER_REVERSE) ? i2c_rx_room - 1 - i : i] = data;
+      }
+      if (x->flags & I2C_XFER_PEC)
+        x->pec = i2c_pec_add(x->pec, data);
+      if (status == STATUS_READ_NACK)                     // The last byte was NACKed
+        i2c_finish((i2c_error || ((x->flags & I2C_XFER_PEC) && x->pec != 0)) ? 1 : 0);
+      break;
+
+    default:                                              // NACK, arbitration lost or bus error
+      i2c_finish(1);
+      break;
   }
-  ret |= i2c_write(command);                 // Set register to be read to command
-  if (ret!=0)   //If NACK return 1
+}
+
+// Queue a transaction. It starts at once if the bus is free.
+int8_t i2c_submit(i2c_transfer *transfer)
+{
+  uint8_t sreg = SREG;
+
+  cli();
+  if (i2c_count >= I2C_QUEUE_LEN)
   {
-    i2c_stop();                         //I2C STOP
+    SREG = sreg;
     return(1);
   }
-  if (i2c_start()!=0)                                 //I2C START
+  transfer->status = I2C_XFER_PENDING;
+  transfer->pec = 0;
+  i2c_queue[(i2c_head + i2c_count) % I2C_QUEUE_LEN] = transfer;
+  i2c_count++;
+  if (i2c_count == 1)
   {
-    i2c_stop();                                 //Attempt to issue I2C STOP
-    return(1);                                  //Stop and return 0 if START fail
+    while (TWCR & (1<<TWSTO));                            // Let the last STOP finish
+    i2c_pos = 0;
+    i2c_reading = 0;
+    TWCR = i2c_go() | (1<<TWSTA);                         // START
   }
-  ret |= i2c_write((address<<1)|I2C_READ_BIT);     // Write 7 bit address with R bit
-
-  data.b[1] = i2c_read(WITH_ACK);                        // Read MSB from buffer
-  data.b[0] = i2c_read(WITH_NACK);                        // Read LSB from buffer
-  i2c_stop();                         //I2C STOP
-
-  *value = data.w;
-
-  if (ret!=0)                         //If NAK
-    return (1);                     //return 1
-  return(0);                                      // Return success
+  SREG = sreg;
+  return(0);
 }
 
-// Write a 16-bit word of data to register specified by "command"
-int8_t i2c_write_word_data(uint8_t address, uint8_t command, uint16_t value)
+// Advance the engine if the TWI has finished a step
+void i2c_service()
 {
-  int8_t ret=0;
-
-  union
-  {
-    uint8_t b[2];
-    uint16_t w;
-  } data;
-  data.w = value;
-
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);       // Write 7 bit address with W bit
-  ret|= i2c_write(command);                 // Set register to be read to command
-  ret|= i2c_write(data.b[1]);         //Write MSB
-  ret|= i2c_write(data.b[0]);         //Write LSB;
-
-  i2c_stop();                        // I2C STOP
-
-  if (ret!=0)                         //If there was a NAK return 1
-    return(1);
-  return(0);
+  uint8_t sreg = SREG;
 
+  cli();
+  if (i2c_count != 0 && (TWCR & (1<<TWINT)))
+    i2c_engine_isr();
+  SREG = sreg;
+}
 
+// Returns the number of transactions queued or running
+uint8_t i2c_busy()
+{
+  return i2c_count;
 }
 
-// Read a block of data, starting at register specified by "command" and ending at (command + length - 1)
-int8_t i2c_read_block_data(uint8_t address, uint8_t command, uint8_t length, uint8_t *values)
+// Release the bus and fail every queued transaction
+void i2c_abort()
 {
-  uint8_t i = (length-1);
-  int8_t ret = 0;
+  uint8_t sreg = SREG;
+  uint8_t running = 1;
 
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);       //Write 7-bit address with W bit
-  if (ret!=0)   //If NACK return 1
+  cli();
+  TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO);
+  while (i2c_count != 0)
   {
-    i2c_stop();                         //I2C STOP
-    return(1);
-  }
-  ret|= i2c_write(command);                           //Write 8 bit command word
-  if (ret!=0)   //If NACK return 1
-  {
-    i2c_stop();                         //I2C STOP
-    return(1);
+    i2c_transfer *x = i2c_queue[i2c_head];
+    i2c_block_count(x, running);
+    running = 0;
+    i2c_head = (i2c_head + 1) % I2C_QUEUE_LEN;
+    i2c_count--;
+    if (lt_trace_buf)
+      i2c_trace(x, 1);
+    x->status = 1;
+    if (x->callback)
+      x->callback(x);
   }
-  if (i2c_start()!=0)                                 //I2C repeated START
-  {
-    i2c_stop();                                 //Attempt to issue I2C STOP
-    return(1);                                  //Stop and return 0 if START fail
-  }
-  ret |= i2c_write((address<<1)|I2C_READ_BIT);        //Write 7-bit address with R bit
+  i2c_pos = 0;
+  i2c_reading = 0;
+  i2c_error = 0;
+  SREG = sreg;
+}
 
-  if (ret!=0)   //If NACK return 1
-  {
-    i2c_stop();                         //I2C STOP
-    return(1);
-  }
-  while (i>0)                         //Begin read loop
+// Wait for a transaction to finish
+int8_t i2c_wait(i2c_transfer *transfer)
+{
+  uint16_t timeout = 0;
+  uint8_t steps = i2c_steps;
+
+  while (transfer->status == I2C_XFER_PENDING)
   {
-    values[i] = i2c_read(WITH_ACK); //Read from bus with ACK
-    i--;
+    i2c_service();
+    if (steps != i2c_steps)                               // The bus moved, restart the timeout
+    {
+      steps = i2c_steps;
+      timeout = 0;
+    }
+    else if (++timeout >= HW_I2C_TIMEOUT)
+      i2c_abort();
+    else
+      _delay_us(1);
   }
+  return(transfer->status);
+}
 
-  values[0] = i2c_read(WITH_NACK);    //Read from bus with NACK for the last one;
-
-  i2c_stop();                         //I2C STOP
-
-
-  return(0);                           // Success!
+// Waits until every queued transaction has finished, before the bus is used directly
+static void i2c_drain()
+{
+  while (i2c_count != 0)
+    i2c_wait(i2c_queue[(i2c_head + i2c_count - 1) % I2C_QUEUE_LEN]);
 }
 
+// Runs one transaction and waits for it. Buffers are sent and filled last byte
+// first, which is the order the i2c_*_data functions have always used.
+static int8_t i2c_run(uint8_t address, uint8_t command_len, uint16_t command,
+                      const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len)
+{
+  i2c_transfer x;
+
+  x.address = address;
+  x.command[0] = (command_len == 2) ? (uint8_t)(command >> 8) : (uint8_t)command;
+  x.command[1] = (uint8_t)command;
+  x.command_len = command_len;
+  x.tx = tx;
+  x.tx_len = tx_len;
+  x.rx = rx;
+  x.rx_len = rx_len;
+  x.flags = I2C_XFER_REVERSE;
+  x.callback = 0;
+  x.arg = 0;
+  while (i2c_submit(&x) != 0)                             // Queue full, wait for the oldest
+    i2c_wait(i2c_queue[i2c_head]);
+  return(i2c_wait(&x));
+}
 
-// Read a block of data, no command byte, reads length number of bytes and stores it in values.
-int8_t i2c_read_block_data(uint8_t address, uint8_t length, uint8_t *values)
+// Read a byte, store in "value".
+int8_t i2c_read_byte(uint8_t address, uint8_t *value)
 {
-  uint8_t i = (length-1);
-  int8_t ret = 0;
+  return(i2c_run(address, 0, 0, 0, 0, value, 1));
+}
 
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_READ_BIT);        //Write 7-bit address with R bit
+// Write "value" byte to device at "address"
+int8_t i2c_write_byte(uint8_t address, uint8_t value)
+{
+  return(i2c_run(address, 0, 0, &value, 1, 0, 0));
+}
 
-  if (ret!=0)   //If NACK return 1
-  {
-    i2c_stop();                         //I2C STOP
-    return(1);
-  }
-  while (i>0)                         //Begin read loop
-  {
-    values[i] = i2c_read(WITH_ACK); //Read from bus with ACK
-    i--;
-  }
+// Read a byte of data at register specified by "command", store in "value"
+int8_t i2c_read_byte_data(uint8_t address, uint8_t command, uint8_t *value)
+{
+  return(i2c_run(address, 1, command, 0, 0, value, 1));
+}
 
-  values[0] = i2c_read(WITH_NACK);    //Read from bus with NACK for the last one;
+// Write a byte of data to register specified by "command"
+int8_t i2c_write_byte_data(uint8_t address, uint8_t command, uint8_t value)
+{
+  return(i2c_run(address, 1, command, &value, 1, 0, 0));
+}
 
-  i2c_stop();                         //I2C STOP
+// Read a 16-bit word of data from register specified by "command"
+int8_t i2c_read_word_data(uint8_t address, uint8_t command, uint16_t *value)
+{
+  // MSB first on the bus, read into the little endian word last byte first
+  return(i2c_run(address, 1, command, 0, 0, (uint8_t *)value, 2));
+}
 
+// Write a 16-bit word of data to register specified by "command"
+int8_t i2c_write_word_data(uint8_t address, uint8_t command, uint16_t value)
+{
+  return(i2c_run(address, 1, command, (const uint8_t *)&value, 2, 0, 0));
+}
 
-  return(0);                           // Success!
+// Read a block of data, starting at register specified by "command" and ending at (command + length - 1)
+int8_t i2c_read_block_data(uint8_t address, uint8_t command, uint8_t length, uint8_t *values)
+{
+  return(i2c_run(address, 1, command, 0, 0, values, length));
 }
 
+// Read a block of data, no command byte, reads length number of bytes and stores it in values.
+int8_t i2c_read_block_data(uint8_t address, uint8_t length, uint8_t *values)
+{
+  return(i2c_run(address, 0, 0, 0, 0, values, length));
+}
 
 // Write a block of data, starting at register specified by "command" and ending at (command + length - 1)
 int8_t i2c_write_block_data(uint8_t address, uint8_t command, uint8_t length, uint8_t *values)
 {
-  int8_t i = length-1;
-  int8_t ret = 0;
-
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);        // Write 7 bit address with W bit
-  ret|= i2c_write(command);           // Set register to be read to command
-
-  while (i>=0)
-  {
-    ret|= i2c_write(values[i]);     //Write Value
-    i--;
-  }
-  i2c_stop();                        // I2C STOP
-
-  if (ret!=0)
-    return(1);
-  else
-    return(0);                      // Success!
+  return(i2c_run(address, 1, command, values, length, 0, 0));
 }
 
 // Write two command bytes, then receive a block of data
 int8_t i2c_two_byte_command_read_block(uint8_t address, uint16_t command, uint8_t length, uint8_t *values)
 {
-
-  int8_t ret = 0;
-
-  union
-  {
-    uint8_t b[2];
-    uint16_t w;
-  } comm;
-  comm.w = command;
-
-  uint8_t i = (length-1);
-
-
-  if (i2c_start()!=0)                                //I2C START
-    return(1);                                  //Stop and return 0 if START fail
-  ret |= i2c_write((address<<1)|I2C_WRITE_BIT);           //Write 7-bit address with W bit
-  ret |= i2c_write(comm.b[1]);                             //Write MSB command word
-  ret |= i2c_write(comm.b[0]);                             // Write LSB of command
-  if (i2c_start()!=0)                                 //I2C repeated START
-  {
-    i2c_stop();                                 //Attempt to issue I2C STOP
-    return(1);                                  //Stop and return 0 if START fail
-  }
-  ret |= i2c_write((address<<1)|I2C_READ_BIT);            //Write 7-bit address with R bit
-  if (ret!=0)                                              //If NACK return 1
-  {
-    i2c_stop();
-    return(1);
-  }
-  while (i> 0)                         //Begin read loop
-  {
-    values[i] = i2c_read(WITH_ACK); //Read from bus with ACK
-    i--;
-  }
-
-  values[0] = i2c_read(WITH_NACK);    //Read from bus with NACK for the last one;
-  i2c_stop();                         //I2C STOP
-
-
-  return(0);                           // Success!
-
+  return(i2c_run(address, 2, command, 0, 0, values, length));
 }
 
 // Initializes Linduino I2C port.
@@ -426,6 +513,7 @@ int8_t i2c_start()
 {
   uint8_t result;
   uint16_t timeout;
+  i2c_drain();                                              //! 0) Let queued transactions finish
   TWCR=(1<<TWINT) | (1<<TWSTA) | (1<<TWEN);                 //! 1) I2C start
   for (timeout = 0; timeout < HW_I2C_TIMEOUT; timeout++)    //! 2) START the timeout loop
   {
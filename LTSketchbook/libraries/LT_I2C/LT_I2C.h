@@ -208,6 +208,84 @@ uint8_t i2c_read(int8_t ack //!< If ACK is 0 then an acknowledge is generated, e
 int8_t i2c_poll(uint8_t i2c_address //!< i2c_address is the address of the slave being polled.
                );
 
+//! @name I2C TRANSACTION ENGINE
+//! @{
+//! The i2c_read_* and i2c_write_* functions above run through a small engine that
+//! drives the TWI one state at a time and keeps a queue of transactions. A sketch
+//! can also submit transactions itself and do other work while they run:
+//!
+//!     i2c_transfer adc;
+//!     adc.address = LTC2485_I2C_ADDRESS;   // fill the rest, then
+//!     i2c_submit(&adc);
+//!     ...                                  // compute while the bytes are clocked
+//!     if (i2c_wait(&adc) == 0) ...
+//!
+//! Without the TWI interrupt the engine is advanced by i2c_service(), which
+//! i2c_wait() calls. Including LT_I2C_ISR.h in one file of the sketch installs the
+//! TWI interrupt handler, and the engine then runs in the background. It is not
+//! included by default because the Wire library has its own handler.
+#define I2C_QUEUE_LEN      4     //!< Transactions that can be queued at once
+#define I2C_XFER_PENDING   -1    //!< i2c_transfer.status until the transaction is finished
+#define I2C_XFER_REVERSE   0x01  //!< Send tx and fill rx last byte first, as the block functions do
+#define I2C_XFER_PEC       0x02  //!< SMBus PEC: sent after a write with no read, else read and checked after rx
+#define I2C_XFER_BLOCK     0x04  //!< SMBus block read: the device sends a byte count before the rx bytes
+//! @}
+
+struct i2c_transfer;
+
+//! Called when a transaction finishes, from the TWI interrupt when it is installed
+typedef void (*i2c_callback)(struct i2c_transfer *transfer);
+
+//! One I2C transaction: START, address+W, command and tx bytes, then a repeated
+//! START, address+R and rx bytes, then STOP. Either phase may be empty.
+//!
+//! The rx bytes are stored straight into the caller's buffer as they arrive, so
+//! there is no limit on the length other than the buffer. With I2C_XFER_PEC the
+//! PEC is worked out while the bus clocks the next byte; the PEC byte itself is
+//! never stored in rx. With I2C_XFER_BLOCK, rx_len is the size of the buffer on
+//! submit and the byte count sent by the device when the transaction finishes,
+//! or 0 if it failed before the count was read.
+typedef struct i2c_transfer
+{
+  uint8_t address;          //!< 7-bit I2C address
+  uint8_t command[2];       //!< Command bytes sent first
+  uint8_t command_len;      //!< Number of command bytes, 0 to 2
+  const uint8_t *tx;        //!< Bytes written after the command
+  uint16_t tx_len;          //!< Number of bytes to write
+  uint8_t *rx;              //!< Buffer for the bytes read
+  uint16_t rx_len;          //!< Number of bytes to read, the last one is NACKed
+  uint8_t flags;            //!< I2C_XFER_REVERSE, I2C_XFER_PEC, I2C_XFER_BLOCK
+  uint8_t pec;              //!< With I2C_XFER_PEC, the PEC of every byte on the bus; 0 after a good read
+  i2c_callback callback;    //!< Called when finished, may be 0
+  void *arg;                //!< Free for the caller, e.g. for the callback
+  volatile int8_t status;   //!< I2C_XFER_PENDING, then 0 on success, 1 on failure (NACK, bad PEC, block too long)
+} i2c_transfer;
+
+//! Queue a transaction. It starts at once if the bus is free.
+//! The transfer and its buffers must stay valid until it is finished.
+//! @return 0 if queued, 1 if the queue is full
+int8_t i2c_submit(i2c_transfer *transfer  //!< Transaction, status is set to I2C_XFER_PENDING
+                 );
+
+//! Wait for a transaction to finish, advancing the engine if the interrupt is not installed.
+//! If the bus makes no progress for HW_I2C_TIMEOUT us every queued transaction is failed.
+//! @return 0 on success, 1 on failure
+int8_t i2c_wait(i2c_transfer *transfer  //!< A submitted transaction
+               );
+
+//! Advance the engine if the TWI has finished a step. Call it from loop() to keep
+//! submitted transactions moving when the interrupt is not installed.
+void i2c_service();
+
+//! @return the number of transactions queued or running
+uint8_t i2c_busy();
+
+//! Release the bus and fail every queued transaction.
+void i2c_abort();
+
+//! Run one step of the engine. Called by the TWI interrupt handler in LT_I2C_ISR.h.
+void i2c_engine_isr();
+
 
 // //! Read a byte, store in "value".
 // //! @return -1 if failed or value if it succeeds
@@ -0,0 +1,72 @@
+/*!
+LT_I2C_ISR: Installs the TWI interrupt handler for the LT_I2C transaction engine.
+
+@verbatim
+
+Include this file in exactly one file of a sketch (normally the .ino) to run
+I2C transactions submitted with i2c_submit() in the background. Without it the
+engine only advances inside i2c_wait() and i2c_service().
+
+Do not include it in a sketch that uses the Wire library, which installs its
+own TWI interrupt handler.
+
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LT_I2C
+    Installs the TWI interrupt handler for the LT_I2C transaction engine.
+*/
+
+#ifndef LT_I2C_ISR_H
+#define LT_I2C_ISR_H
+
+#include <avr/interrupt.h>
+#include "LT_I2C.h"
+
+//! Tells LT_I2C to enable the TWI interrupt
+uint8_t i2c_isr_installed()
+{
+  return 1;
+}
+
+//! TWI interrupt: one step of the transaction engine
+ISR(TWI_vect)
+{
+  i2c_engine_isr();
+}
+
+#endif  // LT_I2C_ISR_H
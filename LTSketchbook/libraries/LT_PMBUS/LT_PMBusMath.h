@@ -50,12 +50,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef LT_PMBusMath_H_
 #define LT_PMBusMath_H_
 
+#include <stdint.h>
+
 class LT_PMBusMath
 {
 
   public:
 
-    typedef unsigned long   fl32_t;    // Type for the bit representation of "float"
+    typedef uint32_t        fl32_t;    // Type for the bit representation of "float"
     typedef unsigned int    lin11_t;   // Type for PMBus Linear11 mantissa
     typedef unsigned int    lin16_t;   // Type for PMBus Linear16 mantissa
     typedef unsigned int    lin16m_t;  // Type for PMBus Linear16 VOUT_MODE
@@ -55,6 +55,27 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //#include <util/delay.h>
 #include "Linduino.h"
 #include "LT_I2CBus.h"
+#include "LT_Trace.h"
+
+// Adds one byte to the SMBus PEC, the same CRC-8 as LT_SMBus::pecAdd()
+static uint8_t pec_add(uint8_t pec, uint8_t data)
+{
+  uint8_t i;
+
+  pec ^= data;
+  for (i = 0; i < 8; i++)
+    pec = (pec & 0x80) ? (uint8_t)((pec << 1) ^ 0x07) : (uint8_t)(pec << 1);
+  return pec;
+}
+
+// Adds a transaction that went through the Wire buffer to the bus trace.
+// Transactions run by LT_Wire.readFrom() are traced by the LT_I2C engine.
+static void trace(uint8_t address, uint8_t failed, const uint8_t *tx, uint16_t tx_len,
+                  const uint8_t *rx, uint16_t rx_len)
+{
+  lt_trace_record(LT_TRACE_I2C | (failed ? LT_TRACE_FAILED : 0), address,
+                  tx, tx_len, rx, failed ? 0 : rx_len);
+}
 
 LT_I2CBus::LT_I2CBus()
 {
@@ -84,8 +105,11 @@ uint32_t LT_I2CBus::getSpeed()
 int8_t LT_I2CBus::readByte(uint8_t address, uint8_t *value)
 {
   uint8_t ret = 0;
+  uint8_t count;
   LT_Wire.beginTransmission(address);
-  LT_Wire.requestFrom(address, value, (uint16_t)1);
+  count = LT_Wire.requestFrom(address, value, (uint16_t)1);
+  if (lt_trace_buf)
+    trace(address, count != 1, 0, 0, value, 1);
 
 
   return ret;
@@ -99,6 +123,8 @@ int8_t LT_I2CBus::writeByte(uint8_t address, uint8_t value)
   LT_Wire.beginTransmission(address);
   LT_Wire.write(value);
   ret = LT_Wire.endTransmission(!inGroupProtocol_);
+  if (lt_trace_buf)
+    trace(address, ret != 0, &value, 1, 0, 0);
   return ret;
 }
 
@@ -106,11 +132,14 @@ int8_t LT_I2CBus::writeByte(uint8_t address, uint8_t value)
 int8_t LT_I2CBus::readByteData(uint8_t address, uint8_t command, uint8_t *value)
 {
   int8_t ret = 1;
+  uint8_t count;
   LT_Wire.beginTransmission(address);
   LT_Wire.write(command);
   ret = LT_Wire.endTransmission(false);
   LT_Wire.beginTransmission(address);
-  LT_Wire.requestFrom(address, value, (uint16_t)1);
+  count = LT_Wire.requestFrom(address, value, (uint16_t)1);
+  if (lt_trace_buf)
+    trace(address, ret != 0 || count != 1, &command, 1, value, 1);
 
   return ret;                             // Return result
 }
@@ -124,6 +153,11 @@ int8_t LT_I2CBus::writeByteData(uint8_t address, uint8_t command, uint8_t value)
   LT_Wire.write(command);
   LT_Wire.write(value);
   ret = LT_Wire.endTransmission(!inGroupProtocol_);
+  if (lt_trace_buf)
+  {
+    uint8_t tx[2] = {command, value};
+    trace(address, ret != 0, tx, 2, 0, 0);
+  }
   return ret;
 }
 
@@ -137,7 +171,9 @@ int8_t LT_I2CBus::readWordData(uint8_t address, uint8_t command, uint16_t *value
   ret = LT_Wire.endTransmission(false);
   LT_Wire.beginTransmission(address);
   uint8_t tempHolder[2];
-  LT_Wire.requestFrom(address, tempHolder, (uint16_t)2);
+  uint8_t count = LT_Wire.requestFrom(address, tempHolder, (uint16_t)2);
+  if (lt_trace_buf)
+    trace(address, ret != 0 || count != 2, &command, 1, tempHolder, 2);
   *value = tempHolder[0] << 8;
   *value |= tempHolder[1];
 
@@ -154,70 +190,128 @@ int8_t LT_I2CBus::writeWordData(uint8_t address, uint8_t command, uint16_t value
   LT_Wire.write(value >> 8);
   LT_Wire.write(value & 0xFF);
   ret = LT_Wire.endTransmission(!inGroupProtocol_);
+  if (lt_trace_buf)
+  {
+    uint8_t tx[3] = {command, (uint8_t)(value >> 8), (uint8_t)value};
+    trace(address, ret != 0, tx, 3, 0, 0);
+  }
 
   return ret;
 }
 
+// Read a block of data, starting at register specified by "command" and ending at (command + length - 1)
 int8_t LT_I2CBus::readBlockData(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
 {
-  int8_t ret = 0;
-  LT_Wire.beginTransmission(address);
-  LT_Wire.write(command);
-  ret = LT_Wire.endTransmission(false);
-  LT_Wire.beginTransmission(address);
-  LT_Wire.requestFrom(address, values, length);
+  uint16_t count;
 
-  return ret;
+  return LT_Wire.readFrom(address, command, 1, values, length, 0, &count);
 }
 
+// Read a block of data, starting at register specified by "command", followed by a PEC
+int8_t LT_I2CBus::readBlockDataPec(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  uint16_t count;
+
+  return LT_Wire.readFrom(address, command, 1, values, length, I2C_XFER_PEC, &count);
+}
 
 // Read a block of data, no command byte, reads length number of bytes and stores it in values.
 int8_t LT_I2CBus::readBlockData(uint8_t address, uint16_t length, uint8_t *values)
 {
   int8_t ret = 0;
+  uint8_t count;
 
   LT_Wire.beginTransmission(address);
-  LT_Wire.requestFrom(address, values, length);
+  count = LT_Wire.requestFrom(address, values, length);
+  if (lt_trace_buf && length <= BUFFER_LENGTH)   // Longer reads are traced by the engine
+    trace(address, count != length, 0, 0, values, length);
 
   return ret;
 }
 
 
+// Read a block of data, no command byte, followed by a PEC
+int8_t LT_I2CBus::readBlockDataPec(uint8_t address, uint16_t length, uint8_t *values)
+{
+  uint16_t count;
+
+  return LT_Wire.readFrom(address, 0, 0, values, length, I2C_XFER_PEC, &count);
+}
+
+// SMBus Block Read: byte count, data, and optionally PEC, straight into values
+int8_t LT_I2CBus::readSMBusBlock(uint8_t address, uint8_t command, uint16_t length, uint8_t *values,
+                                 uint16_t *count, bool pec)
+{
+  return LT_Wire.readFrom(address, command, 1, values, length,
+                          I2C_XFER_BLOCK | (pec ? I2C_XFER_PEC : 0), count);
+}
+
 // Write a block of data, starting at register specified by "command" and ending at (command + length - 1)
 int8_t LT_I2CBus::writeBlockData(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
 {
-  uint8_t i = length;
+  uint16_t i;
   int8_t ret = 1;
 
   LT_Wire.beginTransmission(address);
   LT_Wire.write(command);
-  do
+  for (i = 0; i < length; i++)          // Stops when the Wire buffer is full
   {
-    i--;
+    if (LT_Wire.write(values[i]) != 1)
+      break;
   }
-  while (LT_Wire.write(values[length - 1 - i]) == 1 && i > 0);
 
   ret = LT_Wire.endTransmission(!inGroupProtocol_);
+  if (lt_trace_buf)
+  {
+    uint16_t pos = lt_trace_open(LT_TRACE_I2C | (ret ? LT_TRACE_FAILED : 0), address, 1 + i, 0);
+    if (pos != LT_TRACE_NONE)
+      lt_trace_write(lt_trace_write(pos, &command, 1, 0), values, i, 0);
+  }
 
   return ret;
 }
 
-// Write two command bytes, then receive a block of data
-int8_t LT_I2CBus::twoByteCommandReadBlock(uint8_t address, uint16_t command, uint16_t length, uint8_t *values)
+// Write a block of data, starting at register specified by "command", followed by a PEC
+int8_t LT_I2CBus::writeBlockDataPec(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
 {
-  int8_t ret = 0;
+  uint16_t i;
+  uint8_t pec;
+  uint8_t sent_pec = 0;
+  int8_t ret = 1;
 
+  pec = pec_add(pec_add(0, address << 1), command);
   LT_Wire.beginTransmission(address);
-  LT_Wire.write(command >> 8);
-  LT_Wire.write(command & 0xFF);
-  ret = LT_Wire.endTransmission(false);
-  LT_Wire.beginTransmission(address);
-  LT_Wire.requestFrom(address, values, length);
+  LT_Wire.write(command);
+  for (i = 0; i < length; i++)          // Stops when the Wire buffer is full
+  {
+    if (LT_Wire.write(values[i]) != 1)
+      break;
+    pec = pec_add(pec, values[i]);
+  }
+  if (i == length)
+    sent_pec = LT_Wire.write(pec);
 
+  ret = LT_Wire.endTransmission(!inGroupProtocol_);
+  if (sent_pec != 1)                    // The device would take the block without its PEC
+    ret = 1;
+  if (lt_trace_buf)
+  {
+    uint16_t pos = lt_trace_open(LT_TRACE_I2C | (ret ? LT_TRACE_FAILED : 0), address, 1 + i + sent_pec, 0);
+    if (pos != LT_TRACE_NONE)
+      lt_trace_write(lt_trace_write(lt_trace_write(pos, &command, 1, 0), values, i, 0), &pec, sent_pec, 0);
+  }
 
   return ret;
 }
 
+// Write two command bytes, then receive a block of data
+int8_t LT_I2CBus::twoByteCommandReadBlock(uint8_t address, uint16_t command, uint16_t length, uint8_t *values)
+{
+  uint16_t count;
+
+  return LT_Wire.readFrom(address, command, 2, values, length, 0, &count);
+}
+
 // Initializes Linduino I2C port.
 // Before communicating to the I2C port throught the QuikEval connector, you must also run
 // quikeval_I2C_connect to connect the I2C port to the QuikEval connector throught the
@@ -45,17 +45,34 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LT_I2CBus_H
 
 #include <stdint.h>
+#ifdef __linux__
+struct lt_i2c_dev;
+#else
 #include <LT_Wire.h>
+#endif
 
 class LT_I2CBus
 {
   private:
     bool inGroupProtocol_;
     uint32_t speed_;
+#ifdef __linux__
+    struct lt_i2c_dev *dev_;  //!< i2c-dev adapter, see linux/LT_I2CBus_linux.cpp
+#endif
 
   public:
     LT_I2CBus();
     LT_I2CBus(uint32_t speed);
+#ifdef __linux__
+    //! Use a Linux i2c-dev adapter, e.g. "/dev/i2c-1". The other constructors
+    //! open $LT_I2C_DEVICE, or /dev/i2c-1 when it is not set.
+    LT_I2CBus(const char *device  //!< i2c-dev device node
+             );
+    ~LT_I2CBus();
+
+    //! @return the number of ioctl() calls made on the adapter, one per transaction
+    uint32_t ioctls();
+#endif
 
     //! Change the speed of the bus.
     void changeSpeed(uint32_t speed  //!< the speed
@@ -105,6 +122,7 @@ class LT_I2CBus
                         );
 
     //! Read a block of data, starting at register specified by "command" and ending at (command + length - 1)
+    //! The data goes straight into values, so length is not limited by the Wire buffer.
     //! @return 0 on success, 1 on failure
     int8_t readBlockData(uint8_t address,     //!< 7-bit I2C address
                          uint8_t command,     //!< Command byte
@@ -112,7 +130,8 @@ class LT_I2CBus
                          uint8_t *values      //!< Byte array to be read
                         );
 
-    //! Read a block of data, starting at register specified by "command" and ending at (command + length - 1)
+    //! Read a block of data, starting at register specified by "command" and ending at (command + length - 1),
+    //! followed by a PEC byte that is checked as the data arrives and not stored.
     //! @return 0 on success, 1 on failure
     int8_t readBlockDataPec(uint8_t address,     //!< 7-bit I2C address
                             uint8_t command,     //!< Command byte
@@ -127,13 +146,26 @@ class LT_I2CBus
                          uint8_t *values      //!< Byte array to be read
                         );
 
-    //! Read a block of data, no command byte, reads length number of bytes and stores it in values.
+    //! Read a block of data, no command byte, reads length number of bytes and stores it in values,
+    //! followed by a PEC byte that is checked as the data arrives and not stored.
     //! @return 0 on success, 1 on failure
     int8_t readBlockDataPec(uint8_t address,     //!< 7-bit I2C address
                             uint16_t length,     //!< Length of array
                             uint8_t *values      //!< Byte array to be read
                            );
 
+    //! SMBus Block Read: the device sends a byte count, that many bytes, then a PEC if pec is true.
+    //! The bytes go straight into values and the PEC is checked as they arrive, so a block
+    //! such as a 255 byte fault log is read in one transaction without a copy.
+    //! @return 0 on success, 1 on failure (NACK, bad PEC, or a count larger than length)
+    int8_t readSMBusBlock(uint8_t address,     //!< 7-bit I2C address
+                          uint8_t command,     //!< Command byte
+                          uint16_t length,     //!< Size of values
+                          uint8_t *values,     //!< Byte array to be read, without the count
+                          uint16_t *count,     //!< Byte count sent by the device
+                          bool pec             //!< Read and check a PEC after the block
+                         );
+
 
 
     //! Write a block of data, starting at register specified by "command" and ending at (command + length - 1)
@@ -144,6 +176,15 @@ class LT_I2CBus
                           uint8_t *values        //!< Byte array to be written
                          );
 
+    //! Write a block of data, starting at register specified by "command", followed by a PEC byte
+    //! worked out by the bus over the address, command and values.
+    //! @return 0 on success, 1 on failure
+    int8_t writeBlockDataPec(uint8_t address,       //!< 7-bit I2C address
+                             uint8_t command,       //!< Command byte
+                             uint16_t length,       //!< Length of array, may be 0
+                             uint8_t *values        //!< Byte array to be written, without the PEC
+                            );
+
     //! Write a two command bytes, then receive a block of data
     //! @return 0 on success, 1 on failure
     int8_t twoByteCommandReadBlock(uint8_t address,     //!< 7-bit I2C address
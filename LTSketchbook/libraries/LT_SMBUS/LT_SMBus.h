@@ -181,7 +181,7 @@ class LT_SMBus
                                   ) = 0;
 
     //! SMBus read block command
-    //! @return actual size
+    //! @return actual size, or 0 on failure (NACK, bad PEC, or a block larger than block_size)
     virtual uint8_t readBlock(uint8_t address,     //!< Slave Address
                               uint8_t command,     //!< Command byte
                               uint8_t *block,      //!< Memory to receive data
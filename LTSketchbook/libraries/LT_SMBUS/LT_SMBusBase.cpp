@@ -178,15 +178,7 @@ void LT_SMBusBase::writeByte(uint8_t address, uint8_t command, uint8_t data)
 {
   if (pec_enabled_)
   {
-    uint8_t buffer[2];
-    buffer[0] = data;
-
-    pecClear();
-    pecAdd(address << 1);
-    pecAdd(command);
-    pecAdd(data);
-    buffer[1] = pecGet();
-    if (i2cbus_->writeBlockData(address, command, 2, buffer))
+    if (i2cbus_->writeBlockDataPec(address, command, 1, &data))
       Serial.print(F("Write Byte With Pec: fail.\n"));
   }
   else
@@ -201,19 +193,11 @@ void LT_SMBusBase::writeBytes(uint8_t *addresses, uint8_t *commands,
 {
   if (pec_enabled_)
   {
-    uint8_t buffer[2];
     uint16_t index = 0;
 
     while (index < no_addresses)
     {
-      buffer[0] = data[index];
-      pecClear();
-      pecAdd(addresses[index] << 1);
-      pecAdd(commands[index]);
-      pecAdd(data[index]);
-      buffer[1] = pecGet();
-
-      if (i2cbus_->writeBlockData(addresses[index], commands[index], 2, buffer))
+      if (i2cbus_->writeBlockDataPec(addresses[index], commands[index], 1, &data[index]))
         Serial.print(F("Write Bytes With Pec: fail.\n"));
       index++;
     }
@@ -235,22 +219,13 @@ uint8_t LT_SMBusBase::readByte(uint8_t address, uint8_t command)
 {
   if (pec_enabled_)
   {
-    uint8_t input[2];
-    input[0] = 0x00;
-    input[1] = 0x00;
+    uint8_t input = 0x00;
 
-    pecClear();
-    pecAdd(address << 1);
-    pecAdd(command);
-    pecAdd((address << 1) | 0x01);
-    if (i2cbus_->readBlockData(address, command, 2, input))
+    // The bus checks the PEC, so a bad one fails like a NACK
+    if (i2cbus_->readBlockDataPec(address, command, 1, &input))
       Serial.print(F("Read Byte With Pec: fail.\n"));
 
-    pecAdd(input[0]);
-    if (pecGet() != input[1])
-      Serial.print(F("Read Byte With Pec: fail pec\n"));
-
-    return input[0];
+    return input;
   }
   else
   {
@@ -266,17 +241,11 @@ void LT_SMBusBase::writeWord(uint8_t address, uint8_t command, uint16_t data)
 {
   if (pec_enabled_)
   {
-    uint8_t buffer[3];
+    uint8_t buffer[2];
     buffer[0] = (uint8_t) (data & 0xff);
     buffer[1] = (uint8_t) (data >> 8);
 
-    pecClear();
-    pecAdd(address << 1);
-    pecAdd(command);
-    pecAdd(data & 0xff);
-    pecAdd(data >> 8);
-    buffer[2] = pecGet();
-    if (i2cbus_->writeBlockData(address, command, 3, buffer))
+    if (i2cbus_->writeBlockDataPec(address, command, 2, buffer))
       Serial.print(F("Write Word With Pec: fail.\n"));
   }
   else
@@ -302,24 +271,14 @@ uint16_t LT_SMBusBase::readWord(uint8_t address, uint8_t command)
 {
   if (pec_enabled_)
   {
-    uint8_t input[3];
+    uint8_t input[2];
     input[0] = 0x00;
     input[1] = 0x00;
-    input[2] = 0x00;
-
-    pecClear();
-    pecAdd(address << 1);
-    pecAdd(command);
-    pecAdd((address << 1) | 0x01);
 
-    if (i2cbus_->readBlockData(address, command, 3, input))
+    // The bus checks the PEC, so a bad one fails like a NACK
+    if (i2cbus_->readBlockDataPec(address, command, 2, input))
       Serial.print(F("Read Word With Pec: fail.\n"));
 
-    pecAdd(input[0]);
-    pecAdd(input[1]);
-    if (pecGet() != input[2])
-      Serial.print(F("Read Word With Pec: fail pec\n"));
-
     return input[1] << 8 | input[0];
   }
   else
@@ -347,25 +306,12 @@ void LT_SMBusBase::writeBlock(uint8_t address, uint8_t command,
 {
   if (pec_enabled_)
   {
-    uint16_t pos = 0;
-
-    pecClear();
-    pecAdd(address << 1);
-    pecAdd(command);
-    pecAdd(block_size);
-
-    while (pos < block_size)
-      pecAdd(block[pos++]);
-    uint8_t pec = pecGet();
-
-    uint8_t *data_with_pec = (uint8_t *) malloc(block_size + 2);
-    data_with_pec[0] = block_size;
-    memcpy(data_with_pec + 1, block, block_size);
-    data_with_pec[block_size + 1] = pec;
-
-    if (i2cbus_->writeBlockData(address, command, block_size + 2, data_with_pec))
+    uint8_t *buffer = (uint8_t *)malloc(block_size + 1);
+    buffer[0] = block_size;
+    memcpy(buffer + 1, block, block_size);
+    if (i2cbus_->writeBlockDataPec(address, command, block_size + 1, buffer))
       Serial.print(F("Write Block With Pec: fail.\n"));
-    free(data_with_pec);
+    free(buffer);
   }
   else
   {
@@ -459,64 +405,29 @@ uint8_t LT_SMBusBase::writeReadBlock(uint8_t address, uint8_t command,
 uint8_t LT_SMBusBase::readBlock(uint8_t address, uint8_t command,
                                 uint8_t *block, uint16_t block_size)
 {
-  if (pec_enabled_)
-  {
-    uint16_t pos;
-    uint8_t *buffer = (uint8_t *)malloc(block_size + 2);
-    uint8_t actual_block_size;
-
-    pecClear();
-    pecAdd(address << 1);
-    pecAdd(command);
-    pecAdd((address << 1) | 0x01);
-
-    if (i2cbus_->readBlockData(address, command, block_size + 2, buffer))
+  // The block goes straight into the caller's memory and the PEC is checked on
+  // the fly, so long blocks such as fault logs are read in one transaction.
+  uint16_t actual_block_size;
 
-      if (buffer[0] > block_size)
-        Serial.print(F("Read Block with PEC: fail size too big.\n"));
-
-    memcpy(block, buffer + 1, block_size);
-
-    for (pos = 0; pos<buffer[0] + 1u; pos++)
-      pecAdd(buffer[pos]);
-    if (pecGet() != buffer[buffer[0]+1])
-      Serial.print(F("Read Block With Pec: fail pec\n"));
-
-    actual_block_size = buffer[0];
-    free(buffer);
-    return actual_block_size;
-  }
-  else
+  if (i2cbus_->readSMBusBlock(address, command, block_size, block, &actual_block_size, pec_enabled_))
   {
-    uint8_t *buffer = (uint8_t *)malloc(block_size + 1);
-    uint8_t actual_block_size;
-
-    if (i2cbus_->readBlockData(address, command, block_size + 1, buffer))
+    // The count is 0 when the device did not get as far as sending it
+    if (actual_block_size > block_size)
+      Serial.print(pec_enabled_ ? F("Read Block with PEC: fail size too big.\n") : F("Read Block: fail size too big.\n"));
+    else if (pec_enabled_ && actual_block_size != 0)
+      Serial.print(F("Read Block With Pec: fail pec\n"));
+    else
       Serial.print(F("Read Block: fail.\n"));
-    if (buffer[0] > block_size)
-    {
-      Serial.print(F("Read Block: fail size too big.\n"));
-    }
-    memcpy(block, buffer + 1, block_size);
-
-    actual_block_size = buffer[0];
-    free(buffer);
-    return actual_block_size;
+    return 0;
   }
+  return (uint8_t)actual_block_size;      // An SMBus byte count, so at most 255
 }
 
 void LT_SMBusBase::sendByte(uint8_t address, uint8_t command)
 {
   if (pec_enabled_)
   {
-    uint8_t pec;
-
-    pecClear();
-    pecAdd(address << 1);
-    pecAdd(command);
-    pec = pecGet();
-
-    if (i2cbus_->writeBlockData(address, command, 1, &pec))
+    if (i2cbus_->writeBlockDataPec(address, command, 0, 0))
       Serial.print(F("Send Byte With Pec: fail.\n"));
   }
   else
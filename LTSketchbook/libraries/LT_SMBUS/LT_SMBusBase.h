@@ -133,7 +133,7 @@ class LT_SMBusBase : public LT_SMBus
                           );
 
     //! SMBus read block command
-    //! @return actual size
+    //! @return actual size, or 0 on failure (NACK, bad PEC, or a block larger than block_size)
     uint8_t readBlock(uint8_t address,         //!< Slave Address
                       uint8_t command,         //!< Command byte
                       uint8_t *block,          //!< Memory to receive data
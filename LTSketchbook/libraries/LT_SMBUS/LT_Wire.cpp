@@ -57,6 +57,14 @@ void LT_TwoWire::begin(uint32_t speed)
 
 uint8_t LT_TwoWire::requestFrom(uint8_t address, uint8_t *acceptBuffer, uint16_t quantity, uint8_t sendStop)
 {
+  // twi_readFrom() fails anything longer than its buffer
+  if (quantity > TWI_BUFFER_LENGTH)
+  {
+    uint16_t count;
+    if (readFrom(address, 0, 0, acceptBuffer, quantity, 0, &count))
+      return 0;
+    return count;
+  }
 
   // perform blocking read into buffer
   uint16_t read = twi_readFrom(address, acceptBuffer, quantity, sendStop);
@@ -79,6 +87,31 @@ uint8_t LT_TwoWire::requestFrom(int address, uint8_t *acceptBuffer, int quantity
   return requestFrom((uint8_t)address, (uint8_t *) acceptBuffer, (uint16_t)quantity, (uint8_t)sendStop);
 }
 
+int8_t LT_TwoWire::readFrom(uint8_t address, uint16_t command, uint8_t command_len,
+                            uint8_t *acceptBuffer, uint16_t quantity, uint8_t flags, uint16_t *count)
+{
+  int8_t ret;
+  i2c_transfer x;
+
+  x.address = address;
+  x.command[0] = (command_len == 2) ? (uint8_t)(command >> 8) : (uint8_t)command;
+  x.command[1] = (uint8_t)command;
+  x.command_len = command_len;
+  x.tx = 0;
+  x.tx_len = 0;
+  x.rx = acceptBuffer;
+  x.rx_len = quantity;
+  x.flags = flags;
+  x.callback = 0;
+  x.arg = 0;
+  *count = 0;
+  if (i2c_submit(&x))             // queue full of transactions from the sketch
+    return 1;
+  ret = i2c_wait(&x);
+  *count = x.rx_len;
+  return ret;
+}
+
 // Preinstantiate Objects //////////////////////////////////////////////////////
 
 LT_TwoWire LT_Wire = LT_TwoWire();
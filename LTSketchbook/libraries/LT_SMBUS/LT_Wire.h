@@ -31,6 +31,7 @@
 
 #include <inttypes.h>
 #include <Wire.h>
+#include <LT_I2C.h>
 
 
 class LT_TwoWire : public TwoWire
@@ -44,6 +45,8 @@ class LT_TwoWire : public TwoWire
     void begin(uint32_t speed);
 
     //! Read from a slave I2C device.
+    //! Reads longer than the Wire buffer go through readFrom(), so they must not
+    //! follow endTransmission(false).
     //! @return number of bytes read.  If different from quantity, something bad happened.
     uint8_t requestFrom(uint8_t address,  //!< 7-bit I2C address
                         uint8_t *acceptBuffer,   //!< buffer pointer to fill
@@ -73,6 +76,20 @@ class LT_TwoWire : public TwoWire
                         int sendStop //!< whether to STOP or anticipate a repeated START
                        );
 
+    //! Write command bytes, then repeated START and read from a slave I2C device as
+    //! one transaction. The bytes go straight into acceptBuffer, bypassing the Wire
+    //! buffer, so there is no limit on quantity. Runs on the LT_I2C transaction
+    //! engine, always ends with a STOP, and must not follow endTransmission(false).
+    //! @return 0 on success, 1 on failure (NACK, bad PEC, block too long or engine queue full)
+    int8_t readFrom(uint8_t address,    //!< 7-bit I2C address
+                    uint16_t command,   //!< Command byte, or command word sent MSB first
+                    uint8_t command_len,  //!< Number of command bytes, 0 to 2
+                    uint8_t *acceptBuffer,  //!< buffer pointer to fill
+                    uint16_t quantity,  //!< length of read, or size of acceptBuffer with I2C_XFER_BLOCK
+                    uint8_t flags,      //!< I2C_XFER_PEC, I2C_XFER_BLOCK, or 0
+                    uint16_t *count     //!< Bytes read. With I2C_XFER_BLOCK, the byte count sent by the device
+                   );
+
 };
 
 extern LT_TwoWire LT_Wire;
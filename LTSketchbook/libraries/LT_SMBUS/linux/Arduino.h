@@ -0,0 +1,177 @@
+/*!
+  Host stand-in for the Arduino core header
+@verbatim
+  Provides the Arduino definitions used by LT_SMBUS and LT_PMBUS so they can be
+  compiled on a Linux controller together with LT_I2CBus_linux.cpp. Put this
+  directory first on the include path. Serial writes to stdout.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef LT_I2CBUS_LINUX_ARDUINO_H
+#define LT_I2CBUS_LINUX_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#define PROGMEM
+#define pgm_read_byte_near(address) (*(const uint8_t *)(address))
+#define pgm_read_word_near(address) (*(const uint16_t *)(address))
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define SS 10
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#ifndef min
+#define min(a,b) ((a)<(b)?(a):(b))
+#endif
+#ifndef max
+#define max(a,b) ((a)>(b)?(a):(b))
+#endif
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+//! Flash strings are plain strings on the host
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+//! The Serial port of the sketches, printing to stdout
+class HostSerial
+{
+  public:
+    void begin(unsigned long baud) {}
+    void print(const __FlashStringHelper *s)
+    {
+      fputs(reinterpret_cast<const char *>(s), stdout);
+    }
+    void print(const char *s)
+    {
+      fputs(s, stdout);
+    }
+    void print(char c)
+    {
+      putchar(c);
+    }
+    void print(long n, int base = DEC)
+    {
+      if (base == DEC)
+        printf("%ld", n);
+      else
+        print((unsigned long)n, base);
+    }
+    void print(unsigned long n, int base = DEC)
+    {
+      char buf[8 * sizeof(long) + 1];
+      char *p = &buf[sizeof(buf) - 1];
+
+      *p = 0;
+      do
+      {
+        *--p = "0123456789ABCDEF"[n % base];
+        n /= base;
+      }
+      while (n);
+      fputs(p, stdout);
+    }
+    void print(int n, int base = DEC)
+    {
+      print((long)n, base);
+    }
+    void print(unsigned int n, int base = DEC)
+    {
+      print((unsigned long)n, base);
+    }
+    void print(unsigned char n, int base = DEC)
+    {
+      print((unsigned long)n, base);
+    }
+    void print(double n, int digits = 2)
+    {
+      printf("%.*f", digits, n);
+    }
+    template <typename T> void println(T value)
+    {
+      print(value);
+      putchar('\n');
+    }
+    template <typename T> void println(T value, int format)
+    {
+      print(value, format);
+      putchar('\n');
+    }
+    void println()
+    {
+      putchar('\n');
+    }
+    int available()
+    {
+      return 0;
+    }
+    int read()
+    {
+      return getchar();
+    }
+};
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// The QuikEval mux has no meaning on a Linux controller
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) {}
+inline int digitalRead(uint8_t pin)
+{
+  return LOW;
+}
+
+#endif
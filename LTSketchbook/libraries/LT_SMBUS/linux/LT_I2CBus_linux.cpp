@@ -0,0 +1,627 @@
+/*!
+  LT_I2CBus for Linux i2c-dev adapters
+@verbatim
+  Implements LT_I2CBus on /dev/i2c-N instead of the Linduino TWI port, so the
+  LT_SMBus and LT_PMBus libraries run unmodified on a Linux controller. Build
+  this file in place of LT_I2CBus.cpp and LT_Wire.cpp, with this directory
+  first on the include path, see lt_smbus_stub_bench.cpp for the command line.
+
+  Adapters that move plain I2C messages (I2C_FUNC_I2C) get one I2C_RDWR ioctl
+  per transaction: the command write and the read are combined messages with
+  a repeated START. The writes of a group protocol are held until the last
+  one and sent with it as one ioctl, so they share a single STOP.
+
+  SMBus-only adapters, such as i2c-stub and most PC chipsets, get the
+  matching I2C_SMBUS ioctl instead, still one per transaction. There the
+  kernel adds and checks the PEC (I2C_PEC): readBlockDataPec() and
+  writeBlockDataPec() of 0, 1 or 2 bytes, or of an SMBus block, become the
+  send byte, byte, word or block transaction with I2C_PEC set, so LT_SMBusPec
+  never passes its PEC bytes off as data. Group protocol writes each end with
+  a STOP, block transfers are limited to 32 bytes by the kernel, and block
+  process calls (LT_SMBus::writeReadBlock()) need I2C_FUNC_I2C.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "LT_I2CBus.h"
+
+#define LT_I2C_MAX_MSGS   16    //!< Messages held for one I2C_RDWR, at most I2C_RDWR_IOCTL_MAX_MSGS
+#define LT_I2C_MAX_HELD   512   //!< Bytes of group protocol writes held until the STOP
+
+HostSerial Serial;
+
+//! State of one open adapter
+struct lt_i2c_dev
+{
+  int fd;                                 //!< Open device node, -1 if it failed to open
+  bool rdwr;                              //!< Adapter supports I2C_RDWR
+  int slave;                              //!< Address set with I2C_SLAVE, -1 if none
+  int pec;                                //!< PEC setting given with I2C_PEC, -1 if unknown
+  uint32_t ioctls;                        //!< Transactions sent to the kernel
+  struct i2c_msg msgs[LT_I2C_MAX_MSGS];   //!< Messages of the transaction being built
+  uint8_t nmsgs;
+  uint8_t held[LT_I2C_MAX_HELD];          //!< Write data of those messages
+  uint16_t held_len;
+};
+
+// Opens the adapter and finds out what it can do
+static struct lt_i2c_dev *lt_i2c_open(const char *device)
+{
+  struct lt_i2c_dev *dev = (struct lt_i2c_dev *)calloc(1, sizeof(struct lt_i2c_dev));
+  unsigned long funcs = 0;
+
+  dev->slave = -1;
+  dev->pec = -1;
+  dev->fd = open(device, O_RDWR);
+  if (dev->fd < 0)
+    fprintf(stderr, "LT_I2CBus: cannot open %s: %s\n", device, strerror(errno));
+  else if (ioctl(dev->fd, I2C_FUNCS, &funcs) == 0)
+    dev->rdwr = (funcs & I2C_FUNC_I2C) != 0;
+  return dev;
+}
+
+// Adapter named by $LT_I2C_DEVICE, for the constructors shared with the Linduino
+static struct lt_i2c_dev *lt_i2c_open_default()
+{
+  const char *device = getenv("LT_I2C_DEVICE");
+
+  return lt_i2c_open(device ? device : "/dev/i2c-1");
+}
+
+// Adds a write message, copying the data so the caller may free it at once
+static int8_t lt_i2c_add_write(struct lt_i2c_dev *dev, uint8_t address,
+                               const uint8_t *prefix, uint8_t prefix_len,
+                               const uint8_t *data, uint16_t length)
+{
+  uint8_t *held = dev->held + dev->held_len;
+
+  if (dev->nmsgs >= LT_I2C_MAX_MSGS || dev->held_len + prefix_len + length > LT_I2C_MAX_HELD)
+    return 1;
+  memcpy(held, prefix, prefix_len);
+  memcpy(held + prefix_len, data, length);
+  dev->held_len += prefix_len + length;
+  dev->msgs[dev->nmsgs].addr = address;
+  dev->msgs[dev->nmsgs].flags = 0;
+  dev->msgs[dev->nmsgs].len = prefix_len + length;
+  dev->msgs[dev->nmsgs].buf = held;
+  dev->nmsgs++;
+  return 0;
+}
+
+// Adds a read message straight into the caller's buffer
+static int8_t lt_i2c_add_read(struct lt_i2c_dev *dev, uint8_t address, uint8_t *data, uint16_t length)
+{
+  if (dev->nmsgs >= LT_I2C_MAX_MSGS)
+    return 1;
+  dev->msgs[dev->nmsgs].addr = address;
+  dev->msgs[dev->nmsgs].flags = I2C_M_RD;
+  dev->msgs[dev->nmsgs].len = length;
+  dev->msgs[dev->nmsgs].buf = data;
+  dev->nmsgs++;
+  return 0;
+}
+
+// Sends the messages built so far as one transaction: repeated STARTs between them, one STOP
+static int8_t lt_i2c_send(struct lt_i2c_dev *dev)
+{
+  struct i2c_rdwr_ioctl_data rdwr;
+  int ret;
+
+  rdwr.msgs = dev->msgs;
+  rdwr.nmsgs = dev->nmsgs;
+  ret = ioctl(dev->fd, I2C_RDWR, &rdwr);
+  dev->ioctls++;
+  dev->nmsgs = 0;
+  dev->held_len = 0;
+  return (ret == (int)rdwr.nmsgs) ? 0 : 1;
+}
+
+// Drops held group protocol writes after a failure, so the next transaction starts clean
+static int8_t lt_i2c_fail(struct lt_i2c_dev *dev)
+{
+  dev->nmsgs = 0;
+  dev->held_len = 0;
+  return 1;
+}
+
+// Write, held back while in a group protocol
+static int8_t lt_i2c_write(struct lt_i2c_dev *dev, bool hold, uint8_t address,
+                           const uint8_t *prefix, uint8_t prefix_len,
+                           const uint8_t *data, uint16_t length)
+{
+  if (dev->fd < 0 || lt_i2c_add_write(dev, address, prefix, prefix_len, data, length))
+    return lt_i2c_fail(dev);
+  return hold ? 0 : lt_i2c_send(dev);
+}
+
+// Optional command write, repeated START and read, after any held writes
+static int8_t lt_i2c_read(struct lt_i2c_dev *dev, uint8_t address,
+                          const uint8_t *command, uint8_t command_len,
+                          uint8_t *data, uint16_t length)
+{
+  if (dev->fd < 0)
+    return lt_i2c_fail(dev);
+  if (command_len != 0 && lt_i2c_add_write(dev, address, command, command_len, 0, 0))
+    return lt_i2c_fail(dev);
+  if (lt_i2c_add_read(dev, address, data, length))
+    return lt_i2c_fail(dev);
+  return lt_i2c_send(dev);
+}
+
+// One I2C_SMBUS transaction, for adapters without I2C_RDWR
+static int8_t lt_i2c_smbus(struct lt_i2c_dev *dev, uint8_t address, bool pec, char read_write,
+                           uint8_t command, int size, union i2c_smbus_data *data)
+{
+  struct i2c_smbus_ioctl_data args;
+
+  if (dev->fd < 0)
+    return 1;
+  if (dev->slave != address)
+  {
+    if (ioctl(dev->fd, I2C_SLAVE, address) < 0)
+      return 1;
+    dev->slave = address;
+  }
+  if (dev->pec != (int)pec)
+  {
+    if (ioctl(dev->fd, I2C_PEC, (unsigned long)pec) < 0)
+      return 1;
+    dev->pec = pec;
+  }
+  args.read_write = read_write;
+  args.command = command;
+  args.size = size;
+  args.data = data;
+  dev->ioctls++;
+  return (ioctl(dev->fd, I2C_SMBUS, &args) < 0) ? 1 : 0;
+}
+
+// SMBus I2C block read in pieces of at most 32 bytes, the register pointer advancing with command
+static int8_t lt_i2c_smbus_read_block(struct lt_i2c_dev *dev, uint8_t address, uint8_t command,
+                                      uint16_t length, uint8_t *values)
+{
+  union i2c_smbus_data data;
+  uint16_t pos;
+  uint8_t n;
+
+  for (pos = 0; pos < length; pos += n)
+  {
+    n = min(length - pos, I2C_SMBUS_BLOCK_MAX);
+    data.block[0] = n;
+    if (lt_i2c_smbus(dev, address, false, I2C_SMBUS_READ, command + pos, I2C_SMBUS_I2C_BLOCK_DATA, &data))
+      return 1;
+    memcpy(values + pos, data.block + 1, n);
+  }
+  return 0;
+}
+
+// Adds one byte to the SMBus PEC, the same CRC-8 as LT_SMBus::pecAdd()
+static uint8_t lt_i2c_pec_add(uint8_t pec, uint8_t data)
+{
+  uint8_t i;
+
+  pec ^= data;
+  for (i = 0; i < 8; i++)
+    pec = (pec & 0x80) ? (uint8_t)((pec << 1) ^ 0x07) : (uint8_t)(pec << 1);
+  return pec;
+}
+
+// PEC of a command write, repeated START and read of length bytes
+static uint8_t lt_i2c_read_pec(uint8_t address, const uint8_t *command, uint8_t command_len,
+                               const uint8_t *data, uint16_t length)
+{
+  uint8_t pec = 0;
+  uint16_t i;
+
+  if (command_len != 0)
+  {
+    pec = lt_i2c_pec_add(pec, address << 1);
+    for (i = 0; i < command_len; i++)
+      pec = lt_i2c_pec_add(pec, command[i]);
+  }
+  pec = lt_i2c_pec_add(pec, (address << 1) | 0x01);
+  for (i = 0; i < length; i++)
+    pec = lt_i2c_pec_add(pec, data[i]);
+  return pec;
+}
+
+LT_I2CBus::LT_I2CBus()
+{
+  speed_ = 100000;
+  inGroupProtocol_ = false;
+  dev_ = lt_i2c_open_default();
+}
+
+LT_I2CBus::LT_I2CBus(uint32_t speed)
+{
+  speed_ = speed;
+  inGroupProtocol_ = false;
+  dev_ = lt_i2c_open_default();
+}
+
+LT_I2CBus::LT_I2CBus(const char *device)
+{
+  speed_ = 100000;
+  inGroupProtocol_ = false;
+  dev_ = lt_i2c_open(device);
+}
+
+LT_I2CBus::~LT_I2CBus()
+{
+  if (dev_->fd >= 0)
+    close(dev_->fd);
+  free(dev_);
+}
+
+uint32_t LT_I2CBus::ioctls()
+{
+  return dev_->ioctls;
+}
+
+// The bus speed is set by the adapter driver (device tree or module parameter)
+void LT_I2CBus::changeSpeed(uint32_t speed)
+{
+  speed_ = speed;
+}
+
+uint32_t LT_I2CBus::getSpeed()
+{
+  return speed_;
+}
+
+// Read a byte, store in "value".
+int8_t LT_I2CBus::readByte(uint8_t address, uint8_t *value)
+{
+  union i2c_smbus_data data;
+
+  if (dev_->rdwr)
+    return lt_i2c_read(dev_, address, 0, 0, value, 1);
+  if (lt_i2c_smbus(dev_, address, false, I2C_SMBUS_READ, 0, I2C_SMBUS_BYTE, &data))
+    return 1;
+  *value = data.byte;
+  return 0;
+}
+
+// Write "value" byte to device at "address"
+int8_t LT_I2CBus::writeByte(uint8_t address, uint8_t value)
+{
+  if (dev_->rdwr)
+    return lt_i2c_write(dev_, inGroupProtocol_, address, 0, 0, &value, 1);
+  return lt_i2c_smbus(dev_, address, false, I2C_SMBUS_WRITE, value, I2C_SMBUS_BYTE, 0);
+}
+
+// Read a byte of data at register specified by "command", store in "value"
+int8_t LT_I2CBus::readByteData(uint8_t address, uint8_t command, uint8_t *value)
+{
+  union i2c_smbus_data data;
+
+  if (dev_->rdwr)
+    return lt_i2c_read(dev_, address, &command, 1, value, 1);
+  if (lt_i2c_smbus(dev_, address, false, I2C_SMBUS_READ, command, I2C_SMBUS_BYTE_DATA, &data))
+    return 1;
+  *value = data.byte;
+  return 0;
+}
+
+// Write a byte of data to register specified by "command"
+int8_t LT_I2CBus::writeByteData(uint8_t address, uint8_t command, uint8_t value)
+{
+  union i2c_smbus_data data;
+
+  if (dev_->rdwr)
+    return lt_i2c_write(dev_, inGroupProtocol_, address, &command, 1, &value, 1);
+  data.byte = value;
+  return lt_i2c_smbus(dev_, address, false, I2C_SMBUS_WRITE, command, I2C_SMBUS_BYTE_DATA, &data);
+}
+
+// Read a 16-bit word of data from register specified by "command", first byte on the bus in the MSB
+int8_t LT_I2CBus::readWordData(uint8_t address, uint8_t command, uint16_t *value)
+{
+  union i2c_smbus_data data;
+  uint8_t bytes[2];
+
+  if (dev_->rdwr)
+  {
+    if (lt_i2c_read(dev_, address, &command, 1, bytes, 2))
+      return 1;
+    *value = (bytes[0] << 8) | bytes[1];
+    return 0;
+  }
+  if (lt_i2c_smbus(dev_, address, false, I2C_SMBUS_READ, command, I2C_SMBUS_WORD_DATA, &data))
+    return 1;
+  *value = (data.word << 8) | (data.word >> 8);   // SMBus words are sent LSB first
+  return 0;
+}
+
+// Write a 16-bit word of data to register specified by "command", MSB first on the bus
+int8_t LT_I2CBus::writeWordData(uint8_t address, uint8_t command, uint16_t value)
+{
+  union i2c_smbus_data data;
+  uint8_t bytes[2];
+
+  if (dev_->rdwr)
+  {
+    bytes[0] = value >> 8;
+    bytes[1] = value & 0xFF;
+    return lt_i2c_write(dev_, inGroupProtocol_, address, &command, 1, bytes, 2);
+  }
+  data.word = (value << 8) | (value >> 8);
+  return lt_i2c_smbus(dev_, address, false, I2C_SMBUS_WRITE, command, I2C_SMBUS_WORD_DATA, &data);
+}
+
+// Read a block of data, starting at register specified by "command" and ending at (command + length - 1)
+int8_t LT_I2CBus::readBlockData(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  if (dev_->rdwr)
+    return lt_i2c_read(dev_, address, &command, 1, values, length);
+  return lt_i2c_smbus_read_block(dev_, address, command, length, values);
+}
+
+// Read a block of data, starting at register specified by "command", followed by a PEC
+int8_t LT_I2CBus::readBlockDataPec(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  union i2c_smbus_data data;
+  uint8_t *buffer;
+  int8_t ret;
+
+  if (dev_->rdwr)
+  {
+    buffer = (uint8_t *)malloc(length + 1);
+    if (buffer == NULL)
+      return 1;
+    ret = lt_i2c_read(dev_, address, &command, 1, buffer, length + 1);
+    if (ret == 0 && lt_i2c_read_pec(address, &command, 1, buffer, length) != buffer[length])
+      ret = 1;
+    memcpy(values, buffer, length);
+    free(buffer);
+    return ret;
+  }
+
+  // The kernel checks the PEC of the SMBus byte and word reads
+  if (length == 1 && lt_i2c_smbus(dev_, address, true, I2C_SMBUS_READ, command, I2C_SMBUS_BYTE_DATA, &data) == 0)
+  {
+    values[0] = data.byte;
+    return 0;
+  }
+  if (length == 2 && lt_i2c_smbus(dev_, address, true, I2C_SMBUS_READ, command, I2C_SMBUS_WORD_DATA, &data) == 0)
+  {
+    values[0] = data.word & 0xFF;
+    values[1] = data.word >> 8;
+    return 0;
+  }
+  return 1;
+}
+
+// Read a block of data, no command byte, reads length number of bytes and stores it in values.
+int8_t LT_I2CBus::readBlockData(uint8_t address, uint16_t length, uint8_t *values)
+{
+  uint16_t pos;
+
+  if (dev_->rdwr)
+    return lt_i2c_read(dev_, address, 0, 0, values, length);
+  for (pos = 0; pos < length; pos++)
+    if (readByte(address, values + pos))
+      return 1;
+  return 0;
+}
+
+// Read a block of data, no command byte, followed by a PEC
+int8_t LT_I2CBus::readBlockDataPec(uint8_t address, uint16_t length, uint8_t *values)
+{
+  uint8_t *buffer;
+  int8_t ret;
+
+  if (!dev_->rdwr)
+    return 1;
+  buffer = (uint8_t *)malloc(length + 1);
+  if (buffer == NULL)
+    return 1;
+  ret = lt_i2c_read(dev_, address, 0, 0, buffer, length + 1);
+  if (ret == 0 && lt_i2c_read_pec(address, 0, 0, buffer, length) != buffer[length])
+    ret = 1;
+  memcpy(values, buffer, length);
+  free(buffer);
+  return ret;
+}
+
+// SMBus Block Read: byte count, data, and optionally PEC
+int8_t LT_I2CBus::readSMBusBlock(uint8_t address, uint8_t command, uint16_t length, uint8_t *values,
+                                 uint16_t *count, bool pec)
+{
+  union i2c_smbus_data data;
+  uint8_t *buffer;
+  int8_t ret;
+
+  *count = 0;
+  if (!dev_->rdwr)
+  {
+    if (lt_i2c_smbus(dev_, address, pec, I2C_SMBUS_READ, command, I2C_SMBUS_BLOCK_DATA, &data))
+      return 1;
+    *count = data.block[0];
+    memcpy(values, data.block + 1, min(*count, length));
+    return (*count > length) ? 1 : 0;
+  }
+
+  // Read the longest block that fits, as the Linduino did before the count was known.
+  // The device sends its count, data and PEC, and then whatever it likes.
+  // The count is only known, and values only written, once the transfer went through.
+  buffer = (uint8_t *)malloc(length + 2);
+  if (buffer == NULL)
+    return 1;
+  ret = lt_i2c_read(dev_, address, &command, 1, buffer, length + (pec ? 2 : 1));
+  if (ret == 0)
+  {
+    *count = buffer[0];
+    if (*count > length)
+      ret = 1;
+    else if (pec && lt_i2c_read_pec(address, &command, 1, buffer, *count + 1) != buffer[*count + 1])
+      ret = 1;
+    memcpy(values, buffer + 1, min(*count, length));
+  }
+  free(buffer);
+  return ret;
+}
+
+// Write a block of data, starting at register specified by "command" and ending at (command + length - 1)
+int8_t LT_I2CBus::writeBlockData(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  union i2c_smbus_data data;
+
+  if (dev_->rdwr)
+    return lt_i2c_write(dev_, inGroupProtocol_, address, &command, 1, values, length);
+  if (length > I2C_SMBUS_BLOCK_MAX)
+    return 1;
+  data.block[0] = length;
+  memcpy(data.block + 1, values, length);
+  return lt_i2c_smbus(dev_, address, false, I2C_SMBUS_WRITE, command, I2C_SMBUS_I2C_BLOCK_DATA, &data);
+}
+
+// Write a block of data, starting at register specified by "command", followed by a PEC
+int8_t LT_I2CBus::writeBlockDataPec(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  union i2c_smbus_data data;
+  uint8_t *buffer;
+  uint8_t pec;
+  uint16_t i;
+  int8_t ret;
+
+  if (dev_->rdwr)
+  {
+    buffer = (uint8_t *)malloc(length + 1);
+    if (buffer == NULL)
+      return 1;
+    pec = lt_i2c_pec_add(lt_i2c_pec_add(0, address << 1), command);
+    for (i = 0; i < length; i++)
+      pec = lt_i2c_pec_add(pec, buffer[i] = values[i]);
+    buffer[length] = pec;
+    ret = lt_i2c_write(dev_, inGroupProtocol_, address, &command, 1, buffer, length + 1);
+    free(buffer);
+    return ret;
+  }
+
+  // The SMBus transaction with the same bytes on the bus, the kernel adding the PEC
+  if (length == 0)
+    return lt_i2c_smbus(dev_, address, true, I2C_SMBUS_WRITE, command, I2C_SMBUS_BYTE, 0);
+  if (length == 1)
+  {
+    data.byte = values[0];
+    return lt_i2c_smbus(dev_, address, true, I2C_SMBUS_WRITE, command, I2C_SMBUS_BYTE_DATA, &data);
+  }
+  if (length == 2)
+  {
+    data.word = values[0] | (values[1] << 8);
+    return lt_i2c_smbus(dev_, address, true, I2C_SMBUS_WRITE, command, I2C_SMBUS_WORD_DATA, &data);
+  }
+  if (values[0] == length - 1 && length - 1 <= I2C_SMBUS_BLOCK_MAX)
+  {
+    memcpy(data.block, values, length);     // values starts with the SMBus byte count
+    return lt_i2c_smbus(dev_, address, true, I2C_SMBUS_WRITE, command, I2C_SMBUS_BLOCK_DATA, &data);
+  }
+  return 1;
+}
+
+// Write two command bytes, then receive a block of data
+int8_t LT_I2CBus::twoByteCommandReadBlock(uint8_t address, uint16_t command, uint16_t length, uint8_t *values)
+{
+  uint8_t bytes[2];
+
+  if (!dev_->rdwr)
+    return 1;
+  bytes[0] = command >> 8;
+  bytes[1] = command & 0xFF;
+  return lt_i2c_read(dev_, address, bytes, 2, values, length);
+}
+
+// There is no QuikEval connector on a Linux controller
+void LT_I2CBus::quikevalI2CInit(void)
+{
+}
+
+void LT_I2CBus::quikevalI2CConnect(void)
+{
+}
+
+void LT_I2CBus::startGroupProtocol()
+{
+  inGroupProtocol_ = true;
+}
+
+void LT_I2CBus::endGroupProtocol()
+{
+  inGroupProtocol_ = false;
+}
+
+// Arduino timing on the host clock
+
+static uint64_t lt_i2c_now_us()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+unsigned long millis()
+{
+  return lt_i2c_now_us() / 1000;
+}
+
+unsigned long micros()
+{
+  return lt_i2c_now_us();
+}
+
+void delay(unsigned long ms)
+{
+  usleep(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  usleep(us);
+}
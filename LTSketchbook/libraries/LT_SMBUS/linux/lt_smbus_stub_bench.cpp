@@ -0,0 +1,191 @@
+/*!
+  LT_PMBus telemetry benchmark on Linux i2c-dev adapters
+@verbatim
+  Polls PMBus telemetry through the unmodified LT_PMBus and LT_SMBus libraries
+  on top of LT_I2CBus_linux.cpp and reports transactions per second. Each
+  adapter given with -d gets its own thread, LT_I2CBus and LT_PMBus, as a
+  host watching several boards would.
+
+  Each poll sets PAGE 0 and reads STATUS_WORD, READ_VOUT, READ_IOUT and
+  READ_TEMPERATURE_1, which with the VOUT_MODE read of readVout() is six
+  transactions. Every transaction must be one ioctl, which is checked.
+
+  In CI, against the kernel's SMBus stub (it answers every command, so the
+  values printed are whatever was last written to the stub registers):
+    sudo modprobe i2c-dev
+    sudo modprobe i2c-stub chip_addr=0x30
+    i2cdetect -l                              (find the i2c-stub adapter)
+
+  Build from the LT_SMBUS library directory:
+    g++ -O2 -pthread -Ilinux -I. -I../LT_PMBUS -I../Linduino -I../UserInterface
+        linux/lt_smbus_stub_bench.cpp linux/LT_I2CBus_linux.cpp LT_SMBus.cpp
+        LT_SMBusBase.cpp LT_SMBusNoPec.cpp LT_SMBusPec.cpp LT_SMBusGroup.cpp
+        ../LT_PMBUS/LT_PMBus.cpp ../LT_PMBUS/LT_PMBusMath.cpp -o lt_smbus_stub_bench
+
+  Usage:
+    ./lt_smbus_stub_bench -d /dev/i2c-5 [-d /dev/i2c-6 ...] [-a 0x30] [-n 2000] [-p]
+
+  Options:
+    -d DEV   i2c-dev adapter, may be repeated (default $LT_I2C_DEVICE or /dev/i2c-1)
+    -a ADDR  7-bit PMBus address (default 0x30)
+    -n N     polls per adapter (default 2000)
+    -p       use PEC (LT_SMBusPec). On i2c-stub the PEC goes out with I2C_PEC
+             set and the stub ignores it, so every register still holds
+             only what was written to it.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "LT_I2CBus.h"
+#include "LT_SMBusNoPec.h"
+#include "LT_SMBusPec.h"
+#include "LT_PMBus.h"
+
+#define MAX_ADAPTERS 16
+#define TRANSACTIONS_PER_POLL 6
+
+//! One adapter and the library stack on top of it
+struct bench_adapter
+{
+  const char *device;
+  uint8_t address;
+  uint32_t polls;
+  bool pec;
+  uint32_t transactions;
+  uint32_t ioctls;
+  float vout;
+  uint16_t status;
+};
+
+static void *bench_run(void *arg)
+{
+  struct bench_adapter *a = (struct bench_adapter *)arg;
+  LT_I2CBus *bus = new LT_I2CBus(a->device);
+  LT_SMBus *smbus = a->pec ? (LT_SMBus *)new LT_SMBusPec() : (LT_SMBus *)new LT_SMBusNoPec();
+  LT_PMBus *pmbus = new LT_PMBus(smbus);
+  LT_I2CBus *unused = smbus->i2cbus();
+  uint32_t i;
+
+  smbus->i2cbus(bus);
+  delete unused;
+  for (i = 0; i < a->polls; i++)
+  {
+    pmbus->setPage(a->address, 0);
+    a->status = pmbus->readStatusWord(a->address);
+    a->vout = pmbus->readVout(a->address, false);
+    pmbus->readIout(a->address, false);
+    pmbus->readInternalTemperature(a->address, false);
+  }
+  a->transactions = a->polls * TRANSACTIONS_PER_POLL;
+  a->ioctls = bus->ioctls();
+  delete pmbus;                 // also deletes smbus and bus
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  struct bench_adapter adapters[MAX_ADAPTERS];
+  pthread_t threads[MAX_ADAPTERS];
+  const char *devices[MAX_ADAPTERS];
+  int ndevices = 0;
+  uint8_t address = 0x30;
+  uint32_t polls = 2000;
+  bool pec = false;
+  uint32_t transactions = 0;
+  uint32_t ioctls = 0;
+  unsigned long start;
+  double seconds;
+  int opt;
+  int i;
+
+  while ((opt = getopt(argc, argv, "d:a:n:p")) != -1)
+  {
+    switch (opt)
+    {
+      case 'd':
+        if (ndevices < MAX_ADAPTERS)
+          devices[ndevices++] = optarg;
+        break;
+      case 'a':
+        address = strtoul(optarg, 0, 0);
+        break;
+      case 'n':
+        polls = strtoul(optarg, 0, 0);
+        break;
+      case 'p':
+        pec = true;
+        break;
+      default:
+        fprintf(stderr, "usage: %s -d /dev/i2c-N [-d ...] [-a addr] [-n polls] [-p]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (ndevices == 0)
+    devices[ndevices++] = getenv("LT_I2C_DEVICE") ? getenv("LT_I2C_DEVICE") : "/dev/i2c-1";
+
+  start = micros();
+  for (i = 0; i < ndevices; i++)
+  {
+    memset(&adapters[i], 0, sizeof(adapters[i]));
+    adapters[i].device = devices[i];
+    adapters[i].address = address;
+    adapters[i].polls = polls;
+    adapters[i].pec = pec;
+    pthread_create(&threads[i], 0, bench_run, &adapters[i]);
+  }
+  for (i = 0; i < ndevices; i++)
+  {
+    pthread_join(threads[i], 0);
+    transactions += adapters[i].transactions;
+    ioctls += adapters[i].ioctls;
+  }
+  seconds = (micros() - start) / 1e6;
+
+  for (i = 0; i < ndevices; i++)
+    printf("%s: %u polls, %u transactions, %u ioctls, STATUS_WORD 0x%04x, READ_VOUT %.3f\n",
+           adapters[i].device, adapters[i].polls, adapters[i].transactions, adapters[i].ioctls,
+           adapters[i].status, adapters[i].vout);
+  printf("%d adapter(s), %.3f s, %.0f transactions/s, %.2f ioctls per transaction\n",
+         ndevices, seconds, transactions / seconds, transactions ? (double)ioctls / transactions : 0.0);
+  return (ioctls == transactions) ? 0 : 1;
+}
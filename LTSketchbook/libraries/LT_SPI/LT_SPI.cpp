@@ -78,9 +78,61 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <Arduino.h>
 #include <stdint.h>
+#include <string.h>
 #include <SPI.h>
 #include "Linduino.h"
 #include "LT_SPI.h"
+#include "LT_Trace.h"
+
+// Ring positions of the next tx and rx byte of the trace record for the
+// current chip select period, LT_TRACE_NONE when it is not traced
+static uint16_t spi_trace_tx = LT_TRACE_NONE;
+static uint16_t spi_trace_rx;
+
+// Opens a trace record for length bytes
+static void spi_trace_begin(uint8_t cs_pin, uint16_t length)
+{
+  spi_trace_tx = lt_trace_open(LT_TRACE_SPI, cs_pin, length, length);
+  spi_trace_rx = spi_trace_tx + length;
+}
+
+// Bytes of spi_read() and spi_write() waiting to be recorded as one record
+#define SPI_TRACE_BATCH 16
+static uint8_t spi_batch_tx[SPI_TRACE_BATCH];
+static uint8_t spi_batch_rx[SPI_TRACE_BATCH];
+static uint8_t spi_batch_count = 0;
+
+// Records the gathered bytes, called through lt_trace_flush()
+static void spi_batch_flush()
+{
+  uint8_t count = spi_batch_count;
+
+  spi_batch_count = 0;
+  lt_trace_record(LT_TRACE_SPI, LT_TRACE_NO_CS, spi_batch_tx, count, spi_batch_rx, count);
+}
+
+// Gathers one byte, so that bytes clocked one at a time share a record header
+static void spi_batch_add(uint8_t tx, uint8_t rx)
+{
+  uint8_t count;
+#if defined(ARDUINO_ARCH_AVR)
+  uint8_t sreg = SREG;
+
+  cli();                              // A record opened by an interrupt flushes the batch
+#endif
+  count = spi_batch_count;
+  spi_batch_tx[count] = tx;
+  spi_batch_rx[count] = rx;
+  spi_batch_count = ++count;
+  lt_trace_pending = spi_batch_flush;
+#if defined(ARDUINO_ARCH_AVR)
+  SREG = sreg;
+#endif
+  if (count == SPI_TRACE_BATCH)
+    lt_trace_flush();
+}
+
+static void spi_stream_data(const uint8_t *tx, uint8_t *rx, uint16_t length, uint8_t flags);
 
 // Reads and sends a byte
 // Return 0 if successful, 1 if failed
@@ -91,6 +143,9 @@ void spi_transfer_byte(uint8_t cs_pin, uint8_t tx, uint8_t *rx)
   *rx = SPI.transfer(tx);             //! 2) Read byte and send byte
 
   output_high(cs_pin);                //! 3) Pull CS high
+
+  if (lt_trace_buf)
+    lt_trace_record(LT_TRACE_SPI, cs_pin, &tx, 1, rx, 1);
 }
 
 // Reads and sends a word
@@ -119,19 +174,172 @@ void spi_transfer_word(uint8_t cs_pin, uint16_t tx, uint16_t *rx)
   *rx = data_rx.w;
 
   output_high(cs_pin);                        //! 4) Pull CS high
+
+  if (lt_trace_buf)
+  {
+    uint8_t bus[4] = {data_tx.b[1], data_tx.b[0], data_rx.b[1], data_rx.b[0]};
+    lt_trace_record(LT_TRACE_SPI, cs_pin, bus, 2, bus + 2, 2);
+  }
 }
 
 // Reads and sends a byte array
 void spi_transfer_block(uint8_t cs_pin, uint8_t *tx, uint8_t *rx, uint8_t length)
 {
-  int8_t i;
+  if (lt_trace_buf)
+    spi_trace_begin(cs_pin, length);
+
+  output_low(cs_pin);                 //! 1) Pull CS low
+
+  spi_stream_data(tx, rx, length, LT_SPI_REVERSE); //! 2) Read and send byte array, last byte first
+
+  output_high(cs_pin);                //! 3) Pull CS high
+
+  spi_trace_tx = LT_TRACE_NONE;
+}
+
+// Sends and receives a list of segments with one chip select assertion
+void spi_transaction(uint8_t cs_pin, const spi_segment *segments, uint8_t count)
+{
+  if (lt_trace_buf)
+  {
+    uint16_t length = 0;
+    for (uint8_t i = 0; i < count; i++)
+      length += segments[i].length;
+    spi_trace_begin(cs_pin, length);
+  }
 
   output_low(cs_pin);                 //! 1) Pull CS low
 
-  for (i=(length-1);  i >= 0; i--)
-    rx[i] = SPI.transfer(tx[i]);    //! 2) Read and send byte array
+  for (uint8_t i = 0; i < count; i++) //! 2) Clock each segment in turn
+    spi_stream_data(segments[i].tx, segments[i].rx, segments[i].length, segments[i].flags);
 
   output_high(cs_pin);                //! 3) Pull CS high
+
+  spi_trace_tx = LT_TRACE_NONE;
+}
+
+// Sends and receives one buffer without touching chip select
+void spi_stream(const uint8_t *tx, uint8_t *rx, uint16_t length, uint8_t flags)
+{
+  if (lt_trace_buf)
+    spi_trace_begin(LT_TRACE_NO_CS, length);
+  spi_stream_data(tx, rx, length, flags);
+  spi_trace_tx = LT_TRACE_NONE;
+}
+
+// Clocks one buffer, and adds it to the open trace record if there is one
+static void spi_stream_data(const uint8_t *tx, uint8_t *rx, uint16_t length, uint8_t flags)
+{
+  const uint8_t fill = (flags & LT_SPI_FILL_ONES) ? 0xFF : 0x00;
+  uint16_t trace_tx = spi_trace_tx;
+  uint16_t trace_rx = spi_trace_rx;
+
+  if (length == 0)
+    return;
+
+#if defined(ARDUINO_ARCH_AVR)
+  // The next byte is fetched while the current one is shifted out, and SPDR is
+  // written again as soon as SPIF is set, so SCK only stops for the few cycles
+  // it takes to store the received byte.
+  const int8_t step = (flags & LT_SPI_REVERSE) ? -1 : 1;
+  const uint16_t first = (flags & LT_SPI_REVERSE) ? length - 1 : 0;
+  const uint8_t *tx_ptr = tx ? tx + first : 0;
+  uint8_t *rx_ptr = rx ? rx + first : 0;
+  uint8_t sent = tx ? *tx_ptr : fill;
+  uint8_t in;
+
+  SPDR = sent;                        //! 1) Start the first byte
+  while (--length)
+  {
+    uint8_t out = fill;
+    if (tx)
+    {
+      tx_ptr += step;
+      out = *tx_ptr;                  //! 2) Fetch the next byte while the current one is sent
+    }
+    while (!(SPSR & _BV(SPIF)));      //! 3) Wait until transfer complete
+    in = SPDR;
+    SPDR = out;                       //! 4) Start the next byte
+    if (rx)
+    {
+      *rx_ptr = in;                   //! 5) Store the byte received while it is sent
+      rx_ptr += step;
+    }
+    if (trace_tx != LT_TRACE_NONE)
+    {
+      lt_trace_put(trace_tx++, sent); //! 6) Trace the byte pair while the next byte is sent
+      lt_trace_put(trace_rx++, in);
+    }
+    sent = out;
+  }
+  while (!(SPSR & _BV(SPIF)));        //! 7) Wait for the last byte
+  in = SPDR;
+  if (rx)
+    *rx_ptr = in;
+  if (trace_tx != LT_TRACE_NONE)
+  {
+    lt_trace_put(trace_tx++, sent);
+    lt_trace_put(trace_rx++, in);
+  }
+#else
+  if (trace_tx != LT_TRACE_NONE)
+  {
+    // Record what is sent before rx, which may be the same buffer, is overwritten
+    for (uint16_t i = 0; i < length; i++)
+      lt_trace_put(trace_tx++, tx ? tx[(flags & LT_SPI_REVERSE) ? length - 1 - i : i] : fill);
+  }
+
+  if (!(flags & LT_SPI_REVERSE))
+  {
+    // SPI.transfer(buf, n) works in place, so the bytes to send are first put in
+    // rx, or in a small buffer when nothing is received.
+    if (rx)
+    {
+      if (tx == 0)
+        memset(rx, fill, length);
+      else if (tx != rx)
+        memcpy(rx, tx, length);
+      SPI.transfer(rx, length);
+      if (trace_tx != LT_TRACE_NONE)
+        trace_rx = lt_trace_write(trace_rx, rx, length, 0);
+    }
+    else
+    {
+      uint8_t buf[32];
+      while (length != 0)
+      {
+        uint8_t n = (length < sizeof(buf)) ? length : sizeof(buf);
+        if (tx == 0)
+          memset(buf, fill, n);
+        else
+        {
+          memcpy(buf, tx, n);
+          tx += n;
+        }
+        SPI.transfer(buf, n);
+        if (trace_tx != LT_TRACE_NONE)
+          trace_rx = lt_trace_write(trace_rx, buf, n, 0);
+        length -= n;
+      }
+    }
+  }
+  else
+  {
+    for (uint16_t i = length; i > 0; i--)
+    {
+      uint8_t in = SPI.transfer(tx ? tx[i - 1] : fill);
+      if (rx)
+        rx[i - 1] = in;
+      if (trace_tx != LT_TRACE_NONE)
+        lt_trace_put(trace_rx++, in);
+    }
+  }
+#endif
+  if (trace_tx != LT_TRACE_NONE)
+  {
+    spi_trace_tx = trace_tx;          // The next segment carries on from here
+    spi_trace_rx = trace_rx;
+  }
 }
 
 // Connect SPI pins to QuikEval connector through the Linduino MUX. This will disconnect I2C.
@@ -175,28 +383,24 @@ void spi_disable()
 // Write a data byte using the SPI hardware
 void spi_write(int8_t  data)  // Byte to be written to SPI port
 {
-#if defined(ARDUINO_ARCH_AVR)
-  SPDR = data;                  //! 1) Start the SPI transfer
-  while (!(SPSR & _BV(SPIF)));  //! 2) Wait until transfer complete
-#else
-  SPI.transfer(data);
-#endif
-
+  spi_read(data);
 }
 
 // Read and write a data byte using the SPI hardware
 // Returns the data byte read
 int8_t spi_read(int8_t  data) //!The data byte to be written
 {
+  uint8_t in;
 #if defined(ARDUINO_ARCH_AVR)
   SPDR = data;                  //! 1) Start the SPI transfer
   while (!(SPSR & _BV(SPIF)));  //! 2) Wait until transfer complete
-  return SPDR;                  //! 3) Return the data read
+  in = SPDR;                    //! 3) Get the data read
 #else
-  return SPI.transfer(data);
+  in = SPI.transfer(data);
 #endif
-
-
+  if (lt_trace_buf)
+    spi_batch_add(data, in);
+  return in;                    //! 4) Return the data read
 }
 
 // Below are implementations of spi_read, etc. that do not use the
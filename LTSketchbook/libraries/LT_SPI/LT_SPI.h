@@ -76,6 +76,25 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // #define SPI_2XCLOCK_MASK   0x01    // SPI2X = bit 0 on SPSR
 // //! @}
 
+//! @name SPI SEGMENT FLAGS
+//! @{
+//! Walk the segment's buffers from the last byte to the first, as spi_transfer_block() does.
+//! A little endian integer given as tx or rx is then sent or received MSB first.
+#define LT_SPI_REVERSE    0x01
+//! Send 0xFF instead of 0x00 when the segment has no tx buffer
+#define LT_SPI_FILL_ONES  0x02
+//! @}
+
+//! One piece of an SPI transaction. A segment with no tx buffer sends fill bytes,
+//! a segment with no rx buffer throws away the bytes received.
+typedef struct
+{
+  const uint8_t *tx;   //!< Bytes to send, or 0
+  uint8_t *rx;         //!< Buffer for the bytes received, or 0. May be the same as tx.
+  uint16_t length;     //!< Number of bytes
+  uint8_t flags;       //!< LT_SPI_REVERSE, LT_SPI_FILL_ONES
+} spi_segment;
+
 //! Reads and sends a byte
 //! @return void
 void spi_transfer_byte(uint8_t cs_pin,      //!< Chip select pin
@@ -98,6 +117,23 @@ void spi_transfer_block(uint8_t cs_pin,     //!< Chip select pin
                         uint8_t length      //!< Length of array
                        );
 
+//! Sends and receives a list of segments with one chip select assertion
+//! @return void
+void spi_transaction(uint8_t cs_pin,               //!< Chip select pin
+                     const spi_segment *segments,  //!< Segments, in the order they are clocked
+                     uint8_t count                 //!< Number of segments
+                    );
+
+//! Sends and receives one buffer without touching chip select, for callers that
+//! drive chip select themselves. Bytes are streamed through the SPI data register
+//! without a function call per byte on AVR, and with SPI.transfer(buf, n) elsewhere.
+//! @return void
+void spi_stream(const uint8_t *tx,  //!< Bytes to send, or 0 to send fill bytes
+                uint8_t *rx,        //!< Buffer for the bytes received, or 0. May be the same as tx.
+                uint16_t length,    //!< Number of bytes
+                uint8_t flags       //!< LT_SPI_REVERSE, LT_SPI_FILL_ONES
+               );
+
 //! Connect SPI pins to QuikEval connector through the Linduino MUX. This will disconnect I2C.
 void quikeval_SPI_connect();
 
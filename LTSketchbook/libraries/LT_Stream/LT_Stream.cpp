@@ -0,0 +1,261 @@
+/*!
+LT_Stream: Timer driven conversion and readout for ADCs with a digital filter, such as the LTC2380-24 and LTC2508.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! @ingroup Linduino
+//! @{
+//! @defgroup LT_Stream LT_Stream: Timer driven conversion and readout for ADCs with a digital filter.
+//! @}
+
+/*! @file
+    @ingroup LT_Stream
+    Library for LT_Stream: Timer driven conversion and readout for ADCs with a digital filter.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "LT_SPI.h"
+#include "LT_Stream.h"
+
+#define STREAM_CNV_PIN        10    // OC1B
+#define STREAM_CNV_HIGH       4     // CPU cycles the conversion pin is high, 250ns at 16MHz
+#define STREAM_MIN_CYCLES     256   // Shortest sample period, in CPU cycles, that leaves time for the read
+
+// The indexes run freely and wrap at 256, a multiple of the ring size.
+static volatile uint8_t stream_ring[LT_STREAM_FRAMES][LT_STREAM_FRAME_MAX];
+static uint8_t stream_scratch[LT_STREAM_FRAME_MAX];  // Read into when the ring is full
+static volatile uint8_t stream_head = 0;              // Written only by the interrupt
+static volatile uint8_t stream_tail = 0;              // Written only by the sketch
+static volatile uint32_t stream_samples = 0;
+static volatile uint32_t stream_overruns = 0;
+static uint8_t stream_frame_bytes = 0;
+static uint8_t stream_postscale = 1;                  // Timer2 periods per sample
+static uint8_t stream_countdown = 1;
+static uint32_t stream_sample_cycles = 0;
+static uint32_t stream_start_us = 0;
+static uint32_t stream_stop_us = 0;
+static uint8_t stream_running = 0;
+
+// Reads a counter that the interrupt updates
+static uint32_t stream_counter(volatile uint32_t *counter)
+{
+#if defined(ARDUINO_ARCH_AVR)
+  uint32_t value;
+  uint8_t sreg = SREG;
+
+  cli();
+  value = *counter;
+  SREG = sreg;
+  return value;
+#else
+  return *counter;
+#endif
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+// Once per Timer2 period, and a read every stream_postscale periods
+ISR(TIMER2_COMPA_vect)
+{
+  uint8_t head;
+
+  if (--stream_countdown)
+    return;
+  stream_countdown = stream_postscale;
+
+  head = stream_head;
+  if ((uint8_t)(head - stream_tail) == LT_STREAM_FRAMES)
+  {
+    spi_stream(0, stream_scratch, stream_frame_bytes, 0);  // Keeps the filter window, drops the sample
+    stream_overruns++;
+  }
+  else
+  {
+    spi_stream(0, (uint8_t *)stream_ring[head & (LT_STREAM_FRAMES - 1)], stream_frame_bytes, 0);
+    stream_head = head + 1;
+  }
+  stream_samples++;
+}
+#endif
+
+// Starts converting and reading
+int8_t lt_stream_begin(uint32_t conversion_hz, uint16_t conversions, uint8_t frame_bytes)
+{
+#if defined(ARDUINO_ARCH_AVR)
+  static const uint16_t prescalers[] = {1, 8, 32, 64, 128, 256, 1024};  // Timer2 CS22:0 = index + 1
+  uint32_t period;
+  uint32_t sample;
+  uint32_t count;
+  uint32_t postscale;
+  uint16_t best_postscale = 256;
+  uint8_t best = 0;
+  uint8_t i;
+
+  if (conversion_hz == 0 || conversions == 0 || frame_bytes == 0 || frame_bytes > LT_STREAM_FRAME_MAX)
+    return 1;
+  period = (F_CPU + conversion_hz / 2) / conversion_hz;
+  if (period < 2 || period > 65536)
+    return 1;
+  sample = period * conversions;
+  if (sample < STREAM_MIN_CYCLES)
+    return 1;
+
+  // Timer2 period times postscale must be the sample period, with the fewest interrupts
+  for (i = 0; i < sizeof(prescalers) / sizeof(prescalers[0]); i++)
+  {
+    if (sample % prescalers[i])
+      continue;
+    count = sample / prescalers[i];
+    if (count > 256UL * 255)        // Needs more than the 255 interrupts per sample a postscale allows
+      continue;
+    for (postscale = (count + 255) / 256; postscale < best_postscale; postscale++)
+    {
+      if (count % postscale == 0)
+      {
+        best_postscale = postscale;
+        best = i;
+        break;
+      }
+    }
+  }
+  if (best_postscale == 256)
+    return 1;
+
+  lt_stream_end();
+  stream_head = 0;
+  stream_tail = 0;
+  stream_samples = 0;
+  stream_overruns = 0;
+  stream_frame_bytes = frame_bytes;
+  stream_sample_cycles = sample;
+  stream_postscale = best_postscale;
+  stream_countdown = best_postscale;
+
+  digitalWrite(STREAM_CNV_PIN, LOW);
+  pinMode(STREAM_CNV_PIN, OUTPUT);
+  GTCCR = (1 << TSM) | (1 << PSRASY) | (1 << PSRSYNC);   // Hold both timers while they are set up
+
+  // Timer1: fast PWM with TOP in ICR1, OC1B high from BOTTOM for STREAM_CNV_HIGH cycles
+  TIMSK1 = 0;
+  TCCR1B = 0;
+  TCCR1A = (1 << COM1B1) | (1 << WGM11);
+  ICR1 = period - 1;
+  OCR1B = (period > 2 * STREAM_CNV_HIGH ? STREAM_CNV_HIGH : period / 2) - 1;
+  TCNT1 = 0;
+  TCCR1B = (1 << WGM13) | (1 << WGM12) | (1 << CS10);
+
+  // Timer2: CTC, the interrupt every sample period / postscale
+  TIMSK2 = 0;
+  TCCR2A = (1 << WGM21);
+  TCCR2B = best + 1;
+  OCR2A = sample / prescalers[best] / best_postscale - 1;
+  TCNT2 = 0;
+  TIFR2 = (1 << OCF2A);
+  TIMSK2 = (1 << OCIE2A);
+
+  stream_start_us = micros();
+  stream_running = 1;
+  GTCCR = 0;                                              // Both start on the same clock edge
+  return 0;
+#else
+  return 1;
+#endif
+}
+
+// Stops converting and reading, and gives the timers back as Arduino set them up
+void lt_stream_end()
+{
+#if defined(ARDUINO_ARCH_AVR)
+  if (!stream_running)
+    return;
+  TIMSK2 = 0;
+  TCCR2A = (1 << WGM20);
+  TCCR2B = (1 << CS22);
+  digitalWrite(STREAM_CNV_PIN, LOW);                      // Also disconnects OC1B
+  TCCR1A = (1 << WGM10);
+  TCCR1B = (1 << CS11) | (1 << CS10);
+  stream_stop_us = micros();
+  stream_running = 0;
+#endif
+}
+
+// Number of frames waiting in the ring
+uint8_t lt_stream_available()
+{
+  return stream_head - stream_tail;
+}
+
+// Takes the oldest frame out of the ring
+int8_t lt_stream_read(uint8_t *frame)
+{
+  uint8_t tail = stream_tail;
+  volatile uint8_t *slot;
+  uint8_t i;
+
+  if (stream_head == tail)
+    return 1;
+  slot = stream_ring[tail & (LT_STREAM_FRAMES - 1)];
+  for (i = 0; i < stream_frame_bytes; i++)
+    frame[i] = slot[i];
+  stream_tail = tail + 1;                                 // Gives the slot back to the interrupt
+  return 0;
+}
+
+// Samples read since lt_stream_begin()
+uint32_t lt_stream_samples()
+{
+  return stream_counter(&stream_samples);
+}
+
+// Samples dropped because the ring was full
+uint32_t lt_stream_overruns()
+{
+  return stream_counter(&stream_overruns);
+}
+
+// Samples per second set up by lt_stream_begin()
+float lt_stream_nominal_rate()
+{
+  return stream_sample_cycles ? (float)F_CPU / stream_sample_cycles : 0;
+}
+
+// Samples per second read since lt_stream_begin()
+float lt_stream_rate()
+{
+  uint32_t samples = lt_stream_samples();
+  uint32_t elapsed = (stream_running ? micros() : stream_stop_us) - stream_start_us;
+
+  return elapsed ? samples * 1e6 / elapsed : 0;
+}
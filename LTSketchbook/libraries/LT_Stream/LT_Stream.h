@@ -0,0 +1,114 @@
+/*!
+LT_Stream: Timer driven conversion and readout for ADCs with a digital filter, such as the LTC2380-24 and LTC2508.
+
+@verbatim
+  Timer1 drives the conversion pin (CNV, or MCLK on the LTC2508) from OC1B,
+  Arduino pin 10 and QUIKEVAL_CS on the Linduino, with a pulse every
+  conversion period, so the conversions are timed by hardware and not by
+  code. Timer2 runs from the same clock and interrupts once every
+  "conversions" periods, just after the edge that follows the last
+  conversion of an output sample. The interrupt clocks the sample out of the
+  ADC with spi_stream() into a ring buffer of frames. The sketch takes the
+  frames out with lt_stream_read(), in the loop, while the ADC keeps running.
+
+  The ring has one producer, the interrupt, and one consumer, the sketch.
+  Each side only writes its own index, and the indexes are single bytes, so
+  neither side has to turn interrupts off. When the ring is full the sample
+  is still read, so that the ADC's filter window stays the same length, but
+  it is dropped and counted as an overrun.
+
+  The interrupt takes about 10us at 8MHz SCK for a 5 byte frame on a 16MHz
+  Linduino, which bounds the output data rate at some tens of kHz; the
+  conversion rate itself is only bounded by the ADC. The product of the
+  conversion period and the conversions per sample, in CPU cycles, must be
+  a multiple of one of the Timer2 prescalers 1, 8, 32, 64, 128, 256 or 1024,
+  as it always is for round rates.
+
+  While streaming, the SPI port belongs to the interrupt, Timer1 and Timer2
+  are taken (no analogWrite() on pins 3, 9, 10 and 11, and no tone()), and
+  pin 10 is the conversion clock. AVR only.
+@endverbatim
+
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LT_Stream
+    Library Header File for LT_Stream: Timer driven conversion and readout for ADCs with a digital filter.
+*/
+
+#ifndef LT_STREAM_H
+#define LT_STREAM_H
+
+#include <stdint.h>
+
+#ifndef LT_STREAM_FRAMES
+#define LT_STREAM_FRAMES 32          //!< Frames in the ring, a power of two up to 128
+#endif
+#define LT_STREAM_FRAME_MAX 6        //!< Largest frame, in bytes
+
+//! Starts converting and reading. SPI must already be enabled at the rate to read with,
+//! and the conversion pin low.
+//! @return 0 on success, 1 if the rates cannot be made by the timers
+int8_t lt_stream_begin(uint32_t conversion_hz,  //!< Conversion or MCLK rate, up to F_CPU / 2
+                       uint16_t conversions,    //!< Conversions per sample, the averaging count or DF
+                       uint8_t frame_bytes      //!< Bytes read per sample, up to LT_STREAM_FRAME_MAX
+                      );
+
+//! Stops converting and reading, and leaves the conversion pin low. The frames
+//! already in the ring can still be read.
+void lt_stream_end();
+
+//! @return the number of frames waiting in the ring
+uint8_t lt_stream_available();
+
+//! Takes the oldest frame out of the ring.
+//! @return 0 on success, 1 if the ring is empty
+int8_t lt_stream_read(uint8_t *frame  //!< frame_bytes bytes, as clocked out of the ADC
+                     );
+
+//! @return samples read from the ADC since lt_stream_begin(), including the ones dropped
+uint32_t lt_stream_samples();
+
+//! @return samples dropped because the ring was full
+uint32_t lt_stream_overruns();
+
+//! @return the samples per second set up by lt_stream_begin()
+float lt_stream_nominal_rate();
+
+//! @return the samples per second actually read since lt_stream_begin(), measured with micros()
+float lt_stream_rate();
+
+#endif  // LT_STREAM_H
@@ -0,0 +1,234 @@
+/*!
+LT_Trace: Bus trace of the SPI and I2C transactions made through LT_SPI, LT_I2C and LT_I2CBus.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! @ingroup Linduino
+//! @{
+//! @defgroup LT_Trace LT_Trace: Bus trace of SPI and I2C transactions.
+//! @}
+
+/*! @file
+    @ingroup LT_Trace
+    Library for LT_Trace: Bus trace of SPI and I2C transactions.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "LT_Trace.h"
+
+uint8_t *lt_trace_buf = 0;
+uint16_t lt_trace_mask = 0;
+void (*volatile lt_trace_pending)() = 0;
+
+// Ring positions run freely and wrap at 65536, a multiple of the ring size.
+static uint8_t *trace_ring = 0;           // Kept after lt_trace_stop() for lt_trace_dump()
+static volatile uint16_t trace_head = 0;  // Position of the next record
+static volatile uint16_t trace_tail = 0;  // Position of the oldest record
+static volatile uint16_t trace_dropped = 0;
+
+// Reads the uint16 at a ring position
+static uint16_t trace_get16(uint16_t pos)
+{
+  return trace_ring[pos & lt_trace_mask] | (trace_ring[(uint16_t)(pos + 1) & lt_trace_mask] << 8);
+}
+
+// Adds one byte to a CRC-16/CCITT
+static uint16_t trace_crc_add(uint16_t crc, uint8_t data)
+{
+  uint8_t i;
+
+  crc ^= (uint16_t)data << 8;
+  for (i = 0; i < 8; i++)
+    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  return crc;
+}
+
+// Sends one byte of the dump frame and adds it to the CRC
+static uint16_t trace_send(uint16_t crc, uint8_t data)
+{
+  Serial.write(data);
+  return trace_crc_add(crc, data);
+}
+
+// Starts tracing into buffer
+int8_t lt_trace_start(uint8_t *buffer, uint16_t size)
+{
+  if (size < 32 || size > 32768 || (size & (size - 1)) != 0)
+    return 1;
+  lt_trace_buf = 0;
+  lt_trace_flush();                       // Bytes gathered before the start are dropped
+  trace_ring = buffer;
+  lt_trace_mask = size - 1;
+  trace_head = 0;
+  trace_tail = 0;
+  trace_dropped = 0;
+  lt_trace_buf = buffer;
+  return 0;
+}
+
+// Stops tracing
+void lt_trace_stop()
+{
+  lt_trace_flush();
+  lt_trace_buf = 0;
+}
+
+// Bytes of records in the ring
+uint16_t lt_trace_used()
+{
+  lt_trace_flush();
+  return trace_head - trace_tail;
+}
+
+// Records dropped since lt_trace_start()
+uint16_t lt_trace_dropped()
+{
+  return trace_dropped;
+}
+
+// Opens a record and writes its header
+uint16_t lt_trace_open(uint8_t kind, uint8_t id, uint16_t tx_len, uint16_t rx_len)
+{
+  uint32_t length = (uint32_t)LT_TRACE_HEADER_SIZE + tx_len + rx_len;
+  uint32_t time;
+  uint16_t pos;
+#if defined(ARDUINO_ARCH_AVR)
+  uint8_t sreg;
+#endif
+
+  if (lt_trace_buf == 0)
+    return LT_TRACE_NONE;
+  lt_trace_flush();                       // Gathered bytes came first
+  if (length > (lt_trace_mask + 1UL) / 2)
+  {
+    trace_dropped++;
+    return LT_TRACE_NONE;
+  }
+  time = micros();
+
+  // Records written from the I2C interrupt must not land in the middle of this one
+#if defined(ARDUINO_ARCH_AVR)
+  sreg = SREG;
+  cli();
+#endif
+  while ((uint16_t)(trace_head - trace_tail) + length > lt_trace_mask + 1UL)
+  {
+    trace_tail += LT_TRACE_HEADER_SIZE + trace_get16(trace_tail + 6) + trace_get16(trace_tail + 8);
+    trace_dropped++;
+  }
+  pos = trace_head;
+  trace_head = pos + (uint16_t)length;
+  lt_trace_put(pos, kind);
+  lt_trace_put(pos + 1, id);
+  lt_trace_put(pos + 2, (uint8_t)time);
+  lt_trace_put(pos + 3, (uint8_t)(time >> 8));
+  lt_trace_put(pos + 4, (uint8_t)(time >> 16));
+  lt_trace_put(pos + 5, (uint8_t)(time >> 24));
+  lt_trace_put(pos + 6, (uint8_t)tx_len);
+  lt_trace_put(pos + 7, (uint8_t)(tx_len >> 8));
+  lt_trace_put(pos + 8, (uint8_t)rx_len);
+  lt_trace_put(pos + 9, (uint8_t)(rx_len >> 8));
+#if defined(ARDUINO_ARCH_AVR)
+  SREG = sreg;
+#endif
+  // Masked, so that positions up to the end of the record never reach LT_TRACE_NONE
+  return (pos + LT_TRACE_HEADER_SIZE) & lt_trace_mask;
+}
+
+// Copies bytes into an open record
+uint16_t lt_trace_write(uint16_t pos, const uint8_t *data, uint16_t length, uint8_t reverse)
+{
+  uint8_t *ring = lt_trace_buf;
+  uint16_t mask = lt_trace_mask;
+
+  if (data == 0)
+  {
+    while (length--)
+      ring[pos++ & mask] = 0;
+  }
+  else if (reverse)
+  {
+    data += length;
+    while (length--)
+      ring[pos++ & mask] = *--data;
+  }
+  else
+  {
+    while (length--)
+      ring[pos++ & mask] = *data++;
+  }
+  return pos;
+}
+
+// Records a whole transaction whose buffers are in bus order
+void lt_trace_record(uint8_t kind, uint8_t id, const uint8_t *tx, uint16_t tx_len,
+                     const uint8_t *rx, uint16_t rx_len)
+{
+  uint16_t pos = lt_trace_open(kind, id, tx_len, rx_len);
+
+  if (pos == LT_TRACE_NONE)
+    return;
+  pos = lt_trace_write(pos, tx, tx_len, 0);
+  lt_trace_write(pos, rx, rx_len, 0);
+}
+
+// Sends the records as one dump frame and empties the ring
+void lt_trace_dump()
+{
+  uint8_t *running;
+  uint16_t length;
+  uint16_t crc = 0xFFFF;
+  uint16_t pos;
+
+  lt_trace_flush();
+  running = lt_trace_buf;
+  length = trace_head - trace_tail;
+  lt_trace_buf = 0;
+  Serial.write(LT_TRACE_SYNC0);
+  Serial.write(LT_TRACE_SYNC1);
+  crc = trace_send(crc, LT_TRACE_VERSION);
+  crc = trace_send(crc, (uint8_t)trace_dropped);
+  crc = trace_send(crc, (uint8_t)(trace_dropped >> 8));
+  crc = trace_send(crc, (uint8_t)length);
+  crc = trace_send(crc, (uint8_t)(length >> 8));
+  for (pos = trace_tail; pos != trace_head; pos++)
+    crc = trace_send(crc, trace_ring[pos & lt_trace_mask]);
+  Serial.write((uint8_t)crc);
+  Serial.write((uint8_t)(crc >> 8));
+  trace_tail = trace_head;
+  trace_dropped = 0;
+  lt_trace_buf = running;
+}
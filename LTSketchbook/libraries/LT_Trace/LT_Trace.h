@@ -0,0 +1,178 @@
+/*!
+LT_Trace: Bus trace of the SPI and I2C transactions made through LT_SPI, LT_I2C and LT_I2CBus.
+
+@verbatim
+  Every transaction is stored as one record in a ring buffer given by the
+  sketch. When the ring is full the oldest records are dropped. The ring is
+  sent over Serial by lt_trace_dump() and replayed on a PC by
+  host/lt_trace_replay.cpp, which feeds the recorded responses back to the
+  drivers. Tracing costs one pointer test per transaction while it is stopped.
+
+  Bytes clocked one at a time by spi_read() and spi_write() are gathered by
+  LT_SPI and stored together as one LT_TRACE_NO_CS record, when another record
+  is opened, when the batch is full, or before the ring is read. The time of
+  such a record is when it was stored.
+
+  Record, all values little endian:
+
+    kind                  LT_TRACE_SPI or LT_TRACE_I2C, or'ed with the LT_TRACE_FAILED,
+                          LT_TRACE_PEC and LT_TRACE_BLOCK flags
+    id                    chip select pin, or the 7-bit I2C address
+    time                  uint32, micros() when the record was opened
+    tx_len                uint16
+    rx_len                uint16
+    tx                    bytes sent, in bus order. For I2C the command bytes are first,
+                          the PEC byte is left out.
+    rx                    bytes received, in bus order. For SPI there is one per byte sent.
+                          For I2C the byte count and the PEC of a block read are left out.
+
+  Dump frame sent by lt_trace_dump():
+
+    A5 54                 sync
+    version               LT_TRACE_VERSION
+    dropped               uint16, records dropped since lt_trace_start()
+    length                uint16, bytes of records that follow
+    records               oldest first
+    crc                   uint16 CRC-16/CCITT (0x1021, start 0xFFFF) of every byte
+                          from version to the last record
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup LT_Trace
+    Library Header File for LT_Trace: Bus trace of SPI and I2C transactions.
+*/
+
+#ifndef LT_TRACE_H
+#define LT_TRACE_H
+
+#include <stdint.h>
+
+#define LT_TRACE_SYNC0 0xA5          //!< First byte of a dump frame
+#define LT_TRACE_SYNC1 0x54          //!< Second byte of a dump frame
+#define LT_TRACE_VERSION 1           //!< Record and frame layout version
+#define LT_TRACE_HEADER_SIZE 10      //!< Bytes in a record before tx
+#define LT_TRACE_NONE 0xFFFF         //!< Returned by lt_trace_open() when nothing is recorded
+
+//! @name RECORD KINDS AND FLAGS
+//! @{
+#define LT_TRACE_SPI     0x10  //!< SPI transfer, tx_len and rx_len are equal
+#define LT_TRACE_I2C     0x20  //!< I2C transaction, a write phase and/or a read phase
+#define LT_TRACE_BUS     0xF0  //!< Mask of the kind bits
+#define LT_TRACE_FAILED  0x01  //!< The I2C device NACKed, the PEC was bad or the block was too long
+#define LT_TRACE_PEC     0x02  //!< The I2C transaction carried a PEC
+#define LT_TRACE_BLOCK   0x04  //!< SMBus block read, rx holds the bytes counted by the device
+//! @}
+
+//! id of SPI bytes clocked by spi_stream(), spi_read() or spi_write(), which do not know the chip select
+#define LT_TRACE_NO_CS   0xFF
+
+//! Ring buffer, 0 while tracing is stopped
+extern uint8_t *lt_trace_buf;
+//! Ring buffer size - 1
+extern uint16_t lt_trace_mask;
+//! Set by a driver that gathers bytes before recording them, 0 when none are waiting
+extern void (*volatile lt_trace_pending)();
+
+//! Records the bytes a driver has gathered, if any. Called before a record is
+//! opened, before the ring is read and when tracing stops.
+static inline void lt_trace_flush()
+{
+  void (*pending)() = lt_trace_pending;
+
+  if (pending)
+  {
+    lt_trace_pending = 0;
+    pending();
+  }
+}
+
+//! Starts tracing into buffer, which is cleared. Records longer than half the
+//! buffer are dropped, so give it at least twice the longest transaction.
+//! @return 0 on success, 1 if size is not a power of two from 32 to 32768
+int8_t lt_trace_start(uint8_t *buffer,  //!< Ring buffer, owned by the trace until lt_trace_stop()
+                      uint16_t size     //!< Size of buffer, a power of two
+                     );
+
+//! Stops tracing. The records stay in the buffer until the next lt_trace_start().
+void lt_trace_stop();
+
+//! @return bytes of records in the ring
+uint16_t lt_trace_used();
+
+//! @return records dropped because the ring was full or they were too long
+uint16_t lt_trace_dropped();
+
+//! Sends the records with Serial.write() as one dump frame and empties the ring.
+//! Tracing is paused while the frame is sent.
+void lt_trace_dump();
+
+//! Opens a record and writes its header. The caller then writes exactly tx_len
+//! bytes from the returned position and rx_len bytes after them. Safe to call
+//! from an interrupt.
+//! @return ring position of tx, or LT_TRACE_NONE if tracing is stopped or the record does not fit
+uint16_t lt_trace_open(uint8_t kind,      //!< LT_TRACE_SPI or LT_TRACE_I2C, and flags
+                       uint8_t id,        //!< Chip select pin or 7-bit I2C address
+                       uint16_t tx_len,   //!< Bytes sent
+                       uint16_t rx_len    //!< Bytes received
+                      );
+
+//! Copies bytes into an open record.
+//! @return the ring position after the last byte
+uint16_t lt_trace_write(uint16_t pos,         //!< Ring position from lt_trace_open()
+                        const uint8_t *data,  //!< Bytes to copy, or 0 to write zeros
+                        uint16_t length,      //!< Number of bytes
+                        uint8_t reverse       //!< Copy data from the last byte to the first
+                       );
+
+//! Stores one byte of an open record, for drivers that record while the bus is busy.
+static inline void lt_trace_put(uint16_t pos,  //!< Ring position
+                                uint8_t data   //!< Byte to store
+                               )
+{
+  lt_trace_buf[pos & lt_trace_mask] = data;
+}
+
+//! Records a whole transaction whose buffers are in bus order.
+void lt_trace_record(uint8_t kind,        //!< LT_TRACE_SPI or LT_TRACE_I2C, and flags
+                     uint8_t id,          //!< Chip select pin or 7-bit I2C address
+                     const uint8_t *tx,   //!< Bytes sent, or 0 for zeros
+                     uint16_t tx_len,     //!< Number of bytes sent
+                     const uint8_t *rx,   //!< Bytes received, or 0 for zeros
+                     uint16_t rx_len      //!< Number of bytes received
+                    );
+
+#endif  // LT_TRACE_H
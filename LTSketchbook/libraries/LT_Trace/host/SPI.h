@@ -0,0 +1,24 @@
+/*!
+SPI library stand-in for building LT_SPI.h users on a PC with lt_trace_replay.cpp.
+*/
+
+#ifndef LT_TRACE_HOST_SPI_H
+#define LT_TRACE_HOST_SPI_H
+
+#define SPI_CLOCK_DIV4    0x00
+#define SPI_CLOCK_DIV16   0x01
+#define SPI_CLOCK_DIV64   0x02
+#define SPI_CLOCK_DIV128  0x03
+#define SPI_CLOCK_DIV2    0x04
+#define SPI_CLOCK_DIV8    0x05
+#define SPI_CLOCK_DIV32   0x06
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+#endif
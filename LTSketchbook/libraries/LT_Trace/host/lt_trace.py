@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""
+LT_Trace dump decoder
+
+Reads the dump frames sent by lt_trace_dump(), from a capture file or a
+serial port, checks them and prints one line per SPI or I2C transaction. The
+record and frame layouts are described in LT_Trace.h. Text printed by the
+sketch between frames is skipped. The frames can also be saved, to be replayed
+by lt_trace_replay_bench.cpp.
+
+Usage:
+  python3 lt_trace.py capture.bin
+  python3 lt_trace.py --port /dev/ttyACM0 --frames 1 -o capture.bin   (needs pyserial)
+
+Options:
+  -o FILE     save the good frames to FILE for the replayer
+  --quiet     do not print the transactions
+  --port DEV  read from a serial port instead of a file
+  --baud N    serial baud rate, default 115200
+  --frames N  stop after N good frames
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+
+SYNC = b'\xa5\x54'
+VERSION = 1
+FRAME_HEADER_LEN = 5     # version, dropped, length
+RECORD_HEADER_LEN = 10   # kind to rx_len
+SPI = 0x10
+I2C = 0x20
+FAILED = 0x01
+PEC = 0x02
+BLOCK = 0x04
+NO_CS = 0xFF
+
+
+def crc16(data):
+    """CRC-16/CCITT, polynomial 0x1021 MSB first, start 0xFFFF."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+class Record(object):
+    def __init__(self, kind, ident, time, tx, rx):
+        self.kind = kind
+        self.ident = ident
+        self.time = time
+        self.tx = tx
+        self.rx = rx
+
+    def describe(self):
+        if self.kind & 0xF0 == SPI:
+            where = 'SPI  ' + ('--' if self.ident == NO_CS else 'cs%-2d' % self.ident)
+        else:
+            where = 'I2C  0x%02x' % self.ident
+        flags = ''.join(name for bit, name in ((FAILED, ' FAILED'), (PEC, ' PEC'), (BLOCK, ' BLOCK'))
+                        if self.kind & bit)
+        line = '%10u  %s  W %s' % (self.time, where, self.tx.hex(' ') if self.tx else '-')
+        if self.rx or self.kind & 0xF0 == I2C:
+            line += '  R %s' % (self.rx.hex(' ') if self.rx else '-')
+        return line + flags
+
+
+def parse_records(body):
+    """Splits the records of one frame. Returns None if they do not fill it exactly."""
+    records = []
+    pos = 0
+    while pos + RECORD_HEADER_LEN <= len(body):
+        kind, ident, time, tx_len, rx_len = struct.unpack_from('<BBIHH', body, pos)
+        pos += RECORD_HEADER_LEN
+        tx = bytes(body[pos:pos + tx_len])
+        rx = bytes(body[pos + tx_len:pos + tx_len + rx_len])
+        pos += tx_len + rx_len
+        records.append(Record(kind, ident, time, tx, rx))
+    return records if pos == len(body) else None
+
+
+class Decoder(object):
+    """Finds and checks dump frames in a byte stream fed in arbitrary pieces."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.good = 0
+        self.crc_errors = 0
+        self.dropped = 0
+        self.records = 0
+
+    def feed(self, data):
+        """Returns a list of (raw frame, records)."""
+        self.buf += data
+        frames = []
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                del self.buf[:max(0, len(self.buf) - 1)]
+                return frames
+            del self.buf[:start]
+            if len(self.buf) < len(SYNC) + FRAME_HEADER_LEN:
+                return frames
+            version, dropped, length = struct.unpack_from('<BHH', self.buf, len(SYNC))
+            if version != VERSION:
+                del self.buf[:1]
+                continue
+            total = len(SYNC) + FRAME_HEADER_LEN + length + 2
+            if len(self.buf) < total:
+                return frames
+            body = bytes(self.buf[len(SYNC):total - 2])
+            crc, = struct.unpack_from('<H', self.buf, total - 2)
+            records = parse_records(body[FRAME_HEADER_LEN:]) if crc16(body) == crc else None
+            if records is None:
+                # Not a frame, or a damaged one: look for the next sync
+                self.crc_errors += 1
+                del self.buf[:1]
+                continue
+            frames.append((bytes(self.buf[:total]), records))
+            del self.buf[:total]
+            self.good += 1
+            self.dropped += dropped
+            self.records += len(records)
+
+    def finish(self):
+        """At the end of the input, drops an incomplete frame and decodes anything behind it."""
+        frames = []
+        while self.buf.find(SYNC) >= 0:
+            del self.buf[:self.buf.find(SYNC) + 1]
+            frames += self.feed(b'')
+        return frames
+
+
+def open_input(args):
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=1)
+        return lambda: port.read(4096)
+    f = open(args.capture, 'rb')
+    return lambda: f.read(65536)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode LT_Trace dump frames')
+    parser.add_argument('capture', nargs='?', help='binary capture file')
+    parser.add_argument('-o', '--output', help='save the good frames to this file')
+    parser.add_argument('--quiet', action='store_true', help='do not print the transactions')
+    parser.add_argument('--port', help='serial port to read instead of a file')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--frames', type=int, default=0, help='stop after this many good frames')
+    args = parser.parse_args()
+    if not args.capture and not args.port:
+        parser.error('give a capture file or --port')
+
+    read = open_input(args)
+    out = open(args.output, 'wb') if args.output else None
+    decoder = Decoder()
+    try:
+        while True:
+            data = read()
+            if not data:
+                if args.port:
+                    continue
+                frames = decoder.finish()
+            else:
+                frames = decoder.feed(data)
+            for raw, records in frames:
+                if out:
+                    out.write(raw)
+                if not args.quiet:
+                    for record in records:
+                        print(record.describe())
+                if args.frames and decoder.good >= args.frames:
+                    raise KeyboardInterrupt
+            if not data:
+                break
+    except KeyboardInterrupt:
+        pass
+    if out:
+        out.close()
+    sys.stderr.write('%d frames, %d records, %d records dropped on the Linduino, %d CRC errors\n' %
+                     (decoder.good, decoder.records, decoder.dropped, decoder.crc_errors))
+
+
+if __name__ == '__main__':
+    main()
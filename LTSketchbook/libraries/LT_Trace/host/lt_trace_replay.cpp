@@ -0,0 +1,738 @@
+/*!
+LT_Trace replayer: LT_SPI, LT_I2C and LT_I2CBus answered from a bus trace.
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LT_Trace.h"
+#include "LT_SPI.h"
+#include "LT_I2C.h"
+#include "LT_I2CBus.h"
+#include "lt_trace_replay.h"
+
+//! One record of the trace
+typedef struct
+{
+  uint8_t kind;
+  uint8_t id;
+  uint32_t time;
+  uint16_t tx_len;
+  uint16_t rx_len;
+  const uint8_t *tx;
+  const uint8_t *rx;
+} replay_record;
+
+static uint8_t *replay_bytes = 0;         // tx and rx bytes of every record
+static uint32_t replay_bytes_len = 0;
+static replay_record *replay_records = 0;
+static uint32_t replay_count = 0;
+static uint32_t replay_next = 0;
+static lt_trace_replay_stats replay_stats;
+static uint64_t replay_us = 0;            // Virtual time
+static uint64_t replay_pass_us = 0;       // Virtual time of the first record of this pass
+static const replay_record replay_empty = {0, 0, 0, 0, 0, 0, 0};
+static const replay_record *replay_batch = 0;  // Record of the spi_read() bytes being answered
+static uint16_t replay_batch_pos = 0;
+
+HostSerial Serial;
+
+// Reads the little endian uint16 at p
+static uint16_t replay_get16(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+// Adds one byte to a CRC-16/CCITT, as lt_trace_dump() does
+static uint16_t replay_crc_add(uint16_t crc, uint8_t data)
+{
+  uint8_t i;
+
+  crc ^= (uint16_t)data << 8;
+  for (i = 0; i < 8; i++)
+    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  return crc;
+}
+
+// Adds one byte to the SMBus PEC, as LT_I2CBus::writeBlockDataPec() does
+static uint8_t replay_pec_add(uint8_t pec, uint8_t data)
+{
+  uint8_t i;
+
+  pec ^= data;
+  for (i = 0; i < 8; i++)
+    pec = (pec & 0x80) ? (uint8_t)((pec << 1) ^ 0x07) : (uint8_t)(pec << 1);
+  return pec;
+}
+
+// Forgets every record
+static void replay_clear()
+{
+  free(replay_bytes);
+  free(replay_records);
+  replay_bytes = 0;
+  replay_bytes_len = 0;
+  replay_records = 0;
+  replay_count = 0;
+  memset(&replay_stats, 0, sizeof(replay_stats));
+  lt_trace_replay_rewind();
+}
+
+// Appends the records of one dump frame
+static int32_t replay_append(const uint8_t *records, uint32_t length)
+{
+  uint32_t pos;
+  uint32_t count = 0;
+  uint32_t bytes = 0;
+  uint32_t i;
+  uint8_t *old = replay_bytes;
+
+  // Count first, so the arrays are grown once
+  for (pos = 0; pos + LT_TRACE_HEADER_SIZE <= length; count++)
+  {
+    uint32_t n = replay_get16(records + pos + 6) + replay_get16(records + pos + 8);
+    pos += LT_TRACE_HEADER_SIZE + n;
+    bytes += n;
+  }
+  if (pos != length)
+    return -1;
+
+  replay_bytes = (uint8_t *)realloc(replay_bytes, replay_bytes_len + bytes + 1);
+  replay_records = (replay_record *)realloc(replay_records, (replay_count + count) * sizeof(replay_record));
+  for (i = 0; i < replay_count; i++)     // Bytes may have moved
+  {
+    replay_records[i].tx = replay_bytes + (replay_records[i].tx - old);
+    replay_records[i].rx = replay_bytes + (replay_records[i].rx - old);
+  }
+  for (pos = 0; pos < length; )
+  {
+    replay_record *r = &replay_records[replay_count++];
+    r->kind = records[pos];
+    r->id = records[pos + 1];
+    r->time = replay_get16(records + pos + 2) | ((uint32_t)replay_get16(records + pos + 4) << 16);
+    r->tx_len = replay_get16(records + pos + 6);
+    r->rx_len = replay_get16(records + pos + 8);
+    pos += LT_TRACE_HEADER_SIZE;
+    memcpy(replay_bytes + replay_bytes_len, records + pos, r->tx_len + r->rx_len);
+    r->tx = replay_bytes + replay_bytes_len;
+    r->rx = r->tx + r->tx_len;
+    replay_bytes_len += r->tx_len + r->rx_len;
+    pos += r->tx_len + r->rx_len;
+  }
+  replay_stats.records = replay_count;
+  return count;
+}
+
+// Loads every dump frame found in a capture
+int32_t lt_trace_replay_load(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  uint8_t *data;
+  long size;
+  long i;
+
+  if (f == 0)
+    return -1;
+  fseek(f, 0, SEEK_END);
+  size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  data = (uint8_t *)malloc(size + 1);
+  if (fread(data, 1, size, f) != (size_t)size)
+  {
+    fclose(f);
+    free(data);
+    return -1;
+  }
+  fclose(f);
+
+  replay_clear();
+  for (i = 0; i + 9 <= size; )
+  {
+    uint16_t length;
+    uint16_t crc = 0xFFFF;
+    long j;
+
+    if (data[i] != LT_TRACE_SYNC0 || data[i + 1] != LT_TRACE_SYNC1 || data[i + 2] != LT_TRACE_VERSION)
+    {
+      i++;
+      continue;
+    }
+    length = replay_get16(data + i + 5);
+    if (i + 9 + length > size)
+    {
+      i++;
+      continue;
+    }
+    for (j = i + 2; j < i + 7 + length; j++)
+      crc = replay_crc_add(crc, data[j]);
+    if (crc != replay_get16(data + i + 7 + length) || replay_append(data + i + 7, length) < 0)
+    {
+      i++;                              // Bad frame, or sync bytes inside text
+      continue;
+    }
+    i += 9 + length;
+  }
+  free(data);
+  return replay_count;
+}
+
+// Loads records from memory
+int32_t lt_trace_replay_load_records(const uint8_t *records, uint32_t length)
+{
+  replay_clear();
+  return replay_append(records, length);
+}
+
+// Starts the replay again from the first record
+void lt_trace_replay_rewind()
+{
+  replay_next = 0;
+  replay_batch = 0;
+  replay_us = 0;
+  replay_pass_us = 0;
+}
+
+const lt_trace_replay_stats *lt_trace_replay_get_stats()
+{
+  return &replay_stats;
+}
+
+void lt_trace_replay_reset_stats()
+{
+  uint32_t records = replay_stats.records;
+
+  memset(&replay_stats, 0, sizeof(replay_stats));
+  replay_stats.records = records;
+}
+
+// Takes the next record, moves virtual time up to it and checks the bus and id
+static const replay_record *replay_take(uint8_t bus, uint8_t id)
+{
+  const replay_record *r;
+  uint64_t when;
+
+  replay_batch = 0;                     // Any other transaction ends the batch
+  if (replay_count == 0)
+    return &replay_empty;
+  if (replay_next == replay_count)
+  {
+    const replay_record *last = &replay_records[replay_count - 1];
+    replay_pass_us += (uint32_t)(last->time - replay_records[0].time);
+    replay_next = 0;
+    replay_stats.passes++;
+  }
+  r = &replay_records[replay_next++];
+  when = replay_pass_us + (uint32_t)(r->time - replay_records[0].time);
+  if (replay_us < when)
+    replay_us = when;
+  replay_stats.transactions++;
+  if ((r->kind & LT_TRACE_BUS) != bus || r->id != id)
+    replay_stats.bus_mismatches++;
+  return r;
+}
+
+// Checks the lengths of a record, and counts the bytes sent that differ
+static void replay_check(const replay_record *r, uint16_t tx_len, uint16_t rx_len, uint16_t tx_errors)
+{
+  if (r->tx_len != tx_len || (r->rx_len != rx_len && !(r->kind & LT_TRACE_FAILED)))
+    replay_stats.length_mismatches++;
+  if (tx_errors != 0)
+    replay_stats.tx_mismatches++;
+}
+
+// Replays one SPI buffer from position pos of a record
+// @return bytes sent that differ from the record
+static uint16_t replay_spi(const replay_record *r, uint16_t *pos, const uint8_t *tx, uint8_t *rx,
+                           uint16_t length, uint8_t flags)
+{
+  const uint8_t fill = (flags & LT_SPI_FILL_ONES) ? 0xFF : 0x00;
+  uint16_t errors = 0;
+  uint16_t i;
+
+  for (i = 0; i < length; i++, (*pos)++)
+  {
+    uint16_t index = (flags & LT_SPI_REVERSE) ? length - 1 - i : i;
+    uint8_t out = tx ? tx[index] : fill;
+
+    if (*pos >= r->tx_len || r->tx[*pos] != out)
+      errors++;
+    if (rx)
+      rx[index] = (*pos < r->rx_len) ? r->rx[*pos] : 0;
+  }
+  return errors;
+}
+
+// Replays one I2C transaction. tx and rx are in bus order unless reverse is set.
+// @return 0 on success, 1 if the transaction failed on the Linduino
+static int8_t replay_i2c(uint8_t address, const uint8_t *command, uint8_t command_len,
+                         const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len,
+                         uint8_t flags, uint8_t reverse, uint16_t *count)
+{
+  const replay_record *r = replay_take(LT_TRACE_I2C, address);
+  uint16_t errors = 0;
+  uint16_t n;
+  uint16_t i;
+
+  for (i = 0; i < command_len + tx_len; i++)
+  {
+    uint8_t out = (i < command_len) ? command[i] :
+                  tx[reverse ? tx_len - 1 - (i - command_len) : i - command_len];
+    if (i >= r->tx_len || r->tx[i] != out)
+      errors++;
+  }
+  if ((r->kind & (LT_TRACE_PEC | LT_TRACE_BLOCK)) != (flags & (LT_TRACE_PEC | LT_TRACE_BLOCK)))
+    replay_stats.bus_mismatches++;
+  n = (r->rx_len < rx_len) ? r->rx_len : rx_len;
+  for (i = 0; i < n; i++)
+    rx[reverse ? n - 1 - i : i] = r->rx[i];
+  if (flags & LT_TRACE_BLOCK)
+  {
+    *count = r->rx_len;
+    replay_check(r, command_len + tx_len, r->rx_len, errors);
+    if (r->rx_len > rx_len)
+      return 1;
+  }
+  else
+  {
+    if (count)
+      *count = n;
+    replay_check(r, command_len + tx_len, rx_len, errors);
+  }
+  return (r->kind & LT_TRACE_FAILED) ? 1 : 0;
+}
+
+// Time //////////////////////////////////////////////////////////////////////
+
+unsigned long millis()
+{
+  return replay_us / 1000;
+}
+
+unsigned long micros()
+{
+  return replay_us;
+}
+
+void delay(unsigned long ms)
+{
+  replay_us += ms * 1000ULL;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  replay_us += us;
+}
+
+// LT_SPI ////////////////////////////////////////////////////////////////////
+
+void spi_transfer_byte(uint8_t cs_pin, uint8_t tx, uint8_t *rx)
+{
+  const replay_record *r = replay_take(LT_TRACE_SPI, cs_pin);
+  uint16_t pos = 0;
+
+  replay_check(r, 1, 1, replay_spi(r, &pos, &tx, rx, 1, 0));
+}
+
+void spi_transfer_word(uint8_t cs_pin, uint16_t tx, uint16_t *rx)
+{
+  const replay_record *r = replay_take(LT_TRACE_SPI, cs_pin);
+  uint8_t out[2] = {(uint8_t)(tx >> 8), (uint8_t)tx};
+  uint8_t in[2];
+  uint16_t pos = 0;
+
+  replay_check(r, 2, 2, replay_spi(r, &pos, out, in, 2, 0));
+  *rx = (in[0] << 8) | in[1];
+}
+
+void spi_transfer_block(uint8_t cs_pin, uint8_t *tx, uint8_t *rx, uint8_t length)
+{
+  const replay_record *r = replay_take(LT_TRACE_SPI, cs_pin);
+  uint16_t pos = 0;
+
+  replay_check(r, length, length, replay_spi(r, &pos, tx, rx, length, LT_SPI_REVERSE));
+}
+
+void spi_transaction(uint8_t cs_pin, const spi_segment *segments, uint8_t count)
+{
+  const replay_record *r = replay_take(LT_TRACE_SPI, cs_pin);
+  uint16_t errors = 0;
+  uint16_t pos = 0;
+  uint8_t i;
+
+  for (i = 0; i < count; i++)
+    errors += replay_spi(r, &pos, segments[i].tx, segments[i].rx, segments[i].length, segments[i].flags);
+  replay_check(r, pos, pos, errors);
+}
+
+void spi_stream(const uint8_t *tx, uint8_t *rx, uint16_t length, uint8_t flags)
+{
+  const replay_record *r = replay_take(LT_TRACE_SPI, LT_TRACE_NO_CS);
+  uint16_t pos = 0;
+
+  replay_check(r, length, length, replay_spi(r, &pos, tx, rx, length, flags));
+}
+
+void spi_write(int8_t data)
+{
+  spi_read(data);
+}
+
+// LT_SPI records the bytes of spi_read() in batches, so one record answers several calls
+int8_t spi_read(int8_t data)
+{
+  uint8_t in;
+
+  if (replay_batch == 0 || replay_batch_pos >= replay_batch->tx_len)
+  {
+    replay_batch = replay_take(LT_TRACE_SPI, LT_TRACE_NO_CS);
+    replay_batch_pos = 0;
+  }
+  if (replay_spi(replay_batch, &replay_batch_pos, (const uint8_t *)&data, &in, 1, 0) != 0)
+    replay_stats.tx_mismatches++;
+  return in;
+}
+
+void quikeval_SPI_connect()
+{
+}
+
+void quikeval_SPI_init()
+{
+}
+
+void spi_enable(uint8_t spi_clock_divider)
+{
+}
+
+void spi_disable()
+{
+}
+
+// LT_I2C ////////////////////////////////////////////////////////////////////
+
+// Same buffers and byte order as i2c_run() in LT_I2C.cpp
+static int8_t replay_i2c_run(uint8_t address, uint8_t command_len, uint16_t command,
+                             const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len)
+{
+  uint8_t cmd[2] = {(uint8_t)((command_len == 2) ? command >> 8 : command), (uint8_t)command};
+
+  return replay_i2c(address, cmd, command_len, tx, tx_len, rx, rx_len, 0, 1, 0);
+}
+
+int8_t i2c_read_byte(uint8_t address, uint8_t *value)
+{
+  return replay_i2c_run(address, 0, 0, 0, 0, value, 1);
+}
+
+int8_t i2c_write_byte(uint8_t address, uint8_t value)
+{
+  return replay_i2c_run(address, 0, 0, &value, 1, 0, 0);
+}
+
+int8_t i2c_read_byte_data(uint8_t address, uint8_t command, uint8_t *value)
+{
+  return replay_i2c_run(address, 1, command, 0, 0, value, 1);
+}
+
+int8_t i2c_write_byte_data(uint8_t address, uint8_t command, uint8_t value)
+{
+  return replay_i2c_run(address, 1, command, &value, 1, 0, 0);
+}
+
+int8_t i2c_read_word_data(uint8_t address, uint8_t command, uint16_t *value)
+{
+  return replay_i2c_run(address, 1, command, 0, 0, (uint8_t *)value, 2);
+}
+
+int8_t i2c_write_word_data(uint8_t address, uint8_t command, uint16_t value)
+{
+  return replay_i2c_run(address, 1, command, (const uint8_t *)&value, 2, 0, 0);
+}
+
+int8_t i2c_read_block_data(uint8_t address, uint8_t command, uint8_t length, uint8_t *values)
+{
+  return replay_i2c_run(address, 1, command, 0, 0, values, length);
+}
+
+int8_t i2c_read_block_data(uint8_t address, uint8_t length, uint8_t *values)
+{
+  return replay_i2c_run(address, 0, 0, 0, 0, values, length);
+}
+
+int8_t i2c_write_block_data(uint8_t address, uint8_t command, uint8_t length, uint8_t *values)
+{
+  return replay_i2c_run(address, 1, command, values, length, 0, 0);
+}
+
+int8_t i2c_two_byte_command_read_block(uint8_t address, uint16_t command, uint8_t length, uint8_t *values)
+{
+  return replay_i2c_run(address, 2, command, 0, 0, values, length);
+}
+
+// Transactions finish as soon as they are submitted
+int8_t i2c_submit(i2c_transfer *transfer)
+{
+  uint8_t flags = ((transfer->flags & I2C_XFER_PEC) ? LT_TRACE_PEC : 0) |
+                  ((transfer->flags & I2C_XFER_BLOCK) ? LT_TRACE_BLOCK : 0);
+  uint16_t count;
+
+  transfer->status = replay_i2c(transfer->address, transfer->command, transfer->command_len,
+                                transfer->tx, transfer->tx_len, transfer->rx, transfer->rx_len,
+                                flags, (transfer->flags & I2C_XFER_REVERSE) ? 1 : 0, &count);
+  transfer->rx_len = count;
+  transfer->pec = 0;
+  if (transfer->callback)
+    transfer->callback(transfer);
+  return 0;
+}
+
+int8_t i2c_wait(i2c_transfer *transfer)
+{
+  return transfer->status;
+}
+
+void i2c_service()
+{
+}
+
+uint8_t i2c_busy()
+{
+  return 0;
+}
+
+void i2c_abort()
+{
+}
+
+void i2c_engine_isr()
+{
+}
+
+void quikeval_I2C_init(void)
+{
+}
+
+void quikeval_I2C_connect(void)
+{
+}
+
+void i2c_enable()
+{
+}
+
+// The bit level functions are not traced on the Linduino. They succeed and read 0xFF.
+int8_t i2c_start()
+{
+  return 0;
+}
+
+int8_t i2c_repeated_start()
+{
+  return 0;
+}
+
+void i2c_stop()
+{
+}
+
+int8_t i2c_write(uint8_t data)
+{
+  return 0;
+}
+
+uint8_t i2c_read(int8_t ack)
+{
+  return 0xFF;
+}
+
+int8_t i2c_poll(uint8_t i2c_address)
+{
+  return 0;
+}
+
+// LT_I2CBus /////////////////////////////////////////////////////////////////
+
+LT_I2CBus::LT_I2CBus()
+{
+  speed_ = 100000;
+  inGroupProtocol_ = false;
+  dev_ = 0;
+}
+
+LT_I2CBus::LT_I2CBus(uint32_t speed)
+{
+  speed_ = speed;
+  inGroupProtocol_ = false;
+  dev_ = 0;
+}
+
+LT_I2CBus::LT_I2CBus(const char *device)
+{
+  speed_ = 100000;
+  inGroupProtocol_ = false;
+  dev_ = 0;
+}
+
+LT_I2CBus::~LT_I2CBus()
+{
+}
+
+// Transactions replayed, to compare with the ioctl count of the i2c-dev backend
+uint32_t LT_I2CBus::ioctls()
+{
+  return replay_stats.transactions;
+}
+
+void LT_I2CBus::changeSpeed(uint32_t speed)
+{
+  speed_ = speed;
+}
+
+uint32_t LT_I2CBus::getSpeed()
+{
+  return speed_;
+}
+
+int8_t LT_I2CBus::readByte(uint8_t address, uint8_t *value)
+{
+  return replay_i2c(address, 0, 0, 0, 0, value, 1, 0, 0, 0);
+}
+
+int8_t LT_I2CBus::writeByte(uint8_t address, uint8_t value)
+{
+  return replay_i2c(address, 0, 0, &value, 1, 0, 0, 0, 0, 0);
+}
+
+int8_t LT_I2CBus::readByteData(uint8_t address, uint8_t command, uint8_t *value)
+{
+  return replay_i2c(address, &command, 1, 0, 0, value, 1, 0, 0, 0);
+}
+
+int8_t LT_I2CBus::writeByteData(uint8_t address, uint8_t command, uint8_t value)
+{
+  return replay_i2c(address, &command, 1, &value, 1, 0, 0, 0, 0, 0);
+}
+
+int8_t LT_I2CBus::readWordData(uint8_t address, uint8_t command, uint16_t *value)
+{
+  uint8_t in[2] = {0, 0};
+  int8_t ret = replay_i2c(address, &command, 1, 0, 0, in, 2, 0, 0, 0);
+
+  *value = (in[0] << 8) | in[1];
+  return ret;
+}
+
+int8_t LT_I2CBus::writeWordData(uint8_t address, uint8_t command, uint16_t value)
+{
+  uint8_t out[2] = {(uint8_t)(value >> 8), (uint8_t)value};
+
+  return replay_i2c(address, &command, 1, out, 2, 0, 0, 0, 0, 0);
+}
+
+int8_t LT_I2CBus::readBlockData(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  return replay_i2c(address, &command, 1, 0, 0, values, length, 0, 0, 0);
+}
+
+int8_t LT_I2CBus::readBlockDataPec(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  return replay_i2c(address, &command, 1, 0, 0, values, length, LT_TRACE_PEC, 0, 0);
+}
+
+int8_t LT_I2CBus::readBlockData(uint8_t address, uint16_t length, uint8_t *values)
+{
+  return replay_i2c(address, 0, 0, 0, 0, values, length, 0, 0, 0);
+}
+
+int8_t LT_I2CBus::readBlockDataPec(uint8_t address, uint16_t length, uint8_t *values)
+{
+  return replay_i2c(address, 0, 0, 0, 0, values, length, LT_TRACE_PEC, 0, 0);
+}
+
+int8_t LT_I2CBus::readSMBusBlock(uint8_t address, uint8_t command, uint16_t length, uint8_t *values,
+                                 uint16_t *count, bool pec)
+{
+  return replay_i2c(address, &command, 1, 0, 0, values, length,
+                    LT_TRACE_BLOCK | (pec ? LT_TRACE_PEC : 0), 0, count);
+}
+
+int8_t LT_I2CBus::writeBlockData(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  return replay_i2c(address, &command, 1, values, length, 0, 0, 0, 0, 0);
+}
+
+// The recording holds the PEC the Linduino sent after the values
+int8_t LT_I2CBus::writeBlockDataPec(uint8_t address, uint8_t command, uint16_t length, uint8_t *values)
+{
+  uint8_t *out = (uint8_t *)malloc(length + 1);
+  uint8_t pec = replay_pec_add(replay_pec_add(0, address << 1), command);
+  uint16_t i;
+  int8_t ret;
+
+  for (i = 0; i < length; i++)
+    pec = replay_pec_add(pec, out[i] = values[i]);
+  out[length] = pec;
+  ret = replay_i2c(address, &command, 1, out, length + 1, 0, 0, 0, 0, 0);
+  free(out);
+  return ret;
+}
+
+int8_t LT_I2CBus::twoByteCommandReadBlock(uint8_t address, uint16_t command, uint16_t length, uint8_t *values)
+{
+  uint8_t cmd[2] = {(uint8_t)(command >> 8), (uint8_t)command};
+
+  return replay_i2c(address, cmd, 2, 0, 0, values, length, 0, 0, 0);
+}
+
+void LT_I2CBus::quikevalI2CInit(void)
+{
+}
+
+void LT_I2CBus::quikevalI2CConnect(void)
+{
+}
+
+void LT_I2CBus::startGroupProtocol()
+{
+  inGroupProtocol_ = true;
+}
+
+void LT_I2CBus::endGroupProtocol()
+{
+  inGroupProtocol_ = false;
+}
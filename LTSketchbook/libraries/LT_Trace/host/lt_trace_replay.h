@@ -0,0 +1,91 @@
+/*!
+LT_Trace replayer
+@verbatim
+  Host (Linux) implementation of LT_SPI, LT_I2C and LT_I2CBus that answers
+  every transaction with the bytes recorded by LT_Trace on a Linduino. A
+  driver built against it runs unmodified, and sees the same responses as on
+  the bench, so its CPU cost can be measured on a PC and compared between
+  versions. See lt_trace_replay_bench.cpp.
+
+  Records are used strictly in order. Each call takes the next record and
+  compares what the driver sends with what was recorded. A difference is
+  counted in the statistics, and the recorded response is still used so the
+  replay stays in step. After the last record the replay starts again from the
+  first one and a new pass is counted.
+
+  Time is virtual: micros() and millis() start at the time of the first record
+  and move with the recorded timestamps and with delay(), which returns at once.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_TRACE_REPLAY_H
+#define LT_TRACE_REPLAY_H
+
+#include <stdint.h>
+
+//! Counters kept by the replayer. Cleared by lt_trace_replay_load() and lt_trace_replay_reset_stats().
+typedef struct
+{
+  uint32_t records;             //!< Records loaded
+  uint32_t transactions;        //!< Records replayed
+  uint32_t passes;              //!< Times the replay went past the last record
+  uint32_t bus_mismatches;      //!< Replayed records of the other bus, or of another chip select or address
+  uint32_t tx_mismatches;       //!< Replayed records where the bytes sent differ
+  uint32_t length_mismatches;   //!< Replayed records where the number of bytes differs
+} lt_trace_replay_stats;
+
+//! Loads every dump frame found in a capture of the serial port. Text between
+//! frames is skipped, frames with a bad CRC are dropped.
+//! @return the number of records loaded, or -1 if the file cannot be read
+int32_t lt_trace_replay_load(const char *path  //!< Capture file
+                            );
+
+//! Loads records from memory, laid out as in a dump frame.
+//! @return the number of records loaded, or -1 if the records are truncated
+int32_t lt_trace_replay_load_records(const uint8_t *records,  //!< Records, oldest first
+                                     uint32_t length          //!< Bytes of records
+                                    );
+
+//! Starts the replay again from the first record.
+void lt_trace_replay_rewind();
+
+//! @return the replayer counters
+const lt_trace_replay_stats *lt_trace_replay_get_stats();
+
+//! Clears the replayer counters, except records.
+void lt_trace_replay_reset_stats();
+
+#endif
@@ -0,0 +1,175 @@
+/*!
+LT_Trace replay benchmark
+@verbatim
+  Replays a bus trace recorded by Utilities/Bus_Trace through LT_PMBus,
+  LT_SMBus and LT_I2CBus on a PC, and reports the CPU time the library spends
+  per PMBus poll and per transaction with the bus taken out. The poll is the
+  one in Bus_Trace.ino: PAGE, STATUS_WORD, READ_VOUT with VOUT_MODE, READ_IOUT
+  and READ_ITEMP, 6 transactions. Any difference between what the library
+  sends and what was recorded is reported, so the same trace checks that a new
+  driver version still talks to the part the same way.
+
+  Build, from LT_Trace:
+    g++ -O2 -Ihost -I. -I../LT_SMBUS/linux -I../LT_SMBUS -I../LT_PMBUS -I../LT_SPI \
+        -I../LT_I2C -I../Linduino -I../UserInterface \
+        host/lt_trace_replay_bench.cpp host/lt_trace_replay.cpp \
+        ../LT_SMBUS/LT_SMBus.cpp ../LT_SMBUS/LT_SMBusBase.cpp ../LT_SMBUS/LT_SMBusNoPec.cpp \
+        ../LT_SMBUS/LT_SMBusPec.cpp ../LT_SMBUS/LT_SMBusGroup.cpp \
+        ../LT_PMBUS/LT_PMBus.cpp ../LT_PMBUS/LT_PMBusMath.cpp -o lt_trace_replay_bench
+
+  Run:
+    ./lt_trace_replay_bench capture.bin [-a addr] [-n passes] [-p]
+
+    -a addr     PMBus address used by the sketch, default 0x30
+    -n passes   times the whole trace is replayed, default 10000
+    -p          the sketch used LT_SMBusPec
+
+  Other drivers are replayed the same way: link them with lt_trace_replay.cpp
+  in place of LT_SPI.cpp, LT_I2C.cpp and LT_I2CBus.cpp, and repeat the calls
+  the sketch made while it was tracing.
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "LT_I2CBus.h"
+#include "LT_SMBusNoPec.h"
+#include "LT_SMBusPec.h"
+#include "LT_PMBus.h"
+#include "lt_trace_replay.h"
+
+#define TRANSACTIONS_PER_POLL 6
+
+//! @return CPU time used by the process in nanoseconds
+static uint64_t cpu_ns()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//! One poll, the same calls as poll_rail() in Bus_Trace.ino
+static float poll_rail(LT_PMBus *pmbus, uint8_t address)
+{
+  float sum;
+
+  pmbus->setPage(address, 0);
+  pmbus->readStatusWord(address);
+  sum = pmbus->readVout(address, false);
+  sum += pmbus->readIout(address, false);
+  sum += pmbus->readInternalTemperature(address, false);
+  return sum;
+}
+
+int main(int argc, char *argv[])
+{
+  uint8_t address = 0x30;
+  uint32_t passes = 10000;
+  bool pec = false;
+  const lt_trace_replay_stats *stats;
+  int32_t records;
+  uint32_t polls;
+  uint32_t i;
+  uint64_t start;
+  uint64_t ns;
+  volatile float sink = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "a:n:p")) != -1)
+  {
+    switch (opt)
+    {
+      case 'a':
+        address = strtoul(optarg, 0, 0);
+        break;
+      case 'n':
+        passes = strtoul(optarg, 0, 0);
+        break;
+      case 'p':
+        pec = true;
+        break;
+      default:
+        optind = argc + 1;
+        break;
+    }
+  }
+  if (optind != argc - 1)
+  {
+    fprintf(stderr, "usage: %s capture.bin [-a addr] [-n passes] [-p]\n", argv[0]);
+    return 2;
+  }
+
+  records = lt_trace_replay_load(argv[optind]);
+  if (records <= 0)
+  {
+    fprintf(stderr, "%s: no trace records\n", argv[optind]);
+    return 2;
+  }
+  if (records % TRANSACTIONS_PER_POLL != 0)
+    fprintf(stderr, "warning: %d records is not a whole number of polls\n", records);
+  polls = records / TRANSACTIONS_PER_POLL;
+
+  LT_SMBus *smbus = pec ? (LT_SMBus *)new LT_SMBusPec() : (LT_SMBus *)new LT_SMBusNoPec();
+  LT_PMBus *pmbus = new LT_PMBus(smbus);
+
+  // One pass to check the trace, then the timed passes
+  for (i = 0; i < polls; i++)
+    sink += poll_rail(pmbus, address);
+  stats = lt_trace_replay_get_stats();
+  printf("%d records, %u polls per pass\n", records, polls);
+  printf("check pass: %u bus, %u tx, %u length mismatches\n",
+         stats->bus_mismatches, stats->tx_mismatches, stats->length_mismatches);
+  if (stats->bus_mismatches || stats->tx_mismatches || stats->length_mismatches)
+    return 1;
+
+  lt_trace_replay_rewind();
+  lt_trace_replay_reset_stats();
+  start = cpu_ns();
+  for (i = 0; i < passes * polls; i++)
+    sink += poll_rail(pmbus, address);
+  ns = cpu_ns() - start;
+
+  printf("%u polls, %u transactions, %.1f ns per poll, %.1f ns per transaction\n",
+         passes * polls, stats->transactions, (double)ns / (passes * polls),
+         (double)ns / stats->transactions);
+  delete pmbus;                 // also deletes smbus and its bus
+  return (stats->tx_mismatches || stats->length_mismatches) ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+/*!
+QuikEval_Bus: Shares the QuikEval connector between SPI and I2C devices.
+
+@verbatim
+
+Keeps the mux state and the last SPI settings applied, so the QuikEval mux and
+the SPI clock are only reprogrammed when they change. See QuikEval_Bus.h.
+
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! @ingroup Linduino
+//! @{
+//! @defgroup QuikEval_Bus QuikEval_Bus: Shares the QuikEval connector between SPI and I2C devices.
+//! @}
+
+/*! @file
+    @ingroup QuikEval_Bus
+    Library for QuikEval_Bus: Shares the QuikEval connector between SPI and I2C devices.
+*/
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include <SPI.h>
+#include "Linduino.h"
+#include "LT_SPI.h"
+#include "LT_I2C.h"
+#include "QuikEval_Bus.h"
+
+//! A queued operation
+typedef struct
+{
+  uint8_t bus;
+  quikeval_bus_op op;
+  void *arg;
+} quikeval_bus_entry;
+
+static uint8_t bus_state = QUIKEVAL_BUS_UNKNOWN;
+static const quikeval_spi_device *spi_device = 0;   // Device whose settings were applied last
+static uint16_t bus_switches = 0;
+static quikeval_bus_entry bus_queue[QUIKEVAL_BUS_QUEUE_LEN];
+static uint8_t bus_queued = 0;
+
+// Sets up the mux pin and the SPI and I2C ports
+void quikeval_bus_init()
+{
+  pinMode(QUIKEVAL_CS, OUTPUT);
+  output_high(QUIKEVAL_CS);
+  SPI.begin();
+  quikeval_I2C_init();
+
+  pinMode(QUIKEVAL_MUX_MODE_PIN, OUTPUT);
+  bus_state = (digitalRead(QUIKEVAL_MUX_MODE_PIN) == HIGH) ? QUIKEVAL_BUS_I2C : QUIKEVAL_BUS_SPI;
+  spi_device = 0;
+  bus_switches = 0;
+  bus_queued = 0;
+}
+
+// Forgets the mux state and the SPI settings
+void quikeval_bus_invalidate()
+{
+  bus_state = QUIKEVAL_BUS_UNKNOWN;
+  spi_device = 0;
+}
+
+// Returns the bus the QuikEval connector is on
+uint8_t quikeval_bus_current()
+{
+  return bus_state;
+}
+
+// Puts the QuikEval connector on a bus, if it is not already there
+uint8_t quikeval_bus_select(uint8_t bus)
+{
+  if (bus == bus_state)
+    return 0;
+
+  pinMode(QUIKEVAL_MUX_MODE_PIN, OUTPUT);
+  if (bus == QUIKEVAL_BUS_I2C)
+  {
+    digitalWrite(QUIKEVAL_MUX_MODE_PIN, HIGH);  //! 1) Mux to I2C
+    delay(QUIKEVAL_BUS_I2C_SETTLE_MS);          //! 2) Wait for the LTC4315 to connect (rev B)
+  }
+  else
+  {
+    output_high(QUIKEVAL_CS);                   //! 1) Deselect before SPI reaches the connector
+    digitalWrite(QUIKEVAL_MUX_MODE_PIN, LOW);   //! 2) Mux to SPI
+  }
+  bus_state = bus;
+  bus_switches++;
+  return 1;
+}
+
+// Puts the QuikEval connector on SPI and applies the device's SPI settings
+void quikeval_spi_select(const quikeval_spi_device *device)
+{
+  quikeval_bus_select(QUIKEVAL_BUS_SPI);
+  if (device != spi_device)
+  {
+    // beginTransaction() writes the clock, mode and bit order; nothing else
+    // needs to be held, so the transaction is closed straight away.
+    SPI.beginTransaction(device->settings);
+    SPI.endTransaction();
+    spi_device = device;
+  }
+}
+
+// Queues an operation to be run on a bus by quikeval_bus_run()
+uint8_t quikeval_bus_queue(uint8_t bus, quikeval_bus_op op, void *arg)
+{
+  if (bus_queued >= QUIKEVAL_BUS_QUEUE_LEN)
+    return 1;
+  bus_queue[bus_queued].bus = bus;
+  bus_queue[bus_queued].op = op;
+  bus_queue[bus_queued].arg = arg;
+  bus_queued++;
+  return 0;
+}
+
+// Runs the queued operations, those for the current bus first
+uint8_t quikeval_bus_run()
+{
+  uint8_t switches = 0;
+  uint8_t first = (bus_state == QUIKEVAL_BUS_I2C) ? QUIKEVAL_BUS_I2C : QUIKEVAL_BUS_SPI;
+  uint8_t order[2];
+  quikeval_bus_entry run[QUIKEVAL_BUS_QUEUE_LEN];
+  uint8_t count = bus_queued;
+
+  order[0] = first;
+  order[1] = (first == QUIKEVAL_BUS_SPI) ? QUIKEVAL_BUS_I2C : QUIKEVAL_BUS_SPI;
+
+  // The queue is emptied first, so operations may queue more work for the next run
+  memcpy(run, bus_queue, count*sizeof(quikeval_bus_entry));
+  bus_queued = 0;
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      if (run[i].bus != order[pass])
+        continue;
+      switches += quikeval_bus_select(order[pass]);
+      run[i].op(run[i].arg);
+    }
+  }
+  return switches;
+}
+
+// Returns the number of mux switches since quikeval_bus_init()
+uint16_t quikeval_bus_switches()
+{
+  return bus_switches;
+}
@@ -0,0 +1,129 @@
+/*!
+QuikEval_Bus: Shares the QuikEval connector between SPI and I2C devices.
+
+@verbatim
+
+The QuikEval connector carries either the SPI port or the I2C port, chosen by
+the mux on QUIKEVAL_MUX_MODE_PIN. quikeval_SPI_connect() and
+quikeval_I2C_connect() switch it unconditionally, and spi_enable() reprograms
+the SPI clock each time it is called, so code that talks to an SPI part and an
+I2C part in turn spends most of its time switching.
+
+This library remembers which bus the mux is on and which SPI settings were
+last applied, and only touches the hardware when they change:
+
+  quikeval_bus_select(QUIKEVAL_BUS_I2C);   // mux to I2C, waits for the LTC4315 once
+  LTC6904_write(...);
+  quikeval_spi_select(&adc);               // mux to SPI, applies adc's SPISettings once
+  LTC2484_read(...);
+
+Work that does not need to run in a fixed order can be queued with
+quikeval_bus_queue() and run with quikeval_bus_run(), which runs everything
+for the bus the mux is already on first, then switches once for the rest.
+
+Code that calls quikeval_SPI_connect(), quikeval_I2C_connect() or spi_enable()
+directly should call quikeval_bus_invalidate() afterwards.
+
+@endverbatim
+
+Copyright 2018(c) Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+ - Neither the name of Analog Devices, Inc. nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+ - The use of this software may or may not infringe the patent rights
+   of one or more patent holders.  This license does not release you
+   from the requirement that you obtain separate licenses from these
+   patent holders to use this software.
+ - Use of the software either in source or binary form, must be run
+   on or directly connected to an Analog Devices Inc. component.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*! @file
+    @ingroup QuikEval_Bus
+    Header for QuikEval_Bus: Shares the QuikEval connector between SPI and I2C devices.
+*/
+
+#ifndef QUIKEVAL_BUS_H
+#define QUIKEVAL_BUS_H
+
+#include <stdint.h>
+#include <SPI.h>
+
+//! @name QUIKEVAL MUX STATES
+//! @{
+#define QUIKEVAL_BUS_UNKNOWN  0   //!< Mux state not known, the next select always switches
+#define QUIKEVAL_BUS_SPI      1   //!< SPI port on the QuikEval connector
+#define QUIKEVAL_BUS_I2C      2   //!< I2C port on the QuikEval connector
+//! @}
+
+#define QUIKEVAL_BUS_I2C_SETTLE_MS 55   //!< Time for the LTC4315 on rev B Linduinos to connect I2C
+#define QUIKEVAL_BUS_QUEUE_LEN 8        //!< Operations that can wait in the queue
+
+//! An SPI device on the QuikEval connector
+typedef struct
+{
+  uint8_t cs_pin;         //!< Chip select pin
+  SPISettings settings;   //!< Clock, bit order and mode for this device
+} quikeval_spi_device;
+
+//! An operation queued with quikeval_bus_queue()
+typedef void (*quikeval_bus_op)(void *arg);
+
+//! Sets up the mux pin and the SPI and I2C ports. The mux state is read back from the pin.
+void quikeval_bus_init();
+
+//! Forgets the mux state and the SPI settings, after code that switched them directly.
+void quikeval_bus_invalidate();
+
+//! @return the bus the QuikEval connector is on
+uint8_t quikeval_bus_current();
+
+//! Puts the QuikEval connector on a bus, if it is not already there.
+//! @return 1 if the mux was switched, 0 if it was already on that bus
+uint8_t quikeval_bus_select(uint8_t bus   //!< QUIKEVAL_BUS_SPI or QUIKEVAL_BUS_I2C
+                           );
+
+//! Puts the QuikEval connector on SPI and applies the device's SPI settings,
+//! if they are not the settings applied last. Chip select is left to the caller.
+void quikeval_spi_select(const quikeval_spi_device *device  //!< Device about to be accessed
+                        );
+
+//! Queues an operation to be run on a bus by quikeval_bus_run().
+//! @return 0 if the operation was queued, 1 if the queue is full
+uint8_t quikeval_bus_queue(uint8_t bus,          //!< QUIKEVAL_BUS_SPI or QUIKEVAL_BUS_I2C
+                           quikeval_bus_op op,   //!< Operation, called with arg
+                           void *arg             //!< Argument for the operation
+                          );
+
+//! Runs the queued operations, those for the current bus first and then the
+//! others, so the mux is switched at most once. Operations on the same bus run
+//! in the order they were queued.
+//! @return the number of mux switches made
+uint8_t quikeval_bus_run();
+
+//! @return the number of mux switches since quikeval_bus_init()
+uint16_t quikeval_bus_switches();
+
+#endif  // QUIKEVAL_BUS_H
@@ -46,6 +46,9 @@
 #include <SPI.h>
 #include <Wire.h>
 #include "platform_drivers.h"
+#if defined(ARDUINO_ARCH_AVR)
+#include <LT_I2C.h>
+#endif
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -66,6 +69,7 @@ int32_t i2c_init(i2c_desc **desc,
 	new_desc->id = param.id;
 	new_desc->max_speed_hz = param.max_speed_hz;
 	new_desc->slave_address = param.slave_address;
+	new_desc->held_write_len = 0;
 	
 	*desc = new_desc;
 	
@@ -88,8 +92,47 @@ int32_t i2c_init(i2c_desc **desc,
  */
 int32_t i2c_remove(i2c_desc *desc)
 {
+	free(desc);
+
+	return SUCCESS;
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+/**
+ * @brief Run one transaction on the LT_I2C engine: a write phase, then a
+ *        repeated start and a read phase, then a stop. Either phase may be
+ *        empty. The bytes read go straight into data, so unlike Wire there is
+ *        no 32 byte limit and no copy out of a library buffer.
+ * @param desc - The I2C descriptor.
+ * @param tx - Bytes to write.
+ * @param tx_len - Number of bytes to write.
+ * @param data - Buffer that will store the received data.
+ * @param rx_len - Number of bytes to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t i2c_engine_run(i2c_desc *desc,
+			      const uint8_t *tx,
+			      uint8_t tx_len,
+			      uint8_t *data,
+			      uint8_t rx_len)
+{
+	i2c_transfer x;
+
+	x.address = desc->slave_address;
+	x.command_len = 0;
+	x.tx = tx;
+	x.tx_len = tx_len;
+	x.rx = data;
+	x.rx_len = rx_len;
+	x.flags = 0;
+	x.callback = 0;
+	x.arg = 0;
+	if (i2c_submit(&x) || i2c_wait(&x))
+		return FAILURE;
+
 	return SUCCESS;
 }
+#endif
 
 /**
  * @brief Write data to a slave device.
@@ -106,17 +149,41 @@ int32_t i2c_write(i2c_desc *desc,
 		  uint8_t bytes_number,
 		  uint8_t stop_bit)
 {
+#if defined(ARDUINO_ARCH_AVR)
+	int32_t ret = SUCCESS;
+
+	// Two writes in a row with no stop: the first one goes on its own
+	if (desc->held_write_len) {
+		ret = i2c_engine_run(desc, desc->held_write, desc->held_write_len, 0, 0);
+		desc->held_write_len = 0;
+	}
+
+	// A register pointer before a read is held, and sent with the read
+	if (!stop_bit && bytes_number <= I2C_HELD_WRITE_MAX) {
+		memcpy(desc->held_write, data, bytes_number);
+		desc->held_write_len = bytes_number;
+		return ret;
+	}
+
+	if (i2c_engine_run(desc, data, bytes_number, 0, 0))
+		ret = FAILURE;
+
+	return ret;
+#else
 	return Wire_Write(desc->slave_address, data, bytes_number, stop_bit);
+#endif
 }
 
 /**
- * @brief Read data from a slave device.
+ * @brief Read data from a slave device. A write held by i2c_write() is sent
+ *        first, with a repeated start before the read.
  * @param desc - The I2C descriptor.
  * @param data - Buffer that will store the received data.
  * @param bytes_number - Number of bytes to read.
  * @param stop_bit - Stop condition control.
  *                   Example: 0 - A stop condition will not be generated;
  *                            1 - A stop condition will be generated.
+ *                   On AVR the transaction always ends with a stop.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
 int32_t i2c_read(i2c_desc *desc,
@@ -124,7 +191,17 @@ int32_t i2c_read(i2c_desc *desc,
 		 uint8_t bytes_number,
 		 uint8_t stop_bit)
 {
+#if defined(ARDUINO_ARCH_AVR)
+	int32_t ret;
+
+	ret = i2c_engine_run(desc, desc->held_write, desc->held_write_len,
+			     data, bytes_number);
+	desc->held_write_len = 0;
+
+	return ret;
+#else
 	return Wire_Read(desc->slave_address, data, bytes_number, stop_bit);
+#endif
 }
 
 
@@ -165,6 +242,8 @@ int32_t spi_init(spi_desc **desc,
 	// Create initialization object
 	SPISettings * spi_settings = new SPISettings(spi_speed, MSBFIRST, spi_mode);
 	
+	new_desc->settings = spi_settings;
+	
 	// Set the SPI bus to use our settings
 	SPI.beginTransaction(*spi_settings);
 	SPI.endTransaction();
@@ -172,6 +251,11 @@ int32_t spi_init(spi_desc **desc,
 	// Connect to the bus
 	SPI.begin();
 	
+#if defined(ARDUINO_ARCH_AVR)
+	new_desc->cs_port = portOutputRegister(digitalPinToPort(new_desc->chip_select));
+	new_desc->cs_mask = digitalPinToBitMask(new_desc->chip_select);
+#endif
+	
 	// Pull Chip Select High
 	output_high(new_desc->chip_select); 
 	
@@ -186,10 +270,37 @@ int32_t spi_init(spi_desc **desc,
 int32_t spi_remove(spi_desc *desc)
 {
 	SPI.end();
+	delete (SPISettings *)desc->settings;
+	free(desc);
 
 	return SUCCESS;
 }
 
+/**
+ * @brief Set the chip select of a device.
+ * @param desc - The SPI descriptor.
+ * @param level - LOW or HIGH.
+ * @return None.
+ */
+static inline void spi_cs_write(spi_desc *desc,
+				uint8_t level)
+{
+#if defined(ARDUINO_ARCH_AVR)
+	// Interrupts off so an interrupt cannot change another pin of the port
+	// between the read and the write
+	uint8_t sreg = SREG;
+
+	cli();
+	if (level)
+		*desc->cs_port |= desc->cs_mask;
+	else
+		*desc->cs_port &= ~desc->cs_mask;
+	SREG = sreg;
+#else
+	digitalWrite(desc->chip_select, level);
+#endif
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
@@ -201,51 +312,19 @@ int32_t spi_write_and_read(spi_desc *desc,
 			   uint8_t *data,
 			   uint8_t bytes_number)
 {
-	// Set chip select
-	uint8_t id = desc->chip_select;
-	
-	// transfer & read arrays
-	uint8_t tx[bytes_number];
-	uint8_t rx[bytes_number];
-	
-	// Copy data to tx
-	for(int i = 0; i < bytes_number; i++)
-	{
-		tx[i] = data[i];
-	}
+	// Each device keeps its own mode and speed
+	SPI.beginTransaction(*(SPISettings *)desc->settings);
 
-	// if(false)
-	// {
-		// Serial.print(F("SPI writing: "));
-		// Serial.print(tx[0], HEX);
-		// Serial.print(tx[1], HEX);
-		// Serial.println(tx[2], HEX);
-	// }
+	spi_cs_write(desc, LOW); //! 1) Pull CS low
 
-//	Lin_SPI_Transfer_Block(id, tx, rx, bytes_number);
+	// Received bytes replace the sent ones, each byte is loaded while the
+	// last one is read out
+	SPI.transfer(data, bytes_number); //! 2) Read and send byte array
 
-	// Copy rx back into data
-//	Serial.println(F("read from SPI"));
-//	for(int i = 0; i < bytes_number; i++)
-//	{
-//		data[i] = rx[i];
-//		Serial.print(data[i], HEX);
-//	}
+	spi_cs_write(desc, HIGH); //! 3) Pull CS high
 
-	
-	
-    output_low(id); //! 1) Pull CS low
-
-	//for (i = length; i > 0; i--)
-	for (int i = 0; i < bytes_number; i++)
-    {
-        data[i] = SPI.transfer(tx[i]); //! 2) Read and send byte array
-    }
+	SPI.endTransaction();
 
-    output_high(id); //! 3) Pull CS high
-	
-	
-	
 	return SUCCESS;
 }
 
@@ -66,6 +66,9 @@ extern "C" {
 #define MUX_I2C		0
 #define MUX_SPI		1
 
+/* Longest write with no stop that is held for the next i2c_read() */
+#define I2C_HELD_WRITE_MAX	8
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -86,6 +89,9 @@ typedef struct {
 	uint32_t	id;
 	uint32_t	max_speed_hz;
 	uint8_t		slave_address;
+	/* A write with no stop, sent with the next read as one transaction */
+	uint8_t		held_write[I2C_HELD_WRITE_MAX];
+	uint8_t		held_write_len;
 } i2c_desc;
 
 typedef enum {
@@ -115,6 +121,11 @@ typedef struct {
 	uint32_t	max_speed_hz;
 	uint8_t mode; // spi_mode	mode;
 	uint8_t		chip_select;
+	/* SPISettings made by spi_init(), applied around every transfer */
+	void		*settings;
+	/* Chip select output register and bit, so it is set without digitalWrite() */
+	volatile uint8_t	*cs_port;
+	uint8_t		cs_mask;
 } spi_desc;
 
 typedef enum {